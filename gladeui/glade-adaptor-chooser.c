@@ -24,6 +24,7 @@
 #include "glade-app.h"
 #include "gladeui-enum-types.h"
 #include "glade-adaptor-chooser.h"
+#include "glade-private.h"
 
 #include <string.h>
 
@@ -48,6 +49,10 @@ struct _GladeAdaptorChooserPrivate
   GtkTreeViewColumn *column_adaptor;
   GtkCellRenderer   *adaptor_cell;
 
+  /* The search entry text and its normalized form */
+  gchar *search_text;
+  gchar *search_key;
+
   /* Properties */
   _GladeAdaptorChooserFlags flags;
   GladeProject *project;
@@ -84,6 +89,11 @@ _glade_adaptor_chooser_init (_GladeAdaptorChooser *chooser)
 static void
 _glade_adaptor_chooser_finalize (GObject *object)
 {
+  _GladeAdaptorChooserPrivate *priv = GLADE_ADAPTOR_CHOOSER (object)->priv;
+
+  g_free (priv->search_text);
+  g_free (priv->search_key);
+
   G_OBJECT_CLASS (_glade_adaptor_chooser_parent_class)->finalize (object);
 }
 
@@ -142,23 +152,20 @@ _glade_adaptor_chooser_get_property (GObject    *object,
 static inline gchar *
 normalize_name (const gchar *name)
 {
-  gchar *normalized_name = g_utf8_normalize (name, -1, G_NORMALIZE_DEFAULT);
-  gchar *casefold_name = g_utf8_casefold (normalized_name, -1);
-  g_free (normalized_name);
-  return casefold_name;
+  return _glade_catalog_normalize_search_key (name);
 }
 
 static inline void
 store_append_adaptor (GtkListStore *store, GladeWidgetAdaptor *adaptor)
 {
-  gchar *normalized_name = normalize_name (glade_widget_adaptor_get_name (adaptor));
+  /* Search keys are computed once when the catalogs are loaded */
+  const gchar *normalized_name = _glade_catalog_get_search_key (adaptor);
 
   gtk_list_store_insert_with_values (store, NULL, -1,
                                      COLUMN_ADAPTOR, adaptor,
                                      COLUMN_NORMALIZED_NAME, normalized_name,
                                      COLUMN_NORMALIZED_NAME_LEN, strlen (normalized_name),
                                      -1);
-  g_free (normalized_name);
 }
 
 static inline void
@@ -309,10 +316,18 @@ static gboolean
 treemodelfilter_visible_func (GtkTreeModel *model, GtkTreeIter *iter, gpointer data)
 {
   _GladeAdaptorChooserPrivate *priv = GLADE_ADAPTOR_CHOOSER (data)->priv;
-  gchar *key = normalize_name (gtk_entry_get_text (GTK_ENTRY (priv->searchentry)));
-  gboolean visible = chooser_match_func (data, model, key, iter);
-  g_free (key);
-  return visible;
+  const gchar *text = gtk_entry_get_text (GTK_ENTRY (priv->searchentry));
+
+  /* Normalize the search text once per refilter, not once per row */
+  if (g_strcmp0 (priv->search_text, text) != 0)
+    {
+      g_free (priv->search_text);
+      g_free (priv->search_key);
+      priv->search_text = g_strdup (text);
+      priv->search_key = normalize_name (text);
+    }
+
+  return chooser_match_func (data, model, priv->search_key, iter);
 }
 
 static gboolean
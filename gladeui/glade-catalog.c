@@ -85,6 +85,11 @@ static GList *loaded_catalogs = NULL;
 /* Extra paths to load catalogs from */
 static GList *catalog_paths = NULL;
 
+/* Queries over all loaded adaptors, built once by glade_catalog_load_all() */
+static GList      *catalog_enum_types = NULL;   /* GTypes sorted by name */
+static GList      *catalog_flags_types = NULL;  /* GTypes sorted by name */
+static GHashTable *catalog_search_keys = NULL;  /* adaptor -> casefolded name */
+
 static gboolean
 catalog_get_function (GladeCatalog *catalog,
                       const gchar  *symbol_name,
@@ -611,6 +616,73 @@ glade_catalog_get_extra_paths (void)
   return catalog_paths;
 }
 
+static gint
+catalog_type_name_cmp (gconstpointer a, gconstpointer b)
+{
+  return strcmp (g_type_name (GPOINTER_TO_SIZE (a)),
+                 g_type_name (GPOINTER_TO_SIZE (b)));
+}
+
+static gchar *
+catalog_search_key (const gchar *name)
+{
+  gchar *normalized_name = g_utf8_normalize (name, -1, G_NORMALIZE_DEFAULT);
+  gchar *casefold_name = g_utf8_casefold (normalized_name, -1);
+
+  g_free (normalized_name);
+
+  return casefold_name;
+}
+
+static void
+catalog_index_build (GList *adaptors)
+{
+  GHashTable *types = g_hash_table_new (NULL, NULL);
+  GHashTableIter iter;
+  gpointer key;
+  GList *l;
+
+  catalog_search_keys = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+
+  for (l = adaptors; l; l = g_list_next (l))
+    {
+      GladeWidgetAdaptor *adaptor = l->data;
+      const GList *p;
+
+      g_hash_table_insert (catalog_search_keys, adaptor,
+                           catalog_search_key (glade_widget_adaptor_get_name (adaptor)));
+
+      for (p = glade_widget_adaptor_get_properties (adaptor); p; p = g_list_next (p))
+        {
+          GParamSpec *pspec = glade_property_class_get_pspec (p->data);
+
+          if (G_TYPE_IS_ENUM (pspec->value_type) || G_TYPE_IS_FLAGS (pspec->value_type))
+            g_hash_table_add (types, GSIZE_TO_POINTER (pspec->value_type));
+        }
+    }
+
+  g_hash_table_iter_init (&iter, types);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+      if (G_TYPE_IS_ENUM (GPOINTER_TO_SIZE (key)))
+        catalog_enum_types = g_list_prepend (catalog_enum_types, key);
+      else
+        catalog_flags_types = g_list_prepend (catalog_flags_types, key);
+    }
+  g_hash_table_destroy (types);
+
+  catalog_enum_types = g_list_sort (catalog_enum_types, catalog_type_name_cmp);
+  catalog_flags_types = g_list_sort (catalog_flags_types, catalog_type_name_cmp);
+}
+
+static void
+catalog_index_destroy (void)
+{
+  g_clear_pointer (&catalog_enum_types, g_list_free);
+  g_clear_pointer (&catalog_flags_types, g_list_free);
+  g_clear_pointer (&catalog_search_keys, g_hash_table_destroy);
+}
+
 /**
  * glade_catalog_load_all:
  * 
@@ -699,6 +771,8 @@ glade_catalog_load_all (void)
         }
     }
 
+  catalog_index_build (adaptors);
+
   g_list_free (adaptors);
 
   if (icon_warning)
@@ -838,6 +912,30 @@ glade_catalog_get_adaptors (GladeCatalog *catalog)
   return catalog->adaptors;
 }
 
+/**
+ * glade_catalog_get_enum_types:
+ * 
+ * Returns: (element-type GType) (transfer none): the enumeration types
+ *          of the properties of every loaded class adaptor, sorted by name
+ */
+const GList *
+glade_catalog_get_enum_types (void)
+{
+  return catalog_enum_types;
+}
+
+/**
+ * glade_catalog_get_flags_types:
+ * 
+ * Returns: (element-type GType) (transfer none): the flags types of the
+ *          properties of every loaded class adaptor, sorted by name
+ */
+const GList *
+glade_catalog_get_flags_types (void)
+{
+  return catalog_flags_types;
+}
+
 /**
  * glade_catalog_is_loaded:
  * @name: a catalog object
@@ -870,6 +968,8 @@ glade_catalog_destroy_all (void)
       loaded_catalogs = NULL;
     }
 
+  catalog_index_destroy ();
+
   /* close plugin modules */
   if (modules)
     {
@@ -950,3 +1050,19 @@ _glade_catalog_tsort (GList *catalogs)
 {
   return glade_catalog_tsort (catalogs, FALSE);
 }
+
+/* The normalized and casefolded name of @adaptor, for searching */
+const gchar *
+_glade_catalog_get_search_key (GladeWidgetAdaptor *adaptor)
+{
+  g_return_val_if_fail (catalog_search_keys != NULL, NULL);
+
+  return g_hash_table_lookup (catalog_search_keys, adaptor);
+}
+
+/* Normalizes and casefolds @text the same way as the adaptor search keys */
+gchar *
+_glade_catalog_normalize_search_key (const gchar *text)
+{
+  return catalog_search_key (text);
+}
@@ -72,6 +72,10 @@ GList        *glade_catalog_get_widget_groups       (GladeCatalog     *catalog);
 
 GList        *glade_catalog_get_adaptors            (GladeCatalog     *catalog);
 
+const GList  *glade_catalog_get_enum_types          (void);
+
+const GList  *glade_catalog_get_flags_types         (void);
+
 gboolean      glade_catalog_is_loaded               (const gchar      *name);
 
 void          glade_catalog_destroy_all             (void);
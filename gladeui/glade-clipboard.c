@@ -26,24 +26,38 @@
 
 /**
  * SECTION:glade-clipboard
- * @Short_Description: A list of #GladeWidget objects not in any #GladeProject.
+ * @Short_Description: A shelf of cut or copied #GladeWidget objects.
  *
- * The #GladeClipboard is a singleton and is an accumulative shelf
- * of all cut or copied #GladeWidget in the application. A #GladeWidget
- * can be cut from one #GladeProject and pasted to another.
+ * The #GladeClipboard is a singleton and holds the last cut or copied
+ * #GladeWidget hierarchies of the application, serialized as a GtkBuilder
+ * fragment. The fragment is only instantiated when it is pasted, with
+ * the regular read path, so a #GladeWidget can be cut from one
+ * #GladeProject and pasted to another.
+ *
+ * The fragment is also published on the system clipboard so that
+ * widgets can be copied and pasted between Glade instances.
  */
 
 #include <glib/gi18n-lib.h>
+#include <string.h>
 #include "glade.h"
 #include "glade-clipboard.h"
 #include "glade-widget.h"
 #include "glade-placeholder.h"
 #include "glade-project.h"
+#include "glade-private.h"
+
+#define GLADE_CLIPBOARD_TARGET "application/x-glade-fragment"
 
 struct _GladeClipboardPrivate
 {
-  GList     *widgets;       /* A list of GladeWidget's on the clipboard */
-  gboolean   has_selection; /* TRUE if clipboard has selection */
+  gchar        *fragment;      /* The copied widgets as a GtkBuilder fragment */
+  GList        *widgets;       /* Widgets instantiated for glade_clipboard_widgets() */
+  GladeProject *scratch;       /* The project they were instantiated for */
+  gboolean      has_selection; /* TRUE if clipboard has selection */
+
+  GtkClipboard *clipboard;     /* The system clipboard */
+  gboolean      foreign;       /* Another instance published a fragment */
 };
 
 enum
@@ -55,8 +69,25 @@ enum
 
 static GParamSpec *properties[N_PROPERTIES];
 
+static const GtkTargetEntry clipboard_targets[] = {
+  { GLADE_CLIPBOARD_TARGET, 0, 0 }
+};
+
 G_DEFINE_TYPE_WITH_PRIVATE (GladeClipboard, glade_clipboard, G_TYPE_OBJECT);
 
+static void glade_clipboard_set_has_selection (GladeClipboard *clipboard,
+                                               gboolean        has_selection);
+
+static void
+glade_clipboard_drop_widgets (GladeClipboard *clipboard)
+{
+  GladeClipboardPrivate *priv = clipboard->priv;
+
+  g_list_free_full (priv->widgets, g_object_unref);
+  priv->widgets = NULL;
+  g_clear_object (&priv->scratch);
+}
+
 static void
 glade_project_get_property (GObject    *object,
                             guint       prop_id,
@@ -76,6 +107,26 @@ glade_project_get_property (GObject    *object,
     }
 }
 
+static void
+glade_clipboard_finalize (GObject *object)
+{
+  GladeClipboard *clipboard = GLADE_CLIPBOARD (object);
+  GladeClipboardPrivate *priv = clipboard->priv;
+
+  if (priv->clipboard)
+    {
+      g_signal_handlers_disconnect_by_data (priv->clipboard, clipboard);
+
+      if (gtk_clipboard_get_owner (priv->clipboard) == object)
+        gtk_clipboard_clear (priv->clipboard);
+    }
+
+  glade_clipboard_drop_widgets (clipboard);
+  g_free (priv->fragment);
+
+  G_OBJECT_CLASS (glade_clipboard_parent_class)->finalize (object);
+}
+
 static void
 glade_clipboard_class_init (GladeClipboardClass * klass)
 {
@@ -84,6 +135,7 @@ glade_clipboard_class_init (GladeClipboardClass * klass)
   object_class = G_OBJECT_CLASS (klass);
 
   object_class->get_property = glade_project_get_property;
+  object_class->finalize = glade_clipboard_finalize;
 
   properties[PROP_HAS_SELECTION] =
     g_param_spec_boolean ("has-selection",
@@ -96,13 +148,60 @@ glade_clipboard_class_init (GladeClipboardClass * klass)
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 }
 
+static void
+glade_clipboard_targets_received (GtkClipboard   *gtk_clipboard,
+                                  GdkAtom        *targets,
+                                  gint            n_targets,
+                                  gpointer        data)
+{
+  GladeClipboard *clipboard = data;
+  GladeClipboardPrivate *priv = clipboard->priv;
+  GdkAtom target = gdk_atom_intern_static_string (GLADE_CLIPBOARD_TARGET);
+  gint i;
+
+  priv->foreign = FALSE;
+
+  /* We dont own the system clipboard anymore, check if it holds a fragment */
+  if (gtk_clipboard_get_owner (gtk_clipboard) != G_OBJECT (clipboard))
+    {
+      for (i = 0; i < n_targets; i++)
+        if (targets[i] == target)
+          priv->foreign = TRUE;
+    }
+
+  glade_clipboard_set_has_selection (clipboard, priv->foreign || priv->fragment != NULL);
+  g_object_unref (clipboard);
+}
+
+static void
+glade_clipboard_owner_change (GtkClipboard        *gtk_clipboard,
+                              GdkEventOwnerChange *event,
+                              GladeClipboard      *clipboard)
+{
+  gtk_clipboard_request_targets (gtk_clipboard,
+                                 glade_clipboard_targets_received,
+                                 g_object_ref (clipboard));
+}
+
 static void
 glade_clipboard_init (GladeClipboard *clipboard)
 {
-  clipboard->priv = glade_clipboard_get_instance_private (clipboard);
+  GladeClipboardPrivate *priv;
+
+  priv = clipboard->priv = glade_clipboard_get_instance_private (clipboard);
+
+  priv->fragment = NULL;
+  priv->widgets = NULL;
+  priv->has_selection = FALSE;
 
-  clipboard->priv->widgets = NULL;
-  clipboard->priv->has_selection = FALSE;
+  /* There is no display when running the tests */
+  if (gdk_display_get_default ())
+    {
+      priv->clipboard = gtk_clipboard_get (GDK_SELECTION_CLIPBOARD);
+
+      g_signal_connect (priv->clipboard, "owner-change",
+                        G_CALLBACK (glade_clipboard_owner_change), clipboard);
+    }
 }
 
 static void
@@ -117,6 +216,59 @@ glade_clipboard_set_has_selection (GladeClipboard *clipboard,
 
 }
 
+static void
+glade_clipboard_get_func (GtkClipboard     *gtk_clipboard,
+                          GtkSelectionData *selection_data,
+                          guint             info,
+                          gpointer          data)
+{
+  GladeClipboard *clipboard = data;
+  const gchar *fragment = clipboard->priv->fragment;
+
+  if (fragment)
+    gtk_selection_data_set (selection_data,
+                            gdk_atom_intern_static_string (GLADE_CLIPBOARD_TARGET),
+                            8, (const guchar *) fragment, strlen (fragment));
+}
+
+static void
+glade_clipboard_clear_func (GtkClipboard *gtk_clipboard,
+                            gpointer      data)
+{
+  /* We keep our own copy of the fragment */
+}
+
+/* Fetches the fragment published by another instance, if any */
+static void
+glade_clipboard_fetch_foreign (GladeClipboard *clipboard)
+{
+  GladeClipboardPrivate *priv = clipboard->priv;
+  GtkSelectionData *selection_data;
+  const guchar *data;
+  gint length;
+
+  if (!priv->foreign || !priv->clipboard)
+    return;
+
+  priv->foreign = FALSE;
+
+  selection_data =
+    gtk_clipboard_wait_for_contents (priv->clipboard,
+                                     gdk_atom_intern_static_string (GLADE_CLIPBOARD_TARGET));
+  if (!selection_data)
+    return;
+
+  if ((data = gtk_selection_data_get_data_with_length (selection_data, &length)) != NULL &&
+      length > 0)
+    {
+      glade_clipboard_drop_widgets (clipboard);
+      g_free (priv->fragment);
+      priv->fragment = g_strndup ((const gchar *) data, length);
+    }
+
+  gtk_selection_data_free (selection_data);
+}
+
 /**
  * glade_clipboard_get_has_selection:
  * @clipboard: a #GladeClipboard
@@ -131,13 +283,299 @@ glade_clipboard_get_has_selection (GladeClipboard *clipboard)
   return clipboard->priv->has_selection;
 }
 
+/* Resolves the object properties read from the fragment, references
+ * between the pasted widgets are looked up by their name in the fragment
+ * (they may be renamed when added to @project), other references are
+ * looked up in @project.
+ */
+static GObject *
+glade_clipboard_resolve_object (GHashTable   *names,
+                                GladeProject *project,
+                                const gchar  *name)
+{
+  GladeWidget *gwidget;
+
+  if ((gwidget = g_hash_table_lookup (names, name)) == NULL)
+    gwidget = glade_project_get_widget_by_name (project, name);
+
+  return gwidget ? glade_widget_get_object (gwidget) : NULL;
+}
+
+static void
+glade_clipboard_collect_names (GladeWidget *widget, GHashTable *names)
+{
+  GList *children, *l;
+
+  g_hash_table_insert (names, (gpointer) glade_widget_get_name (widget), widget);
+
+  children = glade_widget_get_children (widget);
+  for (l = children; l; l = l->next)
+    glade_clipboard_collect_names (glade_widget_get_from_gobject (l->data), names);
+  g_list_free (children);
+}
+
+static void
+glade_clipboard_fix_object_props (GHashTable *names, GladeProject *project)
+{
+  GHashTableIter iter;
+  GladeWidget *gwidget;
+  GList *l;
+
+  g_hash_table_iter_init (&iter, names);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &gwidget))
+    {
+      for (l = glade_widget_get_properties (gwidget); l; l = l->next)
+        {
+          GladeProperty *property = l->data;
+          GladePropertyClass *klass = glade_property_get_class (property);
+          GParamSpec *pspec = glade_property_class_get_pspec (klass);
+          GValue value = G_VALUE_INIT;
+          gchar *txt;
+
+          if (!glade_property_class_is_object (klass) ||
+              (txt = g_object_get_data (G_OBJECT (property), "glade-loaded-object")) == NULL)
+            continue;
+
+          g_value_init (&value, pspec->value_type);
+
+          if (GLADE_IS_PARAM_SPEC_OBJECTS (pspec))
+            {
+              GList *objects = NULL;
+              GObject *object;
+              gchar **split;
+              gint i;
+
+              split = g_strsplit (txt, GPC_OBJECT_DELIMITER, 0);
+              for (i = 0; split[i]; i++)
+                if ((object = glade_clipboard_resolve_object (names, project, split[i])) != NULL)
+                  objects = g_list_prepend (objects, object);
+              g_strfreev (split);
+
+              g_value_take_boxed (&value, g_list_reverse (objects));
+            }
+          else
+            g_value_set_object (&value, glade_clipboard_resolve_object (names, project, txt));
+
+          glade_property_set_value (property, &value);
+          g_value_unset (&value);
+
+          g_object_set_data (G_OBJECT (property), "glade-loaded-object", NULL);
+        }
+    }
+}
+
+/* Writes the packing properties of a parented @widget in a <packing> node
+ * following its <object> node, along with the class of its parent which
+ * is needed to read them back.
+ */
+static void
+glade_clipboard_write_packing (GladeWidget     *widget,
+                               GladeXmlContext *context,
+                               GladeXmlNode    *node)
+{
+  GladeWidget *parent;
+  GladeXmlNode *packing_node;
+  GList *l;
+
+  if ((parent = glade_widget_get_parent (widget)) == NULL)
+    return;
+
+  packing_node = glade_xml_node_new (context, GLADE_XML_TAG_PACKING);
+  glade_xml_node_set_property_string
+    (packing_node, GLADE_XML_TAG_CLASS,
+     glade_widget_adaptor_get_name (glade_widget_get_adaptor (parent)));
+  glade_xml_node_append_child (node, packing_node);
+
+  for (l = glade_widget_get_packing_properties (widget); l; l = l->next)
+    glade_property_write (GLADE_PROPERTY (l->data), context, packing_node);
+
+  if (!glade_xml_node_get_children (packing_node))
+    {
+      glade_xml_node_remove (packing_node);
+      glade_xml_node_delete (packing_node);
+    }
+}
+
+/**
+ * _glade_clipboard_write_fragment:
+ * @widgets: (element-type GladeWidget): the #GladeWidget hierarchies to write
+ *
+ * Serializes @widgets as a GtkBuilder fragment, the widgets must still
+ * belong to their project. The packing properties of each hierarchy are
+ * written in a <packing> node following it.
+ *
+ * Returns: (transfer full): A newly allocated fragment
+ */
+gchar *
+_glade_clipboard_write_fragment (GList *widgets)
+{
+  GladeXmlContext *context;
+  GladeXmlNode *root;
+  GladeXmlDoc *doc;
+  GList *list;
+  gchar *fragment;
+
+  doc     = glade_xml_doc_new ();
+  context = glade_xml_context_new (doc, NULL);
+  root    = glade_xml_node_new (context, GLADE_XML_TAG_PROJECT);
+  glade_xml_doc_set_root (doc, root);
+
+  for (list = widgets; list && list->data; list = list->next)
+    {
+      glade_widget_write (GLADE_WIDGET (list->data), context, root);
+      glade_clipboard_write_packing (GLADE_WIDGET (list->data), context, root);
+    }
+
+  fragment = glade_xml_dump_from_context (context);
+  glade_xml_context_destroy (context);
+
+  return fragment;
+}
+
+static void
+glade_clipboard_read_packing (GladeWidget  *widget,
+                              GladeXmlNode *node)
+{
+  GladeWidgetAdaptor *adaptor;
+  gchar *klass;
+
+  if ((klass = glade_xml_get_property_string_required (node, GLADE_XML_TAG_CLASS, NULL)) == NULL)
+    return;
+
+  if ((adaptor = glade_widget_adaptor_get_by_name (klass)) != NULL)
+    _glade_widget_read_packing (widget, adaptor, node);
+
+  g_free (klass);
+}
+
+/**
+ * _glade_clipboard_read_fragment:
+ * @fragment: A fragment created with _glade_clipboard_write_fragment()
+ * @project: the #GladeProject to create the widgets for
+ *
+ * Creates the widgets serialized in @fragment in the same way a project
+ * file is loaded, the widgets are not added to @project. The
+ * #GladeProject::parse-finished fix-ups of the new widgets are run before
+ * returning and the packing properties they had are restored, so that
+ * they can be transfered when adding the widgets.
+ *
+ * Returns: (transfer full) (element-type GladeWidget): A newly created
+ *          list of floating #GladeWidget hierarchies, in the order they
+ *          were written
+ */
+GList *
+_glade_clipboard_read_fragment (const gchar  *fragment,
+                                GladeProject *project)
+{
+  GladeXmlContext *context;
+  GladeXmlNode *root, *node;
+  GladeWidget *widget = NULL;
+  GHashTable *names;
+  GList *widgets = NULL, *l;
+
+  if ((context = glade_xml_context_new_from_buffer (fragment, -1,
+                                                    GLADE_XML_TAG_PROJECT)) == NULL)
+    return NULL;
+
+  root = glade_xml_doc_get_root (glade_xml_context_get_doc (context));
+
+  _glade_project_begin_fragment_load (project);
+
+  for (node = glade_xml_node_get_children (root);
+       node; node = glade_xml_node_next (node))
+    {
+      if (glade_xml_node_verify_silent (node, GLADE_XML_TAG_PACKING))
+        {
+          /* Packing of the widget just read */
+          if (widget)
+            glade_clipboard_read_packing (widget, node);
+          continue;
+        }
+
+      widget = NULL;
+
+      if (!(glade_xml_node_verify_silent (node, GLADE_XML_TAG_WIDGET) ||
+	    glade_xml_node_verify_silent (node, GLADE_XML_TAG_TEMPLATE)))
+        continue;
+
+      if ((widget = glade_widget_read (project, NULL, node, NULL)) != NULL)
+        widgets = g_list_prepend (widgets, widget);
+    }
+
+  glade_xml_context_free (context);
+
+  widgets = g_list_reverse (widgets);
+
+  names = g_hash_table_new (g_str_hash, g_str_equal);
+  for (l = widgets; l; l = l->next)
+    glade_clipboard_collect_names (l->data, names);
+
+  glade_clipboard_fix_object_props (names, project);
+  g_hash_table_destroy (names);
+
+  _glade_project_end_fragment_load (project);
+
+  return widgets;
+}
+
+/**
+ * glade_clipboard_instantiate:
+ * @clipboard: a #GladeClipboard
+ * @project: the #GladeProject to paste into
+ *
+ * Creates the widgets held by @clipboard for @project, this reads the
+ * clipboard fragment in the same way a project file is loaded. The
+ * widgets are not added to @project.
+ *
+ * Returns: (transfer full) (element-type GladeWidget): A newly created
+ *          list of floating #GladeWidget hierarchies, or %NULL
+ */
+GList *
+glade_clipboard_instantiate (GladeClipboard *clipboard,
+                             GladeProject   *project)
+{
+  g_return_val_if_fail (GLADE_IS_CLIPBOARD (clipboard), NULL);
+  g_return_val_if_fail (GLADE_IS_PROJECT (project), NULL);
+
+  glade_clipboard_fetch_foreign (clipboard);
+
+  if (!clipboard->priv->fragment)
+    return NULL;
+
+  return _glade_clipboard_read_fragment (clipboard->priv->fragment, project);
+}
+
+/**
+ * glade_clipboard_widgets:
+ * @clipboard: a #GladeClipboard
+ *
+ * This instantiates the clipboard contents, use
+ * glade_clipboard_instantiate() to paste into a given project.
+ *
+ * Returns: (transfer none) (element-type GladeWidget): the widgets on the clipboard
+ */
 GList *
 glade_clipboard_widgets (GladeClipboard *clipboard)
 {
+  GladeClipboardPrivate *priv;
+  GList *l;
+
   g_return_val_if_fail (GLADE_IS_CLIPBOARD (clipboard), NULL);
 
+  priv = clipboard->priv;
+
+  glade_clipboard_fetch_foreign (clipboard);
+
+  if (priv->widgets == NULL && priv->fragment)
+    {
+      priv->scratch = glade_project_new ();
+      priv->widgets = glade_clipboard_instantiate (clipboard, priv->scratch);
+
+      for (l = priv->widgets; l; l = l->next)
+        g_object_ref_sink (l->data);
+    }
 
-  return clipboard->priv->widgets;
+  return priv->widgets;
 }
 
 /**
@@ -156,28 +594,31 @@ glade_clipboard_new (void)
  * @clipboard: a #GladeClipboard
  * @widgets: a #GList of #GladeWidgets
  * 
- * Adds @widgets to @clipboard.
- * This increases the reference count of each #GladeWidget in @widgets.
+ * Serializes @widgets to @clipboard, replacing its previous contents,
+ * and publishes them on the system clipboard.
  */
 void
 glade_clipboard_add (GladeClipboard *clipboard, GList *widgets)
 {
-  GladeWidget *widget;
-  GList *list;
+  GladeClipboardPrivate *priv;
 
   g_return_if_fail (GLADE_IS_CLIPBOARD (clipboard));
 
+  priv = clipboard->priv;
+
   glade_clipboard_clear (clipboard);
 
-  /*
-   * Add the widgets to the list of children.
-   */
-  for (list = widgets; list && list->data; list = list->next)
-    {
-      widget = list->data;
-      clipboard->priv->widgets =
-          g_list_prepend (clipboard->priv->widgets, g_object_ref_sink (G_OBJECT (widget)));
-    }
+  if (widgets == NULL)
+    return;
+
+  priv->fragment = _glade_clipboard_write_fragment (widgets);
+
+  if (priv->clipboard)
+    gtk_clipboard_set_with_owner (priv->clipboard,
+                                  clipboard_targets, G_N_ELEMENTS (clipboard_targets),
+                                  glade_clipboard_get_func,
+                                  glade_clipboard_clear_func,
+                                  G_OBJECT (clipboard));
 
   glade_clipboard_set_has_selection (clipboard, TRUE);
 }
@@ -191,20 +632,17 @@ glade_clipboard_add (GladeClipboard *clipboard, GList *widgets)
 void
 glade_clipboard_clear (GladeClipboard *clipboard)
 {
-  GladeWidget *widget;
-  GList *list;
+  GladeClipboardPrivate *priv;
 
   g_return_if_fail (GLADE_IS_CLIPBOARD (clipboard));
 
-  for (list = clipboard->priv->widgets; list && list->data; list = list->next)
-    {
-      widget = list->data;
+  priv = clipboard->priv;
 
-      g_object_unref (G_OBJECT (widget));
-    }
+  glade_clipboard_drop_widgets (clipboard);
 
-  clipboard->priv->widgets = 
-    (g_list_free (clipboard->priv->widgets), NULL);
+  g_free (priv->fragment);
+  priv->fragment = NULL;
+  priv->foreign = FALSE;
 
   glade_clipboard_set_has_selection (clipboard, FALSE);
 }
@@ -40,6 +40,8 @@ void            glade_clipboard_clear            (GladeClipboard *clipboard);
 
 gboolean        glade_clipboard_get_has_selection(GladeClipboard *clipboard);
 GList          *glade_clipboard_widgets          (GladeClipboard *clipboard);
+GList          *glade_clipboard_instantiate      (GladeClipboard *clipboard,
+						  GladeProject   *project);
 
 G_END_DECLS
 
@@ -48,6 +48,7 @@
 #include "glade-signal.h"
 #include "glade-app.h"
 #include "glade-name-context.h"
+#include "glade-private.h"
 
 struct _GladeCommandPrivate
 {
@@ -79,8 +80,23 @@ typedef struct
   GList *pack_props;
   gchar *special_type;
   gulong handler_id;
+
+  /* Removed widgets which no other command refers to are dropped while
+   * the command sits on the undo stack, they are kept as a GtkBuilder
+   * fragment (along with the reffed widgets) and read back on undo.
+   */
+  gchar *fragment;
+  gboolean compactable;
 } CommandData;
 
+/* Recorded property values are kept in their serialized form
+ */
+typedef struct
+{
+  GladePropertyClass *pclass;
+  gchar *value;
+} PropData;
+
 /* Group description used for the current group
  */
 static gchar *gc_group_description = NULL;
@@ -93,6 +109,11 @@ static gint gc_group_id = 1;
  */
 static gint gc_group_depth = 0;
 
+/* Projects modified by the current group, their property verifications
+ * are deferred until the outermost group pops.
+ */
+static GList *gc_group_projects = NULL;
+
 
 G_DEFINE_TYPE_WITH_PRIVATE (GladeCommand, glade_command, G_TYPE_OBJECT)
 
@@ -320,10 +341,20 @@ glade_command_push_group (const gchar *fmt, ...)
 void
 glade_command_pop_group (void)
 {
+  GList *l;
+
   if (gc_group_depth-- == 1)
     {
       gc_group_description = (g_free (gc_group_description), NULL);
       gc_group_id++;
+
+      for (l = gc_group_projects; l; l = l->next)
+        {
+          _glade_project_pop_deferral (l->data);
+          g_object_unref (l->data);
+        }
+      g_list_free (gc_group_projects);
+      gc_group_projects = NULL;
     }
 
   if (gc_group_depth < 0)
@@ -345,6 +376,14 @@ glade_command_check_group (GladeCommand *cmd)
       cmd->priv->description =
           (g_free (cmd->priv->description), g_strdup (gc_group_description));
       cmd->priv->group_id = gc_group_id;
+
+      if (cmd->priv->project &&
+          g_list_find (gc_group_projects, cmd->priv->project) == NULL)
+        {
+          _glade_project_push_deferral (cmd->priv->project);
+          gc_group_projects = g_list_prepend (gc_group_projects,
+                                              g_object_ref (cmd->priv->project));
+        }
     }
 }
 
@@ -572,6 +611,10 @@ glade_command_set_property_execute (GladeCommand *cmd)
   if (me->set_once != FALSE)
     glade_property_push_superuser ();
 
+  /* Rebuild widgets once for all the construct only properties */
+  if (cmd->priv->project)
+    _glade_project_push_deferral (cmd->priv->project);
+
   for (l = me->sdata; l; l = l->next)
     {
       GValue              new_value = { 0, };
@@ -627,12 +670,15 @@ glade_command_set_property_execute (GladeCommand *cmd)
            * the first go.. we need to record the actual
            * properties here. XXX should be able to use glade_property_get_value() here
            */
-          g_value_copy (glade_property_inline_value (sdata->property), sdata->new_value);
+          g_value_copy (_glade_property_peek_value (sdata->property), sdata->new_value);
         }
 
       g_value_unset (&new_value);
     }
 
+  if (cmd->priv->project)
+    _glade_project_pop_deferral (cmd->priv->project);
+
   if (me->set_once != FALSE)
     glade_property_pop_superuser ();
 
@@ -942,7 +988,7 @@ glade_command_set_property_value (GladeProperty *property, const GValue *pvalue)
   if (glade_property_equals_value (property, pvalue))
     return;
 
-  glade_command_set_properties (property, glade_property_inline_value (property), pvalue, NULL);
+  glade_command_set_properties (property, _glade_property_peek_value (property), pvalue, NULL);
 }
 
 void
@@ -1022,6 +1068,7 @@ glade_command_set_name_finalize (GObject *obj)
 
   me = GLADE_COMMAND_SET_NAME (obj);
 
+  g_object_unref (me->widget);
   g_free (me->old_name);
   g_free (me->name);
 
@@ -1095,7 +1142,7 @@ glade_command_set_name (GladeWidget *widget, const gchar *name)
   cmd = GLADE_COMMAND (me);
   cmd->priv->project = glade_widget_get_project (widget);
 
-  me->widget = widget;
+  me->widget = g_object_ref (widget);
   me->name = g_strdup (name);
   me->old_name = g_strdup (glade_widget_get_name (widget));
 
@@ -1124,6 +1171,7 @@ typedef struct
   GList *widgets;
   gboolean add;
   gboolean from_clipboard;
+  guint compact_id;
 } GladeCommandAddRemove;
 
 
@@ -1187,6 +1235,325 @@ get_all_parentless_reffed_widgets (GList *reffed, GladeWidget *widget)
   return reffed;
 }
 
+static GList *
+glade_command_encode_props (GList *properties)
+{
+  GList *l, *encoded = NULL;
+
+  for (l = properties; l; l = l->next)
+    {
+      GladeProperty *property = l->data;
+      PropData *pdata = g_slice_new (PropData);
+
+      pdata->pclass = glade_property_get_class (property);
+      pdata->value =
+	glade_widget_adaptor_string_from_value (glade_property_class_get_adaptor (pdata->pclass),
+						pdata->pclass,
+						_glade_property_peek_value (property));
+      encoded = g_list_prepend (encoded, pdata);
+    }
+
+  return encoded;
+}
+
+static void
+prop_data_free (PropData *pdata)
+{
+  g_free (pdata->value);
+  g_slice_free (PropData, pdata);
+}
+
+/* Applies the packing properties encoded by glade_command_encode_props(),
+ * when @transfer is set only the properties which are transfered on paste
+ * are applied.
+ */
+static void
+glade_command_apply_props (GladeWidget  *widget,
+			   GList        *encoded,
+			   GladeProject *project,
+			   gboolean      transfer)
+{
+  GList *l;
+
+  for (l = encoded; l; l = l->next)
+    {
+      PropData *pdata = l->data;
+      GladePropertyClass *pclass;
+      GladeProperty *prop;
+      GValue *value;
+
+      prop = glade_widget_get_pack_property (widget, glade_property_class_id (pdata->pclass));
+      if (prop == NULL)
+	continue;
+
+      pclass = glade_property_get_class (prop);
+
+      if (transfer &&
+	  !(glade_property_class_transfer_on_paste (pdata->pclass) &&
+	    glade_property_class_match (pclass, pdata->pclass)))
+	continue;
+
+      value = glade_property_class_make_gvalue_from_string (pclass, pdata->value, project);
+      glade_property_set_value (prop, value);
+      g_value_unset (value);
+      g_free (value);
+
+      if (!transfer)
+	glade_property_sync (prop);
+    }
+}
+
+static gboolean
+glade_command_data_contains (CommandData *cdata, GladeWidget *widget)
+{
+  GList *l;
+
+  if (widget == cdata->widget || glade_widget_is_ancestor (widget, cdata->widget))
+    return TRUE;
+
+  for (l = cdata->reffed; l; l = l->next)
+    if (widget == l->data || glade_widget_is_ancestor (widget, l->data))
+      return TRUE;
+
+  return FALSE;
+}
+
+/* Whether properties outside of the removed widgets refer to @widget */
+static gboolean
+glade_command_data_has_prop_refs (CommandData *cdata, GladeWidget *widget)
+{
+  GList *l;
+
+  for (l = _glade_widget_peek_prop_refs (widget); l; l = l->next)
+    {
+      GladeWidget *referrer = glade_property_get_widget (l->data);
+
+      if (referrer == NULL || !glade_command_data_contains (cdata, referrer))
+	return TRUE;
+    }
+
+  return FALSE;
+}
+
+/* Whether @widget (and its hierarchy) is only referred to by the command
+ * which removed it. Other commands hold a reference to the widgets, properties
+ * or signals they operate on, so this tells us if it is safe to replace the
+ * widget with a new instance on undo.
+ */
+static gboolean
+glade_command_widget_is_private (CommandData *cdata,
+				 GladeWidget *widget,
+				 gboolean     check_ref_count)
+{
+  GList *children, *list, *l;
+  gboolean retval = TRUE;
+
+  if ((check_ref_count && G_OBJECT (widget)->ref_count != 1) ||
+      glade_command_data_has_prop_refs (cdata, widget))
+    return FALSE;
+
+  for (l = glade_widget_get_properties (widget); l; l = l->next)
+    if (G_OBJECT (l->data)->ref_count != 1)
+      return FALSE;
+
+  for (l = glade_widget_get_packing_properties (widget); l; l = l->next)
+    if (G_OBJECT (l->data)->ref_count != 1)
+      return FALSE;
+
+  list = glade_widget_get_signal_list (widget);
+  for (l = list; l && retval; l = l->next)
+    retval = (G_OBJECT (l->data)->ref_count == 1);
+  g_list_free (list);
+
+  children = glade_widget_get_children (widget);
+  for (l = children; l && retval; l = l->next)
+    {
+      GladeWidget *child = glade_widget_get_from_gobject (l->data);
+
+      /* Internal children are not owned by their parent GladeWidget */
+      if (child)
+	retval = glade_command_widget_is_private (cdata, child,
+						  glade_widget_get_internal (child) == NULL);
+    }
+  g_list_free (children);
+
+  return retval;
+}
+
+static void
+glade_command_collect_objects (GladeWidget *widget, GHashTable *objects)
+{
+  GList *children, *l;
+
+  g_hash_table_add (objects, glade_widget_get_object (widget));
+
+  children = glade_widget_get_children (widget);
+  for (l = children; l; l = l->next)
+    {
+      GladeWidget *child = glade_widget_get_from_gobject (l->data);
+
+      if (child)
+	glade_command_collect_objects (child, objects);
+    }
+  g_list_free (children);
+}
+
+static gboolean
+glade_command_value_refers (const GValue *value, GHashTable *objects)
+{
+  GList *l;
+
+  if (value == NULL || G_VALUE_TYPE (value) == 0)
+    return FALSE;
+
+  if (G_VALUE_HOLDS_OBJECT (value))
+    return g_hash_table_contains (objects, g_value_get_object (value));
+
+  if (G_VALUE_HOLDS (value, GLADE_TYPE_GLIST))
+    {
+      for (l = g_value_get_boxed (value); l; l = l->next)
+	if (g_hash_table_contains (objects, l->data))
+	  return TRUE;
+    }
+
+  return FALSE;
+}
+
+/* Property commands record the runtime objects they assign, check
+ * that no command in the history would restore one of @objects.
+ */
+static gboolean
+glade_command_history_refers (GladeProject *project, GHashTable *objects)
+{
+  GList *list, *l;
+
+  for (list = _glade_project_peek_undo_stack (project); list; list = list->next)
+    {
+      if (!GLADE_IS_COMMAND_SET_PROPERTY (list->data))
+	continue;
+
+      for (l = GLADE_COMMAND_SET_PROPERTY (list->data)->sdata; l; l = l->next)
+	{
+	  GCSetPropData *sdata = l->data;
+
+	  if (glade_command_value_refers (sdata->old_value, objects) ||
+	      glade_command_value_refers (sdata->new_value, objects))
+	    return TRUE;
+	}
+    }
+
+  return FALSE;
+}
+
+/* Whether anything outside of the removed widgets refers to @widget
+ * or its hierarchy */
+static gboolean
+glade_command_data_has_refs (CommandData *cdata, GladeWidget *widget)
+{
+  GList *children, *l;
+  gboolean retval;
+
+  retval = glade_command_data_has_prop_refs (cdata, widget);
+
+  children = glade_widget_get_children (widget);
+  for (l = children; l && !retval; l = l->next)
+    {
+      GladeWidget *child = glade_widget_get_from_gobject (l->data);
+
+      if (child)
+	retval = glade_command_data_has_refs (cdata, child);
+    }
+  g_list_free (children);
+
+  return retval;
+}
+
+static gchar *
+glade_command_data_write (CommandData *cdata)
+{
+  GList *widgets;
+  gchar *fragment;
+
+  widgets = g_list_prepend (g_list_copy (cdata->reffed), cdata->widget);
+  fragment = _glade_clipboard_write_fragment (widgets);
+  g_list_free (widgets);
+
+  return fragment;
+}
+
+static void
+glade_command_data_read (CommandData *cdata, GladeProject *project)
+{
+  GList *widgets, *l;
+
+  if ((widgets = _glade_clipboard_read_fragment (cdata->fragment, project)) == NULL)
+    {
+      g_critical ("Unable to restore removed widgets");
+      return;
+    }
+
+  cdata->widget = g_object_ref_sink (widgets->data);
+
+  for (l = widgets->next; l; l = l->next)
+    cdata->reffed = g_list_append (cdata->reffed, g_object_ref_sink (l->data));
+
+  g_list_free (widgets);
+}
+
+static gboolean
+glade_command_add_remove_compact (GladeCommandAddRemove *me)
+{
+  CommandData *cdata;
+  GHashTable *objects;
+  GList *list, *l;
+  gboolean private;
+
+  me->compact_id = 0;
+
+  /* The widgets were added back meanwhile */
+  if (!me->add)
+    return G_SOURCE_REMOVE;
+
+  for (list = me->widgets; list && list->data; list = list->next)
+    {
+      cdata = list->data;
+
+      if (cdata->widget == NULL || cdata->fragment == NULL)
+	continue;
+
+      private = glade_command_widget_is_private (cdata, cdata->widget, TRUE);
+      for (l = cdata->reffed; l && private; l = l->next)
+	private = glade_command_widget_is_private (cdata, l->data, TRUE);
+
+      if (private)
+	{
+	  objects = g_hash_table_new (NULL, NULL);
+
+	  glade_command_collect_objects (cdata->widget, objects);
+	  for (l = cdata->reffed; l; l = l->next)
+	    glade_command_collect_objects (l->data, objects);
+
+	  private = !glade_command_history_refers (GLADE_COMMAND (me)->priv->project, objects);
+	  g_hash_table_destroy (objects);
+	}
+
+      if (!private)
+	continue;
+
+      GLADE_NOTE (COMMANDS,
+		  g_print ("Compacting removed widget '%s'\n",
+			   glade_widget_get_name (cdata->widget)));
+
+      g_list_free_full (cdata->reffed, g_object_unref);
+      cdata->reffed = NULL;
+
+      g_object_unref (cdata->widget);
+      cdata->widget = NULL;
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
 /**
  * glade_command_add:
  * @widgets (element-type GladeWidget): a #Glist
@@ -1265,6 +1632,9 @@ glade_command_add (GList            *widgets,
       else
 	cdata->parent = parent;
 
+      if (cdata->parent)
+	g_object_ref (cdata->parent);
+
       /* Placeholder */
       if (placeholder != NULL && g_list_length (widgets) == 1)
         {
@@ -1418,10 +1788,20 @@ glade_command_remove (GList *widgets)
       cdata->widget = g_object_ref (G_OBJECT (widget));
       cdata->parent = glade_widget_get_parent (widget);
 
+      if (cdata->parent)
+	g_object_ref (cdata->parent);
+
       if ((cdata->reffed =
            get_all_parentless_reffed_widgets (cdata->reffed, widget)) != NULL)
         g_list_foreach (cdata->reffed, (GFunc) g_object_ref, NULL);
 
+      /* The commands unsetting the references below would hold on
+       * to the runtime object, so it can not be replaced on undo.
+       */
+      cdata->compactable = !glade_command_data_has_refs (cdata, widget);
+      for (l = cdata->reffed; l && cdata->compactable; l = l->next)
+	cdata->compactable = !glade_command_data_has_refs (cdata, l->data);
+
       /* If we're removing the template widget, then we need to unset it as template */
       if (glade_project_get_template (GLADE_COMMAND (me)->priv->project) == widget)
 	glade_command_set_project_template (GLADE_COMMAND (me)->priv->project, NULL);
@@ -1443,13 +1823,8 @@ glade_command_remove (GList *widgets)
 
       /* Record packing props if not deleted from the clipboard */
       if (me->from_clipboard == FALSE)
-	{
-	  for (l = glade_widget_get_packing_properties (widget); l; l = l->next)
-	    cdata->pack_props =
-	      g_list_prepend (cdata->pack_props,
-			      glade_property_dup (GLADE_PROPERTY (l->data),
-						  cdata->widget));
-	}
+	cdata->pack_props =
+	  glade_command_encode_props (glade_widget_get_packing_properties (widget));
     }
 
   g_assert (widget);
@@ -1465,40 +1840,32 @@ glade_command_remove (GList *widgets)
   glade_command_pop_group ();
 }                               /* end of glade_command_remove() */
 
-static void
-glade_command_transfer_props (GladeWidget *gnew, GList *saved_props)
-{
-  GList *l;
-
-  for (l = saved_props; l; l = l->next)
-    {
-      GladeProperty *prop, *sprop = l->data;
-      GladePropertyClass *pclass = glade_property_get_class (sprop);
-
-      prop = glade_widget_get_pack_property (gnew, glade_property_class_id (pclass));
-
-      if (prop && glade_property_class_transfer_on_paste (pclass) &&
-          glade_property_class_match (glade_property_get_class (prop), pclass))
-        glade_property_set_value (prop, glade_property_inline_value (sprop));
-    }
-}
-
 static gboolean
 glade_command_add_execute (GladeCommandAddRemove *me)
 {
+  GladeProject *project = GLADE_COMMAND (me)->priv->project;
   CommandData *cdata;
   GList *list, *l, *saved_props;
   gchar *special_child_type;
 
   if (me->widgets)
     {
-      glade_project_selection_clear (GLADE_COMMAND (me)->priv->project, FALSE);
+      glade_project_selection_clear (project, FALSE);
 
       for (list = me->widgets; list && list->data; list = list->next)
         {
           cdata = list->data;
           saved_props = NULL;
 
+          /* Undoing a remove, read back the compacted widgets */
+          if (cdata->widget == NULL)
+            {
+              glade_command_data_read (cdata, project);
+
+              if (cdata->widget == NULL)
+                continue;
+            }
+
 	  GLADE_NOTE (COMMANDS,
 		      g_print ("Adding widget '%s' to parent '%s' "
 			       "(from clipboard: %s, props recorded: %s, have placeholder: %s, child_type: %s)\n",
@@ -1518,9 +1885,7 @@ glade_command_add_execute (GladeCommandAddRemove *me)
                    * otherwise prioritize packing defaults. 
                    */
                   saved_props =
-                      glade_widget_dup_properties (cdata->widget,
-                                                   glade_widget_get_packing_properties (cdata->widget), 
-						   FALSE, FALSE, FALSE);
+                      glade_command_encode_props (glade_widget_get_packing_properties (cdata->widget));
 
                   glade_widget_set_packing_properties (cdata->widget, cdata->parent);
                 }
@@ -1548,28 +1913,11 @@ glade_command_add_execute (GladeCommandAddRemove *me)
 					cdata->widget,
 					cdata->props_recorded == FALSE);
 
-              glade_command_transfer_props (cdata->widget, saved_props);
-
-              if (saved_props)
-                {
-                  g_list_foreach (saved_props, (GFunc) g_object_unref, NULL);
-                  g_list_free (saved_props);
-                }
+              glade_command_apply_props (cdata->widget, saved_props, project, TRUE);
+              g_list_free_full (saved_props, (GDestroyNotify) prop_data_free);
 
               /* Now that we've added, apply any packing props if nescisary. */
-              for (l = cdata->pack_props; l; l = l->next)
-                {
-                  GValue              value = { 0, };
-                  GladeProperty      *saved_prop = l->data;
-		  GladePropertyClass *pclass = glade_property_get_class (saved_prop);
-                  GladeProperty      *widget_prop =
-		    glade_widget_get_pack_property (cdata->widget, glade_property_class_id (pclass));
-
-                  glade_property_get_value (saved_prop, &value);
-                  glade_property_set_value (widget_prop, &value);
-		  glade_property_sync (widget_prop);
-                  g_value_unset (&value);
-                }
+              glade_command_apply_props (cdata->widget, cdata->pack_props, project, FALSE);
 
               if (cdata->props_recorded == FALSE)
                 {
@@ -1581,11 +1929,8 @@ glade_command_add_execute (GladeCommandAddRemove *me)
                    * Otherwise this recorded marker was set when cutting
                    */
                   g_assert (cdata->pack_props == NULL);
-                  for (l = glade_widget_get_packing_properties (cdata->widget); l; l = l->next)
-                    cdata->pack_props = 
-		      g_list_prepend (cdata->pack_props,
-				      glade_property_dup (GLADE_PROPERTY (l->data), 
-							  cdata->widget));
+                  cdata->pack_props =
+                    glade_command_encode_props (glade_widget_get_packing_properties (cdata->widget));
 
                   /* Record the special-type here after replacing */
                   if ((special_child_type =
@@ -1673,6 +2018,12 @@ glade_command_remove_execute (GladeCommandAddRemove *me)
 	  cdata->props_recorded = TRUE;
 	}
 
+      /* Serialize while the widgets still belong to the project, the
+       * fragment does not change when redoing so it is only written once.
+       */
+      if (cdata->compactable && cdata->fragment == NULL)
+	cdata->fragment = glade_command_data_write (cdata);
+
       glade_project_remove_object (GLADE_COMMAND (me)->priv->project,
                                    glade_widget_get_object (cdata->widget));
 
@@ -1691,6 +2042,13 @@ glade_command_remove_execute (GladeCommandAddRemove *me)
           else
             glade_widget_remove_child (cdata->parent, cdata->widget);
         }
+
+      /* Leave the editors some time to release the widgets */
+      if (cdata->fragment && me->compact_id == 0)
+	me->compact_id =
+	  g_idle_add_full (G_PRIORITY_LOW,
+			   (GSourceFunc) glade_command_add_remove_compact,
+			   me, NULL);
     }
 
   return TRUE;
@@ -1733,6 +2091,9 @@ glade_command_add_remove_finalize (GObject *obj)
 
   cmd = GLADE_COMMAND_ADD_REMOVE (obj);
 
+  if (cmd->compact_id)
+    g_source_remove (cmd->compact_id);
+
   for (list = cmd->widgets; list && list->data; list = list->next)
     {
       cdata = list->data;
@@ -1748,8 +2109,16 @@ glade_command_add_remove_finalize (GObject *obj)
       if (cdata->widget)
         g_object_unref (G_OBJECT (cdata->widget));
 
+      if (cdata->parent)
+        g_object_unref (G_OBJECT (cdata->parent));
+
       g_list_foreach (cdata->reffed, (GFunc) g_object_unref, NULL);
       g_list_free (cdata->reffed);
+
+      g_list_free_full (cdata->pack_props, (GDestroyNotify) prop_data_free);
+      g_free (cdata->special_type);
+      g_free (cdata->fragment);
+      g_free (cdata);
     }
   g_list_free (cmd->widgets);
 
@@ -1869,14 +2238,15 @@ glade_command_cut (GList *widgets)
     g_object_set_data (G_OBJECT (l->data), "glade-command-was-cut",
                        GINT_TO_POINTER (TRUE));
 
+  /* Serialize the widgets while they are still in the project */
+  glade_clipboard_add (glade_app_get_clipboard (), widgets);
+
   widget = widgets->data;
   glade_command_push_group (_("Cut %s"),
                             g_list_length (widgets) == 1 ? 
 			    glade_widget_get_name (widget) : _("multiple"));
   glade_command_remove (widgets);
   glade_command_pop_group ();
-
-  glade_clipboard_add (glade_app_get_clipboard (), widgets);
 }
 
 #if 0
@@ -2273,6 +2643,7 @@ glade_command_set_i18n_finalize (GObject *obj)
   g_return_if_fail (GLADE_IS_COMMAND_SET_I18N (obj));
 
   me = GLADE_COMMAND_SET_I18N (obj);
+  g_object_unref (me->property);
   g_free (me->context);
   g_free (me->comment);
   g_free (me->old_context);
@@ -2349,7 +2720,7 @@ glade_command_set_i18n (GladeProperty *property,
 
   /* load up the command */
   me = g_object_new (GLADE_COMMAND_SET_I18N_TYPE, NULL);
-  me->property = property;
+  me->property = g_object_ref (property);
   me->translatable = translatable;
   me->context = g_strdup (context);
   me->comment = g_strdup (comment);
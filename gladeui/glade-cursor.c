@@ -59,19 +59,21 @@ static void
 set_cursor (GladeProject *project,
 	    GdkCursor    *gdk_cursor)
 {
-  GList *list;
+  GList *widgets, *list;
 
-  for (list = (GList *) glade_project_get_objects (project);
-       list; list = list->next)
+  widgets = glade_project_list_objects_by_type (project, GTK_TYPE_WIDGET);
+
+  for (list = widgets; list; list = list->next)
     {
       GObject *object = list->data;
 
-      if (GTK_IS_WIDGET (object) &&
-	  gtk_widget_get_has_window (GTK_WIDGET (object)))
+      if (gtk_widget_get_has_window (GTK_WIDGET (object)))
 	{
 	  set_cursor_recurse (GTK_WIDGET (object), gdk_cursor);
 	}
     }
+
+  g_list_free (widgets);
 }
 
 /**
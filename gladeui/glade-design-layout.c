@@ -42,6 +42,9 @@
 
 #define MARGIN_STEP       6
 
+/* Size reserved for a dormant child that was never measured */
+#define DORMANT_SIZE      200
+
 typedef enum
 {
   ACTIVITY_NONE,
@@ -109,6 +112,13 @@ struct _GladeDesignLayoutPrivate
   gint drag_x, drag_y;
   GladeWidget *drag_dest;
 
+  /* Virtualization, a dormant layout keeps its child unmapped and
+   * reports the size it had when it was last measured, or a
+   * placeholder size if it was never awake.
+   */
+  gboolean dormant;
+  gint cached_width, cached_height;
+
   /* Properties */
   GladeDesignView *view;
   GladeProject *project;
@@ -319,6 +329,16 @@ gdl_update_max_margins (GladeDesignLayout *layout,
     priv->max_height += parent_h - layout_h - (PADDING - OUTLINE_WIDTH);
 }
 
+/* Drops the size measured while awake, it is stale from now on */
+static void
+gdl_queue_resize (GladeDesignLayout *layout)
+{
+  layout->priv->cached_width = -1;
+  layout->priv->cached_height = -1;
+
+  gtk_widget_queue_resize (GTK_WIDGET (layout));
+}
+
 static void
 glade_design_layout_update_child (GladeDesignLayout *layout,
                                   GtkWidget         *child,
@@ -781,6 +801,12 @@ glade_design_layout_get_preferred_height (GtkWidget *widget,
 
   priv = GLADE_DESIGN_LAYOUT_PRIVATE (widget);
 
+  if (priv->dormant && priv->cached_height >= 0)
+    {
+      *minimum = *natural = priv->cached_height;
+      return;
+    }
+
   *minimum = 0;
 
   child = gtk_bin_get_child (GTK_BIN (widget));
@@ -793,11 +819,16 @@ glade_design_layout_get_preferred_height (GtkWidget *widget,
       gchild = glade_widget_get_from_gobject (child);
       g_assert (gchild);
 
-      gtk_widget_get_preferred_size (child, &req, NULL);
-
       g_object_get (gchild, "toplevel-height", &child_height, NULL);
 
-      child_height = MAX (child_height, req.height);
+      /* Do not measure the child of a layout that never woke up */
+      if (priv->dormant)
+        child_height = child_height > 0 ? child_height : DORMANT_SIZE;
+      else
+        {
+          gtk_widget_get_preferred_size (child, &req, NULL);
+          child_height = MAX (child_height, req.height);
+        }
 
       if (priv->widget_name)
         pango_layout_get_pixel_size (priv->widget_name, NULL, &height);
@@ -810,17 +841,29 @@ glade_design_layout_get_preferred_height (GtkWidget *widget,
   border_width = gtk_container_get_border_width (GTK_CONTAINER (widget));
   *minimum += border_width * 2;
   *natural = *minimum;
+
+  if (!priv->dormant)
+    priv->cached_height = *minimum;
 }
 
 static void
 glade_design_layout_get_preferred_width (GtkWidget *widget,
                                          gint *minimum, gint *natural)
 {
+  GladeDesignLayoutPrivate *priv;
   GtkWidget *child;
   GladeWidget *gchild;
   gint child_width = 0;
   guint border_width = 0;
 
+  priv = GLADE_DESIGN_LAYOUT_PRIVATE (widget);
+
+  if (priv->dormant && priv->cached_width >= 0)
+    {
+      *minimum = *natural = priv->cached_width;
+      return;
+    }
+
   *minimum = 0;
 
   child = gtk_bin_get_child (GTK_BIN (widget));
@@ -832,11 +875,15 @@ glade_design_layout_get_preferred_width (GtkWidget *widget,
       gchild = glade_widget_get_from_gobject (child);
       g_assert (gchild);
 
-      gtk_widget_get_preferred_size (child, &req, NULL);
-
       g_object_get (gchild, "toplevel-width", &child_width, NULL);
 
-      child_width = MAX (child_width, req.width);
+      if (priv->dormant)
+        child_width = child_width > 0 ? child_width : DORMANT_SIZE;
+      else
+        {
+          gtk_widget_get_preferred_size (child, &req, NULL);
+          child_width = MAX (child_width, req.width);
+        }
 
       *minimum = MAX (*minimum, 2*PADDING + 2*OUTLINE_WIDTH + child_width);
     }
@@ -844,6 +891,9 @@ glade_design_layout_get_preferred_width (GtkWidget *widget,
   border_width = gtk_container_get_border_width (GTK_CONTAINER (widget));
   *minimum += border_width * 2;
   *natural = *minimum;
+
+  if (!priv->dormant)
+    priv->cached_width = *minimum;
 }
 
 static void
@@ -914,7 +964,8 @@ glade_design_layout_size_allocate (GtkWidget *widget,
 
   child = gtk_bin_get_child (GTK_BIN (widget));
 
-  if (child && gtk_widget_get_visible (child))
+  if (child && gtk_widget_get_visible (child) &&
+      !GLADE_DESIGN_LAYOUT_PRIVATE (widget)->dormant)
     {
       GladeDesignLayoutPrivate *priv = GLADE_DESIGN_LAYOUT_PRIVATE (widget);
       GtkAllocation alloc;
@@ -958,7 +1009,7 @@ update_widget_name (GladeDesignLayout *layout, GladeWidget *gwidget)
           pango_layout_set_text (priv->widget_name, glade_widget_adaptor_get_name (adaptor), -1);
         }
 
-      gtk_widget_queue_resize (GTK_WIDGET (layout));
+      gdl_queue_resize (layout);
     }
 }
 
@@ -968,6 +1019,14 @@ on_glade_widget_name_notify (GObject *gobject, GParamSpec *pspec, GladeDesignLay
   update_widget_name (layout, GLADE_WIDGET (gobject));
 }
 
+static void
+on_glade_widget_size_notify (GObject *gobject, GParamSpec *pspec, GladeDesignLayout *layout)
+{
+  /* The saved size changed behind a dormant layout, e.g. on undo */
+  if (layout->priv->dormant)
+    gdl_queue_resize (layout);
+}
+
 static void
 glade_design_layout_add (GtkContainer *container, GtkWidget *widget)
 {
@@ -981,6 +1040,7 @@ glade_design_layout_add (GtkContainer *container, GtkWidget *widget)
 
   GTK_CONTAINER_CLASS (glade_design_layout_parent_class)->add (container,
                                                                widget);
+  gtk_widget_set_child_visible (widget, !priv->dormant);
 
   if (!priv->gchild &&
       (priv->gchild = glade_widget_get_from_gobject (G_OBJECT (widget))))
@@ -989,8 +1049,15 @@ glade_design_layout_add (GtkContainer *container, GtkWidget *widget)
       g_signal_connect (priv->gchild, "notify::name",
                         G_CALLBACK (on_glade_widget_name_notify),
                         layout);
+      g_signal_connect (priv->gchild, "notify::toplevel-width",
+                        G_CALLBACK (on_glade_widget_size_notify),
+                        layout);
+      g_signal_connect (priv->gchild, "notify::toplevel-height",
+                        G_CALLBACK (on_glade_widget_size_notify),
+                        layout);
     }
-    
+
+  gdl_queue_resize (layout);
   gtk_widget_queue_draw (GTK_WIDGET (container)); 
 }
 
@@ -1005,11 +1072,14 @@ glade_design_layout_remove (GtkContainer *container, GtkWidget *widget)
       
       g_signal_handlers_disconnect_by_func (gchild, on_glade_widget_name_notify,
                                             GLADE_DESIGN_LAYOUT (container));
+      g_signal_handlers_disconnect_by_func (gchild, on_glade_widget_size_notify,
+                                            GLADE_DESIGN_LAYOUT (container));
       if (gchild == priv->gchild)
         priv->gchild = NULL;
     }
 
   GTK_CONTAINER_CLASS (glade_design_layout_parent_class)->remove (container, widget);
+  gdl_queue_resize (GLADE_DESIGN_LAYOUT (container));
   gtk_widget_queue_draw (GTK_WIDGET (container));
 }
 
@@ -1801,6 +1871,8 @@ glade_design_layout_init (GladeDesignLayout *layout)
   priv->new_width = -1;
   priv->new_height = -1;
   priv->node_over = 0;
+  priv->cached_width = -1;
+  priv->cached_height = -1;
 
   priv->default_context = gtk_style_context_new ();
   gtk_widget_path_append_type (path, GTK_TYPE_WINDOW);
@@ -2237,6 +2309,37 @@ _glade_design_layout_set_highlight (GladeDesignLayout *layout,
   gtk_widget_queue_draw (GTK_WIDGET (layout));
 }
 
+/*
+ * _glade_design_layout_set_dormant:
+ * @layout: A #GladeDesignLayout
+ * @dormant: whether the layout is out of sight
+ *
+ * Dormant layouts do not map, allocate nor measure their child, they
+ * keep the size they had when last measured so that the view does not
+ * move, or the saved toplevel size if they were never awake.
+ */
+void
+_glade_design_layout_set_dormant (GladeDesignLayout *layout,
+                                  gboolean           dormant)
+{
+  GladeDesignLayoutPrivate *priv = layout->priv;
+  GtkWidget *child;
+
+  dormant = dormant != FALSE;
+
+  if (priv->dormant == dormant)
+    return;
+
+  priv->dormant = dormant;
+
+  if ((child = gtk_bin_get_child (GTK_BIN (layout))))
+    gtk_widget_set_child_visible (child, !dormant);
+
+  /* Measure and allocate the child again */
+  if (!dormant)
+    gdl_queue_resize (layout);
+}
+
 typedef struct
 {
   GtkWidget *toplevel;
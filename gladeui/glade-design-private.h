@@ -63,6 +63,9 @@ GtkWidget   *_glade_design_layout_get_child_at_position (GtkWidget *widget,
 void         _glade_design_layout_set_highlight (GladeDesignLayout *layout,
                                                  GladeWidget       *drag);
 
+void         _glade_design_layout_set_dormant (GladeDesignLayout *layout,
+                                               gboolean           dormant);
+
 G_END_DECLS
 
 #endif /* __GLADE_DESIGN_PRIVATE_H__ */
@@ -35,6 +35,7 @@
 #include "config.h"
 
 #include "glade.h"
+#include "glade-private.h"
 #include "glade-dnd.h"
 #include "glade-utils.h"
 #include "glade-design-view.h"
@@ -59,12 +60,24 @@ struct _GladeDesignViewPrivate
   GladeProject *project;
   GtkWidget *scrolled_window;  /* Main scrolled window */
   GtkWidget *layout_box;       /* Box to pack a GladeDesignLayout for each toplevel in project */
+  GArray *layouts;             /* ViewLayout, in the same order as layout_box children */
+  GHashTable *awake;           /* Layouts near the viewport, the others are dormant */
+  guint viewport_id;           /* Idle to update the awake layouts */
 
   _GladeDrag *drag_target;
   GObject *drag_data;
   gboolean drag_highlight;
 };
 
+typedef struct
+{
+  GtkWidget *layout;
+  guint      order;            /* The toplevel order in the project */
+} ViewLayout;
+
+/* Layouts within this many pages of the viewport are kept awake */
+#define VIEWPORT_MARGIN_PAGES 1
+
 static GtkVBoxClass *parent_class = NULL;
 
 static void glade_design_view_drag_init (_GladeDragInterface *iface);
@@ -141,12 +154,132 @@ glade_design_view_selection_changed (GladeProject *project, GladeDesignView *vie
     }
 }
 
+#define VIEW_LAYOUT(view,i) (&g_array_index ((view)->priv->layouts, ViewLayout, (i)))
+
+/* Returns the position of the first layout ordered after @order */
+static guint
+glade_design_view_layout_position (GladeDesignView *view, guint order)
+{
+  GArray *layouts = view->priv->layouts;
+  guint lo = 0, hi = layouts->len, mid;
+
+  /* Toplevels are mostly added in order */
+  if (hi == 0 || VIEW_LAYOUT (view, hi - 1)->order <= order)
+    return hi;
+
+  while (lo < hi)
+    {
+      mid = lo + (hi - lo) / 2;
+
+      if (VIEW_LAYOUT (view, mid)->order <= order)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/* Returns the first layout whose bottom edge is below @y */
+static guint
+glade_design_view_layout_at_y (GladeDesignView *view, gint y)
+{
+  guint lo = 0, hi = view->priv->layouts->len, mid;
+
+  while (lo < hi)
+    {
+      GtkAllocation alloc;
+
+      mid = lo + (hi - lo) / 2;
+      gtk_widget_get_allocation (VIEW_LAYOUT (view, mid)->layout, &alloc);
+
+      if (alloc.y + alloc.height < y)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+static gboolean
+glade_design_view_update_viewport (GladeDesignView *view)
+{
+  GladeDesignViewPrivate *priv = view->priv;
+  GHashTableIter iter;
+  GtkAdjustment *vadj;
+  gpointer layout;
+  gdouble top, bottom, page;
+  guint i;
+
+  priv->viewport_id = 0;
+
+  vadj = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (priv->scrolled_window));
+  page = gtk_adjustment_get_page_size (vadj);
+
+  if (page <= 0)
+    return G_SOURCE_REMOVE;
+
+  top    = gtk_adjustment_get_value (vadj) - page * VIEWPORT_MARGIN_PAGES;
+  bottom = gtk_adjustment_get_value (vadj) + page * (VIEWPORT_MARGIN_PAGES + 1);
+
+  /* Put to sleep the layouts that left the viewport */
+  g_hash_table_iter_init (&iter, priv->awake);
+  while (g_hash_table_iter_next (&iter, &layout, NULL))
+    {
+      GtkAllocation alloc;
+
+      gtk_widget_get_allocation (layout, &alloc);
+
+      if (alloc.y + alloc.height < top || alloc.y > bottom)
+        {
+          _glade_design_layout_set_dormant (layout, TRUE);
+          g_hash_table_iter_remove (&iter);
+        }
+    }
+
+  /* And wake up the ones entering it */
+  for (i = glade_design_view_layout_at_y (view, top); i < priv->layouts->len; i++)
+    {
+      GtkAllocation alloc;
+
+      layout = VIEW_LAYOUT (view, i)->layout;
+      gtk_widget_get_allocation (layout, &alloc);
+
+      if (alloc.y > bottom)
+        break;
+
+      /* Not allocated yet */
+      if (alloc.x < 0)
+        continue;
+
+      if (!g_hash_table_contains (priv->awake, layout))
+        {
+          _glade_design_layout_set_dormant (layout, FALSE);
+          g_hash_table_add (priv->awake, layout);
+        }
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+glade_design_view_queue_viewport (GladeDesignView *view)
+{
+  if (view->priv->viewport_id == 0)
+    view->priv->viewport_id =
+      g_idle_add_full (G_PRIORITY_HIGH_IDLE,
+                       (GSourceFunc) glade_design_view_update_viewport,
+                       view, NULL);
+}
+
 static void
 glade_design_view_add_toplevel (GladeDesignView *view, GladeWidget *widget)
 {
   GtkWidget *layout;
-  GList *toplevels;
   GObject *object;
+  ViewLayout entry;
+  guint position;
 
   if (glade_widget_get_parent (widget) ||
       (object = glade_widget_get_object (widget)) == NULL ||
@@ -154,19 +287,29 @@ glade_design_view_add_toplevel (GladeDesignView *view, GladeWidget *widget)
       gtk_widget_get_parent (GTK_WIDGET (object)))
     return;
 
-  /* Create a GladeDesignLayout and add the toplevel widget to the view */
+  /* Create a GladeDesignLayout and add the toplevel widget to the view,
+   * it stays dormant until it gets close to the viewport.
+   */
   layout = _glade_design_layout_new (view);
   gtk_widget_set_halign (layout, GTK_ALIGN_START);
+  _glade_design_layout_set_dormant (GLADE_DESIGN_LAYOUT (layout), TRUE);
   gtk_box_pack_start (GTK_BOX (view->priv->layout_box), layout, FALSE, FALSE, 0);
 
-  if ((toplevels = glade_project_toplevels (view->priv->project)))
-    gtk_box_reorder_child (GTK_BOX (view->priv->layout_box), layout, 
-                           g_list_index (toplevels, GTK_WIDGET (object)));
+  if ((entry.order = _glade_project_get_toplevel_order (view->priv->project, object)) == 0)
+    entry.order = G_MAXUINT;
+  entry.layout = layout;
+
+  position = glade_design_view_layout_position (view, entry.order);
+  if (position < view->priv->layouts->len)
+    gtk_box_reorder_child (GTK_BOX (view->priv->layout_box), layout, position);
+  g_array_insert_val (view->priv->layouts, position, entry);
 
   gtk_container_add (GTK_CONTAINER (layout), GTK_WIDGET (object));
 
   gtk_widget_show (GTK_WIDGET (object));
   gtk_widget_show (layout);
+
+  glade_design_view_queue_viewport (view);
 }
 
 static void
@@ -183,8 +326,25 @@ glade_design_view_remove_toplevel (GladeDesignView *view, GladeWidget *widget)
   if ((layout = gtk_widget_get_parent (GTK_WIDGET (object))) &&
       gtk_widget_is_ancestor (layout, GTK_WIDGET (view)))
     {
+      guint order, i;
+
+      /* Look it up by order first, it is still in the project */
+      if ((order = _glade_project_get_toplevel_order (view->priv->project, object)) == 0)
+        order = G_MAXUINT;
+
+      i = glade_design_view_layout_position (view, order);
+      if (i == 0 || VIEW_LAYOUT (view, i - 1)->layout != layout)
+        for (i = view->priv->layouts->len; i > 0 && VIEW_LAYOUT (view, i - 1)->layout != layout; i--);
+
+      if (i > 0)
+        g_array_remove_index (view->priv->layouts, i - 1);
+
+      g_hash_table_remove (view->priv->awake, layout);
+
       gtk_container_remove (GTK_CONTAINER (layout), GTK_WIDGET (object));
       gtk_container_remove (GTK_CONTAINER (view->priv->layout_box), layout);
+
+      glade_design_view_queue_viewport (view);
     }
 }
 
@@ -411,6 +571,8 @@ glade_design_view_init (GladeDesignView *view)
 				  GTK_ORIENTATION_VERTICAL);
 
   view->priv->project = NULL;
+  view->priv->layouts = g_array_new (FALSE, FALSE, sizeof (ViewLayout));
+  view->priv->awake = g_hash_table_new (NULL, NULL);
   view->priv->layout_box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
   gtk_widget_set_valign (view->priv->layout_box, GTK_ALIGN_START);
   gtk_container_set_border_width (GTK_CONTAINER (view->priv->layout_box), 0);
@@ -432,6 +594,16 @@ glade_design_view_init (GladeDesignView *view)
   gtk_container_add (GTK_CONTAINER (viewport), view->priv->layout_box);
   gtk_container_add (GTK_CONTAINER (view->priv->scrolled_window), viewport);
 
+  /* Keep the layouts near the viewport awake */
+  g_signal_connect_swapped (gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (view->priv->scrolled_window)),
+                            "value-changed",
+                            G_CALLBACK (glade_design_view_queue_viewport), view);
+  g_signal_connect_swapped (gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (view->priv->scrolled_window)),
+                            "changed",
+                            G_CALLBACK (glade_design_view_queue_viewport), view);
+  g_signal_connect_swapped (view->priv->layout_box, "size-allocate",
+                            G_CALLBACK (glade_design_view_queue_viewport), view);
+
   gtk_widget_show (view->priv->scrolled_window);
   gtk_widget_show (viewport);
   gtk_widget_show_all (view->priv->layout_box);
@@ -453,6 +625,12 @@ glade_design_view_finalize (GObject *object)
 
   glade_design_view_set_project (view, NULL);
 
+  if (view->priv->viewport_id)
+    g_source_remove (view->priv->viewport_id);
+
+  g_array_free (view->priv->layouts, TRUE);
+  g_hash_table_destroy (view->priv->awake);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
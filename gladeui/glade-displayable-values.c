@@ -31,6 +31,7 @@
 #include <stdlib.h>
 
 #include "glade-displayable-values.h"
+#include "glade-private.h"
 
 
 typedef struct
@@ -40,21 +41,25 @@ typedef struct
   gboolean disabled:1;
 } ValueTab;
 
-static GHashTable *values_hash = NULL;
-
+/* The displayable values registered for a type */
+typedef struct
+{
+  GList      *tabs;             /* ValueTab in registration order */
+  GHashTable *by_value;         /* value name -> ValueTab */
+  GHashTable *by_string;        /* displayable string -> ValueTab */
+} TypeValues;
 
-static gint
-find_by_value (ValueTab *a, const gchar *b)
+/* Conversion table of an enum or flags type, built once per type */
+typedef struct
 {
-  return strcmp (a->value, b);
-}
+  gpointer    klass;            /* Kept referenced for the lifetime of the table */
+  GHashTable *by_name;          /* value names and nicks -> GEnumValue or GFlagsValue */
+  GHashTable *by_value;         /* enum value -> GEnumValue */
+} ConversionTable;
 
+static GHashTable *values_hash = NULL;
+static GHashTable *conversion_tables = NULL;
 
-static gint
-find_by_displayable (ValueTab *a, const gchar *b)
-{
-  return strcmp (a->string, b);
-}
 
 void
 glade_register_displayable_value (GType type,
@@ -73,77 +78,65 @@ glade_register_translated_value (GType type,
                                  const gchar *value,
                                  const gchar *string)
 {
+  TypeValues *values;
   ValueTab *tab;
-  gpointer klass;
-  GList *values;
 
   g_return_if_fail (value && value[0]);
-  klass = g_type_class_ref (type);
-  g_return_if_fail (klass != NULL);
+  g_return_if_fail (G_TYPE_IS_ENUM (type) || G_TYPE_IS_FLAGS (type));
 
   if (!values_hash)
     values_hash = g_hash_table_new (NULL, NULL);
 
+  if ((values = g_hash_table_lookup (values_hash, GSIZE_TO_POINTER (type))) == NULL)
+    {
+      values = g_new0 (TypeValues, 1);
+      values->by_value = g_hash_table_new (g_str_hash, g_str_equal);
+      values->by_string = g_hash_table_new (g_str_hash, g_str_equal);
+      g_hash_table_insert (values_hash, GSIZE_TO_POINTER (type), values);
+    }
+
+  if (g_hash_table_lookup (values->by_value, value))
+    {
+      g_warning ("Already registered displayable value %s for %s (type %s)",
+                 string, value, g_type_name (type));
+      return;
+    }
+
   tab = g_new0 (ValueTab, 1);
   tab->value = g_strdup (value);
   tab->string = g_strdup (string);
   tab->disabled = FALSE;
 
-  if ((values = g_hash_table_lookup (values_hash, klass)) != NULL)
-    {
-      if (!g_list_find_custom
-          (values, tab->value, (GCompareFunc) find_by_value))
-        values = g_list_append (values, tab);
-      else
-        {
-          g_warning ("Already registered displayable value %s for %s (type %s)",
-                     tab->string, tab->value, g_type_name (type));
-          g_free (tab->string);
-          g_free (tab->value);
-          g_free (tab);
-        }
-    }
-  else
-    {
-      values = g_list_append (NULL, tab);
-      g_hash_table_insert (values_hash, klass, values);
-    }
-  g_type_class_unref (klass);
+  values->tabs = g_list_append (values->tabs, tab);
+  g_hash_table_insert (values->by_value, tab->value, tab);
+
+  /* The first value registered with a displayable string wins, like it
+   * did when the list was searched in order */
+  if (tab->string && !g_hash_table_contains (values->by_string, tab->string))
+    g_hash_table_insert (values->by_string, tab->string, tab);
 }
 
-static ValueTab *
-get_value_tab (GType type, const gchar *value, GCompareFunc cmpfunc)
+static inline TypeValues *
+get_type_values (GType type)
 {
-  GList *values, *tab_iter;
-  gpointer klass;
-  ValueTab *tab;
-
-  if (!values_hash) return NULL;
-
-  klass = g_type_class_ref (type);
+  if (!values_hash)
+    return NULL;
 
-  if ((values = g_hash_table_lookup (values_hash, klass)) != NULL &&
-      (tab_iter = g_list_find_custom (values, value, cmpfunc)) != NULL)
-    tab = tab_iter->data;
-  else
-    tab = NULL;
+  return g_hash_table_lookup (values_hash, GSIZE_TO_POINTER (type));
+}
 
-  g_type_class_unref (klass);
+static ValueTab *
+get_value_tab (GType type, const gchar *value)
+{
+  TypeValues *values = get_type_values (type);
 
-  return tab;
+  return values ? g_hash_table_lookup (values->by_value, value) : NULL;
 }
 
 gboolean
 glade_type_has_displayable_values (GType type)
 {
-  gboolean has;
-  gpointer klass = g_type_class_ref (type);
-
-  has = values_hash && g_hash_table_lookup (values_hash, klass) != NULL;
-
-  g_type_class_unref (klass);
-
-  return has;
+  return get_type_values (type) != NULL;
 }
 
 G_CONST_RETURN gchar *
@@ -153,7 +146,7 @@ glade_get_displayable_value (GType type, const gchar *value)
 
   g_return_val_if_fail (value && value[0], NULL);
 
-  if ((tab = get_value_tab (type, value, (GCompareFunc) find_by_value)))
+  if ((tab = get_value_tab (type, value)))
     return tab->string;
 
   return NULL;
@@ -163,11 +156,13 @@ glade_get_displayable_value (GType type, const gchar *value)
 G_CONST_RETURN gchar *
 glade_get_value_from_displayable (GType type, const gchar *displayable)
 {
+  TypeValues *values;
   ValueTab *tab;
 
   g_return_val_if_fail (displayable && displayable[0], NULL);
 
-  if ((tab = get_value_tab (type, displayable, (GCompareFunc) find_by_displayable)))
+  if ((values = get_type_values (type)) &&
+      (tab = g_hash_table_lookup (values->by_string, displayable)))
     return tab->value;
 
   return NULL;
@@ -180,7 +175,7 @@ glade_displayable_value_is_disabled (GType type, const gchar *value)
 
   g_return_val_if_fail (value && value[0], FALSE);
 
-  if ((tab = get_value_tab (type, value, (GCompareFunc) find_by_value)))
+  if ((tab = get_value_tab (type, value)))
     return tab->disabled;
 
   return FALSE;
@@ -195,6 +190,107 @@ glade_displayable_value_set_disabled (GType type,
 
   g_return_if_fail (value && value[0]);
 
-  if ((tab = get_value_tab (type, value, (GCompareFunc) find_by_value)))
+  if ((tab = get_value_tab (type, value)))
     tab->disabled = disabled;
 }
+
+/* Private API */
+
+static ConversionTable *
+get_conversion_table (GType type)
+{
+  ConversionTable *table;
+  guint i;
+
+  if (!conversion_tables)
+    conversion_tables = g_hash_table_new (NULL, NULL);
+
+  if ((table = g_hash_table_lookup (conversion_tables, GSIZE_TO_POINTER (type))))
+    return table;
+
+  table = g_new0 (ConversionTable, 1);
+  table->klass = g_type_class_ref (type);
+  table->by_name = g_hash_table_new (g_str_hash, g_str_equal);
+
+  /* Nicks first so that names take precedence, as in
+   * g_enum_get_value_by_name() being tried before the nick */
+  if (G_TYPE_IS_ENUM (type))
+    {
+      GEnumClass *eclass = table->klass;
+
+      table->by_value = g_hash_table_new (NULL, NULL);
+
+      for (i = 0; i < eclass->n_values; i++)
+        {
+          GEnumValue *ev = &eclass->values[i];
+
+          g_hash_table_insert (table->by_name, (gchar *) ev->value_nick, ev);
+
+          /* Aliases resolve to the first value, like g_enum_get_value() */
+          if (!g_hash_table_contains (table->by_value, GINT_TO_POINTER (ev->value)))
+            g_hash_table_insert (table->by_value, GINT_TO_POINTER (ev->value), ev);
+        }
+      for (i = 0; i < eclass->n_values; i++)
+        g_hash_table_insert (table->by_name, (gchar *) eclass->values[i].value_name,
+                             &eclass->values[i]);
+    }
+  else
+    {
+      GFlagsClass *fclass = table->klass;
+
+      for (i = 0; i < fclass->n_values; i++)
+        g_hash_table_insert (table->by_name, (gchar *) fclass->values[i].value_nick,
+                             &fclass->values[i]);
+      for (i = 0; i < fclass->n_values; i++)
+        g_hash_table_insert (table->by_name, (gchar *) fclass->values[i].value_name,
+                             &fclass->values[i]);
+    }
+
+  g_hash_table_insert (conversion_tables, GSIZE_TO_POINTER (type), table);
+
+  return table;
+}
+
+/* Looks up an enum value by name or nick */
+gboolean
+_glade_enum_value_lookup (GType type, const gchar *string, gint *value)
+{
+  GEnumValue *ev;
+
+  g_return_val_if_fail (G_TYPE_IS_ENUM (type), FALSE);
+  g_return_val_if_fail (string != NULL, FALSE);
+
+  if ((ev = g_hash_table_lookup (get_conversion_table (type)->by_name, string)))
+    *value = ev->value;
+
+  return ev != NULL;
+}
+
+/* The nick of an enum value, or %NULL */
+const gchar *
+_glade_enum_value_get_nick (GType type, gint value)
+{
+  GEnumValue *ev;
+
+  g_return_val_if_fail (G_TYPE_IS_ENUM (type), NULL);
+
+  ev = g_hash_table_lookup (get_conversion_table (type)->by_value,
+                            GINT_TO_POINTER (value));
+
+  return ev ? ev->value_nick : NULL;
+}
+
+/* Looks up a single flags value by name or nick */
+gboolean
+_glade_flags_value_lookup (GType type, const gchar *string, guint *value)
+{
+  GFlagsValue *fv;
+
+  g_return_val_if_fail (G_TYPE_IS_FLAGS (type), FALSE);
+  g_return_val_if_fail (string != NULL, FALSE);
+
+  if ((fv = g_hash_table_lookup (get_conversion_table (type)->by_name, string)))
+    *value = fv->value;
+
+  return fv != NULL;
+}
@@ -780,7 +780,7 @@ glade_eprop_numeric_load (GladeEditorProperty *eprop, GladeProperty *property)
   gdouble val = 0.0F;
   GladeEPropNumeric *eprop_numeric = GLADE_EPROP_NUMERIC (eprop);
   GParamSpec *pspec;
-  GValue *value;
+  const GValue *value;
 
   if (eprop_numeric->refreshing)
     return;
@@ -790,7 +790,7 @@ glade_eprop_numeric_load (GladeEditorProperty *eprop, GladeProperty *property)
 
   if (property)
     {
-      value = glade_property_inline_value (property);
+      value = _glade_property_peek_value (property);
       pspec = glade_property_class_get_pspec (eprop->priv->klass);
 
       if (G_IS_PARAM_SPEC_INT (pspec))
@@ -864,7 +864,8 @@ glade_eprop_numeric_force_update (GtkSpinButton       *spin,
 {
   GladeProperty *prop = glade_editor_property_get_property (eprop);
   GladePropertyClass *klass = glade_property_get_class (prop);
-  GValue *val, newval = G_VALUE_INIT;
+  const GValue *val;
+  GValue newval = G_VALUE_INIT;
   gdouble value;
   gchar *text;
 
@@ -877,7 +878,7 @@ glade_eprop_numeric_force_update (GtkSpinButton       *spin,
   if (text && *text == '\0')
     return;
   
-  val = glade_property_inline_value (prop);
+  val = _glade_property_peek_value (prop);
 
   g_value_init (&newval, G_VALUE_TYPE (val));
   value = g_strtod (text, NULL);
@@ -1001,7 +1002,7 @@ glade_eprop_enum_load (GladeEditorProperty *eprop, GladeProperty *property)
     {
       pspec  = glade_property_class_get_pspec (eprop->priv->klass);
       eclass = g_type_class_ref (pspec->value_type);
-      value  = g_value_get_enum (glade_property_inline_value (property));
+      value  = g_value_get_enum (_glade_property_peek_value (property));
 
       for (i = 0; i < eclass->n_values; i++)
         if (eclass->values[i].value == value)
@@ -1149,8 +1150,8 @@ glade_eprop_flags_load (GladeEditorProperty *eprop, GladeProperty *property)
   if (property)
     {
       /* Populate the model with the flags. */
-      klass = g_type_class_ref (G_VALUE_TYPE (glade_property_inline_value (property)));
-      value = g_value_get_flags (glade_property_inline_value (property));
+      klass = g_type_class_ref (G_VALUE_TYPE (_glade_property_peek_value (property)));
+      value = g_value_get_flags (_glade_property_peek_value (property));
       pspec = glade_property_class_get_pspec (eprop->priv->klass);
 
       /* Step through each of the flags in the class. */
@@ -1207,7 +1208,7 @@ flag_toggled_direct (GtkCellRendererToggle *cell,
   GtkTreeIter iter;
   guint new_value = 0;
   gboolean selected;
-  GValue *gvalue;
+  const GValue *gvalue;
   gboolean valid;
 
   GladeEPropFlags *eprop_flags = GLADE_EPROP_FLAGS (eprop);
@@ -1215,7 +1216,7 @@ flag_toggled_direct (GtkCellRendererToggle *cell,
   if (!eprop->priv->property)
     return;
 
-  gvalue = glade_property_inline_value (eprop->priv->property);
+  gvalue = _glade_property_peek_value (eprop->priv->property);
 
   gtk_tree_model_get_iter_from_string (eprop_flags->model, &iter, path_string);
 
@@ -1427,7 +1428,7 @@ glade_eprop_color_load (GladeEditorProperty *eprop, GladeProperty *property)
 
       if (pspec->value_type == GDK_TYPE_COLOR)
 	{
-	  if ((color = g_value_get_boxed (glade_property_inline_value (property))) != NULL)
+	  if ((color = g_value_get_boxed (_glade_property_peek_value (property))) != NULL)
 	    {
 	      GdkRGBA copy;
 
@@ -1450,7 +1451,7 @@ glade_eprop_color_load (GladeEditorProperty *eprop, GladeProperty *property)
 	}
       else if (pspec->value_type == GDK_TYPE_RGBA)
 	{
-	  if ((rgba = g_value_get_boxed (glade_property_inline_value (property))) != NULL)
+	  if ((rgba = g_value_get_boxed (_glade_property_peek_value (property))) != NULL)
 	      gtk_color_chooser_set_rgba (GTK_COLOR_CHOOSER (eprop_color->cbutton), rgba);
 	  else
 	    {
@@ -1847,7 +1848,7 @@ glade_eprop_text_load (GladeEditorProperty *eprop, GladeProperty *property)
 	  GladePropertyClass *pclass = glade_property_get_class (property);
           gchar *text = glade_widget_adaptor_string_from_value
 	    (glade_property_class_get_adaptor (pclass),
-	     pclass, glade_property_inline_value (property));
+	     pclass, _glade_property_peek_value (property));
           gchar *old_text = text_buffer_get_text (buffer);
 
           /* Only update it if necessary, see notes bellow */
@@ -2512,7 +2513,7 @@ glade_eprop_bool_load (GladeEditorProperty *eprop, GladeProperty *property)
   if (property)
     {
       GladeEPropBool *eprop_bool = GLADE_EPROP_BOOL (eprop);
-      gboolean state = g_value_get_boolean (glade_property_inline_value (property));
+      gboolean state = g_value_get_boolean (_glade_property_peek_value (property));
       gtk_switch_set_active (GTK_SWITCH (eprop_bool->button), state);
     }
 }
@@ -2583,7 +2584,7 @@ glade_eprop_check_load (GladeEditorProperty *eprop, GladeProperty *property)
   if (property)
     {
       GladeEPropCheck *eprop_check = GLADE_EPROP_CHECK (eprop);
-      gboolean state = g_value_get_boolean (glade_property_inline_value (property));
+      gboolean state = g_value_get_boolean (_glade_property_peek_value (property));
       gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (eprop_check->button), state);
     }
 }
@@ -2679,7 +2680,7 @@ glade_eprop_unichar_load (GladeEditorProperty *eprop, GladeProperty *property)
       gchar utf8st[8];
       gint n;
 
-      if ((n = g_unichar_to_utf8 (g_value_get_uint (glade_property_inline_value (property)), utf8st)))
+      if ((n = g_unichar_to_utf8 (g_value_get_uint (_glade_property_peek_value (property)), utf8st)))
         {
           utf8st[n] = '\0';
           gtk_entry_set_text (entry, utf8st);
@@ -2840,77 +2841,61 @@ search_list (GList * list, gpointer data)
 }
 
 
-/*
- * Note that widgets is a list of GtkWidgets, while what we store
- * in the model are the associated GladeWidgets.
+/* Appends @widget under its ancestors, appending them first if they are
+ * not in the model yet, and returns the row of @widget.
  */
-static void
-glade_eprop_object_populate_view_real (GtkTreeStore *model,
-                                       GtkTreeIter  *parent_iter,
-                                       GList        *widgets,
-                                       GList        *selected_widgets,
-                                       GList        *exception_widgets,
-                                       GType         object_type,
-                                       gboolean      parentless)
+static GtkTreeIter *
+glade_eprop_object_append_widget (GtkTreeStore *model,
+                                  GHashTable   *iters,
+                                  GladeWidget  *widget,
+                                  GList        *selected_widgets,
+                                  GList        *exception_widgets,
+                                  GType         object_type,
+                                  gboolean      parentless)
 {
-  GList *children, *list;
-  GtkTreeIter iter;
-  gboolean good_type, has_decendant;
+  GladeWidgetAdaptor *adaptor = glade_widget_get_adaptor (widget);
+  GtkTreeIter *iter, *parent_iter = NULL;
+  GladeWidget *parent;
+  gboolean good_type;
 
-  for (list = widgets; list; list = list->next)
-    {
-      GladeWidget *widget;
-      GladeWidgetAdaptor *adaptor;
-      const gchar *widget_name;
-      if ((widget = glade_widget_get_from_gobject (list->data)) != NULL)
-        {
-	  adaptor = glade_widget_get_adaptor (widget);
-
-          has_decendant = 
-	    !parentless && glade_widget_has_decendant (widget, object_type);
+  if ((iter = g_hash_table_lookup (iters, widget)) != NULL)
+    return iter;
 
-          good_type = (glade_widget_adaptor_get_object_type (adaptor) == object_type ||
-                       g_type_is_a (glade_widget_adaptor_get_object_type (adaptor), object_type));
+  if ((parent = glade_widget_get_parent (widget)) != NULL)
+    parent_iter = glade_eprop_object_append_widget (model, iters, parent,
+                                                    selected_widgets,
+                                                    exception_widgets,
+                                                    object_type, parentless);
 
-	  widget_name = glade_widget_get_display_name (widget);
-          if (parentless)
-            good_type = good_type && !GWA_IS_TOPLEVEL (adaptor);
+  good_type = g_type_is_a (glade_widget_adaptor_get_object_type (adaptor), object_type);
+  if (parentless)
+    good_type = good_type && !GWA_IS_TOPLEVEL (adaptor);
 
-          if (good_type || has_decendant)
-            {
-              gtk_tree_store_append (model, &iter, parent_iter);
-              gtk_tree_store_set
-                  (model, &iter,
-                   OBJ_COLUMN_WIDGET, widget,
-                   OBJ_COLUMN_WIDGET_NAME,
-                   glade_eprop_object_name (widget_name, model, parent_iter),
-                   OBJ_COLUMN_WIDGET_CLASS, glade_widget_adaptor_get_title (adaptor),
-                   /* Selectable if its a compatible type and
-                    * its not itself.
-                    */
-                   OBJ_COLUMN_SELECTABLE,
-                   good_type && !search_list (exception_widgets, widget),
-                   OBJ_COLUMN_SELECTED,
-                   good_type && search_list (selected_widgets, widget), -1);
-            }
+  iter = g_slice_new (GtkTreeIter);
+  gtk_tree_store_append (model, iter, parent_iter);
+  gtk_tree_store_set
+      (model, iter,
+       OBJ_COLUMN_WIDGET, widget,
+       OBJ_COLUMN_WIDGET_NAME,
+       glade_eprop_object_name (glade_widget_get_display_name (widget), model, parent_iter),
+       OBJ_COLUMN_WIDGET_CLASS, glade_widget_adaptor_get_title (adaptor),
+       /* Selectable if its a compatible type and
+        * its not itself.
+        */
+       OBJ_COLUMN_SELECTABLE,
+       good_type && !search_list (exception_widgets, widget),
+       OBJ_COLUMN_SELECTED,
+       good_type && search_list (selected_widgets, widget), -1);
 
-          if (has_decendant &&
-              (children = glade_widget_adaptor_get_children
-               (adaptor, glade_widget_get_object (widget))) != NULL)
-            {
-              GtkTreeIter *copy = NULL;
+  g_hash_table_insert (iters, widget, iter);
 
-              copy = gtk_tree_iter_copy (&iter);
-              glade_eprop_object_populate_view_real (model, copy, children,
-                                                     selected_widgets,
-                                                     exception_widgets,
-                                                     object_type, parentless);
-              gtk_tree_iter_free (copy);
+  return iter;
+}
 
-              g_list_free (children);
-            }
-        }
-    }
+static void
+glade_eprop_object_free_iter (GtkTreeIter *iter)
+{
+  g_slice_free (GtkTreeIter, iter);
 }
 
 static void
@@ -2922,24 +2907,32 @@ glade_eprop_object_populate_view (GladeProject *project,
                                   gboolean      parentless)
 {
   GtkTreeStore *model = (GtkTreeStore *) gtk_tree_view_get_model (view);
-  GList *list, *toplevels = NULL;
+  GHashTable *iters;
+  GList *list, *objects;
+
+  iters = g_hash_table_new_full (NULL, NULL, NULL,
+                                 (GDestroyNotify) glade_eprop_object_free_iter);
 
-  /* Make a list of only the toplevel widgets */
-  for (list = (GList *) glade_project_get_objects (project); list;
-       list = list->next)
+  /* Only the objects of a compatible type are listed, under their
+   * ancestors, parentless properties only refer to toplevels
+   */
+  objects = glade_project_list_objects_by_type (project, object_type);
+  for (list = objects; list; list = list->next)
     {
-      GObject *object = G_OBJECT (list->data);
-      GladeWidget *gwidget = glade_widget_get_from_gobject (object);
-      g_assert (gwidget);
+      GladeWidget *widget = glade_widget_get_from_gobject (list->data);
+      g_assert (widget);
+
+      if (parentless &&
+          (glade_widget_get_parent (widget) != NULL ||
+           GWA_IS_TOPLEVEL (glade_widget_get_adaptor (widget))))
+        continue;
 
-      if (glade_widget_get_parent (gwidget) == NULL)
-        toplevels = g_list_append (toplevels, object);
+      glade_eprop_object_append_widget (model, iters, widget, selected,
+                                        exceptions, object_type, parentless);
     }
 
-  /* add the widgets and recurse */
-  glade_eprop_object_populate_view_real (model, NULL, toplevels, selected,
-                                         exceptions, object_type, parentless);
-  g_list_free (toplevels);
+  g_list_free (objects);
+  g_hash_table_destroy (iters);
 }
 
 static gboolean
@@ -3302,11 +3295,11 @@ glade_eprop_object_show_dialog (GladeEditorProperty *eprop)
 
 
   exception_list = g_list_prepend (exception_list, widget);
-  if (g_value_get_object (glade_property_inline_value (eprop->priv->property)))
+  if (g_value_get_object (_glade_property_peek_value (eprop->priv->property)))
     selected_list = g_list_prepend (selected_list,
                                     glade_widget_get_from_gobject
                                     (g_value_get_object
-                                     (glade_property_inline_value (eprop->priv->property))));
+                                     (_glade_property_peek_value (eprop->priv->property))));
 
   tree_view = glade_eprop_object_view (TRUE);
   glade_eprop_object_populate_view (project, GTK_TREE_VIEW (tree_view),
@@ -3454,7 +3447,7 @@ glade_eprop_object_load (GladeEditorProperty *eprop, GladeProperty *property)
 
   if ((obj_name = glade_widget_adaptor_string_from_value
        (glade_property_class_get_adaptor (eprop->priv->klass),
-        eprop->priv->klass, glade_property_inline_value (property))) != NULL)
+        eprop->priv->klass, _glade_property_peek_value (property))) != NULL)
     {
       gtk_entry_set_text (GTK_ENTRY (eprop_object->entry), obj_name);
       g_free (obj_name);
@@ -3522,7 +3515,7 @@ glade_eprop_objects_load (GladeEditorProperty *eprop, GladeProperty *property)
 
   if ((obj_name = glade_widget_adaptor_string_from_value
        (glade_property_class_get_adaptor (eprop->priv->klass),
-        eprop->priv->klass, glade_property_inline_value (property))) != NULL)
+        eprop->priv->klass, _glade_property_peek_value (property))) != NULL)
     {
       gtk_entry_set_text (GTK_ENTRY (eprop_objects->entry), obj_name);
       g_free (obj_name);
@@ -0,0 +1,368 @@
+/*
+ * glade-image-cache.c
+ *
+ * Copyright (C) 2017 The Glade developers
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <config.h>
+
+#include <glib/gstdio.h>
+
+#include "glade-image-cache.h"
+
+/* A project scoped cache of the images referenced by GdkPixbuf properties.
+ *
+ * Images are keyed by their resolved path and modification time, each
+ * file is decoded only once on a worker thread and every property
+ * referencing it gets a GdkPixbuf sharing the same pixel data.
+ *
+ * Until an image is decoded, lookups return a placeholder flagged with
+ * the path of the pending image, the owner is notified from the main loop
+ * for each image that is ready so that it can patch the properties.
+ */
+#define GLADE_IMAGE_CACHE_FILENAME "GladeFileName"
+#define GLADE_IMAGE_CACHE_PENDING  "glade-image-cache-pending"
+
+typedef struct
+{
+  gchar      *fullpath;
+  gint64      mtime;      /* -1 if the file could not be stat()ed */
+  GdkPixbuf  *pixbuf;     /* The decoded image, NULL if loading or failed */
+  GHashTable *variants;   /* filename -> GdkPixbuf sharing pixbuf's pixels */
+  gpointer    job;        /* The ImageJob in flight, if any */
+} ImageEntry;
+
+typedef struct
+{
+  GladeImageCache *cache;
+  gchar           *fullpath;
+  GdkPixbuf       *pixbuf;
+} ImageJob;
+
+struct _GladeImageCache
+{
+  gint        ref_count;
+
+  GHashTable *entries;    /* fullpath -> ImageEntry, NULL once destroyed */
+  GdkPixbuf  *missing;
+
+  GladeImageCacheReadyFunc ready_func;
+  gpointer                 user_data;
+
+  /* Shared with the worker threads */
+  GMutex      lock;
+  GList      *done;
+  guint       done_id;
+};
+
+static GThreadPool *image_pool = NULL;
+
+static GladeImageCache *
+image_cache_ref (GladeImageCache *cache)
+{
+  g_atomic_int_inc (&cache->ref_count);
+  return cache;
+}
+
+static void
+image_cache_unref (GladeImageCache *cache)
+{
+  if (!g_atomic_int_dec_and_test (&cache->ref_count))
+    return;
+
+  g_clear_object (&cache->missing);
+  g_mutex_clear (&cache->lock);
+  g_slice_free (GladeImageCache, cache);
+}
+
+static void
+image_job_free (ImageJob *job)
+{
+  image_cache_unref (job->cache);
+  g_clear_object (&job->pixbuf);
+  g_free (job->fullpath);
+  g_slice_free (ImageJob, job);
+}
+
+static ImageEntry *
+image_entry_new (const gchar *fullpath, gint64 mtime)
+{
+  ImageEntry *entry = g_slice_new0 (ImageEntry);
+
+  entry->fullpath = g_strdup (fullpath);
+  entry->mtime    = mtime;
+  entry->variants = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                           g_free, g_object_unref);
+  return entry;
+}
+
+static void
+image_entry_free (ImageEntry *entry)
+{
+  g_hash_table_destroy (entry->variants);
+  g_clear_object (&entry->pixbuf);
+  g_free (entry->fullpath);
+  g_slice_free (ImageEntry, entry);
+}
+
+static gboolean
+image_cache_flush (GladeImageCache *cache)
+{
+  GList *done, *ready = NULL, *l;
+
+  g_mutex_lock (&cache->lock);
+  done = cache->done;
+  cache->done = NULL;
+  cache->done_id = 0;
+  g_mutex_unlock (&cache->lock);
+
+  for (l = done; l; l = l->next)
+    {
+      ImageJob   *job = l->data;
+      ImageEntry *entry = NULL;
+
+      if (cache->entries)
+        entry = g_hash_table_lookup (cache->entries, job->fullpath);
+
+      /* Results of stale jobs (the file changed meanwhile) are dropped */
+      if (entry && entry->job == job)
+        {
+          entry->job = NULL;
+          entry->pixbuf = job->pixbuf;
+          job->pixbuf = NULL;
+
+          /* Forget about the placeholders, they get replaced by the owner */
+          g_hash_table_remove_all (entry->variants);
+          ready = g_list_prepend (ready, g_strdup (entry->fullpath));
+        }
+
+      image_job_free (job);
+    }
+  g_list_free (done);
+
+  /* The owner looks images up again, entries may be replaced meanwhile */
+  for (l = ready; l; l = l->next)
+    if (cache->ready_func)
+      cache->ready_func (cache, l->data, cache->user_data);
+
+  g_list_free_full (ready, g_free);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Runs in a worker thread */
+static void
+image_job_decode (ImageJob *job, gpointer unused)
+{
+  GladeImageCache *cache = job->cache;
+
+  job->pixbuf = gdk_pixbuf_new_from_file (job->fullpath, NULL);
+
+  g_mutex_lock (&cache->lock);
+  cache->done = g_list_prepend (cache->done, job);
+  if (cache->done_id == 0)
+    cache->done_id = g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+                                      (GSourceFunc) image_cache_flush,
+                                      image_cache_ref (cache),
+                                      (GDestroyNotify) image_cache_unref);
+  g_mutex_unlock (&cache->lock);
+}
+
+static void
+image_cache_queue (GladeImageCache *cache, ImageEntry *entry)
+{
+  ImageJob *job = g_slice_new0 (ImageJob);
+
+  job->cache    = image_cache_ref (cache);
+  job->fullpath = g_strdup (entry->fullpath);
+  entry->job    = job;
+
+  if (image_pool == NULL)
+    image_pool = g_thread_pool_new ((GFunc) image_job_decode, NULL,
+                                    g_get_num_processors (), FALSE, NULL);
+
+  g_thread_pool_push (image_pool, job, NULL);
+}
+
+static GdkPixbuf *
+image_cache_get_missing (GladeImageCache *cache)
+{
+  if (cache->missing == NULL)
+    cache->missing = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
+                                               "image-missing", 22, 0, NULL);
+  return cache->missing;
+}
+
+/* Wraps the pixels of @source without copying them, so that each
+ * property can carry its own "GladeFileName".
+ */
+static GdkPixbuf *
+image_pixbuf_share (GdkPixbuf *source)
+{
+  GdkPixbuf *pixbuf;
+  GBytes *bytes;
+
+  bytes  = gdk_pixbuf_read_pixel_bytes (source);
+  pixbuf = gdk_pixbuf_new_from_bytes (bytes,
+                                      gdk_pixbuf_get_colorspace (source),
+                                      gdk_pixbuf_get_has_alpha (source),
+                                      gdk_pixbuf_get_bits_per_sample (source),
+                                      gdk_pixbuf_get_width (source),
+                                      gdk_pixbuf_get_height (source),
+                                      gdk_pixbuf_get_rowstride (source));
+  g_bytes_unref (bytes);
+
+  return pixbuf;
+}
+
+/**
+ * glade_image_cache_new:
+ * @ready_func: called when pending images are decoded
+ * @user_data: data for @ready_func
+ *
+ * Returns: a new #GladeImageCache
+ */
+GladeImageCache *
+glade_image_cache_new (GladeImageCacheReadyFunc ready_func,
+                       gpointer                 user_data)
+{
+  GladeImageCache *cache = g_slice_new0 (GladeImageCache);
+
+  cache->ref_count  = 1;
+  cache->ready_func = ready_func;
+  cache->user_data  = user_data;
+  cache->entries    = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                             (GDestroyNotify) image_entry_free);
+  g_mutex_init (&cache->lock);
+
+  return cache;
+}
+
+/**
+ * glade_image_cache_destroy:
+ * @cache: A #GladeImageCache
+ *
+ * Drops all cached images, decodings still in flight are discarded.
+ */
+void
+glade_image_cache_destroy (GladeImageCache *cache)
+{
+  g_return_if_fail (cache != NULL);
+
+  cache->ready_func = NULL;
+  g_hash_table_destroy (cache->entries);
+  cache->entries = NULL;
+
+  image_cache_unref (cache);
+}
+
+/**
+ * glade_image_cache_lookup:
+ * @cache: A #GladeImageCache
+ * @fullpath: The resolved path of the image
+ * @filename: The filename as written in the project
+ *
+ * Looks up the image at @fullpath, the entry is only invalidated if
+ * the file changed since it was decoded. If the image is not decoded
+ * yet a placeholder is returned and the decoding is queued.
+ *
+ * Returns: (transfer full): A #GdkPixbuf with @filename set as its
+ *          "GladeFileName" or %NULL
+ */
+GdkPixbuf *
+glade_image_cache_lookup (GladeImageCache *cache,
+                          const gchar     *fullpath,
+                          const gchar     *filename)
+{
+  ImageEntry *entry;
+  GdkPixbuf *pixbuf, *source;
+  GStatBuf statbuf;
+  gint64 mtime;
+
+  g_return_val_if_fail (cache != NULL, NULL);
+  g_return_val_if_fail (fullpath && filename, NULL);
+
+  mtime = (g_stat (fullpath, &statbuf) == 0) ? (gint64) statbuf.st_mtime : -1;
+
+  entry = g_hash_table_lookup (cache->entries, fullpath);
+
+  if (entry && entry->mtime != mtime)
+    {
+      g_hash_table_remove (cache->entries, fullpath);
+      entry = NULL;
+    }
+
+  if (entry == NULL)
+    {
+      entry = image_entry_new (fullpath, mtime);
+      g_hash_table_insert (cache->entries, entry->fullpath, entry);
+
+      /* No need to bother the pool for missing files */
+      if (mtime >= 0)
+        image_cache_queue (cache, entry);
+    }
+
+  if ((pixbuf = g_hash_table_lookup (entry->variants, filename)) == NULL)
+    {
+      source = entry->pixbuf ? entry->pixbuf : image_cache_get_missing (cache);
+
+      if (source == NULL)
+        return NULL;
+
+      pixbuf = image_pixbuf_share (source);
+      g_object_set_data_full (G_OBJECT (pixbuf), GLADE_IMAGE_CACHE_FILENAME,
+                              g_strdup (filename), g_free);
+
+      if (entry->job)
+        g_object_set_data_full (G_OBJECT (pixbuf), GLADE_IMAGE_CACHE_PENDING,
+                                g_strdup (entry->fullpath), g_free);
+
+      g_hash_table_insert (entry->variants, g_strdup (filename), pixbuf);
+    }
+
+  return g_object_ref (pixbuf);
+}
+
+/**
+ * glade_image_cache_is_pending:
+ * @pixbuf: A #GdkPixbuf
+ *
+ * Returns: whether @pixbuf is a placeholder for an image being decoded
+ */
+gboolean
+glade_image_cache_is_pending (GdkPixbuf *pixbuf)
+{
+  g_return_val_if_fail (GDK_IS_PIXBUF (pixbuf), FALSE);
+
+  return g_object_get_data (G_OBJECT (pixbuf), GLADE_IMAGE_CACHE_PENDING) != NULL;
+}
+
+/**
+ * glade_image_cache_get_pending_path:
+ * @pixbuf: A #GdkPixbuf
+ *
+ * Returns: the resolved path of the image @pixbuf is a placeholder for,
+ *          or %NULL if @pixbuf is not pending
+ */
+const gchar *
+glade_image_cache_get_pending_path (GdkPixbuf *pixbuf)
+{
+  g_return_val_if_fail (GDK_IS_PIXBUF (pixbuf), NULL);
+
+  return g_object_get_data (G_OBJECT (pixbuf), GLADE_IMAGE_CACHE_PENDING);
+}
@@ -0,0 +1,51 @@
+/*
+ * glade-image-cache.h
+ *
+ * Copyright (C) 2017 The Glade developers
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __GLADE_IMAGE_CACHE_H__
+#define __GLADE_IMAGE_CACHE_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GladeImageCache GladeImageCache;
+
+/* Called from the main loop once the pending image at @fullpath is decoded */
+typedef void (* GladeImageCacheReadyFunc) (GladeImageCache *cache,
+                                           const gchar     *fullpath,
+                                           gpointer         user_data);
+
+GladeImageCache *glade_image_cache_new        (GladeImageCacheReadyFunc  ready_func,
+                                               gpointer                  user_data);
+
+void             glade_image_cache_destroy    (GladeImageCache          *cache);
+
+GdkPixbuf       *glade_image_cache_lookup     (GladeImageCache          *cache,
+                                               const gchar              *fullpath,
+                                               const gchar              *filename);
+
+gboolean         glade_image_cache_is_pending (GdkPixbuf                *pixbuf);
+
+const gchar     *glade_image_cache_get_pending_path (GdkPixbuf          *pixbuf);
+
+G_END_DECLS
+
+#endif /* __GLADE_IMAGE_CACHE_H__ */
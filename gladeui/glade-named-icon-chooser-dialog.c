@@ -65,11 +65,14 @@ enum
   LAST_SIGNAL
 };
 
+typedef struct _IconTable IconTable;
+
 struct _GladeNamedIconChooserDialogPrivate
 {
   GtkWidget *icons_view;
   GtkTreeModel *filter_model;   /* filtering model  */
-  GtkListStore *icons_store;    /* data store       */
+  GtkListStore *icons_store;    /* data store, shared with other dialogs */
+  IconTable *table;             /* the icon names table owning the store */
   GtkTreeSelection *selection;
 
   GtkWidget *contexts_view;
@@ -94,6 +97,12 @@ struct _GladeNamedIconChooserDialogPrivate
   GtkWidget *last_focus_widget;
 
   gboolean icons_loaded;        /* whether the icons have been loaded into the model */
+
+  gpointer index;               /* the icon index we are waiting for, if any */
+
+  gchar *search_key;            /* the last searched prefix and its matching rows */
+  guint search_first;
+  guint search_last;
 };
 
 static GHashTable *standard_icon_quarks = NULL;
@@ -118,6 +127,10 @@ static gboolean should_respond (GladeNamedIconChooserDialog *dialog);
 
 static void filter_icons_model (GladeNamedIconChooserDialog *dialog);
 
+static gboolean icons_store_row_has_prefix (GladeNamedIconChooserDialog *dialog,
+                                            GtkTreeIter                 *iter,
+                                            const gchar                 *key);
+
 static gboolean scan_for_name_func (GtkTreeModel *model,
                                     GtkTreePath  *path,
                                     GtkTreeIter  *iter,
@@ -544,6 +557,10 @@ contexts_row_activated_cb (GtkTreeView                 *view,
   GtkTreeIter iter;
   GtkTreePath *path;
 
+  /* The icons are still being loaded */
+  if (!dialog->priv->filter_model)
+    return;
+
   if (gtk_tree_model_get_iter_first (dialog->priv->filter_model, &iter))
     {
 
@@ -699,6 +716,9 @@ filter_visible_func (GtkTreeModel                *model,
 }
 
 
+/* searches are narrowed down with the icon index, which is case
+ * insensitive, the tree view search itself is case sensitive
+ */
 static gboolean
 search_equal_func (GtkTreeModel                *model,
                    gint                         column,
@@ -706,9 +726,16 @@ search_equal_func (GtkTreeModel                *model,
                    GtkTreeIter                 *iter,
                    GladeNamedIconChooserDialog *dialog)
 {
+  GtkTreeIter store_iter;
   gchar *name;
   gboolean retval;
 
+  gtk_tree_model_filter_convert_iter_to_child_iter (GTK_TREE_MODEL_FILTER (model),
+                                                    &store_iter, iter);
+
+  if (!icons_store_row_has_prefix (dialog, &store_iter, key))
+    return TRUE;
+
   gtk_tree_model_get (model, iter, ICONS_NAME_COLUMN, &name, -1);
 
   retval = !g_str_has_prefix (name, key);
@@ -716,7 +743,15 @@ search_equal_func (GtkTreeModel                *model,
   g_free (name);
 
   return retval;
+}
 
+static gboolean
+completion_match_func (GtkEntryCompletion          *completion,
+                       const gchar                 *key,
+                       GtkTreeIter                 *iter,
+                       GladeNamedIconChooserDialog *dialog)
+{
+  return icons_store_row_has_prefix (dialog, iter, key);
 }
 
 static gboolean
@@ -914,14 +949,311 @@ is_standard_icon_name (const gchar *icon_name)
 
 }
 
+/* A snapshot of the icon names of a theme, sorted case insensitively.
+ * The rows of @store are in the same order as @entries, so that a row
+ * can be mapped to its entry by position.
+ */
+typedef struct
+{
+  gchar   *name;
+  guint    context;
+  gboolean standard;
+} IconEntry;
+
+struct _IconTable
+{
+  gint          ref_count;
+  GtkListStore *store;
+  GArray       *entries;        /* IconEntry */
+};
+
+/* The process wide index of an icon theme, set as qdata on the theme.
+ * Tables are built once on a worker thread and shared by all dialogs
+ * until the theme changes.
+ */
+typedef struct
+{
+  IconTable *table;             /* the current table, NULL until loaded */
+  guint      serial;            /* bumped when the theme changes */
+  gboolean   loading;           /* whether a worker is enumerating icons */
+  GList     *waiters;           /* dialogs waiting for the table */
+} IconIndex;
+
+typedef struct
+{
+  guint   serial;
+  gchar  *theme_name;
+  gchar **search_path;
+  gint    n_search_path;
+} IconIndexJob;
+
+static IconTable *
+icon_table_ref (IconTable *table)
+{
+  table->ref_count++;
+  return table;
+}
+
 static void
-cleanup_after_load (GladeNamedIconChooserDialog *dialog)
+icon_table_unref (IconTable *table)
 {
-  dialog->priv->load_id = 0;
+  if (--table->ref_count > 0)
+    return;
 
-  pending_select_name_process (dialog);
+  g_object_unref (table->store);
+  g_array_free (table->entries, TRUE);
+  g_slice_free (IconTable, table);
+}
 
-  set_busy_cursor (dialog, FALSE);
+static void
+icon_entry_clear (IconEntry *entry)
+{
+  g_free (entry->name);
+}
+
+static gint
+icon_entry_compare (const IconEntry *a, const IconEntry *b)
+{
+  return g_ascii_strcasecmp (a->name, b->name);
+}
+
+static void
+icon_index_job_free (IconIndexJob *job)
+{
+  g_free (job->theme_name);
+  g_strfreev (job->search_path);
+  g_slice_free (IconIndexJob, job);
+}
+
+/* Runs in a worker thread, the theme is private to this thread since
+ * GtkIconTheme is not thread safe.
+ */
+static void
+icon_index_thread (GTask        *task,
+                   gpointer      source_object,
+                   IconIndexJob *job,
+                   GCancellable *cancellable)
+{
+  GtkIconTheme *theme = gtk_icon_theme_new ();
+  GArray *entries;
+  GList *l;
+  guint i;
+
+  gtk_icon_theme_set_search_path (theme, (const gchar **) job->search_path,
+                                  job->n_search_path);
+  if (job->theme_name)
+    gtk_icon_theme_set_custom_theme (theme, job->theme_name);
+
+  entries = g_array_new (FALSE, FALSE, sizeof (IconEntry));
+  g_array_set_clear_func (entries, (GDestroyNotify) icon_entry_clear);
+
+  /* retrieve icon names from each context */
+  for (i = 0; i < G_N_ELEMENTS (standard_contexts); i++)
+    {
+      GList *icons_in_context =
+          gtk_icon_theme_list_icons (theme, standard_contexts[i].name);
+
+      for (l = icons_in_context; l; l = l->next)
+        {
+          IconEntry entry;
+
+          entry.name = l->data;
+          entry.context = i;
+          entry.standard = is_standard_icon_name (entry.name);
+
+          g_array_append_val (entries, entry);
+        }
+
+      g_list_free (icons_in_context);
+    }
+
+  /* sort icon names */
+  g_array_sort (entries, (GCompareFunc) icon_entry_compare);
+
+  g_object_unref (theme);
+
+  g_task_return_pointer (task, entries, (GDestroyNotify) g_array_unref);
+}
+
+static void icon_index_load (GtkIconTheme *theme, IconIndex *index, GtkWidget *widget);
+static void icons_table_ready (GladeNamedIconChooserDialog *dialog, IconTable *table);
+
+static void
+icon_index_loaded (GtkIconTheme *theme,
+                   GAsyncResult *result,
+                   IconIndex    *index)
+{
+  IconIndexJob *job = g_task_get_task_data (G_TASK (result));
+  GArray *entries = g_task_propagate_pointer (G_TASK (result), NULL);
+  IconTable *table;
+  GList *waiters, *l;
+  guint i;
+
+  index->loading = FALSE;
+
+  /* The theme changed meanwhile, enumerate again */
+  if (job->serial != index->serial)
+    {
+      g_array_unref (entries);
+
+      if (index->waiters)
+        icon_index_load (theme, index, index->waiters->data);
+      return;
+    }
+
+  table = g_slice_new0 (IconTable);
+  table->ref_count = 1;
+  table->entries = entries;
+  table->store = gtk_list_store_new (ICONS_N_COLUMNS,
+                                     G_TYPE_UINT,
+                                     G_TYPE_BOOLEAN,
+                                     G_TYPE_STRING);
+
+  /* put into to model */
+  for (i = 0; i < entries->len; i++)
+    {
+      IconEntry *entry = &g_array_index (entries, IconEntry, i);
+
+      gtk_list_store_insert_with_values (table->store, NULL, -1,
+                                         ICONS_CONTEXT_COLUMN, entry->context,
+                                         ICONS_STANDARD_COLUMN, entry->standard,
+                                         ICONS_NAME_COLUMN, entry->name, -1);
+    }
+
+  index->table = table;
+
+  waiters = index->waiters;
+  index->waiters = NULL;
+
+  for (l = waiters; l; l = l->next)
+    icons_table_ready (l->data, table);
+
+  g_list_free (waiters);
+}
+
+static void
+icon_index_load (GtkIconTheme *theme, IconIndex *index, GtkWidget *widget)
+{
+  IconIndexJob *job = g_slice_new0 (IconIndexJob);
+  GtkSettings *settings;
+  GTask *task;
+
+  /* Copy what the worker needs to set up its own theme */
+  settings = gtk_settings_get_for_screen (gtk_widget_get_screen (widget));
+  g_object_get (settings, "gtk-icon-theme-name", &job->theme_name, NULL);
+  gtk_icon_theme_get_search_path (theme, &job->search_path, &job->n_search_path);
+  job->serial = index->serial;
+
+  index->loading = TRUE;
+
+  task = g_task_new (theme, NULL, (GAsyncReadyCallback) icon_index_loaded, index);
+  g_task_set_task_data (task, job, (GDestroyNotify) icon_index_job_free);
+  g_task_run_in_thread (task, (GTaskThreadFunc) icon_index_thread);
+  g_object_unref (task);
+}
+
+static void
+icon_index_theme_changed (GtkIconTheme *theme, IconIndex *index)
+{
+  /* Dialogs keep their table until they reload */
+  g_clear_pointer (&index->table, icon_table_unref);
+  index->serial++;
+}
+
+static IconIndex *
+icon_index_get (GtkIconTheme *theme)
+{
+  static GQuark index_quark = 0;
+  IconIndex *index;
+
+  if (index_quark == 0)
+    index_quark = g_quark_from_static_string ("glade-named-icon-index");
+
+  if ((index = g_object_get_qdata (G_OBJECT (theme), index_quark)) == NULL)
+    {
+      index = g_slice_new0 (IconIndex);
+      g_object_set_qdata (G_OBJECT (theme), index_quark, index);
+
+      g_signal_connect (theme, "changed",
+                        G_CALLBACK (icon_index_theme_changed), index);
+    }
+
+  return index;
+}
+
+/* Finds the range of entries starting with @prefix, returns the
+ * number of entries in [*first, *last).
+ */
+static guint
+icon_table_find_prefix (IconTable   *table,
+                        const gchar *prefix,
+                        guint       *first,
+                        guint       *last)
+{
+  gsize len = strlen (prefix);
+  guint lo, hi, mid;
+
+  /* first entry >= prefix */
+  for (lo = 0, hi = table->entries->len; lo < hi;)
+    {
+      mid = lo + (hi - lo) / 2;
+      if (g_ascii_strncasecmp (g_array_index (table->entries, IconEntry, mid).name,
+                               prefix, len) < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  *first = lo;
+
+  /* first entry > prefix */
+  for (hi = table->entries->len; lo < hi;)
+    {
+      mid = lo + (hi - lo) / 2;
+      if (g_ascii_strncasecmp (g_array_index (table->entries, IconEntry, mid).name,
+                               prefix, len) <= 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  *last = lo;
+
+  return *last - *first;
+}
+
+/* Whether the row at @iter of the icons store starts with @key, ignoring
+ * case as the completion does. The range of matching rows is computed
+ * once per key.
+ */
+static gboolean
+icons_store_row_has_prefix (GladeNamedIconChooserDialog *dialog,
+                            GtkTreeIter                 *iter,
+                            const gchar                 *key)
+{
+  GladeNamedIconChooserDialogPrivate *priv = dialog->priv;
+  GtkTreePath *path;
+  guint row;
+
+  if (priv->table == NULL)
+    return FALSE;
+
+  if (g_strcmp0 (priv->search_key, key) != 0)
+    {
+      g_free (priv->search_key);
+      priv->search_key = g_strdup (key);
+      icon_table_find_prefix (priv->table, key, &priv->search_first, &priv->search_last);
+    }
+
+  path = gtk_tree_model_get_path (GTK_TREE_MODEL (priv->icons_store), iter);
+  row = gtk_tree_path_get_indices (path)[0];
+  gtk_tree_path_free (path);
+
+  return row >= priv->search_first && row < priv->search_last;
+}
+
+static void
+cleanup_after_load (GladeNamedIconChooserDialog *dialog)
+{
+  dialog->priv->load_id = 0;
 }
 
 static void
@@ -953,72 +1285,43 @@ chooser_set_model (GladeNamedIconChooserDialog *dialog)
   dialog->priv->icons_loaded = TRUE;
 }
 
-typedef struct
+static void
+icons_table_ready (GladeNamedIconChooserDialog *dialog, IconTable *table)
 {
-  gchar *name;
-  gint context;
-} IconData;
+  if (dialog->priv->table)
+    icon_table_unref (dialog->priv->table);
 
-static gint
-icon_data_compare (IconData *a, IconData *b)
-{
-  return g_ascii_strcasecmp (a->name, b->name);
+  dialog->priv->table = icon_table_ref (table);
+  dialog->priv->icons_store = table->store;
+  dialog->priv->index = NULL;
+  g_clear_pointer (&dialog->priv->search_key, g_free);
+
+  chooser_set_model (dialog);
+
+  pending_select_name_process (dialog);
+
+  set_busy_cursor (dialog, FALSE);
 }
 
 static gboolean
 reload_icons (GladeNamedIconChooserDialog *dialog)
 {
-  GtkListStore *store = dialog->priv->icons_store;
-  GtkTreeIter iter;
-  guint i;
-  GList *l, *icons = NULL;
-
-  /* retrieve icon names from each context */
-  for (i = 0; i < G_N_ELEMENTS (standard_contexts); i++)
-    {
-
-      GList *icons_in_context =
-          gtk_icon_theme_list_icons (dialog->priv->icon_theme,
-                                     standard_contexts[i].name);
-
-      for (l = icons_in_context; l; l = l->next)
-        {
-
-          IconData *data = g_slice_new (IconData);
+  GtkIconTheme *theme = dialog->priv->icon_theme;
+  IconIndex *index = icon_index_get (theme);
 
-          data->name = (gchar *) l->data;
-          data->context = i;
-
-          icons = g_list_prepend (icons, data);
-        }
-
-      g_list_free (icons_in_context);
-    }
-
-  /* sort icon names */
-  icons = g_list_sort (icons, (GCompareFunc) icon_data_compare);
-
-  /* put into to model */
-  for (l = icons; l; l = l->next)
+  if (index->table)
+    icons_table_ready (dialog, index->table);
+  else
     {
+      if (!g_list_find (index->waiters, dialog))
+        index->waiters = g_list_prepend (index->waiters, dialog);
 
-      IconData *data = (IconData *) l->data;
-
-      gtk_list_store_append (store, &iter);
-      gtk_list_store_set (store, &iter,
-                          ICONS_CONTEXT_COLUMN, data->context,
-                          ICONS_STANDARD_COLUMN,
-                          is_standard_icon_name (data->name), ICONS_NAME_COLUMN,
-                          data->name, -1);
+      dialog->priv->index = index;
 
-      g_free (data->name);
-      g_slice_free (IconData, data);
+      if (!index->loading)
+        icon_index_load (theme, index, GTK_WIDGET (dialog));
     }
 
-  g_list_free (icons);
-
-  chooser_set_model (dialog);
-
   return FALSE;
 }
 
@@ -1029,14 +1332,16 @@ change_icon_theme (GladeNamedIconChooserDialog *dialog)
     dialog->priv->icon_theme = get_icon_theme_for_widget (GTK_WIDGET (dialog));
 
   gtk_tree_view_set_model (GTK_TREE_VIEW (dialog->priv->icons_view), NULL);
-  gtk_list_store_clear (dialog->priv->icons_store);
+  gtk_entry_completion_set_model (dialog->priv->entry_completion, NULL);
+  dialog->priv->filter_model = NULL;
 
   set_busy_cursor (dialog, TRUE);
 
-  dialog->priv->load_id = g_idle_add_full (G_PRIORITY_HIGH_IDLE + 300,
-                                           (GSourceFunc) reload_icons,
-                                           dialog,
-                                           (GDestroyNotify) cleanup_after_load);
+  if (dialog->priv->load_id == 0)
+    dialog->priv->load_id = g_idle_add_full (G_PRIORITY_HIGH_IDLE + 300,
+                                             (GSourceFunc) reload_icons,
+                                             dialog,
+                                             (GDestroyNotify) cleanup_after_load);
 
 }
 
@@ -1199,6 +1504,19 @@ glade_named_icon_chooser_dialog_finalize (GObject *object)
       dialog->priv->pending_select_name = NULL;
     }
 
+  if (dialog->priv->load_id)
+    g_source_remove (dialog->priv->load_id);
+
+  if (dialog->priv->index)
+    {
+      IconIndex *index = dialog->priv->index;
+
+      index->waiters = g_list_remove (index->waiters, dialog);
+    }
+
+  g_clear_pointer (&dialog->priv->table, icon_table_unref);
+  g_free (dialog->priv->search_key);
+
   G_OBJECT_CLASS (glade_named_icon_chooser_dialog_parent_class)->
     finalize (object);
 }
@@ -1416,6 +1734,9 @@ glade_named_icon_chooser_dialog_init (GladeNamedIconChooserDialog *dialog)
                                              FALSE);
   gtk_entry_completion_set_inline_completion (dialog->priv->entry_completion,
                                               TRUE);
+  gtk_entry_completion_set_match_func (dialog->priv->entry_completion,
+                                       (GtkEntryCompletionMatchFunc)
+                                       completion_match_func, dialog, NULL);
 
   gtk_label_set_mnemonic_widget (GTK_LABEL (label), dialog->priv->entry);
 
@@ -1495,11 +1816,7 @@ glade_named_icon_chooser_dialog_init (GladeNamedIconChooserDialog *dialog)
                       0);
   gtk_box_pack_start (GTK_BOX (content_area), contents, TRUE, TRUE, 0);
 
-  /* underlying model */
-  dialog->priv->icons_store = gtk_list_store_new (ICONS_N_COLUMNS,
-                                                  G_TYPE_UINT,
-                                                  G_TYPE_BOOLEAN,
-                                                  G_TYPE_STRING);
+  /* the underlying model is shared, it is set once the icon names are indexed */
 }
 
 static void
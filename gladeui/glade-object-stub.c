@@ -63,17 +63,11 @@ on_infobar_response (GladeObjectStub *stub, gint response_id)
   else if (response_id == RESPONSE_DELETE_ALL)
     {
       GladeProject *project = glade_widget_get_project (gwidget);
-      GList *stubs = NULL;
-      const GList *l;
-
-      for (l = glade_project_get_objects (project); l; l = g_list_next (l))
-        {
-          if (GLADE_IS_OBJECT_STUB (l->data))
-            {
-              GladeWidget *gobj = glade_widget_get_from_gobject (l->data);
-              stubs = g_list_prepend (stubs, gobj);
-            }
-        }
+      GList *stubs, *l;
+
+      stubs = glade_project_list_objects_by_type (project, GLADE_TYPE_OBJECT_STUB);
+      for (l = stubs; l; l = g_list_next (l))
+        l->data = glade_widget_get_from_gobject (l->data);
 
       glade_command_delete (stubs);
       g_list_free (stubs);
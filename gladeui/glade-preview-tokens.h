@@ -7,5 +7,18 @@
 #define QUIT_TOKEN "<quit>\n"
 #define QUIT_TOKEN_SIZE strlen (QUIT_TOKEN)
 
-#endif /* __GLADE_PREVIEW_TOKENS_H__ */
+/* Previewer server protocol, every message starts with a token followed
+ * by the id of the preview window it is meant for, on a line of its own.
+ *
+ * <preview>ID, followed by the toplevel name, file name, css file and
+ *              template flag lines, and then the interface.
+ * <update>ID,  followed by the toplevel name line and then the interface.
+ * <close>ID,   closes a preview window.
+ * <closed>ID,  sent back by the server when the user closes a window.
+ */
+#define SERVER_PREVIEW_TOKEN "<preview>"
+#define SERVER_UPDATE_TOKEN  "<update>"
+#define SERVER_CLOSE_TOKEN   "<close>"
+#define SERVER_CLOSED_TOKEN  "<closed>"
 
+#endif /* __GLADE_PREVIEW_TOKENS_H__ */
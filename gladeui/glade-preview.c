@@ -25,11 +25,11 @@
  * SECTION:glade-preview
  * @Short_Description: The glade preview launch/kill interface.
  *
- * This object owns all data that is needed to keep a preview. It stores
- * the GIOChannel used for comunnication between glade and glade-previewer,
- * the event source id for a watch  (in the case a watch is used to monitor
- * the communication channel), the previewed widget and the pid of the
- * corresponding glade-previewer.
+ * This object owns all data that is needed to keep a preview. Previews
+ * are windows of a single glade-previewer process shared by the whole
+ * glade instance, so that catalogs, types and templates stay loaded
+ * between previews; the preview keeps its id in that process and the
+ * previewed widget.
  * 
  */
 
@@ -56,12 +56,26 @@
 /* Private data for glade-preview */
 struct _GladePreviewPrivate
 {
-  GIOChannel *channel;          /* Channel user for communication between glade and glade-previewer */
-  guint watch;                  /* Event source id used to monitor the channel */
+  guint id;                     /* Id of the preview window in the previewer server */
   GladeWidget *previewed_widget;
-  GPid pid;                     /* Pid of the corresponding glade-previewer process */
+  GPid pid;                     /* Pid of the glade-previewer process hosting the preview */
 };
 
+/* The glade-previewer process hosting every preview window */
+typedef struct
+{
+  GPid pid;
+  GIOChannel *input;            /* Server's standard input, where previews are sent */
+  GIOChannel *output;           /* Server's standard output, where closed windows are reported */
+  guint child_watch;
+  guint output_watch;
+
+  GHashTable *previews;         /* Live previews by id */
+  guint next_id;
+} PreviewServer;
+
+static PreviewServer *server = NULL;
+
 G_DEFINE_TYPE_WITH_PRIVATE (GladePreview, glade_preview, G_TYPE_OBJECT);
 
 enum
@@ -72,29 +86,30 @@ enum
 
 static guint glade_preview_signals[LAST_SIGNAL] = { 0 };
 
-/**
- * glade_preview_kill
- * @preview: a #GladePreview that will be killed.
- *
- * Uses the communication channel and protocol to send the "<quit>" token to the
- * glade-previewer telling it to commit suicide.
- *
- */
 static void
-glade_preview_kill (GladePreview *preview)
+preview_server_write (const gchar *header, const gchar *buffer)
 {
-  const gchar *quit = QUIT_TOKEN;
-  GIOChannel *channel;
+  GIOChannel *channel = server->input;
   GError *error = NULL;
   gsize size;
 
-  channel = preview->priv->channel;
-  g_io_channel_write_chars (channel, quit, strlen (quit), &size, &error);
+  g_io_channel_write_chars (channel, header, strlen (header), &size, &error);
 
-  if (size != strlen (quit) && error != NULL)
+  if (size != strlen (header) && error != NULL)
     {
-      g_warning ("Error passing quit signal trough pipe: %s", error->message);
-      g_error_free (error);
+      g_warning ("Error passing message trough pipe: %s", error->message);
+      g_clear_error (&error);
+    }
+
+  if (buffer)
+    {
+      g_io_channel_write_chars (channel, buffer, strlen (buffer), &size, &error);
+
+      if (size != strlen (buffer) && error != NULL)
+        {
+          g_warning ("Error passing UI trough pipe: %s", error->message);
+          g_clear_error (&error);
+        }
     }
 
   g_io_channel_flush (channel, &error);
@@ -103,13 +118,126 @@ glade_preview_kill (GladePreview *preview)
       g_warning ("Error flushing channel: %s", error->message);
       g_error_free (error);
     }
+}
 
-  g_io_channel_shutdown (channel, TRUE, &error);
-  if (error != NULL)
+/* The preview is gone, stop tracking it and let its owner know */
+static void
+preview_server_preview_exits (guint id)
+{
+  GladePreview *preview;
+
+  if ((preview = g_hash_table_lookup (server->previews, GUINT_TO_POINTER (id))))
+    {
+      g_hash_table_remove (server->previews, GUINT_TO_POINTER (id));
+      g_signal_emit (preview, glade_preview_signals[PREVIEW_EXITS], 0);
+    }
+}
+
+static void
+preview_server_free (PreviewServer *old_server)
+{
+  if (old_server->output_watch)
+    g_source_remove (old_server->output_watch);
+
+  /* Channels close their pipes on unref */
+  g_io_channel_unref (old_server->input);
+  g_io_channel_unref (old_server->output);
+  g_hash_table_destroy (old_server->previews);
+  g_spawn_close_pid (old_server->pid);
+  g_slice_free (PreviewServer, old_server);
+}
+
+static void
+preview_server_watch (GPid pid, gint status, gpointer data)
+{
+  GList *ids, *l;
+
+  /* The server crashed or quit, every preview it hosted is gone */
+  ids = g_hash_table_get_keys (server->previews);
+  for (l = ids; l; l = g_list_next (l))
+    preview_server_preview_exits (GPOINTER_TO_UINT (l->data));
+  g_list_free (ids);
+
+  server->child_watch = 0;
+  preview_server_free (server);
+  server = NULL;
+}
+
+static gboolean
+preview_server_output (GIOChannel *source, GIOCondition condition, gpointer data)
+{
+  gchar *line;
+
+  if (g_io_channel_read_line (source, &line, NULL, NULL, NULL) != G_IO_STATUS_NORMAL)
+    {
+      /* The child watch takes care of the rest */
+      server->output_watch = 0;
+      return FALSE;
+    }
+
+  if (g_str_has_prefix (line, SERVER_CLOSED_TOKEN))
+    preview_server_preview_exits (strtoul (line + strlen (SERVER_CLOSED_TOKEN), NULL, 10));
+
+  g_free (line);
+
+  return TRUE;
+}
+
+static gboolean
+preview_server_ensure (void)
+{
+  gint child_stdin, child_stdout;
+  GError *error = NULL;
+  gchar *argv[3], *executable;
+  GPid pid;
+
+  if (server)
+    return TRUE;
+
+  executable = g_find_program_in_path (GLADE_PREVIEWER);
+
+  argv[0] = executable;
+  argv[1] = "--server";
+  argv[2] = NULL;
+
+  if (g_spawn_async_with_pipes (NULL,
+                                argv,
+                                NULL, G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL,
+                                &pid, &child_stdin, &child_stdout, NULL,
+                                &error) == FALSE)
     {
-      g_warning ("Error shutting down channel: %s", error->message);
+      g_warning (_("Error launching previewer: %s\n"), error->message);
+      glade_util_ui_message (glade_app_get_window (),
+                             GLADE_UI_ERROR, NULL,
+                             _("Failed to launch preview: %s.\n"),
+                             error->message);
       g_error_free (error);
+      g_free (executable);
+      return FALSE;
     }
+
+  server = g_slice_new0 (PreviewServer);
+  server->pid = pid;
+  server->previews = g_hash_table_new (NULL, NULL);
+
+#ifdef G_OS_WIN32
+  server->input = g_io_channel_win32_new_fd (child_stdin);
+  server->output = g_io_channel_win32_new_fd (child_stdout);
+#else
+  server->input = g_io_channel_unix_new (child_stdin);
+  server->output = g_io_channel_unix_new (child_stdout);
+#endif
+
+  g_io_channel_set_close_on_unref (server->input, TRUE);
+  g_io_channel_set_close_on_unref (server->output, TRUE);
+
+  server->output_watch = g_io_add_watch (server->output, G_IO_IN | G_IO_HUP,
+                                         preview_server_output, NULL);
+  server->child_watch = g_child_watch_add (pid, preview_server_watch, NULL);
+
+  g_free (executable);
+
+  return TRUE;
 }
 
 static void
@@ -117,16 +245,15 @@ glade_preview_dispose (GObject *gobject)
 {
   GladePreview *self = GLADE_PREVIEW (gobject);
 
-  if (self->priv->watch)
+  /* Close our window, the server stays around for the next preview */
+  if (server &&
+      g_hash_table_lookup (server->previews, GUINT_TO_POINTER (self->priv->id)) == self)
     {
-      g_source_remove (self->priv->watch);
-      glade_preview_kill (self);
-    }
+      gchar *close = g_strdup_printf ("%s%u\n", SERVER_CLOSE_TOKEN, self->priv->id);
 
-  if (self->priv->channel)
-    {
-      g_io_channel_unref (self->priv->channel);
-      self->priv->channel = NULL;
+      g_hash_table_remove (server->previews, GUINT_TO_POINTER (self->priv->id));
+      preview_server_write (close, NULL);
+      g_free (close);
     }
 
   G_OBJECT_CLASS (glade_preview_parent_class)->dispose (gobject);
@@ -165,21 +292,7 @@ glade_preview_class_init (GladePreviewClass *klass)
 static void
 glade_preview_init (GladePreview *self)
 {
-  GladePreviewPrivate *priv;
-
-  self->priv = priv = glade_preview_get_instance_private (self);
-  priv->channel = NULL;
-}
-
-static void
-glade_preview_internal_watch (GPid pid, gint status, gpointer data)
-{
-  GladePreview *preview = GLADE_PREVIEW (data);
-
-  preview->priv->watch = 0;
-
-  /* This means a preview exited. We'll now signal it */
-  g_signal_emit (preview, glade_preview_signals[PREVIEW_EXITS], 0);
+  self->priv = glade_preview_get_instance_private (self);
 }
 
 /**
@@ -187,7 +300,8 @@ glade_preview_internal_watch (GPid pid, gint status, gpointer data)
  * @widget: Pointer to a local instance of the widget that will be previewed.
  * @buffer: Contents of an xml definition of the interface which will be previewed
  *
- * Creates a new #GladePreview and launches glade-previewer to preview it.
+ * Creates a new #GladePreview and shows it in a new window of the
+ * glade-previewer process, launching it first if it is not running.
  *
  * Returns: a new #GladePreview or NULL if launch fails.
  * 
@@ -195,98 +309,39 @@ glade_preview_internal_watch (GPid pid, gint status, gpointer data)
 GladePreview *
 glade_preview_launch (GladeWidget *widget, const gchar *buffer)
 {
-  GPid pid;
-  GError *error = NULL;
-  gchar *argv[10], *executable;
-  gint child_stdin;
-  gsize bytes_written;
-  GIOChannel *output;
   GladePreview *preview = NULL;
   const gchar *css_provider, *filename;
   GladeProject *project;
-  gchar *name;
-  gint i;
+  gchar *header, *name;
 
   g_return_val_if_fail (GLADE_IS_WIDGET (widget), NULL);
 
-  executable = g_find_program_in_path (GLADE_PREVIEWER);
+  if (!preview_server_ensure ())
+    return NULL;
 
   project = glade_widget_get_project (widget);
   filename = glade_project_get_path (project);
   name = (filename) ? NULL : glade_project_get_name (project);
-  
-  argv[0] = executable;
-  argv[1] = "--listen";
-  argv[2] = "--toplevel";
-  argv[3] = (gchar *) glade_widget_get_name (widget);
-  argv[4] = "--filename";
-  argv[5] = (filename) ? (gchar *) filename : name;
-
-  i = 5;
-  if (glade_project_get_template (project))
-    argv[++i] = "--template";
-    
-  argv[++i] = NULL;
-
-  css_provider = glade_project_get_css_provider_path (glade_widget_get_project (widget));
-  if (css_provider)
-    {
-      argv[i] = "--css";
-      argv[++i] = (gchar *) css_provider;
-      argv[++i] = NULL;
-    }
-  
-  if (g_spawn_async_with_pipes (NULL,
-                                argv,
-                                NULL, G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL,
-                                &pid, &child_stdin, NULL, NULL,
-                                &error) == FALSE)
-    {
-      g_warning (_("Error launching previewer: %s\n"), error->message);
-      glade_util_ui_message (glade_app_get_window (),
-                             GLADE_UI_ERROR, NULL,
-                             _("Failed to launch preview: %s.\n"),
-                             error->message);
-      g_error_free (error);
-      g_free (executable);
-      g_free (name);
-      return NULL;
-    }
-
-#ifdef G_OS_WIN32
-  output = g_io_channel_win32_new_fd (child_stdin);
-#else
-  output = g_io_channel_unix_new (child_stdin);
-#endif
-
-  g_io_channel_write_chars (output, buffer, strlen (buffer), &bytes_written,
-                            &error);
-
-  if (bytes_written != strlen (buffer) && error != NULL)
-    {
-      g_warning ("Error passing UI trough pipe: %s", error->message);
-      g_error_free (error);
-    }
-
-  g_io_channel_flush (output, &error);
-  if (error != NULL)
-    {
-      g_warning ("Error flushing UI trough pipe: %s", error->message);
-      g_error_free (error);
-    }
+  css_provider = glade_project_get_css_provider_path (project);
 
   /* Setting up preview data */
   preview                         = g_object_new (GLADE_TYPE_PREVIEW, NULL);
-  preview->priv->channel          = output;
+  preview->priv->id               = ++server->next_id;
   preview->priv->previewed_widget = widget;
-  preview->priv->pid              = pid;
+  preview->priv->pid              = server->pid;
 
-  preview->priv->watch = 
-    g_child_watch_add (preview->priv->pid,
-		       glade_preview_internal_watch,
-		       preview);
+  g_hash_table_insert (server->previews, GUINT_TO_POINTER (preview->priv->id), preview);
 
-  g_free (executable);
+  header = g_strdup_printf ("%s%u\n%s\n%s\n%s\n%d\n",
+                            SERVER_PREVIEW_TOKEN, preview->priv->id,
+                            glade_widget_get_name (widget),
+                            (filename) ? filename : name,
+                            (css_provider) ? css_provider : "",
+                            glade_project_get_template (project) != NULL);
+
+  preview_server_write (header, buffer);
+
+  g_free (header);
   g_free (name);
 
   return preview;
@@ -295,54 +350,18 @@ glade_preview_launch (GladeWidget *widget, const gchar *buffer)
 void
 glade_preview_update (GladePreview *preview, const gchar  *buffer)
 {
-  const gchar *update_token = UPDATE_TOKEN;
   gchar *update;
-  GIOChannel *channel;
-  GError *error = NULL;
-  gsize size;
-  gsize bytes_written;
-  GladeWidget *gwidget;
 
   g_return_if_fail (GLADE_IS_PREVIEW (preview));
   g_return_if_fail (buffer && buffer[0]);
 
-  gwidget = glade_preview_get_widget (preview);
-
-  update = g_strdup_printf ("%s%s\n", update_token,
-                            glade_widget_get_name (gwidget));
+  if (!server)
+    return;
 
-  channel = preview->priv->channel;
-  g_io_channel_write_chars (channel, update, strlen (update), &size, &error);
+  update = g_strdup_printf ("%s%u\n%s\n", SERVER_UPDATE_TOKEN, preview->priv->id,
+                            glade_widget_get_name (preview->priv->previewed_widget));
 
-  if (size != strlen (update) && error != NULL)
-    {
-      g_warning ("Error passing quit signal trough pipe: %s", error->message);
-      g_error_free (error);
-    }
-
-  g_io_channel_flush (channel, &error);
-  if (error != NULL)
-    {
-      g_warning ("Error flushing channel: %s", error->message);
-      g_error_free (error);
-    }
-
-  /* We'll now send the interface: */
-  g_io_channel_write_chars (channel, buffer, strlen (buffer), &bytes_written,
-                            &error);
-
-  if (bytes_written != strlen (buffer) && error != NULL)
-    {
-      g_warning ("Error passing UI trough pipe: %s", error->message);
-      g_error_free (error);
-    }
-
-  g_io_channel_flush (channel, &error);
-  if (error != NULL)
-    {
-      g_warning ("Error flushing UI trough pipe: %s", error->message);
-      g_error_free (error);
-    }
+  preview_server_write (update, buffer);
 
   g_free (update);
 }
@@ -354,6 +373,13 @@ glade_preview_get_widget (GladePreview *preview)
   return preview->priv->previewed_widget;
 }
 
+/**
+ * glade_preview_get_pid:
+ * @preview: a #GladePreview
+ *
+ * Returns: the pid of the glade-previewer process hosting @preview,
+ *          which is shared by every preview.
+ */
 GPid
 glade_preview_get_pid (GladePreview *preview)
 {
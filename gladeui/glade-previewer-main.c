@@ -37,6 +37,9 @@ typedef struct
   GladePreviewer *preview;
   gchar *file_name, *toplevel;
   gboolean is_template;
+
+  guint id;             /* Preview id when running as a server */
+  gboolean shown;       /* Whether a widget was ever set on preview */
 } GladePreviewerApp;
 
 static GObject *
@@ -67,7 +70,7 @@ get_toplevel (GtkBuilder *builder, gchar *name)
       if (toplevel == NULL)
         {
           g_printerr (_("UI definition has no previewable widgets.\n"));
-          exit (1);
+          return NULL;
         }
     }
   else
@@ -77,13 +80,13 @@ get_toplevel (GtkBuilder *builder, gchar *name)
       if (object == NULL)
         {
           g_printerr (_("Object %s not found in UI definition.\n"), name);
-          exit (1);
+          return NULL;
         }
 
       if (!GTK_IS_WIDGET (object))
         {
           g_printerr (_("Object is not previewable.\n"));
-          exit (1);
+          return NULL;
         }
 
       toplevel = object;
@@ -163,22 +166,58 @@ get_toplevel_from_string (GladePreviewerApp *app, gchar *name, gchar *string, gs
   return retval;
 }
 
-static gchar *
-read_buffer (GIOChannel * source)
+static gboolean
+read_line (GIOChannel *source, gchar **line)
 {
-  gchar *buffer;
-  gchar *token;
-  gchar *tmp;
   GError *error = NULL;
 
-  if (g_io_channel_read_line (source, &token, NULL, NULL, &error) !=
+  *line = NULL;
+
+  if (g_io_channel_read_line (source, line, NULL, NULL, &error) ==
       G_IO_STATUS_NORMAL)
+    return TRUE;
+
+  g_clear_pointer (line, g_free);
+
+  if (error)
     {
       g_printerr (_("Error: %s.\n"), error->message);
       g_error_free (error);
-      exit (1);
     }
 
+  return FALSE;
+}
+
+/* Appends lines to @buffer up to the end of the UI definition */
+static gboolean
+read_interface (GIOChannel *source, GString *buffer)
+{
+  gboolean done;
+  gchar *line;
+
+  do
+    {
+      if (!read_line (source, &line))
+        return FALSE;
+
+      g_string_append (buffer, line);
+      done = (g_strcmp0 ("</interface>\n", line) == 0);
+      g_free (line);
+    }
+  while (!done);
+
+  return TRUE;
+}
+
+static gchar *
+read_buffer (GIOChannel * source)
+{
+  GString *buffer;
+  gchar *token;
+
+  if (!read_line (source, &token))
+    exit (1);
+
   /* Check for quit token */
   if (g_strcmp0 (QUIT_TOKEN, token) == 0)
     {
@@ -187,25 +226,13 @@ read_buffer (GIOChannel * source)
     }
 
   /* Loop to load the UI */
-  buffer = g_strdup (token);
-  do
-    {
-      g_free (token);
-      if (g_io_channel_read_line (source, &token, NULL, NULL, &error) !=
-          G_IO_STATUS_NORMAL)
-        {
-          g_printerr (_("Error: %s.\n"), error->message);
-          g_error_free (error);
-          exit (1);
-        }
-      tmp = buffer;
-      buffer = g_strconcat (buffer, token, NULL);
-      g_free (tmp);
-    }
-  while (g_strcmp0 ("</interface>\n", token) != 0);
+  buffer = g_string_new (token);
   g_free (token);
 
-  return buffer;
+  if (!read_interface (source, buffer))
+    exit (1);
+
+  return g_string_free (buffer, FALSE);
 }
 
 static gboolean
@@ -266,8 +293,8 @@ glade_previewer_app_new (gchar *filename, gchar *toplevel)
 {
   GladePreviewerApp *app = g_new0 (GladePreviewerApp, 1);
 
+  /* GladePreviewer is a plain GObject, we own the only reference */
   app->preview = GLADE_PREVIEWER (glade_previewer_new ());
-  g_object_ref_sink (app->preview);
 
   app->file_name = g_strdup (filename);
   app->toplevel = g_strdup (toplevel);
@@ -284,7 +311,143 @@ glade_previewer_free (GladePreviewerApp *app)
   g_free (app);
 }
 
+/* Preview windows hosted by the server, by id */
+static GHashTable *server_previews = NULL;
+
+static void
+on_server_preview_closed (GladePreviewer *preview, GladePreviewerApp *app)
+{
+  /* Let glade know, it will not send anything else for this id */
+  g_print ("%s%u\n", SERVER_CLOSED_TOKEN, app->id);
+  fflush (stdout);
+
+  g_hash_table_remove (server_previews, GUINT_TO_POINTER (app->id));
+}
+
+static void
+server_preview_show (GladePreviewerApp *app, gchar *toplevel, GString *buffer)
+{
+  GObject *widget;
+
+  if ((widget = get_toplevel_from_string (app, toplevel, buffer->str, buffer->len)))
+    {
+      glade_previewer_set_widget (app->preview, GTK_WIDGET (widget));
+      gtk_widget_show (GTK_WIDGET (widget));
+      g_object_unref (widget);
+
+      glade_previewer_present (app->preview);
+      app->shown = TRUE;
+    }
+  else if (!app->shown)
+    {
+      /* Nothing to show, drop it so glade can launch it again */
+      on_server_preview_closed (app->preview, app);
+    }
+}
+
+static gchar *
+read_server_line (GIOChannel *source)
+{
+  gchar *line;
+
+  return read_line (source, &line) ? g_strchomp (line) : NULL;
+}
+
+/* Reads the next message from glade, the process keeps catalogs,
+ * types and templates loaded between previews.
+ */
+static gboolean
+on_server_data_incoming (GIOChannel *source, GIOCondition condition, gpointer data)
+{
+  GladePreviewerApp *app = NULL;
+  gchar *token, *toplevel = NULL;
+  GString *buffer;
+  guint id;
+
+  /* Glade went away or asked us to quit */
+  if (!read_line (source, &token) || g_strcmp0 (QUIT_TOKEN, token) == 0)
+    {
+      g_free (token);
+      gtk_main_quit ();
+      return FALSE;
+    }
+
+  g_strchomp (token);
+
+  if (g_str_has_prefix (token, SERVER_CLOSE_TOKEN))
+    {
+      id = strtoul (token + strlen (SERVER_CLOSE_TOKEN), NULL, 10);
+      g_hash_table_remove (server_previews, GUINT_TO_POINTER (id));
+      g_free (token);
+      return TRUE;
+    }
+  else if (g_str_has_prefix (token, SERVER_PREVIEW_TOKEN))
+    {
+      gchar *file_name, *css_file_name, *is_template;
+
+      id = strtoul (token + strlen (SERVER_PREVIEW_TOKEN), NULL, 10);
+
+      toplevel = read_server_line (source);
+      file_name = read_server_line (source);
+      css_file_name = read_server_line (source);
+      is_template = read_server_line (source);
+
+      if (is_template)
+        {
+          app = glade_previewer_app_new (file_name[0] ? file_name : NULL, toplevel);
+          app->id = id;
+          app->is_template = (g_strcmp0 (is_template, "1") == 0);
+
+          if (css_file_name[0])
+            glade_previewer_set_css_file (app->preview, css_file_name);
+
+          g_signal_connect (app->preview, "closed",
+                            G_CALLBACK (on_server_preview_closed), app);
+
+          g_hash_table_insert (server_previews, GUINT_TO_POINTER (id), app);
+        }
+
+      g_free (file_name);
+      g_free (css_file_name);
+      g_free (is_template);
+    }
+  else if (g_str_has_prefix (token, SERVER_UPDATE_TOKEN))
+    {
+      id = strtoul (token + strlen (SERVER_UPDATE_TOKEN), NULL, 10);
+
+      /* The window might have been closed meanwhile */
+      toplevel = read_server_line (source);
+      app = g_hash_table_lookup (server_previews, GUINT_TO_POINTER (id));
+    }
+  else
+    {
+      g_free (token);
+      return TRUE;
+    }
+
+  g_free (token);
+
+  buffer = g_string_new (NULL);
+
+  if (toplevel == NULL || !read_interface (source, buffer))
+    {
+      g_string_free (buffer, TRUE);
+      g_free (toplevel);
+      gtk_main_quit ();
+      return FALSE;
+    }
+
+  if (app)
+    server_preview_show (app, toplevel, buffer);
+
+  g_string_free (buffer, TRUE);
+  g_free (toplevel);
+
+  return TRUE;
+}
+
 static gboolean listen = FALSE;
+static gboolean server = FALSE;
 static gboolean version = FALSE;
 static gboolean slideshow = FALSE;
 static gboolean template = FALSE;
@@ -302,6 +465,7 @@ static GOptionEntry option_entries[] =
     {"screenshot", 0, 0, G_OPTION_ARG_FILENAME, &screenshot_file_name, N_("File name to save a screenshot"), NULL},
     {"css", 0, 0, G_OPTION_ARG_FILENAME, &css_file_name, N_("CSS file to use"), NULL},
     {"listen", 'l', 0, G_OPTION_ARG_NONE, &listen, N_("Listen standard input"), NULL},
+    {"server", 0, 0, G_OPTION_ARG_NONE, &server, N_("Host every preview window of a glade instance, listening standard input"), NULL},
     {"slideshow", 0, 0, G_OPTION_ARG_NONE, &slideshow, N_("make a slideshow of every toplevel widget by adding them in a GtkStack"), NULL},
     {"print-handler", 0, 0, G_OPTION_ARG_NONE, &print_handler, N_("Print handlers signature on invocation"), NULL},
     {"version", 'v', 0, G_OPTION_ARG_NONE, &version, N_("Display previewer version"), NULL},
@@ -344,7 +508,7 @@ main (int argc, char **argv)
       return 0;
     }
 
-  if (!listen && !file_name)
+  if (!listen && !server && !file_name)
     {
       g_printerr (_("Either --listen or --filename must be specified.\n"));
       return 0;
@@ -353,8 +517,32 @@ main (int argc, char **argv)
   gtk_init (&argc, &argv);
   glade_app_get ();
 
+  if (server)
+    {
+#ifdef WINDOWS
+      GIOChannel *input = g_io_channel_win32_new_fd (fileno (stdin));
+#else
+      GIOChannel *input = g_io_channel_unix_new (fileno (stdin));
+#endif
+
+      server_previews = g_hash_table_new_full (NULL, NULL, NULL,
+                                               (GDestroyNotify) glade_previewer_free);
+
+      g_io_add_watch (input, G_IO_IN | G_IO_HUP, on_server_data_incoming, NULL);
+
+      gtk_main ();
+
+      g_hash_table_destroy (server_previews);
+      g_io_channel_unref (input);
+
+      return 0;
+    }
+
   app = glade_previewer_app_new (file_name, toplevel_name);
 
+  /* There is only one window, closing it quits */
+  g_signal_connect (app->preview, "closed", G_CALLBACK (gtk_main_quit), NULL);
+
   app->is_template = template;
 
   if (print_handler)
@@ -412,10 +600,10 @@ main (int argc, char **argv)
 
           g_slist_free (objects);
         }
+      else if ((toplevel = get_toplevel (builder, toplevel_name)) == NULL)
+        return 1;
       else
         {
-          toplevel = get_toplevel (builder, toplevel_name);
-
           gtk_builder_connect_signals_full (builder,
                                             glade_previewer_connect_function,
                                             app->preview);
@@ -46,6 +46,14 @@ struct _GladePreviewerPrivate
 
 G_DEFINE_TYPE_WITH_PRIVATE (GladePreviewer, glade_previewer, G_TYPE_OBJECT);
 
+enum
+{
+  CLOSED,
+  LAST_SIGNAL
+};
+
+static guint glade_previewer_signals[LAST_SIGNAL] = { 0 };
+
 static void
 glade_previewer_init (GladePreviewer *preview)
 {
@@ -62,7 +70,15 @@ glade_previewer_dispose (GObject *object)
   g_list_free (priv->objects);
   
   priv->objects = NULL;
-  priv->dialog = NULL;
+
+  /* Windows are owned by GTK+, a server may free previews at any time */
+  g_clear_pointer (&priv->dialog, gtk_widget_destroy);
+  g_clear_pointer (&priv->widget, gtk_widget_destroy);
+  priv->textview = NULL;
+
+  if (priv->css_provider)
+    gtk_style_context_remove_provider_for_screen (gdk_screen_get_default (),
+                                                  GTK_STYLE_PROVIDER (priv->css_provider));
   g_clear_object (&priv->css_provider);
   g_clear_object (&priv->css_monitor);
 
@@ -154,6 +170,19 @@ glade_previewer_class_init (GladePreviewerClass *klass)
 
   object_class->dispose = glade_previewer_dispose;
   object_class->finalize = glade_previewer_finalize;
+
+  /**
+   * GladePreviewer::closed:
+   * @preview: the #GladePreviewer which received the signal.
+   *
+   * Emitted when the user closes the preview window.
+   */
+  glade_previewer_signals[CLOSED] =
+      g_signal_new ("closed",
+                    G_TYPE_FROM_CLASS (object_class),
+                    G_SIGNAL_RUN_LAST,
+                    0, NULL, NULL,
+                    g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 }
 
 GObject *
@@ -169,6 +198,21 @@ glade_previewer_present (GladePreviewer *preview)
   gtk_window_present (GTK_WINDOW (preview->priv->widget));
 }
 
+static gboolean
+on_widget_delete_event (GtkWidget      *widget,
+                        GdkEvent       *event,
+                        GladePreviewer *preview)
+{
+  /* Whoever owns the preview decides what closing it means,
+   * handlers might as well free it.
+   */
+  g_object_ref (preview);
+  g_signal_emit (preview, glade_previewer_signals[CLOSED], 0);
+  g_object_unref (preview);
+
+  return TRUE;
+}
+
 void
 glade_previewer_set_widget (GladePreviewer *preview, GtkWidget *widget)
 {
@@ -180,6 +224,8 @@ glade_previewer_set_widget (GladePreviewer *preview, GtkWidget *widget)
 
   priv = preview->priv;
 
+  /* The log dialog goes away with the widget it is transient for */
+  g_clear_pointer (&priv->dialog, gtk_widget_destroy);
   if (priv->widget)
     gtk_widget_destroy (priv->widget);
 
@@ -216,10 +262,10 @@ glade_previewer_set_widget (GladePreviewer *preview, GtkWidget *widget)
                     G_CALLBACK (gtk_widget_hide),
                     NULL);
 
-  /* Quit on delete event */
-  g_signal_connect (priv->widget, "delete-event",
-                    G_CALLBACK (gtk_main_quit),
-                    NULL);
+  /* Let the owner know on delete event */
+  g_signal_connect_object (priv->widget, "delete-event",
+                           G_CALLBACK (on_widget_delete_event),
+                           preview, 0);
 
   /* Make sure we get press events */
   gtk_widget_add_events (priv->widget, GDK_KEY_PRESS_MASK);
@@ -35,13 +35,78 @@ G_BEGIN_DECLS
 
 /* glade-widget.c */
 
-GList *_glade_widget_peek_prop_refs (GladeWidget *widget);
+GList    *_glade_widget_peek_prop_refs (GladeWidget        *widget);
+gboolean  _glade_widget_is_rebuilding  (GladeWidget        *widget);
+void      _glade_widget_read_packing   (GladeWidget        *widget,
+                                        GladeWidgetAdaptor *container,
+                                        GladeXmlNode       *node);
 
-/* glade-catalog.c */
+/* glade-signal.c */
+
+void      _glade_signal_share_strings  (GladeSignal        *signal,
+                                        GHashTable         *strings);
+
+/* glade-property.c */
+
+const GValue *_glade_property_peek_value (GladeProperty *property);
+
+/* glade-clipboard.c */
 
-GladeCatalog *_glade_catalog_get_catalog (const gchar *name);
-GList        *_glade_catalog_tsort       (GList *catalogs);
+gchar *_glade_clipboard_write_fragment (GList        *widgets);
+GList *_glade_clipboard_read_fragment  (const gchar  *fragment,
+                                        GladeProject *project);
+
+/* glade-displayable-values.c */
+
+gboolean     _glade_enum_value_lookup   (GType        type,
+                                         const gchar *string,
+                                         gint        *value);
+const gchar *_glade_enum_value_get_nick (GType        type,
+                                         gint         value);
+gboolean     _glade_flags_value_lookup  (GType        type,
+                                         const gchar *string,
+                                         guint       *value);
+
+/* glade-catalog.c */
 
+GladeCatalog *_glade_catalog_get_catalog          (const gchar        *name);
+GList        *_glade_catalog_tsort                (GList              *catalogs);
+const gchar  *_glade_catalog_get_search_key       (GladeWidgetAdaptor *adaptor);
+gchar        *_glade_catalog_normalize_search_key (const gchar        *text);
+
+
+/* glade-project.c */
+
+GdkPixbuf *_glade_project_load_pixbuf (GladeProject *project,
+                                       const gchar  *filename);
+void       _glade_project_watch_pixbuf (GladeProject  *project,
+                                        GladeProperty *property);
+
+GList     *_glade_project_peek_undo_stack (GladeProject *project);
+GHashTable *_glade_project_get_signal_strings (GladeProject *project);
+
+void      _glade_project_push_deferral (GladeProject  *project);
+void      _glade_project_pop_deferral  (GladeProject  *project);
+gboolean  _glade_project_defer_verify  (GladeProject  *project,
+                                        GladeProperty *property,
+                                        gboolean       warn_before);
+gboolean  _glade_project_defer_rebuild (GladeProject  *project,
+                                        GladeWidget   *widget);
+void      _glade_project_invalidate_verify (GladeProject *project,
+                                            GladeWidget  *widget);
+void      _glade_project_begin_fragment_load (GladeProject *project);
+void      _glade_project_end_fragment_load   (GladeProject *project);
+
+void      _glade_project_replace_object (GladeProject *project,
+                                         GladeWidget  *old_widget,
+                                         GObject      *old_object,
+                                         GObject      *new_object);
+guint     _glade_project_get_toplevel_order (GladeProject *project,
+                                             GObject      *object);
+void      _glade_project_foreach_object_of_type (GladeProject *project,
+                                                 GType         type,
+                                                 GFunc         func,
+                                                 gpointer      user_data);
 
 /* glade-project-properties.c */
 void
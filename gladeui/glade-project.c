@@ -42,6 +42,7 @@
 #include "gladeui-enum-types.h"
 #include "glade-widget.h"
 #include "glade-id-allocator.h"
+#include "glade-image-cache.h"
 #include "glade-app.h"
 #include "glade-marshallers.h"
 #include "glade-catalog.h"
@@ -76,6 +77,9 @@ static void     glade_project_set_readonly          (GladeProject       *project
 static void     glade_project_set_modified          (GladeProject       *project,
 						     gboolean            modified);
 
+static void     glade_project_image_cache_ready     (GladeImageCache    *cache,
+						     const gchar        *fullpath,
+						     gpointer            user_data);
 static void     glade_project_model_iface_init      (GtkTreeModelIface  *iface);
 
 static void     glade_project_drag_source_init      (GtkTreeDragSourceIface *iface);
@@ -91,15 +95,19 @@ struct _GladeProjectPrivate
   GladeWidgetAdaptor *add_item; /* The next item to add to the project. */
 
   GList *tree;                  /* List of toplevel Objects in this projects */
+  GHashTable *tree_order;       /* Toplevel Objects -> increasing keys in tree order */
+  guint tree_serial;            /* The last key given to a toplevel */
   GList *objects;               /* List of all objects in this project */
+  GHashTable *type_index;       /* GType -> TypeBucket of the objects of exactly that type */
   GtkTreeModel *model;          /* GtkTreeStore used as proxy model */
 
-  GList *selection;             /* We need to keep the selection in the project
+  GQueue selection;             /* We need to keep the selection in the project
                                  * because we have multiple projects and when the
                                  * user switchs between them, he will probably
-                                 * not want to loose the selection. This is a list
-                                 * of #GtkWidget items.
+                                 * not want to loose the selection. This is a queue
+                                 * of #GtkWidget items, the last selected first.
                                  */
+  GHashTable *selection_set;    /* Selected objects -> their link in the selection queue */
   guint selection_changed_id;
 
   GladeNameContext *widget_names; /* Context for uniqueness of names */
@@ -108,6 +116,19 @@ struct _GladeProjectPrivate
   GList *undo_stack;            /* A stack with the last executed commands */
   GList *prev_redo_item;        /* Points to the item previous to the redo items */
 
+  gint deferral_depth;          /* Verification is deferred while this is > 0 */
+  GHashTable *deferred_properties; /* Changed properties -> warning state before the change */
+  GHashTable *deferred_widgets;    /* The widgets owning them */
+  GHashTable *deferred_rebuilds;   /* Widgets to rebuild when the scope ends */
+
+  GHashTable *verify_results;   /* GladeWidget -> VerifyResult, widgets changed since
+                                 * they were last verified have none */
+  GHashTable *adaptor_support;  /* GladeWidgetAdaptor -> AdaptorSupport for the
+                                 * current target versions */
+
+  GHashTable *signal_strings;   /* Handler and user data strings shared by the
+                                 * signals of the project's widgets */
+
   GList *first_modification;    /* we record the first modification, so that we
                                  * can set "modification" to FALSE when we
                                  * undo this modification
@@ -130,6 +151,10 @@ struct _GladeProjectPrivate
                                  * (full or relative path, null means project directory).
                                  */
 
+  GladeImageCache *image_cache; /* Decoded images for GdkPixbuf properties */
+  GHashTable *pending_pixbufs;  /* Image path -> GPtrArray of the properties
+                                 * holding a placeholder for it */
+
   gchar *css_provider_path;     /* The custom css to use for this project */
   GtkCssProvider *css_provider;
   GFileMonitor *css_monitor;
@@ -138,7 +163,7 @@ struct _GladeProjectPrivate
 
   GtkWidget *prefs_dialog;
 
-  /* Store previews, so we can kill them on close */
+  /* Store previews by previewed toplevel, so we can kill them on close */
   GHashTable *previews;
 
   /* For the loading progress bars ("load-progress" signal) */
@@ -166,6 +191,24 @@ typedef struct
   gint position;
 } CatalogInfo;
 
+typedef struct
+{
+  GladeVerifyFlags flags;  /* The flags the report was generated for */
+  gchar           *report; /* NULL if the widget has nothing to report */
+} VerifyResult;
+
+typedef struct
+{
+  GladeSupportMask mask;
+  gchar           *warning;
+} AdaptorSupport;
+
+typedef struct
+{
+  GQueue      objects; /* Objects of one type, the last added first */
+  GHashTable *links;   /* Objects -> their link in the queue */
+} TypeBucket;
+
 
 enum
 {
@@ -220,6 +263,57 @@ G_DEFINE_TYPE_WITH_CODE (GladeProject, glade_project, G_TYPE_OBJECT,
                                                 glade_project_drag_source_init))
 
 
+/*******************************************************************
+                            Type index
+ *******************************************************************/
+static void
+type_bucket_free (TypeBucket *bucket)
+{
+  g_queue_clear (&bucket->objects);
+  g_hash_table_destroy (bucket->links);
+  g_slice_free (TypeBucket, bucket);
+}
+
+static void
+glade_project_index_object (GladeProject *project, GObject *object)
+{
+  GHashTable *index = project->priv->type_index;
+  GType type = G_OBJECT_TYPE (object);
+  TypeBucket *bucket;
+
+  if ((bucket = g_hash_table_lookup (index, GSIZE_TO_POINTER (type))) == NULL)
+    {
+      bucket = g_slice_new0 (TypeBucket);
+      bucket->links = g_hash_table_new (NULL, NULL);
+      g_hash_table_insert (index, GSIZE_TO_POINTER (type), bucket);
+    }
+
+  if (!g_hash_table_contains (bucket->links, object))
+    {
+      g_queue_push_head (&bucket->objects, object);
+      g_hash_table_insert (bucket->links, object, bucket->objects.head);
+    }
+}
+
+static void
+glade_project_unindex_object (GladeProject *project, GObject *object)
+{
+  GHashTable *index = project->priv->type_index;
+  GType type = G_OBJECT_TYPE (object);
+  TypeBucket *bucket;
+  GList *link;
+
+  if ((bucket = g_hash_table_lookup (index, GSIZE_TO_POINTER (type))) == NULL ||
+      (link = g_hash_table_lookup (bucket->links, object)) == NULL)
+    return;
+
+  g_hash_table_remove (bucket->links, object);
+  g_queue_delete_link (&bucket->objects, link);
+
+  if (g_queue_is_empty (&bucket->objects))
+    g_hash_table_remove (index, GSIZE_TO_POINTER (type));
+}
+
 /*******************************************************************
                             GObjectClass
  *******************************************************************/
@@ -289,10 +383,21 @@ glade_project_dispose (GObject *object)
 
   g_clear_object (&priv->css_provider);
   g_clear_object (&priv->css_monitor);
+
+  if (priv->image_cache)
+    {
+      glade_image_cache_destroy (priv->image_cache);
+      priv->image_cache = NULL;
+    }
+  g_hash_table_remove_all (priv->pending_pixbufs);
   
   glade_project_list_unref (priv->undo_stack);
   priv->undo_stack = NULL;
 
+  g_hash_table_remove_all (priv->deferred_properties);
+  g_hash_table_remove_all (priv->deferred_widgets);
+  g_hash_table_remove_all (priv->deferred_rebuilds);
+
   /* Remove objects from the project */
   tree = g_list_copy (priv->tree);
   for (list = tree; list; list = list->next)
@@ -354,6 +459,18 @@ glade_project_finalize (GObject *object)
     glade_id_allocator_release (get_unsaved_number_allocator (),
                                 priv->unsaved_number);
 
+  g_hash_table_destroy (priv->selection_set);
+  g_hash_table_destroy (priv->tree_order);
+  g_hash_table_destroy (priv->type_index);
+  g_hash_table_destroy (priv->deferred_properties);
+  g_hash_table_destroy (priv->deferred_widgets);
+  g_hash_table_destroy (priv->deferred_rebuilds);
+  g_hash_table_destroy (priv->verify_results);
+  g_hash_table_destroy (priv->adaptor_support);
+  g_hash_table_destroy (priv->pending_pixbufs);
+
+  /* Signals still alive keep their own reference */
+  g_hash_table_unref (priv->signal_strings);
   g_hash_table_destroy (priv->target_versions_major);
   g_hash_table_destroy (priv->target_versions_minor);
 
@@ -469,6 +586,8 @@ glade_project_undo_impl (GladeProject *project)
 {
   GladeCommand *cmd, *next_cmd;
 
+  _glade_project_push_deferral (project);
+
   while ((cmd = glade_project_next_undo_item (project)) != NULL)
     {
       glade_command_undo (cmd);
@@ -483,6 +602,8 @@ glade_project_undo_impl (GladeProject *project)
            glade_command_group_id (next_cmd) != glade_command_group_id (cmd)))
         break;
     }
+
+  _glade_project_pop_deferral (project);
 }
 
 static void
@@ -490,6 +611,8 @@ glade_project_redo_impl (GladeProject *project)
 {
   GladeCommand *cmd, *next_cmd;
 
+  _glade_project_push_deferral (project);
+
   while ((cmd = glade_project_next_redo_item (project)) != NULL)
     {
       glade_command_execute (cmd);
@@ -504,6 +627,8 @@ glade_project_redo_impl (GladeProject *project)
            glade_command_group_id (next_cmd) != glade_command_group_id (cmd)))
         break;
     }
+
+  _glade_project_pop_deferral (project);
 }
 
 static GladeCommand *
@@ -605,38 +730,19 @@ glade_project_push_undo_impl (GladeProject *project, GladeCommand *cmd)
                  glade_project_signals[CHANGED], 0, cmd, TRUE);
 }
 
-static inline gchar *
-glade_preview_get_pid_as_str (GladePreview *preview)
-{
-#ifdef G_OS_WIN32
-  return g_strdup_printf ("%p", glade_preview_get_pid (preview));
-#else
-  return g_strdup_printf ("%d", glade_preview_get_pid (preview));
-#endif
-}
-
+/* Every preview runs in the same previewer process, so they are
+ * tracked by toplevel rather than by pid.
+ */
 static void
 glade_project_preview_exits (GladePreview *preview, GladeProject *project)
 {
-  gchar       *pidstr;
-
-  pidstr  = glade_preview_get_pid_as_str (preview);
-  preview = g_hash_table_lookup (project->priv->previews, pidstr);
-
-  if (preview)
-    g_hash_table_remove (project->priv->previews, pidstr);
-
-  g_free (pidstr);
+  g_hash_table_remove (project->priv->previews, glade_preview_get_widget (preview));
 }
 
 static void
 glade_project_destroy_preview (gpointer data)
 {
   GladePreview *preview = GLADE_PREVIEW (data);
-  GladeWidget  *gwidget;
-
-  gwidget = glade_preview_get_widget (preview);
-  g_object_set_data (G_OBJECT (gwidget), "preview", NULL);
 
   g_signal_handlers_disconnect_by_func (preview,
                                         G_CALLBACK (glade_project_preview_exits),
@@ -662,18 +768,38 @@ glade_project_changed_impl (GladeProject *project,
     }
 }
 
-static void 
-glade_project_set_css_provider_forall (GtkWidget *widget, gpointer data)
+static GQuark css_provider_quark = 0;
+
+static void glade_project_css_provider_add_internal (GtkWidget *widget,
+                                                     gpointer   data);
+
+/* GTK+ 3 style providers are not inherited, so the project CSS has to be
+ * added to every widget. Each GladeWidget adds it to its own object and to
+ * the internal widgets it is built of, descendants with a GladeWidget of
+ * their own get it when they are added to the project in turn.
+ */
+static void
+glade_project_css_provider_add (GtkWidget *widget, GtkCssProvider *provider)
 {
-  if (GLADE_IS_PLACEHOLDER (widget) || GLADE_IS_OBJECT_STUB (widget))
+  if (GLADE_IS_PLACEHOLDER (widget) || GLADE_IS_OBJECT_STUB (widget) ||
+      g_object_get_qdata (G_OBJECT (widget), css_provider_quark) == provider)
     return;
 
+  g_object_set_qdata (G_OBJECT (widget), css_provider_quark, provider);
   gtk_style_context_add_provider (gtk_widget_get_style_context (widget),
-                                  GTK_STYLE_PROVIDER (data),
+                                  GTK_STYLE_PROVIDER (provider),
                                   GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
-  
+
   if (GTK_IS_CONTAINER (widget))
-    gtk_container_forall (GTK_CONTAINER (widget), glade_project_set_css_provider_forall, data);
+    gtk_container_forall (GTK_CONTAINER (widget),
+                          glade_project_css_provider_add_internal, provider);
+}
+
+static void
+glade_project_css_provider_add_internal (GtkWidget *widget, gpointer data)
+{
+  if (glade_widget_get_from_gobject (widget) == NULL)
+    glade_project_css_provider_add (widget, data);
 }
 
 static void
@@ -685,12 +811,26 @@ glade_project_add_object_impl (GladeProject *project, GladeWidget *gwidget)
   if (!priv->css_provider || !GTK_IS_WIDGET (widget))
     return;
 
-  glade_project_set_css_provider_forall (GTK_WIDGET (widget), priv->css_provider);
+  glade_project_css_provider_add (GTK_WIDGET (widget), priv->css_provider);
 }
 
 /*******************************************************************
                           Class Initializers
  *******************************************************************/
+static void
+verify_result_free (VerifyResult *result)
+{
+  g_free (result->report);
+  g_slice_free (VerifyResult, result);
+}
+
+static void
+adaptor_support_free (AdaptorSupport *support)
+{
+  g_free (support->warning);
+  g_slice_free (AdaptorSupport, support);
+}
+
 static void
 glade_project_init (GladeProject *project)
 {
@@ -720,21 +860,35 @@ glade_project_init (GladeProject *project)
   
   priv->readonly = FALSE;
   priv->tree = NULL;
-  priv->selection = NULL;
+  priv->tree_order = g_hash_table_new (NULL, NULL);
+  priv->type_index = g_hash_table_new_full (NULL, NULL, NULL,
+                                            (GDestroyNotify) type_bucket_free);
+  g_queue_init (&priv->selection);
+  priv->selection_set = g_hash_table_new (NULL, NULL);
   priv->has_selection = FALSE;
   priv->undo_stack = NULL;
   priv->prev_redo_item = NULL;
+  priv->deferred_properties = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+  priv->deferred_widgets = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+  priv->deferred_rebuilds = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+  priv->verify_results = g_hash_table_new_full (NULL, NULL, NULL,
+                                                (GDestroyNotify) verify_result_free);
+  priv->adaptor_support = g_hash_table_new_full (NULL, NULL, NULL,
+                                                 (GDestroyNotify) adaptor_support_free);
+  priv->signal_strings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
   priv->first_modification = NULL;
   priv->first_modification_is_na = FALSE;
   priv->unknown_catalogs = NULL;
 
-  priv->previews = g_hash_table_new_full (g_str_hash, 
-                                          g_str_equal,
-                                          g_free, 
+  priv->previews = g_hash_table_new_full (NULL, NULL, NULL,
                                           glade_project_destroy_preview);
 
   priv->widget_names = glade_name_context_new ();
 
+  priv->image_cache = glade_image_cache_new (glade_project_image_cache_ready, project);
+  priv->pending_pixbufs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                                 (GDestroyNotify) g_ptr_array_unref);
+
   priv->unsaved_number =
       glade_id_allocator_allocate (get_unsaved_number_allocator ());
 
@@ -786,6 +940,8 @@ glade_project_class_init (GladeProjectClass *klass)
   klass->close = NULL;
   klass->changed = glade_project_changed_impl;
 
+  css_provider_quark = g_quark_from_static_string ("glade-project-css-provider");
+
   /**
    * GladeProject::add-widget:
    * @gladeproject: the #GladeProject which received the signal.
@@ -1506,8 +1662,27 @@ glade_project_read_requires (GladeProject *project,
   return loadable;
 }
 
+/* Loads @property's image again from its filename */
 static void
-update_project_for_resource_path (GladeProject *project)
+glade_project_reload_pixbuf (GladeProject *project, GladeProperty *property)
+{
+  GValue *value;
+  gchar  *string;
+
+  string = glade_property_make_string (property);
+  value  = glade_property_class_make_gvalue_from_string (glade_property_get_class (property),
+                                                         string, project);
+
+  glade_property_set_value (property, value);
+
+  g_value_unset (value);
+  g_free (value);
+  g_free (string);
+}
+
+/* Reload all GdkPixbuf properties */
+static void
+update_project_pixbufs (GladeProject *project)
 {
   GladeWidget *widget;
   GladeProperty *property;
@@ -1533,21 +1708,131 @@ update_project_for_resource_path (GladeProject *project)
                                                 * required to generate unique strings for value comparisons).
                                                   */
           if (pspec->value_type == GDK_TYPE_PIXBUF)
-            {
-              GValue *value;
-              gchar  *string;
+            glade_project_reload_pixbuf (project, property);
+        }
+    }
+}
+
+static void
+update_project_for_resource_path (GladeProject *project)
+{
+  /* Images whose file did not change are still in the cache */
+  update_project_pixbufs (project);
+}
 
-              string = glade_property_make_string (property);
-              value  = glade_property_class_make_gvalue_from_string (klass, string, project);
+/* Patches the properties which got a placeholder for @fullpath */
+static void
+glade_project_image_cache_ready (GladeImageCache *cache,
+                                 const gchar     *fullpath,
+                                 gpointer         user_data)
+{
+  GladeProject *project = GLADE_PROJECT (user_data);
+  GPtrArray *pending;
+  guint i;
 
-              glade_property_set_value (property, value);
+  if ((pending = g_hash_table_lookup (project->priv->pending_pixbufs, fullpath)) == NULL)
+    return;
 
-              g_value_unset (value);
-              g_free (value);
-              g_free (string);
-            }
-        }
+  g_ptr_array_ref (pending);
+  g_hash_table_remove (project->priv->pending_pixbufs, fullpath);
+
+  for (i = 0; i < pending->len; i++)
+    {
+      GladeProperty *property = g_ptr_array_index (pending, i);
+      GladeWidget   *widget = glade_property_get_widget (property);
+      GdkPixbuf     *pixbuf;
+
+      /* Skip properties which were removed or changed meanwhile */
+      if (widget == NULL || glade_widget_get_project (widget) != project)
+        continue;
+
+      pixbuf = g_value_get_object (_glade_property_peek_value (property));
+      if (pixbuf == NULL ||
+          g_strcmp0 (glade_image_cache_get_pending_path (pixbuf), fullpath) != 0)
+        continue;
+
+      glade_project_reload_pixbuf (project, property);
     }
+
+  g_ptr_array_unref (pending);
+}
+
+/**
+ * _glade_project_watch_pixbuf:
+ * @project: A #GladeProject
+ * @property: A #GdkPixbuf property of a widget in @project
+ *
+ * Records @property to be patched when its image is decoded, if
+ * it holds a placeholder from the project image cache.
+ */
+void
+_glade_project_watch_pixbuf (GladeProject *project, GladeProperty *property)
+{
+  GdkPixbuf *pixbuf;
+  GPtrArray *pending;
+  const gchar *fullpath;
+  guint i;
+
+  g_return_if_fail (GLADE_IS_PROJECT (project));
+
+  if ((pixbuf = g_value_get_object (_glade_property_peek_value (property))) == NULL ||
+      (fullpath = glade_image_cache_get_pending_path (pixbuf)) == NULL)
+    return;
+
+  if ((pending = g_hash_table_lookup (project->priv->pending_pixbufs, fullpath)) == NULL)
+    {
+      pending = g_ptr_array_new_with_free_func (g_object_unref);
+      g_hash_table_insert (project->priv->pending_pixbufs, g_strdup (fullpath), pending);
+    }
+
+  for (i = 0; i < pending->len; i++)
+    if (g_ptr_array_index (pending, i) == property)
+      return;
+
+  g_ptr_array_add (pending, g_object_ref (property));
+}
+
+/**
+ * _glade_project_load_pixbuf:
+ * @project: A #GladeProject
+ * @filename: An image filename as found in the project
+ *
+ * Loads @filename from the project resource path through the project
+ * image cache, the returned pixbuf may be a placeholder which will be
+ * replaced once the image is decoded in the background.
+ *
+ * Returns: (transfer full): A #GdkPixbuf or %NULL
+ */
+GdkPixbuf *
+_glade_project_load_pixbuf (GladeProject *project, const gchar *filename)
+{
+  GdkPixbuf *pixbuf;
+  gchar *fullpath;
+
+  g_return_val_if_fail (GLADE_IS_PROJECT (project), NULL);
+
+  if (project->priv->image_cache == NULL)
+    return NULL;
+
+  fullpath = glade_project_resource_fullpath (project, filename);
+  pixbuf   = glade_image_cache_lookup (project->priv->image_cache, fullpath, filename);
+  g_free (fullpath);
+
+  return pixbuf;
+}
+
+/* The commands in the undo and redo history, in execution order */
+GList *
+_glade_project_peek_undo_stack (GladeProject *project)
+{
+  return project->priv->undo_stack;
+}
+
+/* The table the signals of the project's widgets share their strings from */
+GHashTable *
+_glade_project_get_signal_strings (GladeProject *project)
+{
+  return project->priv->signal_strings;
 }
 
 void
@@ -2012,7 +2297,7 @@ glade_project_load_internal (GladeProject *project)
 
   g_free (autosave_path);
 
-  priv->selection = NULL;
+  glade_project_selection_clear (project, FALSE);
   priv->objects = NULL;
   priv->loading = TRUE;
 
@@ -2110,9 +2395,10 @@ glade_project_load_internal (GladeProject *project)
   /* Now we have to loop over all the object properties
    * and fix'em all ('cause they probably weren't found)
    */
+  _glade_project_push_deferral (project);
   glade_project_fix_object_props (project);
-
   glade_project_fix_template (project);
+  _glade_project_pop_deferral (project);
 
   /* Emit "parse-finished" signal */
   g_signal_emit (project, glade_project_signals[PARSE_FINISHED], 0);
@@ -2842,8 +3128,8 @@ void
 glade_project_preview (GladeProject *project, GladeWidget *gwidget)
 {
   GladeXmlContext *context;
-  gchar *text, *pidstr;
-  GladePreview *preview = NULL;
+  GladePreview *preview;
+  gchar *text;
 
   g_return_if_fail (GLADE_IS_PROJECT (project));
 
@@ -2857,10 +3143,7 @@ glade_project_preview (GladeProject *project, GladeWidget *gwidget)
   if (!GTK_IS_WIDGET (glade_widget_get_object (gwidget)))
     return;
 
-  if ((pidstr = g_object_get_data (G_OBJECT (gwidget), "preview")) != NULL)
-    preview = g_hash_table_lookup (project->priv->previews, pidstr);
-
-  if (!preview)
+  if ((preview = g_hash_table_lookup (project->priv->previews, gwidget)) == NULL)
     {
       /* If the previewer program is somehow missing, this can return NULL */
       preview = glade_preview_launch (gwidget, text);
@@ -2869,20 +3152,12 @@ glade_project_preview (GladeProject *project, GladeWidget *gwidget)
       /* Leave project data on the preview */
       g_object_set_data (G_OBJECT (preview), "project", project);
 
-      /* Leave preview data on the widget */
-      g_object_set_data_full (G_OBJECT (gwidget),
-                              "preview", 
-                              glade_preview_get_pid_as_str (preview),
-                              g_free);
-
       g_signal_connect (preview, "exits",
                         G_CALLBACK (glade_project_preview_exits),
                         project);
 
       /* Add preview to list of previews */
-      g_hash_table_insert (project->priv->previews,
-                           glade_preview_get_pid_as_str (preview),
-                           preview);
+      g_hash_table_insert (project->priv->previews, gwidget, preview);
     }
   else
     {
@@ -3170,6 +3445,242 @@ glade_project_verify_property (GladeProperty *property)
 					    GLADE_VERIFY_UNRECOGNIZED);
 }
 
+/**
+ * _glade_project_push_deferral:
+ * @project: A #GladeProject
+ *
+ * Starts a scope in which the verification of changed properties and
+ * the rebuilds for construct only properties are deferred, scopes nest
+ * and both are done once when the outermost scope ends. This is used
+ * for command groups, undo/redo and load fix-ups where many properties
+ * are changed at once.
+ */
+void
+_glade_project_push_deferral (GladeProject *project)
+{
+  g_return_if_fail (GLADE_IS_PROJECT (project));
+
+  project->priv->deferral_depth++;
+}
+
+/**
+ * _glade_project_pop_deferral:
+ * @project: A #GladeProject
+ *
+ * Ends a scope started with _glade_project_push_deferral(), rebuilds
+ * and verifies the widgets whose properties changed meanwhile, each
+ * widget is rebuilt and verified at most once.
+ */
+void
+_glade_project_pop_deferral (GladeProject *project)
+{
+  GladeProjectPrivate *priv;
+  GHashTable *rebuilds, *properties, *widgets;
+  GHashTableIter iter;
+  GladeProperty *property;
+  GladeWidget *widget;
+  gpointer warn_before, verify;
+
+  g_return_if_fail (GLADE_IS_PROJECT (project));
+
+  priv = project->priv;
+
+  g_return_if_fail (priv->deferral_depth > 0);
+
+  if (--priv->deferral_depth > 0)
+    return;
+
+  /* Rebuild first, rebuilds requested from here on are done right away */
+  rebuilds = priv->deferred_rebuilds;
+  priv->deferred_rebuilds = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+
+  g_hash_table_iter_init (&iter, rebuilds);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &widget, NULL))
+    {
+      /* Moved to another project meanwhile */
+      if (glade_widget_get_project (widget) != project)
+        continue;
+
+      glade_widget_rebuild (widget);
+    }
+
+  g_hash_table_destroy (rebuilds);
+
+  /* Take over the tables, verifying may change properties again */
+  properties = priv->deferred_properties;
+  widgets    = priv->deferred_widgets;
+  priv->deferred_properties = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+  priv->deferred_widgets    = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+
+  g_hash_table_iter_init (&iter, properties);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &property, &warn_before))
+    {
+      widget = glade_property_get_widget (property);
+
+      /* Removed meanwhile */
+      if (widget == NULL || glade_widget_get_project (widget) != project)
+        continue;
+
+      glade_project_verify_property (property);
+
+      /* Update owning widget's warning state if need be */
+      if (GPOINTER_TO_INT (warn_before) - 1 != glade_property_warn_usage (property))
+        g_hash_table_insert (widgets, g_object_ref (widget), GINT_TO_POINTER (TRUE));
+    }
+
+  g_hash_table_iter_init (&iter, widgets);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &widget, &verify))
+    {
+      if (verify && glade_widget_get_project (widget) == project)
+        glade_widget_verify (widget);
+    }
+
+  g_hash_table_destroy (properties);
+  g_hash_table_destroy (widgets);
+}
+
+/**
+ * _glade_project_begin_fragment_load:
+ * @project: A #GladeProject
+ *
+ * Starts reading widgets for @project outside of a project load, such as
+ * a clipboard fragment. The project is flagged as loading so adaptors
+ * defer their fix-ups to #GladeProject::parse-finished as they do while
+ * loading a file, handlers connected to that signal before this call are
+ * blocked until _glade_project_end_fragment_load().
+ */
+void
+_glade_project_begin_fragment_load (GladeProject *project)
+{
+  g_return_if_fail (GLADE_IS_PROJECT (project));
+  g_return_if_fail (project->priv->loading == FALSE);
+
+  g_signal_handlers_block_matched (project, G_SIGNAL_MATCH_ID,
+                                   glade_project_signals[PARSE_FINISHED],
+                                   0, NULL, NULL, NULL);
+  project->priv->loading = TRUE;
+}
+
+/**
+ * _glade_project_end_fragment_load:
+ * @project: A #GladeProject
+ *
+ * Emits #GladeProject::parse-finished for the handlers the widgets read
+ * since _glade_project_begin_fragment_load() connected, and disconnects
+ * them since they only make sense once, the project is no longer
+ * flagged as loading afterwards.
+ */
+void
+_glade_project_end_fragment_load (GladeProject *project)
+{
+  guint signal_id = glade_project_signals[PARSE_FINISHED];
+
+  g_return_if_fail (GLADE_IS_PROJECT (project));
+  g_return_if_fail (project->priv->loading);
+
+  g_signal_emit (project, signal_id, 0);
+
+  g_signal_handlers_disconnect_matched (project,
+                                        G_SIGNAL_MATCH_ID | G_SIGNAL_MATCH_UNBLOCKED,
+                                        signal_id, 0, NULL, NULL, NULL);
+  g_signal_handlers_unblock_matched (project, G_SIGNAL_MATCH_ID,
+                                     signal_id, 0, NULL, NULL, NULL);
+
+  project->priv->loading = FALSE;
+}
+
+/**
+ * _glade_project_defer_verify:
+ * @project: A #GladeProject
+ * @property: A #GladeProperty which changed
+ * @warn_before: the warning state of @property before the change
+ *
+ * Returns: %TRUE if the verification of @property was deferred
+ */
+gboolean
+_glade_project_defer_verify (GladeProject  *project,
+                             GladeProperty *property,
+                             gboolean       warn_before)
+{
+  GladeProjectPrivate *priv = project->priv;
+  GladeWidget *widget;
+
+  if (priv->deferral_depth == 0 || priv->loading)
+    return FALSE;
+
+  /* Keep the state before the first change only */
+  if (g_hash_table_contains (priv->deferred_properties, property))
+    return TRUE;
+
+  g_hash_table_insert (priv->deferred_properties, g_object_ref (property),
+                       GINT_TO_POINTER (warn_before + 1));
+
+  widget = glade_property_get_widget (property);
+  if (!g_hash_table_contains (priv->deferred_widgets, widget))
+    g_hash_table_insert (priv->deferred_widgets, g_object_ref (widget), NULL);
+
+  return TRUE;
+}
+
+/**
+ * _glade_project_defer_rebuild:
+ * @project: A #GladeProject
+ * @widget: A #GladeWidget with a changed construct only property
+ *
+ * Returns: %TRUE if rebuilding @widget was deferred
+ */
+gboolean
+_glade_project_defer_rebuild (GladeProject *project,
+                              GladeWidget  *widget)
+{
+  GladeProjectPrivate *priv = project->priv;
+
+  if (priv->deferral_depth == 0)
+    return FALSE;
+
+  if (!g_hash_table_contains (priv->deferred_rebuilds, widget))
+    g_hash_table_insert (priv->deferred_rebuilds, g_object_ref (widget), NULL);
+
+  return TRUE;
+}
+
+/**
+ * _glade_project_invalidate_verify:
+ * @project: A #GladeProject
+ * @widget: A #GladeWidget whose properties or signals changed
+ *
+ * Drops the cached verification report of @widget, it is verified
+ * again on the next glade_project_verify().
+ */
+void
+_glade_project_invalidate_verify (GladeProject *project,
+                                  GladeWidget  *widget)
+{
+  g_hash_table_remove (project->priv->verify_results, widget);
+}
+
+/* Reports include the path of the widget, renames change it for the
+ * whole hierarchy below.
+ */
+static void
+glade_project_invalidate_verify_hierarchy (GladeProject *project,
+                                           GladeWidget  *widget)
+{
+  GList *children, *l;
+
+  _glade_project_invalidate_verify (project, widget);
+
+  children = glade_widget_get_children (widget);
+  for (l = children; l; l = l->next)
+    {
+      GladeWidget *child = glade_widget_get_from_gobject (l->data);
+
+      if (child)
+        glade_project_invalidate_verify_hierarchy (project, child);
+    }
+  g_list_free (children);
+}
+
 void
 glade_project_verify_signal (GladeWidget *widget, GladeSignal *signal)
 {
@@ -3297,6 +3808,7 @@ glade_project_verify (GladeProject    *project,
   for (list = project->priv->objects; list; list = list->next)
     {
       GladeWidget *widget = glade_widget_get_from_gobject (list->data);
+      VerifyResult *result;
       
       if ((flags & GLADE_VERIFY_UNRECOGNIZED) != 0 &&
 	  GLADE_IS_OBJECT_STUB (list->data))
@@ -3307,18 +3819,32 @@ glade_project_verify (GladeProject    *project,
           g_string_append_printf (string, _("Object %s has unrecognized type %s\n"), 
                                   glade_widget_get_name (widget), type);
           g_free (type);
+          continue;
         }
-      else
+
+      /* Only widgets which changed since the last run are verified again */
+      result = g_hash_table_lookup (project->priv->verify_results, widget);
+
+      if (result == NULL || result->flags != flags)
         {
+          GString *report = g_string_new (NULL);
           gchar *path_name = glade_widget_generate_path_name (widget);
 
           glade_project_verify_adaptor (project, glade_widget_get_adaptor (widget),
-                                        path_name, string, flags, FALSE, NULL);
-          glade_project_verify_properties_internal (widget, path_name, string, FALSE, flags);
-          glade_project_verify_signals (widget, path_name, string, FALSE, flags);
+                                        path_name, report, flags, FALSE, NULL);
+          glade_project_verify_properties_internal (widget, path_name, report, FALSE, flags);
+          glade_project_verify_signals (widget, path_name, report, FALSE, flags);
 
           g_free (path_name);
+
+          result = g_slice_new (VerifyResult);
+          result->flags  = flags;
+          result->report = g_string_free (report, report->len == 0);
+          g_hash_table_replace (project->priv->verify_results, widget, result);
         }
+
+      if (result->report)
+        g_string_append (string, result->report);
     }
 
   if (string->len > 0)
@@ -3443,27 +3969,32 @@ glade_project_verify_widget_adaptor (GladeProject       *project,
                                      GladeWidgetAdaptor *adaptor,
                                      GladeSupportMask   *mask)
 {
-  GString *string = g_string_new (NULL);
-  gchar *ret = NULL;
-
-  glade_project_verify_adaptor (project, adaptor, NULL,
-                                string,
-				GLADE_VERIFY_VERSIONS     |
-				GLADE_VERIFY_DEPRECATIONS |
-				GLADE_VERIFY_UNRECOGNIZED,
-				TRUE, mask);
+  AdaptorSupport *support;
+  GString *string;
 
-  /* there was a '\0' byte... */
-  if (string->len > 0)
+  /* This only depends on the target versions, the result is kept */
+  if ((support = g_hash_table_lookup (project->priv->adaptor_support, adaptor)) == NULL)
     {
-      ret = string->str;
-      g_string_free (string, FALSE);
+      string = g_string_new (NULL);
+      support = g_slice_new (AdaptorSupport);
+
+      glade_project_verify_adaptor (project, adaptor, NULL,
+                                    string,
+                                    GLADE_VERIFY_VERSIONS     |
+                                    GLADE_VERIFY_DEPRECATIONS |
+                                    GLADE_VERIFY_UNRECOGNIZED,
+                                    TRUE, &support->mask);
+
+      /* there was a '\0' byte... */
+      support->warning = g_string_free (string, string->len == 0);
+
+      g_hash_table_insert (project->priv->adaptor_support, adaptor, support);
     }
-  else
-    g_string_free (string, TRUE);
 
+  if (mask)
+    *mask = support->mask;
 
-  return ret;
+  return g_strdup (support->warning);
 }
 
 
@@ -3694,6 +4225,7 @@ glade_project_set_widget_name (GladeProject *project,
   /* Release old name and set new widget name */
   glade_project_release_widget_name (project, widget, glade_widget_get_name (widget));
   glade_widget_set_name (widget, new_name);
+  glade_project_invalidate_verify_hierarchy (project, widget);
 
   g_signal_emit (G_OBJECT (project),
                  glade_project_signals[WIDGET_NAME_CHANGED], 0, widget);
@@ -3827,7 +4359,11 @@ glade_project_add_object (GladeProject *project, GObject *object)
 
   /* Be sure to update the lists before emitting signals */
   if (glade_widget_get_parent (gwidget) == NULL)
-    priv->tree = g_list_append (priv->tree, object);
+    {
+      priv->tree = g_list_append (priv->tree, object);
+      g_hash_table_insert (priv->tree_order, object,
+                           GUINT_TO_POINTER (++priv->tree_serial));
+    }
   else if (glade_project_get_iter_for_object (project,
                                               glade_widget_get_parent (gwidget),
                                               &iter))
@@ -3836,6 +4372,7 @@ glade_project_add_object (GladeProject *project, GObject *object)
     }
 
   priv->objects = g_list_prepend (priv->objects, object);
+  glade_project_index_object (project, object);
   gtk_tree_store_insert_with_values (GTK_TREE_STORE (priv->model), NULL, parent, -1,
                                      0, gwidget, -1);
 
@@ -3890,7 +4427,17 @@ glade_project_widget_changed (GladeProject *project, GladeWidget *gwidget)
   g_return_if_fail (GLADE_IS_WIDGET (gwidget));
   g_return_if_fail (glade_project_has_gwidget (project, gwidget));
 
-  glade_project_get_iter_for_object (project, gwidget, &iter);
+  /* The row is updated once the rebuilt widget is back in its parent */
+  if (_glade_widget_is_rebuilding (gwidget))
+    return;
+
+  if (!glade_project_get_iter_for_object (project, gwidget, &iter))
+    {
+      g_warning ("%s: widget '%s' has no row in the project model",
+                 G_STRFUNC, glade_widget_get_name (gwidget));
+      return;
+    }
+
   path = gtk_tree_model_get_path (project->priv->model, &iter);
   gtk_tree_model_row_changed (project->priv->model, path, &iter);
   gtk_tree_path_free (path);
@@ -3912,7 +4459,6 @@ glade_project_remove_object (GladeProject *project, GObject *object)
 {
   GladeWidget *gwidget;
   GList *list, *children;
-  gchar *preview_pid;
   GtkTreeIter iter;
 
   g_return_if_fail (GLADE_IS_PROJECT (project));
@@ -3926,8 +4472,10 @@ glade_project_remove_object (GladeProject *project, GObject *object)
       if (g_list_find (project->priv->objects, object))
         {
           project->priv->tree = g_list_remove_all (project->priv->tree, object);
+          g_hash_table_remove (project->priv->tree_order, object);
           project->priv->objects = g_list_remove_all (project->priv->objects, object);
-          project->priv->selection = g_list_remove_all (project->priv->selection, object);
+          glade_project_unindex_object (project, object);
+          glade_project_selection_remove (project, object, FALSE);
           g_warning ("Internal data model error, removing object %p %s without a GladeWidget wrapper",
                      object, G_OBJECT_TYPE_NAME (object));
         }
@@ -3956,6 +4504,8 @@ glade_project_remove_object (GladeProject *project, GObject *object)
   /* Update internal data structure (remove from lists) */
   project->priv->tree = g_list_remove (project->priv->tree, object);
   project->priv->objects = g_list_remove (project->priv->objects, object);
+  g_hash_table_remove (project->priv->tree_order, object);
+  glade_project_unindex_object (project, object);
   
   if (glade_project_get_iter_for_object (project, gwidget, &iter))
     gtk_tree_store_remove (GTK_TREE_STORE (project->priv->model), &iter);
@@ -3963,15 +4513,117 @@ glade_project_remove_object (GladeProject *project, GObject *object)
     g_warning ("Internal data model error, object %p %s not found in tree model",
                object, G_OBJECT_TYPE_NAME (object));
   
-  if ((preview_pid = g_object_get_data (G_OBJECT (gwidget), "preview")))
-    g_hash_table_remove (project->priv->previews, preview_pid);
+  g_hash_table_remove (project->priv->previews, gwidget);
   
+  g_hash_table_remove (project->priv->verify_results, gwidget);
+
   /* Unset the project pointer on the GladeWidget */
   glade_widget_set_project (gwidget, NULL);
   glade_widget_set_in_project (gwidget, FALSE);
   g_object_unref (gwidget);
 }
 
+/**
+ * _glade_project_replace_object:
+ * @project: a #GladeProject
+ * @old_widget: the #GladeWidget of @old_object
+ * @old_object: the #GObject in @project
+ * @new_object: the #GObject taking its place
+ *
+ * Swaps @old_object for @new_object keeping its position in the model
+ * and the selection, this is used when an instance is rebuilt. If the
+ * #GladeWidget changes too (internal children of a rebuilt instance),
+ * the new one also takes over the name and the row of @old_widget.
+ */
+void
+_glade_project_replace_object (GladeProject *project,
+                               GladeWidget  *old_widget,
+                               GObject      *old_object,
+                               GObject      *new_object)
+{
+  GladeProjectPrivate *priv = project->priv;
+  GladeWidget *new_widget;
+  GtkTreeIter iter;
+  gchar *name;
+  GList *link;
+
+  new_widget = glade_widget_get_from_gobject (new_object);
+
+  if (new_widget != old_widget)
+    {
+      if (!glade_project_get_iter_for_object (project, old_widget, &iter))
+        {
+          g_warning ("Internal data model error, object %p %s not found in tree model",
+                     old_object, G_OBJECT_TYPE_NAME (old_object));
+          return;
+        }
+
+      g_signal_emit (G_OBJECT (project),
+                     glade_project_signals[REMOVE_WIDGET], 0, old_widget);
+    }
+
+  if ((link = g_list_find (priv->tree, old_object)) != NULL)
+    {
+      gpointer order = g_hash_table_lookup (priv->tree_order, old_object);
+
+      link->data = new_object;
+      g_hash_table_remove (priv->tree_order, old_object);
+      g_hash_table_insert (priv->tree_order, new_object, order);
+    }
+
+  if ((link = g_list_find (priv->objects, old_object)) != NULL)
+    {
+      link->data = new_object;
+      glade_project_unindex_object (project, old_object);
+      glade_project_index_object (project, new_object);
+    }
+
+  /* A rebuilt instance keeps its GladeWidget and is not added again */
+  if (priv->css_provider && GTK_IS_WIDGET (new_object))
+    glade_project_css_provider_add (GTK_WIDGET (new_object), priv->css_provider);
+
+  if ((link = g_hash_table_lookup (priv->selection_set, old_object)) != NULL)
+    {
+      g_hash_table_remove (priv->selection_set, old_object);
+      link->data = new_object;
+      g_hash_table_insert (priv->selection_set, new_object, link);
+    }
+
+  if (new_widget == old_widget)
+    return;
+
+  name = g_strdup (glade_widget_get_name (old_widget));
+  glade_project_release_widget_name (project, old_widget, name);
+  glade_widget_set_name (new_widget, name);
+  glade_project_reserve_widget_name (project, new_widget, name);
+  g_free (name);
+
+  glade_widget_set_project (new_widget, (gpointer) project);
+  glade_widget_set_in_project (new_widget, TRUE);
+  g_object_ref_sink (new_widget);
+
+  gtk_tree_store_set (GTK_TREE_STORE (priv->model), &iter, 0, new_widget, -1);
+
+  g_hash_table_remove (priv->verify_results, old_widget);
+
+  glade_widget_set_project (old_widget, NULL);
+  glade_widget_set_in_project (old_widget, FALSE);
+  g_object_unref (old_widget);
+
+  g_signal_emit (G_OBJECT (project),
+                 glade_project_signals[ADD_WIDGET], 0, new_widget);
+}
+
+/* Returns a key ordering @object among the toplevels of @project as
+ * in glade_project_toplevels(), or 0 if @object is not a toplevel.
+ */
+guint
+_glade_project_get_toplevel_order (GladeProject *project,
+                                   GObject      *object)
+{
+  return GPOINTER_TO_UINT (g_hash_table_lookup (project->priv->tree_order, object));
+}
+
 /*******************************************************************
  *                          Other API                              *
  *******************************************************************/
@@ -4132,6 +4784,10 @@ glade_project_set_target_version (GladeProject *project,
   g_hash_table_insert (project->priv->target_versions_minor,
                        g_strdup (catalog), GINT_TO_POINTER ((int) minor));
 
+  /* Everything is verified against the new versions */
+  g_hash_table_remove_all (project->priv->verify_results);
+  g_hash_table_remove_all (project->priv->adaptor_support);
+
   glade_project_verify_project_for_ui (project);
 
   g_signal_emit (project, glade_project_signals[TARGETS_CHANGED], 0);
@@ -4266,7 +4922,7 @@ gboolean
 glade_project_is_selected (GladeProject *project, GObject *object)
 {
   g_return_val_if_fail (GLADE_IS_PROJECT (project), FALSE);
-  return (g_list_find (project->priv->selection, object)) != NULL;
+  return g_hash_table_contains (project->priv->selection_set, object);
 }
 
 /**
@@ -4285,17 +4941,17 @@ glade_project_selection_clear (GladeProject *project, gboolean emit_signal)
 
   g_return_if_fail (GLADE_IS_PROJECT (project));
 
-  if (project->priv->selection == NULL)
+  if (project->priv->selection.head == NULL)
     return;
 
-  for (l = project->priv->selection; l; l = l->next)
+  for (l = project->priv->selection.head; l; l = l->next)
     {
       if (GTK_IS_WIDGET (l->data))
         gtk_widget_queue_draw (GTK_WIDGET (l->data));
     }
 
-  g_list_free (project->priv->selection);
-  project->priv->selection = NULL;
+  g_queue_clear (&project->priv->selection);
+  g_hash_table_remove_all (project->priv->selection_set);
   glade_project_set_has_selection (project, FALSE);
 
   if (emit_signal)
@@ -4318,14 +4974,17 @@ glade_project_selection_remove (GladeProject *project,
                                 GObject      *object,
                                 gboolean      emit_signal)
 {
+  GList *link;
+
   g_return_if_fail (GLADE_IS_PROJECT (project));
   g_return_if_fail (G_IS_OBJECT (object));
 
-  if (glade_project_is_selected (project, object))
+  if ((link = g_hash_table_lookup (project->priv->selection_set, object)) != NULL)
     {
-      project->priv->selection =
-          g_list_remove (project->priv->selection, object);
-      if (project->priv->selection == NULL)
+      g_queue_delete_link (&project->priv->selection, link);
+      g_hash_table_remove (project->priv->selection_set, object);
+
+      if (project->priv->selection.head == NULL)
         glade_project_set_has_selection (project, FALSE);
       if (emit_signal)
         glade_project_selection_changed (project);
@@ -4354,13 +5013,14 @@ glade_project_selection_add (GladeProject *project,
 
   if (glade_project_is_selected (project, object) == FALSE)
     {
-      gboolean toggle_has_selection = (project->priv->selection == NULL);
+      gboolean toggle_has_selection = (project->priv->selection.head == NULL);
 
       if (GTK_IS_WIDGET (object))
         gtk_widget_queue_draw (GTK_WIDGET (object));
 
-      project->priv->selection =
-        g_list_prepend (project->priv->selection, object);
+      g_queue_push_head (&project->priv->selection, object);
+      g_hash_table_insert (project->priv->selection_set, object,
+                           project->priv->selection.head);
 
       if (toggle_has_selection)
         glade_project_set_has_selection (project, TRUE);
@@ -4391,7 +5051,7 @@ glade_project_selection_set (GladeProject *project,
   g_return_if_fail (glade_project_has_object (project, object));
 
   if (glade_project_is_selected (project, object) == FALSE ||
-      g_list_length (project->priv->selection) != 1)
+      project->priv->selection.length != 1)
     {
       glade_project_selection_clear (project, FALSE);
       glade_project_selection_add (project, object, emit_signal);
@@ -4402,14 +5062,16 @@ glade_project_selection_set (GladeProject *project,
  * glade_project_selection_get:
  * @project: a #GladeProject
  *
- * Returns: a #GList containing the #GtkWidget items currently selected in @project
+ * Returns: a #GList containing the #GtkWidget items currently selected in @project,
+ * the last selected item first. The list is owned by @project and should not be
+ * modified.
  */
 GList *
 glade_project_selection_get (GladeProject *project)
 {
   g_return_val_if_fail (GLADE_IS_PROJECT (project), NULL);
 
-  return project->priv->selection;
+  return project->priv->selection.head;
 }
 
 /**
@@ -4800,6 +5462,150 @@ glade_project_get_file_mtime (GladeProject *project)
   return project->priv->mtime;
 }
 
+/* Appends to @path the position of @gwidget in the project tree: the
+ * order of its toplevel followed by its position among the children of
+ * each of its ancestors. @children caches the children of the ancestors.
+ */
+static void
+glade_project_tree_path (GladeProject *project,
+                         GladeWidget  *gwidget,
+                         GHashTable   *children,
+                         GArray       *path)
+{
+  GladeWidget *parent;
+  GList *siblings;
+  guint position;
+
+  if ((parent = glade_widget_get_parent (gwidget)) == NULL)
+    {
+      position = _glade_project_get_toplevel_order (project, glade_widget_get_object (gwidget));
+      g_array_append_val (path, position);
+      return;
+    }
+
+  glade_project_tree_path (project, parent, children, path);
+
+  if (!g_hash_table_lookup_extended (children, parent, NULL, (gpointer *) &siblings))
+    {
+      siblings = glade_widget_get_children (parent);
+      g_hash_table_insert (children, parent, siblings);
+    }
+
+  position = g_list_index (siblings, glade_widget_get_object (gwidget));
+  g_array_append_val (path, position);
+}
+
+static gint
+glade_project_compare_tree_paths (gconstpointer a,
+                                  gconstpointer b,
+                                  gpointer      user_data)
+{
+  GHashTable *paths = user_data;
+  GArray *path_a = g_hash_table_lookup (paths, a);
+  GArray *path_b = g_hash_table_lookup (paths, b);
+  guint i;
+
+  for (i = 0; i < path_a->len && i < path_b->len; i++)
+    {
+      guint position_a = g_array_index (path_a, guint, i);
+      guint position_b = g_array_index (path_b, guint, i);
+
+      if (position_a != position_b)
+        return position_a < position_b ? -1 : 1;
+    }
+
+  /* Parents go before their children */
+  return (gint) path_a->len - (gint) path_b->len;
+}
+
+/* Sorts @objects the way they appear in the project tree */
+static GList *
+glade_project_sort_by_tree_order (GladeProject *project, GList *objects)
+{
+  GHashTable *children, *paths;
+  GList *l;
+
+  if (objects == NULL || objects->next == NULL)
+    return objects;
+
+  children = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_list_free);
+  paths = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_array_unref);
+
+  for (l = objects; l; l = l->next)
+    {
+      GArray *path = g_array_new (FALSE, FALSE, sizeof (guint));
+
+      glade_project_tree_path (project, glade_widget_get_from_gobject (l->data),
+                               children, path);
+      g_hash_table_insert (paths, l->data, path);
+    }
+
+  objects = g_list_sort_with_data (objects, glade_project_compare_tree_paths, paths);
+
+  g_hash_table_destroy (paths);
+  g_hash_table_destroy (children);
+
+  return objects;
+}
+
+/* Calls @func on the objects in @project of type @type or of a type
+ * derived from it, in no particular order. @func must not add objects
+ * to nor remove objects from @project.
+ */
+void
+_glade_project_foreach_object_of_type (GladeProject *project,
+                                       GType         type,
+                                       GFunc         func,
+                                       gpointer      user_data)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_return_if_fail (GLADE_IS_PROJECT (project));
+
+  g_hash_table_iter_init (&iter, project->priv->type_index);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      TypeBucket *bucket = value;
+
+      if (g_type_is_a (GPOINTER_TO_SIZE (key), type))
+        g_queue_foreach (&bucket->objects, func, user_data);
+    }
+}
+
+/**
+ * glade_project_list_objects_by_type:
+ * @project: a GladeProject
+ * @type: a #GType
+ *
+ * Lists the objects in @project of type @type or of a type derived
+ * from it in tree order, without going through every object in the
+ * project.
+ *
+ * Returns: (transfer container) (element-type GObject): a newly
+ *          allocated list of the objects
+ */
+GList *
+glade_project_list_objects_by_type (GladeProject *project, GType type)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  GList *objects = NULL;
+
+  g_return_val_if_fail (GLADE_IS_PROJECT (project), NULL);
+
+  g_hash_table_iter_init (&iter, project->priv->type_index);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      TypeBucket *bucket = value;
+
+      if (g_type_is_a (GPOINTER_TO_SIZE (key), type))
+        objects = g_list_concat (g_list_copy (bucket->objects.head), objects);
+    }
+
+  return glade_project_sort_by_tree_order (project, objects);
+}
+
 /**
  * glade_projects_get_objects:
  * @project: a GladeProject
@@ -4918,35 +5724,40 @@ glade_project_get_translation_domain (GladeProject *project)
   return project->priv->translation_domain;
 }
 
-static void 
-glade_project_css_provider_remove_forall (GtkWidget *widget, gpointer data)
+static void glade_project_css_provider_remove_internal (GtkWidget *widget,
+                                                        gpointer   data);
+
+static void
+glade_project_css_provider_remove (GtkWidget *widget, GtkCssProvider *provider)
 {
+  if (g_object_get_qdata (G_OBJECT (widget), css_provider_quark) != provider)
+    return;
+
+  g_object_set_qdata (G_OBJECT (widget), css_provider_quark, NULL);
   gtk_style_context_remove_provider (gtk_widget_get_style_context (widget),
-                                     GTK_STYLE_PROVIDER (data));
-  
+                                     GTK_STYLE_PROVIDER (provider));
+
   if (GTK_IS_CONTAINER (widget))
-    gtk_container_forall (GTK_CONTAINER (widget), glade_project_css_provider_remove_forall, data);
+    gtk_container_forall (GTK_CONTAINER (widget),
+                          glade_project_css_provider_remove_internal, provider);
+}
+
+static void
+glade_project_css_provider_remove_internal (GtkWidget *widget, gpointer data)
+{
+  if (glade_widget_get_from_gobject (widget) == NULL)
+    glade_project_css_provider_remove (widget, data);
 }
 
+/* Visits every widget of the project once, the order does not matter */
 static inline void
 glade_project_css_provider_refresh (GladeProject *project, gboolean remove)
 {
-  GladeProjectPrivate *priv = project->priv;
-  GtkCssProvider *provider = priv->css_provider;
-  const GList *l;
-
-  for (l = priv->tree; l; l = g_list_next (l))
-    {
-      GObject *object = l->data;
-
-      if (!GTK_IS_WIDGET (object) || GLADE_IS_OBJECT_STUB (object))
-        continue;
-
-      if (remove)
-        glade_project_css_provider_remove_forall (GTK_WIDGET (object), provider);
-      else
-        glade_project_set_css_provider_forall (GTK_WIDGET (object), provider);
-    }
+  _glade_project_foreach_object_of_type (project, GTK_TYPE_WIDGET,
+                                         remove ?
+                                         (GFunc) glade_project_css_provider_remove :
+                                         (GFunc) glade_project_css_provider_add,
+                                         project->priv->css_provider);
 }
 
 static void 
@@ -5070,27 +5881,28 @@ glade_project_copy_selection (GladeProject *project)
   if (glade_project_is_loading (project))
     return;
 
-  if (!project->priv->selection)
+  if (!project->priv->selection.head)
     {
       glade_util_ui_message (glade_app_get_window (),
                              GLADE_UI_INFO, NULL, _("No widget selected."));
       return;
     }
 
-  for (list = project->priv->selection; list && list->data; list = list->next)
+  for (list = project->priv->selection.head; list && list->data; list = list->next)
     {
       GladeWidget *widget = glade_widget_get_from_gobject (list->data);
 
       if (widget_contains_unknown_type (widget))
         has_unknown = TRUE;
       else
-	widgets = g_list_prepend (widgets, glade_widget_dup (widget, FALSE));
+	widgets = g_list_prepend (widgets, widget);
     }
 
   if (has_unknown)
     glade_util_ui_message (glade_app_get_window (),
                            GLADE_UI_INFO, NULL, _("Unable to copy unrecognized widget type."));
 
+  /* The clipboard serializes the widgets, no copy is instantiated until pasted */
   glade_clipboard_add (glade_app_get_clipboard (), widgets);
   g_list_free (widgets);
 }
@@ -5107,7 +5919,7 @@ glade_project_command_cut (GladeProject *project)
   if (glade_project_is_loading (project))
     return;
 
-  for (list = project->priv->selection; list && list->data; list = list->next)
+  for (list = project->priv->selection.head; list && list->data; list = list->next)
     {
       GladeWidget *widget = glade_widget_get_from_gobject (list->data);
 
@@ -5130,12 +5942,25 @@ glade_project_command_cut (GladeProject *project)
     g_list_free (widgets);
 }
 
+static void
+glade_project_discard_pasted (GList *widgets)
+{
+  GList *l;
+
+  for (l = widgets; l; l = l->next)
+    {
+      g_object_ref_sink (l->data);
+      g_object_unref (l->data);
+    }
+  g_list_free (widgets);
+}
+
 void
 glade_project_command_paste (GladeProject     *project,
                              GladePlaceholder *placeholder)
 {
   GladeClipboard *clipboard;
-  GList *list;
+  GList *list, *widgets;
   GladeWidget *widget = NULL, *parent;
   gint placeholder_relations = 0;
 
@@ -5151,20 +5976,43 @@ glade_project_command_paste (GladeProject     *project,
         return;
     }
 
-  list      = project->priv->selection;
+  list      = project->priv->selection.head;
   clipboard = glade_app_get_clipboard ();
 
+  /* Check if selection is good */
+  if (project->priv->selection.head)
+    {
+      if (project->priv->selection.length != 1)
+        {
+          glade_util_ui_message (glade_app_get_window (),
+                                 GLADE_UI_INFO, NULL,
+                                 _("Unable to paste to multiple widgets"));
+
+          return;
+        }
+    }
+
+  /* Instantiate the clipboard contents, through the regular read path */
+  if (!glade_clipboard_get_has_selection (clipboard) ||
+      (widgets = glade_clipboard_instantiate (clipboard, project)) == NULL)
+    {
+      glade_util_ui_message (glade_app_get_window (), GLADE_UI_INFO, NULL,
+                             _("No widget on the clipboard"));
+
+      return;
+    }
+
   /* If there is a selection, paste in to the selected widget, otherwise
    * paste into the placeholder's parent, or at the toplevel
    */
   parent = list ? glade_widget_get_from_gobject (list->data) :
       (placeholder) ? glade_placeholder_get_parent (placeholder) : NULL;
 
-  widget = glade_clipboard_widgets (clipboard) ? glade_clipboard_widgets (clipboard)->data : NULL;
+  widget = widgets->data;
 
   /* Ignore parent argument if we are pasting a toplevel
    */
-  if (g_list_length (glade_clipboard_widgets (clipboard)) == 1 &&
+  if (widgets->next == NULL &&
       widget && GWA_IS_TOPLEVEL (glade_widget_get_adaptor (widget)))
     parent = NULL;
 
@@ -5174,46 +6022,28 @@ glade_project_command_paste (GladeProject     *project,
       glade_util_ui_message (glade_app_get_window (),
                              GLADE_UI_INFO, NULL,
                              _("Unable to paste to the selected parent"));
-      return;
-    }
-
-  /* Check if selection is good */
-  if (project->priv->selection)
-    {
-      if (g_list_length (project->priv->selection) != 1)
-        {
-          glade_util_ui_message (glade_app_get_window (),
-                                 GLADE_UI_INFO, NULL,
-                                 _("Unable to paste to multiple widgets"));
-
-          return;
-        }
-    }
-
-  /* Check if we have anything to paste */
-  if (g_list_length (glade_clipboard_widgets (clipboard)) == 0)
-    {
-      glade_util_ui_message (glade_app_get_window (), GLADE_UI_INFO, NULL,
-                             _("No widget on the clipboard"));
-
+      glade_project_discard_pasted (widgets);
       return;
     }
 
   /* Check that the underlying adaptor allows the paste */
   if (parent)
     {
-      for (list = glade_clipboard_widgets (clipboard); list && list->data; list = list->next)
+      for (list = widgets; list && list->data; list = list->next)
         {
           widget = list->data;
 
           if (!glade_widget_add_verify (parent, widget, TRUE))
-            return;
+            {
+              glade_project_discard_pasted (widgets);
+              return;
+            }
         }
     }
 
 
   /* Check that we have compatible heirarchies */
-  for (list = glade_clipboard_widgets (clipboard); list && list->data; list = list->next)
+  for (list = widgets; list && list->data; list = list->next)
     {
       widget = list->data;
 
@@ -5235,12 +6065,13 @@ glade_project_command_paste (GladeProject     *project,
    */
   if (GTK_IS_WIDGET (glade_widget_get_object (widget)) &&
       parent && !GWA_USE_PLACEHOLDERS (glade_widget_get_adaptor (parent)) &&
-      g_list_length (glade_clipboard_widgets (clipboard)) != 1)
+      widgets->next != NULL)
     {
       glade_util_ui_message (glade_app_get_window (),
                              GLADE_UI_INFO, NULL,
                              _("Only one widget can be pasted at a "
                                "time to this container"));
+      glade_project_discard_pasted (widgets);
       return;
     }
 
@@ -5253,10 +6084,18 @@ glade_project_command_paste (GladeProject     *project,
                              GLADE_UI_INFO, NULL,
                              _("Insufficient amount of placeholders in "
                                "target container"));
+      glade_project_discard_pasted (widgets);
       return;
     }
 
-  glade_command_paste (glade_clipboard_widgets (clipboard), parent, placeholder, project);
+  /* The widgets are fresh instances, add them as they are */
+  glade_command_push_group (_("Paste %s"),
+                            widgets->next == NULL ?
+                            glade_widget_get_name (widgets->data) : _("multiple"));
+  glade_command_add (widgets, parent, placeholder, project, TRUE);
+  glade_command_pop_group ();
+
+  g_list_free (widgets);
 }
 
 void
@@ -5271,7 +6110,7 @@ glade_project_command_delete (GladeProject *project)
   if (glade_project_is_loading (project))
     return;
 
-  for (list = project->priv->selection; list && list->data; list = list->next)
+  for (list = project->priv->selection.head; list && list->data; list = list->next)
     {
       widget  = glade_widget_get_from_gobject (list->data);
       widgets = g_list_prepend (widgets, widget);
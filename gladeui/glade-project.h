@@ -186,6 +186,8 @@ GtkWidget          *glade_project_redo_items           (GladeProject       *proj
 
 /* Add/Remove Objects */
 const GList        *glade_project_get_objects          (GladeProject       *project);
+GList              *glade_project_list_objects_by_type (GladeProject       *project,
+                                                        GType               type);
 void                glade_project_add_object           (GladeProject       *project,
                                                         GObject            *object);
 void                glade_project_remove_object        (GladeProject       *project,
@@ -46,6 +46,7 @@
 #include "glade-editor-property.h"
 #include "glade-displayable-values.h"
 #include "glade-debug.h"
+#include "glade-private.h"
 
 #define NUMERICAL_STEP_INCREMENT   1.0F
 #define NUMERICAL_PAGE_INCREMENT   10.0F
@@ -59,7 +60,8 @@
 struct _GladePropertyClass
 {
   GladeWidgetAdaptor *adaptor; /* The GladeWidgetAdaptor that this property class
-				* was created for.
+				* was created for, derived adaptors share it
+				* unless their catalog overrides it.
 				*/
 
   guint16     version_since_major; /* Version in which this property was */
@@ -68,8 +70,8 @@ struct _GladePropertyClass
   GParamSpec *pspec; /* The Parameter Specification for this property.
 		      */
 
-  gchar *id;       /* The id of the property. Like "label" or "xpad"
-		    * this is a non-translatable string
+  const gchar *id; /* The id of the property. Like "label" or "xpad"
+		    * this is a non-translatable interned string
 		    */
 
   gchar *name;     /* The name of the property. Like "Label" or "X Pad"
@@ -204,7 +206,7 @@ glade_property_class_new (GladeWidgetAdaptor *adaptor,
   property_class = g_slice_new0 (GladePropertyClass);
   property_class->adaptor = adaptor;
   property_class->pspec = NULL;
-  property_class->id = g_strdup (id);
+  property_class->id = g_intern_string (id);
   property_class->name = NULL;
   property_class->tooltip = NULL;
   property_class->def = NULL;
@@ -267,7 +269,6 @@ glade_property_class_clone (GladePropertyClass *property_class,
 
   /* Make sure we own our strings */
   clone->pspec = property_class->pspec;
-  clone->id = g_strdup (clone->id);
   clone->name = g_strdup (clone->name);
   clone->tooltip = g_strdup (clone->tooltip);
 
@@ -302,7 +303,6 @@ glade_property_class_free (GladePropertyClass * property_class)
 
   g_return_if_fail (GLADE_IS_PROPERTY_CLASS (property_class));
 
-  g_free (property_class->id);
   g_free (property_class->tooltip);
   g_free (property_class->name);
   if (property_class->orig_def)
@@ -336,21 +336,7 @@ glade_property_class_get_default_from_spec (GParamSpec * spec)
 static gchar *
 glade_property_class_make_string_from_enum (GType etype, gint eval)
 {
-  GEnumClass *eclass;
-  gchar *string = NULL;
-  guint i;
-
-  g_return_val_if_fail ((eclass = g_type_class_ref (etype)) != NULL, NULL);
-  for (i = 0; i < eclass->n_values; i++)
-    {
-      if (eval == eclass->values[i].value)
-        {
-          string = g_strdup (eclass->values[i].value_nick);
-          break;
-        }
-    }
-  g_type_class_unref (eclass);
-  return string;
+  return g_strdup (_glade_enum_value_get_nick (etype, eval));
 }
 
 static gchar *
@@ -580,44 +566,41 @@ glade_property_class_make_string_from_gvalue (GladePropertyClass *
   return string;
 }
 
-/* This is copied exactly from libglade. I've just renamed the function.
+/* This is copied from libglade, values are looked up in the
+ * conversion table of the type and the string is not duplicated.
  */
 static guint
 glade_property_class_make_flags_from_string (GType type, const char *string)
 {
-  GFlagsClass *fclass;
-  gchar *endptr, *prevptr;
+  const gchar *endptr, *prevptr;
+  gchar buffer[128];
   guint i, j, ret = 0;
-  char *flagstr;
 
-  ret = strtoul (string, &endptr, 0);
+  ret = strtoul (string, (gchar **) &endptr, 0);
   if (endptr != string)         /* parsed a number */
     return ret;
 
-  fclass = g_type_class_ref (type);
-
+  /* The common case of a single value */
+  if (_glade_flags_value_lookup (type, string, &ret))
+    return ret;
 
-  flagstr = g_strdup (string);
   for (ret = i = j = 0;; i++)
     {
       gboolean eos;
 
-      eos = flagstr[i] == '\0';
+      eos = string[i] == '\0';
 
-      if (eos || flagstr[i] == '|')
+      if (eos || string[i] == '|')
         {
-          GFlagsValue *fv;
+          guint fv;
           const char *flag;
           gunichar ch;
 
-          flag = &flagstr[j];
-          endptr = &flagstr[i];
+          flag = &string[j];
+          endptr = &string[i];
 
           if (!eos)
-            {
-              flagstr[i++] = '\0';
-              j = i;
-            }
+            j = i + 1;
 
           /* trim spaces */
           for (;;)
@@ -639,16 +622,19 @@ glade_property_class_make_flags_from_string (GType type, const char *string)
 
           if (endptr > flag)
             {
-              *endptr = '\0';
-              fv = g_flags_get_value_by_name (fclass, flag);
+              gsize len = endptr - flag;
+              gchar *name = len < sizeof (buffer) ? buffer : g_malloc (len + 1);
 
-              if (!fv)
-                fv = g_flags_get_value_by_nick (fclass, flag);
+              memcpy (name, flag, len);
+              name[len] = '\0';
 
-              if (fv)
-                ret |= fv->value;
+              if (_glade_flags_value_lookup (type, name, &fv))
+                ret |= fv;
               else
-                g_warning ("Unknown flag: '%s'", flag);
+                g_warning ("Unknown flag: '%s'", name);
+
+              if (name != buffer)
+                g_free (name);
             }
 
           if (eos)
@@ -656,10 +642,6 @@ glade_property_class_make_flags_from_string (GType type, const char *string)
         }
     }
 
-  g_free (flagstr);
-
-  g_type_class_unref (fclass);
-
   return ret;
 }
 
@@ -668,8 +650,6 @@ glade_property_class_make_flags_from_string (GType type, const char *string)
 static gint
 glade_property_class_make_enum_from_string (GType type, const char *string)
 {
-  GEnumClass *eclass;
-  GEnumValue *ev;
   gchar *endptr;
   gint ret = 0;
 
@@ -677,14 +657,8 @@ glade_property_class_make_enum_from_string (GType type, const char *string)
   if (endptr != string)         /* parsed a number */
     return ret;
 
-  eclass = g_type_class_ref (type);
-  ev = g_enum_get_value_by_name (eclass, string);
-  if (!ev)
-    ev = g_enum_get_value_by_nick (eclass, string);
-  if (ev)
-    ret = ev->value;
-
-  g_type_class_unref (eclass);
+  if (!_glade_enum_value_lookup (type, string, &ret))
+    ret = 0;
 
   return ret;
 }
@@ -696,34 +670,17 @@ glade_property_class_make_object_from_string (GladePropertyClass *
                                               GladeProject * project)
 {
   GObject *object = NULL;
-  gchar *fullpath;
 
   if (string == NULL)
     return NULL;
 
   if (property_class->pspec->value_type == GDK_TYPE_PIXBUF && project)
     {
-      GdkPixbuf *pixbuf;
-
       if (*string == '\0')
         return NULL;
 
-      fullpath = glade_project_resource_fullpath (project, string);
-
-      if ((pixbuf = gdk_pixbuf_new_from_file (fullpath, NULL)) == NULL)
-        {
-          pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-                                             "image-missing", 22, 0, NULL);
-        }
-
-      if (pixbuf)
-        {
-          object = G_OBJECT (pixbuf);
-          g_object_set_data_full (object, "GladeFileName",
-                                  g_strdup (string), g_free);
-        }
-
-      g_free (fullpath);
+      /* Decoded asynchronously and shared through the project image cache */
+      object = (GObject *) _glade_project_load_pixbuf (project, string);
     }
   else if (project)
     {
@@ -2156,7 +2113,7 @@ glade_property_class_match (GladePropertyClass * klass,
   g_return_val_if_fail (klass != NULL, FALSE);
   g_return_val_if_fail (comp != NULL, FALSE);
 
-  return (strcmp (klass->id, comp->id) == 0 &&
+  return (klass->id == comp->id &&
           klass->packing == comp->packing &&
           klass->pspec->owner_type == comp->pspec->owner_type);
 }
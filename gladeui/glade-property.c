@@ -54,6 +54,7 @@
 #include "glade-app.h"
 #include "glade-editor.h"
 #include "glade-marshallers.h"
+#include "glade-private.h"
 
 struct _GladePropertyPrivate {
 
@@ -67,7 +68,9 @@ struct _GladePropertyPrivate {
   GladePropertyState  state;     /* Current property state, used by editing widgets.
 				  */
 	
-  GValue             *value;     /* The value of the property
+  GValue             *value;     /* The value of the property, this is the
+				  * original default of the class until
+				  * the property is first written to.
 				  */
 
   gchar              *insensitive_tooltip; /* Tooltip to display when in insensitive state
@@ -80,6 +83,9 @@ struct _GladePropertyPrivate {
 					* (used to explain why the property is 
 					*  insensitive)
 					*/
+  guint               value_shared : 1; /* Whether value belongs to the class
+					 */
+
   guint               support_disabled : 1; /* Whether this property is disabled due
 					     * to format conflicts
 					     */
@@ -141,6 +147,35 @@ static GObjectClass *glade_property_parent_class = NULL;
 /*******************************************************************************
                            GladeProperty class methods
  *******************************************************************************/
+/* Most properties stay at their default, they share the original default
+ * of their class and get a value of their own on the first write.
+ */
+static void
+glade_property_share_default (GladeProperty *property)
+{
+  property->priv->value = (GValue *)
+    glade_property_class_get_original_default (property->priv->klass);
+  property->priv->value_shared = TRUE;
+}
+
+static GValue *
+glade_property_own_value (GladeProperty *property)
+{
+  GladePropertyPrivate *priv = property->priv;
+
+  if (priv->value_shared)
+    {
+      const GValue *shared = priv->value;
+
+      priv->value = g_new0 (GValue, 1);
+      g_value_init (priv->value, G_VALUE_TYPE (shared));
+      g_value_copy (shared, priv->value);
+      priv->value_shared = FALSE;
+    }
+
+  return priv->value;
+}
+
 static GladeProperty *
 glade_property_dup_impl (GladeProperty *template_prop, GladeWidget *widget)
 {
@@ -153,9 +188,6 @@ glade_property_dup_impl (GladeProperty *template_prop, GladeWidget *widget)
 			   "i18n-comment", template_prop->priv->i18n_comment, 
 			   NULL);
   property->priv->widget = widget;
-  property->priv->value = g_new0 (GValue, 1);
-
-  g_value_init (property->priv->value, template_prop->priv->value->g_type);
 
   /* Cannot duplicate parentless_widget property */
   if (glade_property_class_parentless_widget (template_prop->priv->klass))
@@ -163,10 +195,18 @@ glade_property_dup_impl (GladeProperty *template_prop, GladeWidget *widget)
       if (!G_IS_PARAM_SPEC_OBJECT (glade_property_class_get_pspec (template_prop->priv->klass)))
         g_warning ("Parentless widget property should be of object type");
 
+      property->priv->value = g_new0 (GValue, 1);
+      g_value_init (property->priv->value, template_prop->priv->value->g_type);
       g_value_set_object (property->priv->value, NULL);
     }
+  else if (template_prop->priv->value_shared)
+    glade_property_share_default (property);
   else
-    g_value_copy (template_prop->priv->value, property->priv->value);
+    {
+      property->priv->value = g_new0 (GValue, 1);
+      g_value_init (property->priv->value, template_prop->priv->value->g_type);
+      g_value_copy (template_prop->priv->value, property->priv->value);
+    }
 
   property->priv->enabled = template_prop->priv->enabled;
   property->priv->state   = template_prop->priv->state;
@@ -304,6 +344,7 @@ glade_property_set_value_impl (GladeProperty *property, const GValue *value)
   gboolean changed = FALSE;
   GValue old_value = { 0, };
   gboolean warn_before, warn_after;
+  gboolean notify, keep_old;
 
 #ifdef GLADE_ENABLE_DEBUG
   if (glade_get_debug_flags () & GLADE_DEBUG_PROPERTIES)
@@ -356,34 +397,64 @@ glade_property_set_value_impl (GladeProperty *property, const GValue *value)
   /* Check pre-changed warning state */
   warn_before = glade_property_warn_usage (property);
 
-  /* Make a copy of the old value */
-  g_value_init (&old_value, G_VALUE_TYPE (property->priv->value));
-  g_value_copy (property->priv->value, &old_value);
+  /* Make a copy of the old value, only if someone is going to look at it */
+  notify = changed && property->priv->widget;
+  keep_old = glade_property_class_parentless_widget (property->priv->klass) ||
+    (notify && (GLADE_PROPERTY_GET_KLASS (property)->value_changed != NULL ||
+                g_signal_has_handler_pending (property, glade_property_signals[VALUE_CHANGED],
+                                              0, FALSE)));
+
+  if (keep_old)
+    {
+      g_value_init (&old_value, G_VALUE_TYPE (property->priv->value));
+      g_value_copy (property->priv->value, &old_value);
+    }
 
   /* Assign property first so that; if the object need be
-   * rebuilt, it will reflect the new value
+   * rebuilt, it will reflect the new value (a shared default
+   * is kept as long as it is identical)
    */
-  g_value_reset (property->priv->value);
-  g_value_copy (value, property->priv->value);
+  if (!property->priv->value_shared ||
+      G_VALUE_TYPE (value) != G_VALUE_TYPE (property->priv->value) ||
+      g_param_values_cmp (glade_property_class_get_pspec (property->priv->klass),
+                          property->priv->value, value) != 0)
+    {
+      glade_property_own_value (property);
+      g_value_reset (property->priv->value);
+      g_value_copy (value, property->priv->value);
+    }
 
   GLADE_PROPERTY_GET_KLASS (property)->sync (property);
 
+  /* A placeholder image is patched once the image is decoded */
+  if (project && G_VALUE_HOLDS (value, GDK_TYPE_PIXBUF))
+    _glade_project_watch_pixbuf (project, property);
+
   glade_property_fix_state (property);
 
-  if (changed && property->priv->widget)
+  if (notify)
     {
-      g_signal_emit (G_OBJECT (property),
-                     glade_property_signals[VALUE_CHANGED],
-                     0, &old_value, property->priv->value);
+      if (project)
+        _glade_project_invalidate_verify (project, property->priv->widget);
+
+      if (keep_old)
+        g_signal_emit (G_OBJECT (property),
+                       glade_property_signals[VALUE_CHANGED],
+                       0, &old_value, property->priv->value);
 
-      glade_project_verify_property (property);
+      /* Inside command groups this is done once when the group ends */
+      if (project == NULL ||
+          !_glade_project_defer_verify (project, property, warn_before))
+        {
+          glade_project_verify_property (property);
 
-      /* Check post change warning state */
-      warn_after = glade_property_warn_usage (property);
+          /* Check post change warning state */
+          warn_after = glade_property_warn_usage (property);
 
-      /* Update owning widget's warning state if need be */
-      if (property->priv->widget != NULL && warn_before != warn_after)
-	glade_widget_verify (property->priv->widget);
+          /* Update owning widget's warning state if need be */
+          if (property->priv->widget != NULL && warn_before != warn_after)
+            glade_widget_verify (property->priv->widget);
+        }
     }
 
   /* Special case parentless widget properties */
@@ -401,7 +472,8 @@ glade_property_set_value_impl (GladeProperty *property, const GValue *value)
         glade_widget_hide (gobj);  
     }
 
-  g_value_unset (&old_value);
+  if (keep_old)
+    g_value_unset (&old_value);
   return TRUE;
 }
 
@@ -458,18 +530,23 @@ glade_property_sync_impl (GladeProperty *property)
    */
   if (glade_property_class_get_construct_only (klass) && priv->syncing == 1)
     {
-      /* Virtual properties can be construct only, in which
-       * case they are allowed to trigger a rebuild, and in
-       * the process are allowed to get "synced" after the
-       * instance is rebuilt.
+      GladeProject *project = glade_widget_get_project (priv->widget);
+
+      /* While the instance is rebuilt real construct only properties
+       * are applied at construction time, virtual ones can be construct
+       * only too and are allowed to get "synced" on the new instance.
+       *
+       * Otherwise the rebuild is deferred to the end of the current
+       * command group, so that the widget is rebuilt only once.
        */
-      if (glade_property_class_get_virtual (klass))
-        priv->sync_tolerance++;
-
-      glade_widget_rebuild (priv->widget);
-
-      if (glade_property_class_get_virtual (klass))
-        priv->sync_tolerance--;
+      if (_glade_widget_is_rebuilding (priv->widget))
+        {
+          if (glade_property_class_get_virtual (klass))
+            glade_widget_object_set_property (priv->widget, id, value);
+        }
+      else if (project == NULL ||
+               !_glade_project_defer_rebuild (project, priv->widget))
+        glade_widget_rebuild (priv->widget);
     }
   else if (glade_property_class_get_is_packing (klass))
     glade_widget_child_set_property (glade_widget_get_parent (priv->widget),
@@ -499,7 +576,27 @@ glade_property_load_impl (GladeProperty *property)
   object = glade_widget_get_object (property->priv->widget);
   oclass = G_OBJECT_GET_CLASS (object);
 
-  if (g_object_class_find_property (oclass, glade_property_class_id (property->priv->klass)))
+  if (!g_object_class_find_property (oclass, glade_property_class_id (property->priv->klass)))
+    return;
+
+  if (property->priv->value_shared)
+    {
+      GValue value = G_VALUE_INIT;
+
+      /* Keep sharing the default if that's what the object has */
+      g_value_init (&value, G_VALUE_TYPE (property->priv->value));
+      glade_widget_object_get_property (property->priv->widget,
+                                        glade_property_class_id (property->priv->klass),
+                                        &value);
+
+      if (g_param_values_cmp (pspec, property->priv->value, &value) != 0)
+        {
+          glade_property_own_value (property);
+          g_value_copy (&value, property->priv->value);
+        }
+      g_value_unset (&value);
+    }
+  else
     glade_widget_object_get_property (property->priv->widget, 
 				      glade_property_class_id (property->priv->klass),
                                       property->priv->value);
@@ -586,7 +683,7 @@ glade_property_finalize (GObject *object)
 {
   GladeProperty *property = GLADE_PROPERTY (object);
 
-  if (property->priv->value)
+  if (property->priv->value && !property->priv->value_shared)
     {
       g_value_unset (property->priv->value);
       g_free (property->priv->value);
@@ -777,14 +874,7 @@ glade_property_new (GladePropertyClass *klass,
     property->priv->enabled = glade_property_class_optional_default (klass);
 
   if (property->priv->value == NULL)
-    {
-      const GValue *orig_def =
-	glade_property_class_get_original_default (klass);
-
-      property->priv->value = g_new0 (GValue, 1);
-      g_value_init (property->priv->value, orig_def->g_type);
-      g_value_copy (orig_def, property->priv->value);
-    }
+    glade_property_share_default (property);
 
   return property;
 }
@@ -1553,6 +1643,10 @@ glade_property_set_enabled (GladeProperty *property, gboolean enabled)
   property->priv->enabled = enabled;
   glade_property_sync (property);
 
+  if (property->priv->widget && glade_widget_get_project (property->priv->widget))
+    _glade_project_invalidate_verify (glade_widget_get_project (property->priv->widget),
+                                      property->priv->widget);
+
   glade_property_fix_state (property);
 
   /* Check post-changed warning state */
@@ -1598,11 +1692,27 @@ glade_property_get_widget (GladeProperty *property)
   return property->priv->widget;
 }
 
+/**
+ * glade_property_inline_value:
+ * @property: a #GladeProperty
+ *
+ * The returned value may be modified in place, a property which
+ * still shares the default of its class gets a value of its own.
+ *
+ * Returns: (transfer none): the value of @property
+ */
 GValue *
 glade_property_inline_value (GladeProperty *property)
 {
   g_return_val_if_fail (GLADE_IS_PROPERTY (property), NULL);
 
+  return glade_property_own_value (property);
+}
+
+/* Read only access which keeps a shared default shared */
+const GValue *
+_glade_property_peek_value (GladeProperty *property)
+{
   return property->priv->value;
 }
 
@@ -38,6 +38,7 @@ struct _GladeSignalClass
   const gchar        *name;                /* Name of the signal, eg clicked */
   const gchar        *type;                /* Name of the object class that this signal 
 					    * belongs to eg GtkButton */
+                                           /* (both are interned strings) */
 
   guint deprecated : 1;                    /* True if this signal is deprecated */
 };
@@ -65,8 +66,8 @@ glade_signal_class_new  (GladeWidgetAdaptor *adaptor,
       return NULL;
     }
 
-  class->name = (class->query.signal_name);
-  class->type = g_type_name (for_type);
+  class->name = g_intern_string (class->query.signal_name);
+  class->type = g_intern_string (g_type_name (for_type));
 
   /* Initialize signal versions & deprecated to adaptor version */
   class->version_since_major = GWA_VERSION_SINCE_MAJOR (adaptor);
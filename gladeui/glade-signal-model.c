@@ -30,16 +30,63 @@
 #define HANDLER_DEFAULT  _("<Type here>")
 #define USERDATA_DEFAULT _("<Click here>")
 
+/* The signal classes of an adaptor grouped by the type declaring them,
+ * computed once per adaptor and shared by the models of its widgets.
+ */
+typedef struct
+{
+  const gchar *type;       /* Interned name of the declaring type */
+  GPtrArray   *classes;    /* GladeSignalClass, in the adaptor's order */
+} SignalGroup;
+
+typedef struct
+{
+  guint group;             /* Index of the SignalGroup */
+  guint index;             /* Index of the class in the group */
+} SignalPosition;
+
+typedef struct
+{
+  GPtrArray      *groups;    /* SignalGroup */
+  SignalPosition *positions;
+  GHashTable     *by_name;   /* Interned signal name -> SignalPosition */
+} SignalIndex;
+
+/* A row under a type, the handlers of each signal are followed
+ * by a dummy row used to add new handlers.
+ */
+typedef struct
+{
+  const GladeSignalClass *sig_class;
+  GladeSignal            *handler;   /* NULL for the dummy row */
+} SignalRow;
+
+/* A toplevel row of the model */
+typedef struct
+{
+  const SignalGroup *group;
+  guint              index;  /* Position among the toplevel rows */
+  GArray            *rows;   /* SignalRow */
+} ModelGroup;
+
 struct _GladeSignalModelPrivate
 {
   GladeWidget *widget;
-  GList       *widgets; /* names of the widgets that this widgets derives from and that have signals */
+  SignalIndex *index;   /* The index of the widget's adaptor */
+  GPtrArray   *groups;  /* ModelGroup, one per SignalGroup */
   gint         stamp;
 
   GHashTable  *dummy_signals;
   GHashTable  *signals; /* signals of the widget */
 };
 
+/* Iters point to a ModelGroup in user_data, rows under it also
+ * carry their index + 1 in user_data2.
+ */
+#define ITER_GROUP(iter) ((ModelGroup *) (iter)->user_data)
+#define ITER_ROW(iter)   (GPOINTER_TO_UINT ((iter)->user_data2) - 1)
+#define ITER_IS_ROW(iter) ((iter)->user_data2 != NULL)
+
 enum
 {
   PROP_0,
@@ -54,7 +101,7 @@ static void on_glade_signal_model_added (GladeWidget *widget, const GladeSignal
 static void on_glade_signal_model_removed (GladeWidget *widget, const GladeSignal *signal,
 					   GladeSignalModel *model);
 static void on_glade_signal_model_changed (GladeWidget *widget, const GladeSignal *signal,
-					   GladeSignalModel *model);	
+					   GladeSignalModel *model);
 static void on_glade_widget_support_changed (GladeWidget *widget, GladeSignalModel *model);
 
 G_DEFINE_TYPE_WITH_CODE (GladeSignalModel, glade_signal_model, G_TYPE_OBJECT,
@@ -64,35 +111,165 @@ G_DEFINE_TYPE_WITH_CODE (GladeSignalModel, glade_signal_model, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_DRAG_SOURCE,
                                                 gtk_tree_drag_source_iface_init))
 
+static void
+signal_index_free (SignalIndex *index)
+{
+  guint i;
+
+  for (i = 0; i < index->groups->len; i++)
+    {
+      SignalGroup *group = g_ptr_array_index (index->groups, i);
+
+      g_ptr_array_free (group->classes, TRUE);
+      g_slice_free (SignalGroup, group);
+    }
+
+  g_ptr_array_free (index->groups, TRUE);
+  g_hash_table_destroy (index->by_name);
+  g_free (index->positions);
+  g_slice_free (SignalIndex, index);
+}
+
+static SignalIndex *
+signal_index_get (GladeWidgetAdaptor *adaptor)
+{
+  static GQuark index_quark = 0;
+  SignalIndex *index;
+  SignalGroup *group = NULL;
+  const GList *list;
+  guint i;
+
+  if (index_quark == 0)
+    index_quark = g_quark_from_static_string ("glade-signal-model-index");
+
+  if ((index = g_object_get_qdata (G_OBJECT (adaptor), index_quark)) != NULL)
+    return index;
+
+  index            = g_slice_new0 (SignalIndex);
+  index->groups    = g_ptr_array_new ();
+  index->by_name   = g_hash_table_new (g_direct_hash, g_direct_equal);
+  index->positions = g_new0 (SignalPosition,
+                             g_list_length ((GList *) glade_widget_adaptor_get_signals (adaptor)));
+
+  /* Type names are interned, signals of a type are listed together */
+  for (list = glade_widget_adaptor_get_signals (adaptor), i = 0;
+       list; list = list->next, i++)
+    {
+      GladeSignalClass *sig_class = list->data;
+      const gchar *type = glade_signal_class_get_type (sig_class);
+      SignalPosition *position = &index->positions[i];
+
+      if (group == NULL || group->type != type)
+        {
+          guint g;
+
+          for (g = 0, group = NULL; g < index->groups->len; g++)
+            if (((SignalGroup *) g_ptr_array_index (index->groups, g))->type == type)
+              group = g_ptr_array_index (index->groups, g);
+
+          if (group == NULL)
+            {
+              group          = g_slice_new0 (SignalGroup);
+              group->type    = type;
+              group->classes = g_ptr_array_new ();
+              g_ptr_array_add (index->groups, group);
+            }
+        }
+
+      for (position->group = 0;
+           g_ptr_array_index (index->groups, position->group) != group;
+           position->group++);
+      position->index = group->classes->len;
+
+      g_ptr_array_add (group->classes, sig_class);
+      g_hash_table_insert (index->by_name,
+                           (gpointer) glade_signal_class_get_name (sig_class),
+                           position);
+    }
+
+  g_object_set_qdata_full (G_OBJECT (adaptor), index_quark, index,
+                           (GDestroyNotify) signal_index_free);
+
+  return index;
+}
+
+static void
+model_group_free (ModelGroup *group)
+{
+  g_array_free (group->rows, TRUE);
+  g_slice_free (ModelGroup, group);
+}
+
 static void
 glade_signal_model_init (GladeSignalModel *object)
 {
   object->priv = glade_signal_model_get_instance_private (object);
 
-  object->priv->dummy_signals = 
-    g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_object_unref);
+  object->priv->dummy_signals =
+    g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_object_unref);
+  object->priv->groups =
+    g_ptr_array_new_with_free_func ((GDestroyNotify) model_group_free);
 }
 
 static void
-glade_signal_model_create_widget_list (GladeSignalModel *sig_model)
+glade_signal_model_create_groups (GladeSignalModel *sig_model)
 {
-  const GList *list;
   GladeWidget *widget = sig_model->priv->widget;
-  GladeWidgetAdaptor *adaptor = glade_widget_get_adaptor (widget);
+  SignalIndex *index;
+  guint g, i, j;
 
-  for (list = glade_widget_adaptor_get_signals (adaptor);
-       list != NULL; list = g_list_next (list))
+  index = sig_model->priv->index =
+    signal_index_get (glade_widget_get_adaptor (widget));
+
+  for (g = 0; g < index->groups->len; g++)
     {
-      GladeSignalClass *signal = (GladeSignalClass *) list->data;
+      SignalGroup *group = g_ptr_array_index (index->groups, g);
+      ModelGroup *model_group = g_slice_new0 (ModelGroup);
 
-      if (!g_list_find_custom (sig_model->priv->widgets, 
-			       (gpointer) glade_signal_class_get_type (signal), (GCompareFunc) strcmp))
-	{
-	  sig_model->priv->widgets = 
-	    g_list_prepend (sig_model->priv->widgets, (gpointer) glade_signal_class_get_type (signal));
-	}
+      model_group->group = group;
+      model_group->index = g;
+      model_group->rows  = g_array_new (FALSE, FALSE, sizeof (SignalRow));
+
+      for (i = 0; i < group->classes->len; i++)
+        {
+          SignalRow row = { g_ptr_array_index (group->classes, i), NULL };
+          GPtrArray *handlers = NULL;
+
+          if (sig_model->priv->signals)
+            handlers = g_hash_table_lookup (sig_model->priv->signals,
+                                            glade_signal_class_get_name (row.sig_class));
+
+          for (j = 0; handlers && j < handlers->len; j++)
+            {
+              SignalRow handler_row = { row.sig_class, g_ptr_array_index (handlers, j) };
+
+              g_array_append_val (model_group->rows, handler_row);
+            }
+
+          g_array_append_val (model_group->rows, row);
+        }
+
+      g_ptr_array_add (sig_model->priv->groups, model_group);
     }
-  sig_model->priv->widgets = g_list_reverse (sig_model->priv->widgets);
+}
+
+static void
+glade_signal_model_constructed (GObject *object)
+{
+  GladeSignalModel *sig_model = GLADE_SIGNAL_MODEL (object);
+
+  G_OBJECT_CLASS (glade_signal_model_parent_class)->constructed (object);
+
+  glade_signal_model_create_groups (sig_model);
+
+  g_signal_connect (sig_model->priv->widget, "add-signal-handler",
+                    G_CALLBACK (on_glade_signal_model_added), sig_model);
+  g_signal_connect (sig_model->priv->widget, "remove-signal-handler",
+                    G_CALLBACK (on_glade_signal_model_removed), sig_model);
+  g_signal_connect (sig_model->priv->widget, "change-signal-handler",
+                    G_CALLBACK (on_glade_signal_model_changed), sig_model);
+  g_signal_connect (sig_model->priv->widget, "support-changed",
+                    G_CALLBACK (on_glade_widget_support_changed), sig_model);
 }
 
 static void
@@ -100,7 +277,7 @@ glade_signal_model_finalize (GObject *object)
 {
   GladeSignalModel *sig_model = GLADE_SIGNAL_MODEL (object);
 
-  g_list_free (sig_model->priv->widgets);
+  g_ptr_array_free (sig_model->priv->groups, TRUE);
   g_hash_table_destroy (sig_model->priv->dummy_signals);
   G_OBJECT_CLASS (glade_signal_model_parent_class)->finalize (object);
 }
@@ -121,15 +298,6 @@ glade_signal_model_set_property (GObject *object,
     {
       case PROP_WIDGET:
         sig_model->priv->widget = g_value_get_object (value);
-        glade_signal_model_create_widget_list (sig_model);
-        g_signal_connect (sig_model->priv->widget, "add-signal-handler",
-                          G_CALLBACK (on_glade_signal_model_added), sig_model);
-        g_signal_connect (sig_model->priv->widget, "remove-signal-handler",
-                          G_CALLBACK (on_glade_signal_model_removed), sig_model);
-        g_signal_connect (sig_model->priv->widget, "change-signal-handler",
-                          G_CALLBACK (on_glade_signal_model_changed), sig_model);
-        g_signal_connect (sig_model->priv->widget, "support-changed",
-                          G_CALLBACK (on_glade_widget_support_changed), sig_model);
       break;
       case PROP_SIGNALS:
         sig_model->priv->signals = g_value_get_pointer (value);
@@ -171,6 +339,7 @@ glade_signal_model_class_init (GladeSignalModelClass *klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
+  object_class->constructed = glade_signal_model_constructed;
   object_class->finalize = glade_signal_model_finalize;
   object_class->set_property = glade_signal_model_set_property;
   object_class->get_property = glade_signal_model_get_property;
@@ -203,7 +372,7 @@ GtkTreeModel *
 glade_signal_model_new (GladeWidget *widget, GHashTable *signals)
 {
   GObject *object = g_object_new (GLADE_TYPE_SIGNAL_MODEL,
-				  "widget", widget, 
+				  "widget", widget,
 				  "signals", signals, NULL);
   return GTK_TREE_MODEL (object);
 }
@@ -263,12 +432,12 @@ glade_signal_model_is_dummy_handler (GladeSignalModel *model,
 }
 
 static GladeSignal *
-glade_signal_model_get_dummy_handler (GladeSignalModel *model, 
+glade_signal_model_get_dummy_handler (GladeSignalModel *model,
                                       const GladeSignalClass *sig_class)
 {
   GladeSignal *signal;
 
-  signal = g_hash_table_lookup (model->priv->dummy_signals, 
+  signal = g_hash_table_lookup (model->priv->dummy_signals,
 				glade_signal_class_get_name (sig_class));
 
   if (!signal)
@@ -278,8 +447,8 @@ glade_signal_model_get_dummy_handler (GladeSignalModel *model,
 				 NULL,
 				 FALSE,
 				 FALSE);
-      g_hash_table_insert (model->priv->dummy_signals, 
-			   (gpointer) glade_signal_class_get_name (sig_class), 
+      g_hash_table_insert (model->priv->dummy_signals,
+			   (gpointer) glade_signal_class_get_name (sig_class),
 			   signal);
 
       glade_project_verify_signal (model->priv->widget, signal);
@@ -289,138 +458,187 @@ glade_signal_model_get_dummy_handler (GladeSignalModel *model,
 
 static void
 glade_signal_model_create_widget_iter (GladeSignalModel *sig_model,
-                                       const gchar *widget,
+                                       ModelGroup *group,
                                        GtkTreeIter *iter)
 {
   iter->stamp = sig_model->priv->stamp;
-  iter->user_data = (gpointer) widget;
+  iter->user_data = group;
   iter->user_data2 = NULL;
   iter->user_data3 = NULL;
 }
 
 static void
 glade_signal_model_create_signal_iter (GladeSignalModel *sig_model,
-                                       const gchar *widget,
-                                       const GladeSignal *signal,
+                                       ModelGroup *group,
+                                       guint row,
                                        GtkTreeIter *iter)
 {
-	glade_signal_model_create_widget_iter (sig_model, widget, iter);
-	iter->user_data2 = GLADE_SIGNAL (signal);
+	glade_signal_model_create_widget_iter (sig_model, group, iter);
+	iter->user_data2 = GUINT_TO_POINTER (row + 1);
 }
 
-static GList *
-glade_signal_model_create_signal_list (GladeSignalModel *sig_model,
-				       const gchar *widget_type)
+static GladeSignal *
+glade_signal_model_get_row_signal (GladeSignalModel *sig_model,
+                                   ModelGroup *group,
+                                   guint row)
 {
-  GList *widget_signals = NULL;
-  const GList *signals;
-  GladeWidget *widget = sig_model->priv->widget;
-  GladeWidgetAdaptor *adaptor = glade_widget_get_adaptor (widget);
+  SignalRow *signal_row = &g_array_index (group->rows, SignalRow, row);
+
+  if (signal_row->handler)
+    return signal_row->handler;
 
-  for (signals = glade_widget_adaptor_get_signals (adaptor);
-       signals != NULL;
-       signals = g_list_next (signals))
+  return glade_signal_model_get_dummy_handler (sig_model, signal_row->sig_class);
+}
+
+/* Finds the group and the row of @signal, or the dummy row of its
+ * class if @signal is %NULL.
+ */
+static ModelGroup *
+glade_signal_model_find_row (GladeSignalModel *model,
+                             const GladeSignalClass *sig_class,
+                             const GladeSignal *signal,
+                             guint *row)
+{
+  SignalPosition *position;
+  const GladeSignalClass *index_class;
+  ModelGroup *group;
+  guint i;
+
+  if ((position = g_hash_table_lookup (model->priv->index->by_name,
+                                       glade_signal_class_get_name (sig_class))) == NULL)
+    return NULL;
+
+  group = g_ptr_array_index (model->priv->groups, position->group);
+  index_class = g_ptr_array_index (group->group->classes, position->index);
+
+  for (i = 0; i < group->rows->len; i++)
     {
-      GladeSignalClass *sig_class = signals->data;
-      if (g_str_equal (glade_signal_class_get_type (sig_class), widget_type))
-	{
-	  widget_signals = g_list_append (widget_signals, sig_class);
-	}
+      SignalRow *signal_row = &g_array_index (group->rows, SignalRow, i);
+
+      if (signal_row->sig_class == index_class && signal_row->handler == signal)
+        {
+          *row = i;
+          return group;
+        }
     }
-  return widget_signals;
+
+  return NULL;
+}
+
+/* Whether the row is the first one of its signal, only those show the name */
+static gboolean
+glade_signal_model_row_shows_name (ModelGroup *group, guint row)
+{
+  return (row == 0 ||
+          g_array_index (group->rows, SignalRow, row - 1).sig_class !=
+          g_array_index (group->rows, SignalRow, row).sig_class);
 }
 
 static void
-on_glade_signal_model_added (GladeWidget *widget,
-                             const GladeSignal *signal,
-                             GladeSignalModel* model)
+glade_signal_model_emit_row_changed (GladeSignalModel *model,
+                                     ModelGroup *group,
+                                     guint row)
 {
-  GtkTreeIter iter;	
+  GtkTreeIter iter;
   GtkTreePath *path;
-  const GladeSignalClass *sig_class = glade_signal_get_class (signal);
-
-  glade_signal_model_create_signal_iter (model,
-					 glade_signal_class_get_type (sig_class),
-					 signal, 
-					 &iter);
-  path = gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter);
 
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (model), path, &iter);
+  glade_signal_model_create_signal_iter (model, group, row, &iter);
+  path = gtk_tree_path_new_from_indices (group->index, row, -1);
+  gtk_tree_model_row_changed (GTK_TREE_MODEL (model), path, &iter);
   gtk_tree_path_free (path);
-  model->priv->stamp++;
 }
 
 static void
-on_glade_signal_model_removed (GladeWidget *widget,
-                               const GladeSignal *signal,
-                               GladeSignalModel *model)
+on_glade_signal_model_added (GladeWidget *widget,
+                             const GladeSignal *signal,
+                             GladeSignalModel* model)
 {
   GtkTreeIter iter;
   GtkTreePath *path;
-  const GladeSignalClass *sig_class = glade_signal_get_class (signal);
-  
-  glade_signal_model_create_signal_iter (model,
-					 glade_signal_class_get_type (sig_class),
-					 signal, 
-					 &iter);
-  path = gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter);
-  gtk_tree_model_row_deleted (GTK_TREE_MODEL (model), path);
-  gtk_tree_path_free (path);
+  ModelGroup *group;
+  SignalRow row;
+  guint dummy;
+
+  /* New handlers go last, right before the dummy row */
+  if ((group = glade_signal_model_find_row (model, glade_signal_get_class (signal),
+                                            NULL, &dummy)) == NULL)
+    return;
+
+  row.sig_class = g_array_index (group->rows, SignalRow, dummy).sig_class;
+  row.handler   = (GladeSignal *) signal;
+  g_array_insert_val (group->rows, dummy, row);
   model->priv->stamp++;
+
+  glade_signal_model_create_signal_iter (model, group, dummy, &iter);
+  path = gtk_tree_path_new_from_indices (group->index, dummy, -1);
+  gtk_tree_model_row_inserted (GTK_TREE_MODEL (model), path, &iter);
+  gtk_tree_path_free (path);
+
+  /* The dummy row no longer shows the signal name */
+  if (glade_signal_model_row_shows_name (group, dummy))
+    glade_signal_model_emit_row_changed (model, group, dummy + 1);
 }
 
 static void
-on_glade_signal_model_changed (GladeWidget *widget,
+on_glade_signal_model_removed (GladeWidget *widget,
                                const GladeSignal *signal,
                                GladeSignalModel *model)
 {
-  GtkTreeIter iter;
   GtkTreePath *path;
-  const GladeSignalClass *sig_class = glade_signal_get_class (signal);
-  
-  glade_signal_model_create_signal_iter (model,
-					 glade_signal_class_get_type (sig_class),
-					 signal, 
-					 &iter);
-  path = gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter);
-  gtk_tree_model_row_changed (GTK_TREE_MODEL (model), path, &iter);
-  gtk_tree_path_free (path);
+  ModelGroup *group;
+  gboolean shows_name;
+  guint row;
+
+  if ((group = glade_signal_model_find_row (model, glade_signal_get_class (signal),
+                                            signal, &row)) == NULL)
+    return;
+
+  shows_name = glade_signal_model_row_shows_name (group, row);
+  g_array_remove_index (group->rows, row);
   model->priv->stamp++;
-}
 
-static void
-verify_dummies (const gchar *signal_name,
-                GladeSignal *signal,
-                GladeSignalModel *model)
-{
-  glade_project_verify_signal (model->priv->widget, signal);
+  path = gtk_tree_path_new_from_indices (group->index, row, -1);
+  gtk_tree_model_row_deleted (GTK_TREE_MODEL (model), path);
+  gtk_tree_path_free (path);
 
-  on_glade_signal_model_changed (model->priv->widget, signal, model);
+  /* The next row of the same signal now shows its name */
+  if (shows_name)
+    glade_signal_model_emit_row_changed (model, group, row);
 }
 
 static void
-emit_changed (const gchar *signal_name,
-	      GPtrArray *signals,
-	      GladeSignalModel *model)
+on_glade_signal_model_changed (GladeWidget *widget,
+                               const GladeSignal *signal,
+                               GladeSignalModel *model)
 {
-  gint i;
-  GladeSignal *signal;
+  ModelGroup *group;
+  guint row;
 
-  for (i = 0; i < signals->len; i++)
-    {
-      signal = (GladeSignal *)signals->pdata[i];
-      on_glade_signal_model_changed (model->priv->widget, signal, model);
-    }
+  if ((group = glade_signal_model_find_row (model, glade_signal_get_class (signal),
+                                            signal, &row)) != NULL)
+    glade_signal_model_emit_row_changed (model, group, row);
 }
 
 static void
 on_glade_widget_support_changed (GladeWidget *widget, GladeSignalModel *model)
 {
+  GHashTableIter iter;
+  gpointer dummy;
+  guint g, row;
+
   /* Update support warning on dummy signals */
-  g_hash_table_foreach (model->priv->dummy_signals, (GHFunc)verify_dummies, model);
+  g_hash_table_iter_init (&iter, model->priv->dummy_signals);
+  while (g_hash_table_iter_next (&iter, NULL, &dummy))
+    glade_project_verify_signal (model->priv->widget, dummy);
 
   /* row changed on every row */
-  g_hash_table_foreach (model->priv->signals, (GHFunc)emit_changed, model);
+  for (g = 0; g < model->priv->groups->len; g++)
+    {
+      ModelGroup *group = g_ptr_array_index (model->priv->groups, g);
+
+      for (row = 0; row < group->rows->len; row++)
+        glade_signal_model_emit_row_changed (model, group, row);
+    }
 }
 
 static gboolean
@@ -431,6 +649,7 @@ glade_signal_model_get_iter (GtkTreeModel *model,
   gint *indices;
   gint depth;
   GladeSignalModel *sig_model;
+  ModelGroup *group;
 
   g_return_val_if_fail (path != NULL, FALSE);
   g_return_val_if_fail (iter != NULL, FALSE);
@@ -440,95 +659,40 @@ glade_signal_model_get_iter (GtkTreeModel *model,
   depth = gtk_tree_path_get_depth (path);
   sig_model = GLADE_SIGNAL_MODEL (model);
 
-  switch (depth)
+  if (depth < 1 || depth > 2 ||
+      indices[ITER_WIDGET] < 0 || indices[ITER_WIDGET] >= sig_model->priv->groups->len)
+    return FALSE;
+
+  group = g_ptr_array_index (sig_model->priv->groups, indices[ITER_WIDGET]);
+
+  if (depth == 1)
     {
-      case 1:
-        /* Widget */
-        {
-          glade_signal_model_create_widget_iter (sig_model,
-                                                 g_list_nth_data (sig_model->priv->widgets,
-                                                                  indices[ITER_WIDGET]),
-                                                 iter);
-          return TRUE;
-        }
-      case 2:
-        /* Signal */
-        {
-          gboolean retval;
-          GtkTreePath *path =
-            gtk_tree_path_new_from_indices (indices[ITER_WIDGET], -1);
-          GtkTreeIter widget_iter;
-
-          gtk_tree_model_get_iter (model, &widget_iter, path);
-          retval = gtk_tree_model_iter_nth_child (model,
-                                                  iter,
-                                                  &widget_iter,
-                                                  indices[ITER_SIGNAL]);
-          gtk_tree_path_free (path);
-          return retval;
-        }
+      /* Widget */
+      glade_signal_model_create_widget_iter (sig_model, group, iter);
+      return TRUE;
     }
-  return FALSE;
+
+  /* Signal */
+  if (indices[ITER_SIGNAL] < 0 || indices[ITER_SIGNAL] >= group->rows->len)
+    return FALSE;
+
+  glade_signal_model_create_signal_iter (sig_model, group, indices[ITER_SIGNAL], iter);
+  return TRUE;
 }
 
 static GtkTreePath*
 glade_signal_model_get_path (GtkTreeModel *model, GtkTreeIter *iter)
 {
-  const gchar *widget;
-  GladeSignal *handler;
-  GladeSignalModel *sig_model;
-
   g_return_val_if_fail (iter != NULL, NULL);
   g_return_val_if_fail (GLADE_IS_SIGNAL_MODEL(model), NULL);
 
-  widget = iter->user_data;
-  handler = iter->user_data2;
-  sig_model = GLADE_SIGNAL_MODEL (model);
+  if (ITER_IS_ROW (iter))
+    /* Signal */
+    return gtk_tree_path_new_from_indices (ITER_GROUP (iter)->index, ITER_ROW (iter), -1);
+  else if (ITER_GROUP (iter))
+    /* Widget */
+    return gtk_tree_path_new_from_indices (ITER_GROUP (iter)->index, -1);
 
-  if (handler)
-    {
-      /* Signal */
-      const GladeSignalClass *sig_class = glade_signal_get_class (handler);
-      gint index0, index1 = 0;
-      GList *signal;
-      GList *signals = glade_signal_model_create_signal_list (sig_model,
-							      widget);
-
-      index0 = g_list_index (sig_model->priv->widgets,
-			     widget);
-
-      for (signal = signals; signal != NULL; signal = g_list_next (signal))
-	{		
-	  GPtrArray *handlers = g_hash_table_lookup (sig_model->priv->signals,
-						     glade_signal_class_get_name (signal->data));
-
-	  if (signal->data != sig_class)
-	    {
-	      if (handlers) 
-                index1 += handlers->len;
-	      index1++; /* dummy_handler */
-	    }
-	  else
-	    {
-	      if (handlers)
-		{
-		  guint handler_index;
-		  if (g_ptr_array_find (handlers, handler, &handler_index))
-		    index1 += handler_index;
-		  else
-		    index1 += handlers->len;
-		}
-	      break;
-	    }
-	}
-      return gtk_tree_path_new_from_indices (index0, index1, -1);
-    }
-  else if (widget)
-    {
-      /* Widget */
-      return gtk_tree_path_new_from_indices (g_list_index (sig_model->priv->widgets,
-							   widget), -1);
-    }
   g_assert_not_reached();
 }
 
@@ -537,19 +701,21 @@ glade_signal_model_get_value (GtkTreeModel *model,
                               GtkTreeIter *iter,
                               gint column,
                               GValue *value)
-{	
-  const gchar *widget;
-  GladeSignal *signal;
+{
+  ModelGroup *group;
+  GladeSignal *signal = NULL;
   GladeSignalModel *sig_model;
 
   g_return_if_fail (iter != NULL);
   g_return_if_fail (GLADE_IS_SIGNAL_MODEL(model));
 
-  widget = iter->user_data;
-  signal = iter->user_data2;
   sig_model = GLADE_SIGNAL_MODEL (model);
+  group = ITER_GROUP (iter);
 
-  value = g_value_init (value, 
+  if (ITER_IS_ROW (iter))
+    signal = glade_signal_model_get_row_signal (sig_model, group, ITER_ROW (iter));
+
+  value = g_value_init (value,
 			glade_signal_model_get_column_type (model, column));
 
   switch (column)
@@ -561,30 +727,21 @@ glade_signal_model_get_value (GtkTreeModel *model,
           break;
         }
         else
-          g_value_set_static_string (value, widget);
+          g_value_set_static_string (value, group->group->type);
       break;
       case GLADE_SIGNAL_COLUMN_SHOW_NAME:
         if (signal)
-        {
-          GPtrArray *handlers = g_hash_table_lookup (sig_model->priv->signals,
-                                                     glade_signal_get_name (signal));
-          guint index;
-          if (!handlers || !handlers->len || (g_ptr_array_find (handlers, signal, &index) && index == 0))
-            g_value_set_boolean (value, TRUE);
-          else
-            g_value_set_boolean (value, FALSE);
-          break;
-        }
-        else if (widget)
+          g_value_set_boolean (value, glade_signal_model_row_shows_name (group, ITER_ROW (iter)));
+        else
           g_value_set_boolean (value, TRUE);
-      break;	
+      break;
       case GLADE_SIGNAL_COLUMN_HANDLER:
         if (signal)
           {
             const gchar *handler = glade_signal_get_handler (signal);
             g_value_set_static_string (value, handler ? handler : HANDLER_DEFAULT);
           }
-        else 
+        else
           g_value_set_static_string (value, "");
       break;
       case GLADE_SIGNAL_COLUMN_OBJECT:
@@ -597,19 +754,19 @@ glade_signal_model_get_value (GtkTreeModel *model,
             g_value_set_static_string (value, USERDATA_DEFAULT);
           break;
         }
-        else 
+        else
           g_value_set_static_string (value, "");
       break;
       case GLADE_SIGNAL_COLUMN_SWAP:
         if (signal)
           g_value_set_boolean (value, glade_signal_get_swapped (signal));
-        else 
+        else
           g_value_set_boolean (value, FALSE);
       break;
       case GLADE_SIGNAL_COLUMN_AFTER:
         if (signal)
           g_value_set_boolean (value, glade_signal_get_after (signal));
-        else 
+        else
           g_value_set_boolean (value, FALSE);
         break;
       case GLADE_SIGNAL_COLUMN_TOOLTIP:
@@ -627,7 +784,7 @@ glade_signal_model_get_value (GtkTreeModel *model,
             const gchar *detail = glade_signal_get_detail (signal);
             g_value_set_static_string (value, detail ? detail : DETAIL_DEFAULT);
           }
-        else 
+        else
           g_value_set_static_string (value, "");
       break;
       default:
@@ -635,114 +792,35 @@ glade_signal_model_get_value (GtkTreeModel *model,
     }
 }
 
-static gboolean
-glade_signal_model_iter_next_signal (GladeSignalModel *sig_model,
-                                     const gchar *widget,
-                                     GtkTreeIter *iter,
-                                     GList *signal)
-{
-  if (signal->next)
-    {
-      signal = signal->next;
-      GladeSignal *next_handler;
-      GPtrArray *next_handlers = 
-	g_hash_table_lookup (sig_model->priv->signals,
-			     glade_signal_class_get_name (signal->data));
-      if (next_handlers && next_handlers->len)
-	{
-	  next_handler = g_ptr_array_index (next_handlers, 0);
-	}
-      else
-	{
-	  next_handler = 
-	    glade_signal_model_get_dummy_handler (sig_model,
-						  signal->data);
-	}
-      glade_signal_model_create_signal_iter (sig_model, widget,
-					     next_handler,
-					     iter);
-      g_list_free (signal);
-      return TRUE;
-    }
-  else
-    {
-      g_list_free (signal);
-      return FALSE;
-    }
-}
-
-
 static gboolean
 glade_signal_model_iter_next (GtkTreeModel *model, GtkTreeIter *iter)
 {
-  const gchar *widget;
-  GladeSignal *handler;
-  GtkTreeIter parent;
   GladeSignalModel *sig_model;
+  ModelGroup *group;
 
   g_return_val_if_fail (iter != NULL, FALSE);
   g_return_val_if_fail (GLADE_IS_SIGNAL_MODEL(model), FALSE);
 
-  widget = iter->user_data;
-  handler = iter->user_data2;
-
-  sig_model = GLADE_SIGNAL_MODEL (model);  
-
-  gtk_tree_model_iter_parent (model, &parent, iter);		
+  sig_model = GLADE_SIGNAL_MODEL (model);
+  group = ITER_GROUP (iter);
 
-  if (handler)
+  if (ITER_IS_ROW (iter))
     {
-      const GladeSignalClass *sig_class = glade_signal_get_class (handler);
-      GList *signals = 
-	glade_signal_model_create_signal_list (sig_model,
-					       widget);
-      GList* signal = g_list_find (signals, sig_class);
-      GPtrArray* handlers = g_hash_table_lookup (sig_model->priv->signals,
-						 glade_signal_class_get_name (sig_class));
-      if (glade_signal_model_is_dummy_handler (sig_model, handler))
-	{
-	  return glade_signal_model_iter_next_signal (sig_model, widget, iter, signal);
-	}
-      else if (handlers)
+      if (ITER_ROW (iter) + 1 < group->rows->len)
 	{
-	  guint new_index = 0;
-	  if (g_ptr_array_find (handlers, handler, &new_index))
-	    new_index++;
-
-	  if (new_index < handlers->len)
-	    {
-	      glade_signal_model_create_signal_iter (sig_model, widget,
-						     g_ptr_array_index (handlers, new_index),
-						     iter);
-	      g_list_free (signals);
-	      return TRUE;
-	    }
-	  else if (new_index == handlers->len)
-	    {
-	      glade_signal_model_create_signal_iter (sig_model, widget,
-						     glade_signal_model_get_dummy_handler (sig_model,
-											   sig_class),
-						     iter);
-	      g_list_free (signals);
-	      return TRUE;
-	    }
-	  else
-	    {
-	      return glade_signal_model_iter_next_signal (sig_model, widget, iter, signal);
-	    }
-	}
-      else
-	{
-	  g_list_free (signals);
-	  return FALSE;
+	  glade_signal_model_create_signal_iter (sig_model, group, ITER_ROW (iter) + 1, iter);
+	  return TRUE;
 	}
     }
-  else if (widget)
+  else if (group && group->index + 1 < sig_model->priv->groups->len)
     {
-      gint new_index = g_list_index (sig_model->priv->widgets, widget) + 1;
-      
-      return gtk_tree_model_iter_nth_child (model, iter, NULL, new_index);
+      glade_signal_model_create_widget_iter (sig_model,
+					     g_ptr_array_index (sig_model->priv->groups,
+								group->index + 1),
+					     iter);
+      return TRUE;
     }
+
   iter->user_data = NULL;
   iter->user_data2 = NULL;
   iter->user_data3 = NULL;
@@ -753,43 +831,18 @@ glade_signal_model_iter_next (GtkTreeModel *model, GtkTreeIter *iter)
 static gint
 glade_signal_model_iter_n_children (GtkTreeModel *model, GtkTreeIter *iter)
 {
-  GladeSignal *handler;
   GladeSignalModel *sig_model;
-  const gchar *widget;
 
   g_return_val_if_fail (GLADE_IS_SIGNAL_MODEL(model), 0);
 
-  /* FIXME: return the number of toplevels, if it makes sense in this context */
-  if (iter == NULL) return 0;
-  
-  handler = iter->user_data2;
   sig_model = GLADE_SIGNAL_MODEL (model);
-  widget = iter->user_data;
 
-  if (handler)
-    {
-      return 0;
-    }
-  else if (widget)
-    {
-      GList *signals = glade_signal_model_create_signal_list (sig_model,
-							      widget);
-      GList *signal;
-      gint retval = 0;
+  if (iter == NULL)
+    return sig_model->priv->groups->len;
+  else if (ITER_IS_ROW (iter))
+    return 0;
 
-      for (signal = signals; signal != NULL; signal = g_list_next (signal))
-	{
-	  GPtrArray* handlers = g_hash_table_lookup (sig_model->priv->signals,
-						     glade_signal_class_get_name (signal->data));
-	  if (handlers)
-	    retval += handlers->len;
-	  retval++; 
-	}
-      g_list_free (signals);
-      
-      return retval;
-    }
-  g_assert_not_reached ();	
+  return ITER_GROUP (iter)->rows->len;
 }
 
 static gboolean
@@ -807,70 +860,32 @@ glade_signal_model_iter_nth_child (GtkTreeModel *model,
                                    GtkTreeIter *parent,
                                    gint n)
 {
-  GladeSignal *handler;
   GladeSignalModel *sig_model;
-  const gchar *widget;
 
   g_return_val_if_fail (iter != NULL, 0);
   g_return_val_if_fail (GLADE_IS_SIGNAL_MODEL(model), 0);
 
-  handler = parent ? parent->user_data2 : NULL;
   sig_model = GLADE_SIGNAL_MODEL (model);
-  widget = parent ? parent->user_data : NULL;
 
-  if (handler)
-    {
-      return FALSE;
-    }
-  else if (widget)
-    {
-      GList *signals = glade_signal_model_create_signal_list (sig_model,
-							      widget);
-      GList *signal;
-      for (signal = signals; signal != NULL; signal = g_list_next (signal))
-	{
-	  GPtrArray *handlers = g_hash_table_lookup (sig_model->priv->signals,
-						     glade_signal_class_get_name (signal->data));
-	  if (handlers)
-	    {
-	      if (n >= handlers->len)
-		n -= handlers->len;
-	      else
-		{
-		  glade_signal_model_create_signal_iter (sig_model,
-							 widget,
-							 g_ptr_array_index (handlers, n),
-							 iter);
-		  g_list_free (signals);
-		  return TRUE;
-		}
-	    }
-	  if (n == 0)
-	    {
-	      GladeSignal *handler =
-		glade_signal_model_get_dummy_handler (sig_model,
-						      signal->data);
-	      glade_signal_model_create_signal_iter (sig_model,
-						     widget,
-						     handler,
-						     iter);
-	      g_list_free (signals);
-	      return TRUE;
-	    }
-	  n--;
-	}
-      return FALSE;
-    }
-  else
+  if (n < 0)
+    return FALSE;
+
+  if (parent == NULL)
     {
-      if (g_list_length (sig_model->priv->widgets) > n)
+      if (n < sig_model->priv->groups->len)
 	{
 	  glade_signal_model_create_widget_iter (sig_model,
-						 g_list_nth_data (sig_model->priv->widgets, n),
+						 g_ptr_array_index (sig_model->priv->groups, n),
 						 iter);
 	  return TRUE;
 	}
     }
+  else if (!ITER_IS_ROW (parent) && n < ITER_GROUP (parent)->rows->len)
+    {
+      glade_signal_model_create_signal_iter (sig_model, ITER_GROUP (parent), n, iter);
+      return TRUE;
+    }
+
   return FALSE;
 }
 
@@ -887,21 +902,14 @@ glade_signal_model_iter_parent (GtkTreeModel *model,
                                 GtkTreeIter *iter,
                                 GtkTreeIter *child)
 {
-  GladeSignalModel *sig_model;
-  GladeSignal *handler;
-  const gchar *widget;
-
   g_return_val_if_fail (iter != NULL, FALSE);
   g_return_val_if_fail (child != NULL, FALSE);
-  g_return_val_if_fail (GLADE_IS_SIGNAL_MODEL(model), FALSE);  
-
-  sig_model = GLADE_SIGNAL_MODEL (model);
-  handler = child->user_data2;
-  widget = child->user_data;
+  g_return_val_if_fail (GLADE_IS_SIGNAL_MODEL(model), FALSE);
 
-  if (handler)
+  if (ITER_IS_ROW (child))
     {
-      glade_signal_model_create_widget_iter (sig_model, widget, iter);
+      glade_signal_model_create_widget_iter (GLADE_SIGNAL_MODEL (model),
+                                             ITER_GROUP (child), iter);
       return TRUE;
     }
   return FALSE;
@@ -915,7 +923,7 @@ gtk_tree_model_iface_init (GtkTreeModelIface *iface)
   iface->get_n_columns = glade_signal_model_get_n_columns;
   iface->get_iter = glade_signal_model_get_iter;
   iface->get_path = glade_signal_model_get_path;
-  iface->get_value = glade_signal_model_get_value;	
+  iface->get_value = glade_signal_model_get_value;
   iface->iter_next = glade_signal_model_iter_next;
   iface->iter_children = glade_signal_model_iter_children;
   iface->iter_has_child = glade_signal_model_iter_has_child;
@@ -953,7 +961,7 @@ glade_signal_model_drag_data_get (GtkTreeDragSource *model,
   if (gtk_tree_model_get_iter (GTK_TREE_MODEL (model), &iter, path))
     {
       GladeSignal *signal;
-      const gchar *widget = iter.user_data;
+      const gchar *widget = ITER_GROUP (&iter)->group->type;
       gchar *dnd_text;
       const gchar *user_data;
 
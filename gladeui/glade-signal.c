@@ -29,6 +29,7 @@
 #include "glade.h"
 #include "glade-signal.h"
 #include "glade-xml-utils.h"
+#include "glade-private.h"
 
 struct _GladeSignalPrivate
 {
@@ -37,6 +38,9 @@ struct _GladeSignalPrivate
   gchar    *handler;      /* Handler function eg "gtk_main_quit" */
   gchar    *userdata;     /* User data signal handler argument   */
 
+  GHashTable *strings;    /* Project table the handler and user data are shared
+                           * from, NULL while the signal owns them */
+
   gchar    *support_warning;/* Message to inform the user about signals introduced in future versions */
 
   guint8    after : 1;    /* Connect after TRUE or FALSE         */
@@ -68,16 +72,47 @@ G_DEFINE_TYPE_WITH_PRIVATE (GladeSignal, glade_signal, G_TYPE_OBJECT)
 
 static GParamSpec *properties[N_PROPERTIES];
 
+/* Handler and user data strings come from the shared table once there is one */
+static gchar *
+glade_signal_dup_string (GladeSignal *signal, const gchar *string)
+{
+  gchar *shared;
+
+  if (string == NULL || signal->priv->strings == NULL)
+    return g_strdup (string);
+
+  if ((shared = g_hash_table_lookup (signal->priv->strings, string)) == NULL)
+    {
+      shared = g_strdup (string);
+      g_hash_table_add (signal->priv->strings, shared);
+    }
+
+  return shared;
+}
+
+static void
+glade_signal_free_string (GladeSignal *signal, gchar *string)
+{
+  if (signal->priv->strings == NULL)
+    g_free (string);
+}
+
 static void
 glade_signal_finalize (GObject *object)
 {
   GladeSignal *signal = GLADE_SIGNAL (object);
 
   g_free (signal->priv->detail);
-  g_free (signal->priv->handler);
-  g_free (signal->priv->userdata);
   g_free (signal->priv->support_warning);
 
+  if (signal->priv->strings)
+    g_hash_table_unref (signal->priv->strings);
+  else
+    {
+      g_free (signal->priv->handler);
+      g_free (signal->priv->userdata);
+    }
+
   G_OBJECT_CLASS (glade_signal_parent_class)->finalize (object);
 }
 
@@ -263,8 +298,10 @@ glade_signal_equal (const GladeSignal *sig1, const GladeSignal *sig2)
   g_return_val_if_fail (GLADE_IS_SIGNAL (sig1), FALSE);
   g_return_val_if_fail (GLADE_IS_SIGNAL (sig2), FALSE);
 
-  /* Intentionally ignore support_warning */
-  if (!g_strcmp0 (glade_signal_get_name (sig1), glade_signal_get_name (sig2)) &&
+  /* Intentionally ignore support_warning, signal names are interned
+   * along with the catalog while user typed strings are not.
+   */
+  if (glade_signal_get_name (sig1) == glade_signal_get_name (sig2) &&
       !g_strcmp0 (sig1->priv->handler, sig2->priv->handler) &&
       !g_strcmp0 (sig1->priv->detail, sig2->priv->detail) &&
       sig1->priv->after == sig2->priv->after && sig1->priv->swapped == sig2->priv->swapped)
@@ -466,9 +503,8 @@ glade_signal_set_handler (GladeSignal *signal, const gchar *handler)
 
   if (g_strcmp0 (signal->priv->handler, handler))
     {
-      g_free (signal->priv->handler);
-      signal->priv->handler =
-          handler ? g_strdup (handler) : NULL;
+      glade_signal_free_string (signal, signal->priv->handler);
+      signal->priv->handler = glade_signal_dup_string (signal, handler);
 
       g_object_notify_by_pspec (G_OBJECT (signal), properties[PROP_HANDLER]);
     }
@@ -489,9 +525,8 @@ glade_signal_set_userdata (GladeSignal *signal, const gchar *userdata)
 
   if (g_strcmp0 (signal->priv->userdata, userdata))
     {
-      g_free (signal->priv->userdata);
-      signal->priv->userdata =
-          userdata ? g_strdup (userdata) : NULL;
+      glade_signal_free_string (signal, signal->priv->userdata);
+      signal->priv->userdata = glade_signal_dup_string (signal, userdata);
 
       g_object_notify_by_pspec (G_OBJECT (signal), properties[PROP_USERDATA]);
     }
@@ -570,3 +605,30 @@ glade_signal_get_support_warning (const GladeSignal *signal)
 
   return signal->priv->support_warning;
 }
+
+/* Makes @signal use the copies of its handler and user data found in
+ * @strings, a project table. The table is referenced, so the strings stay
+ * valid as long as the signal does.
+ */
+void
+_glade_signal_share_strings (GladeSignal *signal, GHashTable *strings)
+{
+  GladeSignalPrivate *priv = signal->priv;
+  GHashTable *old_strings = priv->strings;
+  gchar *handler = priv->handler, *userdata = priv->userdata;
+
+  if (old_strings == strings)
+    return;
+
+  priv->strings  = g_hash_table_ref (strings);
+  priv->handler  = glade_signal_dup_string (signal, handler);
+  priv->userdata = glade_signal_dup_string (signal, userdata);
+
+  if (old_strings)
+    g_hash_table_unref (old_strings);
+  else
+    {
+      g_free (handler);
+      g_free (userdata);
+    }
+}
@@ -42,6 +42,7 @@
 #include "glade-private.h"
 
 #include <string.h>
+#include <stdlib.h>
 #include <gdk/gdkkeysyms.h>
 #include <gmodule.h>
 #include <glib/gi18n-lib.h>
@@ -1312,21 +1313,15 @@ glade_utils_enum_value_from_string (GType enum_type, const gchar *strval)
 {
   gint value = 0;
   const gchar *displayable;
-  GValue *gvalue;
 
   g_return_val_if_fail (strval && strval[0], 0);
 
-  if (((displayable =
-        glade_get_value_from_displayable (enum_type, strval)) != NULL &&
-       (gvalue =
-        glade_utils_value_from_string (enum_type, displayable, NULL)) != NULL) ||
-      (gvalue =
-       glade_utils_value_from_string (enum_type, strval, NULL)) != NULL)
-    {
-      value = g_value_get_enum (gvalue);
-      g_value_unset (gvalue);
-      g_free (gvalue);
-    }
+  /* Displayable strings, names and nicks are all hashed per type */
+  if (((displayable = glade_get_value_from_displayable (enum_type, strval)) == NULL ||
+       !_glade_enum_value_lookup (enum_type, displayable, &value)) &&
+      !_glade_enum_value_lookup (enum_type, strval, &value))
+    value = strtoul (strval, NULL, 0);
+
   return value;
 }
 
@@ -1373,18 +1368,17 @@ glade_utils_enum_string_from_value_displayable (GType enum_type, gint value)
 gint
 glade_utils_flags_value_from_string (GType flags_type, const gchar *strval)
 {
-  gint value = 0;
+  guint value = 0;
   const gchar *displayable;
   GValue *gvalue;
 
   g_return_val_if_fail (strval && strval[0], 0);
 
-  if (((displayable =
-        glade_get_value_from_displayable (flags_type, strval)) != NULL &&
-       (gvalue =
-        glade_utils_value_from_string (flags_type, displayable, NULL)) != NULL) ||
-      (gvalue =
-       glade_utils_value_from_string (flags_type, strval, NULL)) != NULL)
+  /* A single value is looked up directly, only combinations are parsed */
+  if (((displayable = glade_get_value_from_displayable (flags_type, strval)) == NULL ||
+       !_glade_flags_value_lookup (flags_type, displayable, &value)) &&
+      !_glade_flags_value_lookup (flags_type, strval, &value) &&
+      (gvalue = glade_utils_value_from_string (flags_type, strval, NULL)) != NULL)
     {
       value = g_value_get_flags (gvalue);
       g_value_unset (gvalue);
@@ -374,6 +374,18 @@ gwa_list_signals (GladeWidgetAdaptor *adaptor, GType real_type)
   return g_list_reverse (signals);
 }
 
+/* Whether property classes dispatch to the same methods on both adaptors */
+static gboolean
+gwa_shares_property_methods (GladeWidgetAdaptor *adaptor,
+                             GladeWidgetAdaptor *parent_adaptor)
+{
+  GladeWidgetAdaptorClass *klass = GLADE_WIDGET_ADAPTOR_GET_CLASS (adaptor);
+  GladeWidgetAdaptorClass *parent_klass = GLADE_WIDGET_ADAPTOR_GET_CLASS (parent_adaptor);
+
+  return (klass->create_eprop == parent_klass->create_eprop &&
+          klass->string_from_value == parent_klass->string_from_value);
+}
+
 static GList *
 gwa_clone_parent_properties (GladeWidgetAdaptor *adaptor, gboolean is_packing)
 {
@@ -382,7 +394,7 @@ gwa_clone_parent_properties (GladeWidgetAdaptor *adaptor, gboolean is_packing)
 
   if ((parent_adaptor = gwa_get_parent_adaptor (adaptor)) != NULL)
     {
-      gboolean reset_version;
+      gboolean reset_version, share;
 
       proplist = is_packing ?
           parent_adaptor->priv->packing_props : parent_adaptor->priv->properties;
@@ -390,11 +402,21 @@ gwa_clone_parent_properties (GladeWidgetAdaptor *adaptor, gboolean is_packing)
       /* Reset versioning in derived catalogs just once */
       reset_version = strcmp (adaptor->priv->catalog, parent_adaptor->priv->catalog) != 0;
 
+      /* Inherited property classes are shared with the parent adaptor,
+       * they are only cloned when the catalog overrides them for this
+       * adaptor (see gwa_own_property_class()).
+       */
+      share = !reset_version && gwa_shares_property_methods (adaptor, parent_adaptor);
+
       for (list = proplist; list; list = list->next)
         {
-          GladePropertyClass *pclass = glade_property_class_clone (list->data, reset_version);
+          GladePropertyClass *pclass = list->data;
 
-	  glade_property_class_set_adaptor (pclass, adaptor);
+          if (!share)
+            {
+              pclass = glade_property_class_clone (pclass, reset_version);
+              glade_property_class_set_adaptor (pclass, adaptor);
+            }
 
           properties = g_list_prepend (properties, pclass);
         }
@@ -403,6 +425,24 @@ gwa_clone_parent_properties (GladeWidgetAdaptor *adaptor, gboolean is_packing)
   return g_list_reverse (properties);
 }
 
+/* Makes sure the property class at @link belongs to @adaptor, cloning
+ * it if it is shared with a parent adaptor.
+ */
+static GladePropertyClass *
+gwa_own_property_class (GladeWidgetAdaptor *adaptor, GList *link)
+{
+  GladePropertyClass *pclass = link->data;
+
+  if (glade_property_class_get_adaptor (pclass) != adaptor)
+    {
+      pclass = glade_property_class_clone (pclass, FALSE);
+      glade_property_class_set_adaptor (pclass, adaptor);
+      link->data = pclass;
+    }
+
+  return pclass;
+}
+
 static void
 gwa_setup_introspected_props_from_pspecs (GladeWidgetAdaptor *adaptor,
                                           GParamSpec        **specs,
@@ -483,7 +523,9 @@ gwa_setup_properties (GladeWidgetAdaptor *adaptor,
         {
           GladePropertyClass *property_class = l->data;
 
-	  glade_property_class_set_is_packing (property_class, TRUE);
+          /* Shared classes were already marked by their adaptor */
+          if (glade_property_class_get_adaptor (property_class) == adaptor)
+            glade_property_class_set_is_packing (property_class, TRUE);
         }
     }
 }
@@ -723,18 +765,31 @@ gwa_internal_children_free (GladeWidgetAdaptor *adaptor)
     }
 }
 
+/* Frees @properties, only the classes owned by @adaptor are freed */
+static void
+gwa_free_property_classes (GladeWidgetAdaptor *adaptor, GList *properties)
+{
+  GList *l;
+
+  for (l = properties; l; l = l->next)
+    {
+      GladePropertyClass *pclass = l->data;
+
+      if (glade_property_class_get_adaptor (pclass) == adaptor)
+        glade_property_class_free (pclass);
+    }
+
+  g_list_free (properties);
+}
+
 static void
 glade_widget_adaptor_finalize (GObject *object)
 {
   GladeWidgetAdaptor *adaptor = GLADE_WIDGET_ADAPTOR (object);
 
   /* Free properties and signals */
-  g_list_foreach (adaptor->priv->properties, (GFunc) glade_property_class_free, NULL);
-  g_list_free (adaptor->priv->properties);
-
-  g_list_foreach (adaptor->priv->packing_props, (GFunc) glade_property_class_free,
-                  NULL);
-  g_list_free (adaptor->priv->packing_props);
+  gwa_free_property_classes (adaptor, adaptor->priv->properties);
+  gwa_free_property_classes (adaptor, adaptor->priv->packing_props);
 
   /* Be careful, this list holds GladeSignalClass* not GladeSignal,
    * thus g_free is enough as all members are const */
@@ -2040,7 +2095,8 @@ gwa_update_properties_from_node (GladeWidgetAdaptor *adaptor,
 
       if (list)
         {
-          property_class = GLADE_PROPERTY_CLASS (list->data);
+          /* Overrides only apply to this adaptor */
+          property_class = gwa_own_property_class (adaptor, list);
         }
       else
         {
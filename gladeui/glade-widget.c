@@ -127,10 +127,13 @@ struct _GladeWidgetPrivate {
   GHashTable *signals; /* A table with a GPtrArray of GladeSignals (signal handlers),
 			* indexed by its name */
 
-  GList     *prop_refs; /* List of properties in the project who's value are `this object'
+  GQueue     prop_refs; /* List of properties in the project who's value are `this object'
 			 * (this is used to set/unset those properties when the object is
 			 * added/removed from the project).
 			 */
+  GHashTable *prop_refs_hash; /* The links of prop_refs indexed by property, shared
+			       * objects can be referred to by thousands of properties
+			       */
 
   gint               width;   /* Current size used in the UI, this is only */
   gint               height;  /* usefull for parentless widgets in the
@@ -335,14 +338,21 @@ glade_widget_add_signal_handler (GladeWidget       *widget,
     {
       signals = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
       g_hash_table_insert (widget->priv->signals, 
-			   g_strdup (glade_signal_get_name (signal_handler)),
+			   (gchar *) glade_signal_get_name (signal_handler),
                            signals);
     }
 
   new_signal_handler = glade_signal_clone (signal_handler);
   g_ptr_array_add (signals, new_signal_handler);
+
+  if (widget->priv->project)
+    _glade_signal_share_strings (new_signal_handler,
+                                 _glade_project_get_signal_strings (widget->priv->project));
   g_signal_emit (widget, glade_widget_signals[ADD_SIGNAL_HANDLER], 0, new_signal_handler);
 
+  if (widget->priv->project)
+    _glade_project_invalidate_verify (widget->priv->project, widget);
+
   glade_project_verify_signal (widget, new_signal_handler);
 
   if (glade_signal_get_support_warning (new_signal_handler))
@@ -381,6 +391,9 @@ glade_widget_remove_signal_handler (GladeWidget       *widget,
 	  g_signal_emit (widget, glade_widget_signals[REMOVE_SIGNAL_HANDLER], 0, tmp_signal_handler);
           g_ptr_array_remove_index (signals, i);
 
+          if (widget->priv->project)
+            _glade_project_invalidate_verify (widget->priv->project, widget);
+
 	  if (glade_signal_get_support_warning (tmp_signal_handler))
 	    glade_widget_verify (widget);
 
@@ -637,7 +650,7 @@ glade_widget_template_params (GladeWidget *widget,
        */
       if (pspec[i]->owner_type == glade_widget_adaptor_get_object_type (adaptor) &&
           g_param_values_cmp (pspec[i],
-                              glade_property_inline_value (glade_property), 
+                              _glade_property_peek_value (glade_property), 
                               glade_property_class_get_original_default (pclass)) == 0)
         continue;
 
@@ -646,7 +659,7 @@ glade_widget_template_params (GladeWidget *widget,
        */
       parameter.name = pspec[i]->name;  /* These are not copied/freed */
       g_value_init (&parameter.value, pspec[i]->value_type);
-      g_value_copy (glade_property_inline_value (glade_property), &parameter.value);
+      g_value_copy (_glade_property_peek_value (glade_property), &parameter.value);
 
       g_array_append_val (params, parameter);
     }
@@ -798,7 +811,8 @@ glade_widget_remove_property (GladeWidget *widget, const gchar *id_property)
   if ((prop = glade_widget_get_property (widget, id_property)) != NULL)
     {
       widget->priv->properties = g_list_remove (widget->priv->properties, prop);
-      g_hash_table_remove (widget->priv->props_hash, id_property);
+      g_hash_table_remove (widget->priv->props_hash,
+                           glade_property_class_id (glade_property_get_class (prop)));
       g_object_unref (prop);
     }
   else
@@ -970,6 +984,9 @@ glade_widget_finalize (GObject *object)
   if (widget->priv->pack_props_hash)
     g_hash_table_destroy (widget->priv->pack_props_hash);
 
+  g_hash_table_destroy (widget->priv->prop_refs_hash);
+  g_queue_clear (&widget->priv->prop_refs);
+
   G_OBJECT_CLASS (glade_widget_parent_class)->finalize (object);
 }
 
@@ -1002,9 +1019,9 @@ glade_widget_dispose (GObject *object)
   g_list_free (children);
 
   /* Release references by way of object properties... */
-  while (widget->priv->prop_refs)
+  while (widget->priv->prop_refs.head)
     {
-      GladeProperty *property = GLADE_PROPERTY (widget->priv->prop_refs->data);
+      GladeProperty *property = GLADE_PROPERTY (widget->priv->prop_refs.head->data);
       glade_property_set (property, NULL);
     }
 
@@ -1208,10 +1225,10 @@ glade_widget_init (GladeWidget *widget)
   widget->priv->object = NULL;
   widget->priv->properties = NULL;
   widget->priv->packing_properties = NULL;
-  widget->priv->prop_refs = NULL;
+  g_queue_init (&widget->priv->prop_refs);
+  widget->priv->prop_refs_hash = g_hash_table_new (g_direct_hash, g_direct_equal);
   widget->priv->signals = g_hash_table_new_full
-      (g_str_hash, g_str_equal,
-       (GDestroyNotify) g_free, (GDestroyNotify) free_signals);
+      (g_str_hash, g_str_equal, NULL, (GDestroyNotify) free_signals);
 
   /* Initial invalid values */
   widget->priv->width = -1;
@@ -1567,7 +1584,7 @@ glade_widget_copy_packing_props (GladeWidget *parent,
       pclass    = glade_property_get_class (dup_prop);
       orig_prop = glade_widget_get_pack_property (template_widget, glade_property_class_id (pclass));
 
-      glade_property_set_value (dup_prop, glade_property_inline_value (orig_prop));
+      glade_property_set_value (dup_prop, _glade_property_peek_value (orig_prop));
     }
 }
 
@@ -2014,8 +2031,8 @@ glade_widget_set_adaptor (GladeWidget *widget, GladeWidgetAdaptor *adaptor)
  * child type for this widget of this container.
  */
 static GList *
-glade_widget_create_packing_properties (GladeWidget *container,
-                                        GladeWidget *widget)
+glade_widget_create_packing_properties (GladeWidgetAdaptor *container,
+                                        GladeWidget        *widget)
 {
   GladePropertyClass *property_class;
   GladeProperty      *property;
@@ -2025,7 +2042,7 @@ glade_widget_create_packing_properties (GladeWidget *container,
   /* XXX TODO: by checking with some GladePropertyClass metadata, decide
    * which packing properties go on which type of children.
    */
-  for (list = glade_widget_adaptor_get_packing_props (container->priv->adaptor);
+  for (list = glade_widget_adaptor_get_packing_props (container);
        list && list->data; list = list->next)
     {
       property_class = list->data;
@@ -2036,12 +2053,92 @@ glade_widget_create_packing_properties (GladeWidget *container,
   return g_list_reverse (packing_props);
 }
 
+/* Replaces the packing properties of @widget with new ones for
+ * a @container parent
+ */
+static void
+glade_widget_reset_packing_properties (GladeWidget        *widget,
+                                       GladeWidgetAdaptor *container)
+{
+  GList *list;
+
+  g_list_foreach (widget->priv->packing_properties, (GFunc) g_object_unref, NULL);
+  g_list_free (widget->priv->packing_properties);
+  widget->priv->packing_properties = NULL;
+
+  if (widget->priv->pack_props_hash)
+    g_hash_table_destroy (widget->priv->pack_props_hash);
+  widget->priv->pack_props_hash = NULL;
+
+  /* We have to detect whether this is an anarchist child of a composite
+   * widget or not, in otherwords; whether its really a direct child or
+   * a child of a popup window created on the composite widget's behalf.
+   */
+  if (widget->priv->anarchist)
+    return;
+
+  widget->priv->packing_properties =
+      glade_widget_create_packing_properties (container, widget);
+  widget->priv->pack_props_hash = g_hash_table_new (g_str_hash, g_str_equal);
+
+  /* update the quick reference hash table */
+  for (list = widget->priv->packing_properties; list && list->data; list = list->next)
+    {
+      GladeProperty      *property = list->data;
+      GladePropertyClass *pclass = glade_property_get_class (property);
+
+      g_hash_table_insert (widget->priv->pack_props_hash, 
+			   (gchar *)glade_property_class_id (pclass), 
+			   property);
+    }
+}
+
 /* Private API */
 
 GList *
 _glade_widget_peek_prop_refs (GladeWidget *widget)
 {
-  return widget->priv->prop_refs;
+  return widget->priv->prop_refs.head;
+}
+
+gboolean
+_glade_widget_is_rebuilding (GladeWidget *widget)
+{
+  return widget->priv->rebuilding;
+}
+
+/* Reads back the packing properties @widget had in a @container parent
+ * from a <packing> node written apart from the parent, the widget is not
+ * parented and the properties are only recorded, as in clipboard fragments.
+ */
+void
+_glade_widget_read_packing (GladeWidget        *widget,
+                            GladeWidgetAdaptor *container,
+                            GladeXmlNode       *node)
+{
+  GladeProperty *property;
+  GladeXmlNode *iter_node;
+  gchar *name, *prop_name;
+
+  glade_widget_reset_packing_properties (widget, container);
+
+  for (iter_node = glade_xml_node_get_children (node);
+       iter_node; iter_node = glade_xml_node_next (iter_node))
+    {
+      if (!glade_xml_node_verify_silent (iter_node, GLADE_XML_TAG_PROPERTY))
+        continue;
+
+      if (!(name = glade_xml_get_property_string_required (iter_node, GLADE_XML_TAG_NAME, NULL)))
+        continue;
+
+      prop_name = glade_util_read_prop_name (name);
+
+      if ((property = glade_widget_get_pack_property (widget, prop_name)) != NULL)
+        glade_property_read (property, widget->priv->project, iter_node);
+
+      g_free (prop_name);
+      g_free (name);
+    }
 }
 
 /*******************************************************************************
@@ -2133,8 +2230,12 @@ glade_widget_add_prop_ref (GladeWidget *widget, GladeProperty *property)
   g_return_if_fail (GLADE_IS_WIDGET (widget));
   g_return_if_fail (GLADE_IS_PROPERTY (property));
 
-  if (!g_list_find (widget->priv->prop_refs, property))
-    widget->priv->prop_refs = g_list_prepend (widget->priv->prop_refs, property);
+  if (!g_hash_table_contains (widget->priv->prop_refs_hash, property))
+    {
+      g_queue_push_head (&widget->priv->prop_refs, property);
+      g_hash_table_insert (widget->priv->prop_refs_hash, property,
+                           widget->priv->prop_refs.head);
+    }
 
   /* parentless widget reffed widgets are added to thier reffering widgets. 
    * they cant be in the design view.
@@ -2165,11 +2266,16 @@ void
 glade_widget_remove_prop_ref (GladeWidget *widget, GladeProperty *property)
 {
   GladePropertyClass *pclass;
+  GList              *link;
 
   g_return_if_fail (GLADE_IS_WIDGET (widget));
   g_return_if_fail (GLADE_IS_PROPERTY (property));
 
-  widget->priv->prop_refs = g_list_remove (widget->priv->prop_refs, property);
+  if ((link = g_hash_table_lookup (widget->priv->prop_refs_hash, property)))
+    {
+      g_hash_table_remove (widget->priv->prop_refs_hash, property);
+      g_queue_delete_link (&widget->priv->prop_refs, link);
+    }
 
   pclass = glade_property_get_class (property);
   if (glade_property_class_parentless_widget (pclass))
@@ -2186,7 +2292,7 @@ glade_widget_list_prop_refs (GladeWidget *widget)
 {
   g_return_val_if_fail (GLADE_IS_WIDGET (widget), NULL);
 
-  return g_list_copy (widget->priv->prop_refs);
+  return g_list_copy (widget->priv->prop_refs.head);
 }
 
 gboolean
@@ -2194,7 +2300,7 @@ glade_widget_has_prop_refs (GladeWidget *widget)
 {
   g_return_val_if_fail (GLADE_IS_WIDGET (widget), FALSE);
 
-  return widget->priv->prop_refs != NULL;
+  return widget->priv->prop_refs.head != NULL;
 }
 
 GladeProperty *
@@ -2206,7 +2312,7 @@ glade_widget_get_parentless_widget_ref (GladeWidget *widget)
 
   g_return_val_if_fail (GLADE_IS_WIDGET (widget), NULL);
 
-  for (l = widget->priv->prop_refs; l && l->data; l = l->next)
+  for (l = widget->priv->prop_refs.head; l && l->data; l = l->next)
     {
       property = l->data;
       pclass   = glade_property_get_class (property);
@@ -2377,7 +2483,7 @@ glade_widget_copy_properties (GladeWidget *widget,
                 glade_property_set (widget_prop, NULL);
             }
           else
-            glade_property_set_value (widget_prop, glade_property_inline_value (template_prop));
+            glade_property_set_value (widget_prop, _glade_property_peek_value (template_prop));
         }
     }
 }
@@ -2481,6 +2587,87 @@ typedef struct
   GValue value;
 } PropertyData;
 
+/* Collects the internal children of @gwidget, each one before
+ * its own internal children. Their instances are kept alive until
+ * they are replaced in the project, the old parent instance takes
+ * them down with it when it's destroyed.
+ */
+static GList *
+glade_widget_collect_internals (GladeWidget *gwidget, GList *internals)
+{
+  GList *children, *l;
+
+  children = glade_widget_adaptor_get_children (gwidget->priv->adaptor,
+                                                gwidget->priv->object);
+
+  for (l = g_list_last (children); l; l = l->prev)
+    {
+      GladeWidget *gchild = glade_widget_get_from_gobject (l->data);
+
+      if (gchild && gchild->priv->internal)
+        {
+          internals = glade_widget_collect_internals (gchild, internals);
+          internals = g_list_prepend (internals, g_object_ref (gchild));
+
+          g_object_ref (gchild->priv->object);
+        }
+    }
+  g_list_free (children);
+
+  return internals;
+}
+
+/* The rebuilt instance comes with new internal children, they take
+ * the place of the old ones in the project (this consumes @internals)
+ */
+static void
+glade_widget_replace_internals (GladeWidget  *gwidget,
+                                GladeProject *project,
+                                GList        *internals)
+{
+  GHashTable *replacements;
+  GladeWidget *old_internal, *new_internal, *parent;
+  GObject *internal_object;
+  GList *l;
+
+  replacements = g_hash_table_new (NULL, NULL);
+  g_hash_table_insert (replacements, gwidget, gwidget);
+
+  /* Resolve the new internal children top down... */
+  for (l = internals; l; l = l->next)
+    {
+      old_internal = l->data;
+      new_internal = NULL;
+
+      if ((parent = g_hash_table_lookup (replacements, old_internal->priv->parent)) &&
+          (internal_object = glade_widget_get_internal_child (gwidget, parent,
+                                                              old_internal->priv->internal)))
+        new_internal = glade_widget_get_from_gobject (internal_object);
+
+      g_hash_table_insert (replacements, old_internal, new_internal);
+    }
+
+  /* ... and replace them bottom up, so that the old rows are found */
+  for (l = g_list_last (internals); l; l = l->prev)
+    {
+      old_internal = l->data;
+      new_internal = g_hash_table_lookup (replacements, old_internal);
+
+      if (new_internal == NULL)
+        glade_project_remove_object (project, old_internal->priv->object);
+      else if (new_internal != old_internal)
+        _glade_project_replace_object (project, old_internal,
+                                       old_internal->priv->object,
+                                       new_internal->priv->object);
+
+      g_object_unref (old_internal->priv->object);
+      g_object_unref (old_internal);
+    }
+
+  g_hash_table_destroy (replacements);
+  g_list_free (internals);
+}
+
 /**
  * glade_widget_rebuild:
  * @gwidget: a #GladeWidget
@@ -2497,8 +2684,9 @@ glade_widget_rebuild (GladeWidget *gwidget)
   GladeWidgetAdaptor *adaptor;
   GladeProject *project = NULL;
   GladeWidget  *parent = NULL;
+  GtkWidget *container = NULL;
   GList *children;
-  GList *selection = NULL;
+  GList *internals = NULL;
   GList *restore_properties = NULL;
   GList *save_properties, *l;
 
@@ -2522,27 +2710,24 @@ glade_widget_rebuild (GladeWidget *gwidget)
 
   g_object_ref (gwidget);
 
-  /* Extract and keep the child hierarchies aside... */
-  children = glade_widget_extract_children (gwidget);
-
-  /* Here we take care removing the widget from the project and
-   * the selection before rebuilding the instance.
+  /* The widget stays in the project, only the instance is swapped
+   * once rebuilt so that the rows in the project model, the children
+   * and the selection are kept in place.
    */
   if (gwidget->priv->project && glade_project_has_object (gwidget->priv->project,
                                                           gwidget->priv->object))
     {
       project = gwidget->priv->project;
-
-      if (glade_project_is_selected (project, gwidget->priv->object))
-        selection = g_list_copy (glade_project_selection_get (project));
-
-      glade_project_remove_object (project, gwidget->priv->object);
+      internals = glade_widget_collect_internals (gwidget, NULL);
     }
 
+  /* Extract and keep the child hierarchies aside... */
+  children = glade_widget_extract_children (gwidget);
+
   /* parentless_widget and object properties that reffer to this widget 
    * should be unset before transfering */
   l = g_list_copy (gwidget->priv->properties);
-  save_properties = g_list_copy (gwidget->priv->prop_refs);
+  save_properties = g_list_copy (gwidget->priv->prop_refs.head);
   save_properties = g_list_concat (l, save_properties);
 
   for (l = save_properties; l; l = l->next)
@@ -2574,6 +2759,13 @@ glade_widget_rebuild (GladeWidget *gwidget)
    */
   if (parent)
     glade_widget_remove_child (parent, gwidget);
+  else if (gwidget->priv->parent == NULL && GTK_IS_WIDGET (gwidget->priv->object) &&
+           (container = gtk_widget_get_parent (GTK_WIDGET (gwidget->priv->object))))
+    {
+      /* Toplevels are embedded in the design view's layouts */
+      g_object_ref (container);
+      gtk_container_remove (GTK_CONTAINER (container), GTK_WIDGET (gwidget->priv->object));
+    }
 
   /* Hold a reference to the old widget while we transport properties
    * and children from it
@@ -2581,6 +2773,12 @@ glade_widget_rebuild (GladeWidget *gwidget)
   old_object = g_object_ref (glade_widget_get_object (gwidget));
   new_object = glade_widget_build_object (gwidget, gwidget, GLADE_CREATE_REBUILD);
 
+  /* The old instance is no longer mapped to this widget, swap them
+   * in the project right away.
+   */
+  if (project)
+    _glade_project_replace_object (project, gwidget, old_object, new_object);
+
   /* Only call this once the object has a proper GladeWidget */
   glade_widget_adaptor_post_create (adaptor, new_object, GLADE_CREATE_REBUILD);
 
@@ -2593,6 +2791,11 @@ glade_widget_rebuild (GladeWidget *gwidget)
    */
   if (parent)
     glade_widget_add_child (parent, gwidget, FALSE);
+  else if (container)
+    {
+      gtk_container_add (GTK_CONTAINER (container), GTK_WIDGET (new_object));
+      g_object_unref (container);
+    }
 
   /* Custom properties aren't transfered in build_object, since build_object
    * is only concerned with object creation.
@@ -2624,29 +2827,13 @@ glade_widget_rebuild (GladeWidget *gwidget)
   if (parent)
     glade_widget_sync_packing_props (gwidget);
 
-  /* If the widget was in a project (and maybe the selection), then
-   * restore that stuff.
-   */
+  /* The internal children are swapped once they are all restored */
   if (project)
     {
-      glade_project_add_object (project, gwidget->priv->object);
-
-      if (selection)
-        {
-          glade_project_selection_clear (project, FALSE);
-
-          for (l = selection; l; l = g_list_next (l))
-            {
-              GObject *selected = l->data;
-
-              if (selected == old_object)
-                glade_project_selection_add (project, gwidget->priv->object, TRUE);
-              else
-                glade_project_selection_add (project, selected, TRUE);
-            }
+      glade_widget_replace_internals (gwidget, project, internals);
 
-          g_list_free (selection);
-        }
+      if (glade_project_is_selected (project, new_object))
+        glade_project_selection_changed (project);
     }
 
   /* Must call dispose for cases like dialogs and toplevels */
@@ -2668,6 +2855,10 @@ glade_widget_rebuild (GladeWidget *gwidget)
 
   gwidget->priv->rebuilding = FALSE;
   glade_widget_pop_superuser ();
+
+  /* Row changes were skipped while rebuilding */
+  if (project)
+    glade_project_widget_changed (project, gwidget);
 }
 
 /**
@@ -2853,6 +3044,21 @@ glade_widget_get_adaptor (GladeWidget *widget)
   return widget->priv->adaptor;
 }
 
+/* Handlers and user data are shared by the signals of a project */
+static void
+glade_widget_share_signal_strings (GladeWidget *widget, GladeProject *project)
+{
+  GHashTable *strings = _glade_project_get_signal_strings (project);
+  GHashTableIter iter;
+  GPtrArray *signals;
+  guint i;
+
+  g_hash_table_iter_init (&iter, widget->priv->signals);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &signals))
+    for (i = 0; i < signals->len; i++)
+      _glade_signal_share_strings (g_ptr_array_index (signals, i), strings);
+}
+
 /**
  * glade_widget_set_project:
  * @widget: a #GladeWidget
@@ -2866,6 +3072,9 @@ glade_widget_set_project (GladeWidget *widget, GladeProject *project)
   if (widget->priv->project != project)
     {
       widget->priv->project = project;
+
+      if (project)
+        glade_widget_share_signal_strings (widget, project);
       g_object_notify_by_pspec (G_OBJECT (widget), properties[PROP_PROJECT]);
     }
 }
@@ -3280,7 +3489,7 @@ glade_widget_property_string (GladeWidget  *widget,
       pclass     = glade_property_get_class (property);
       ret_string = glade_widget_adaptor_string_from_value
         (glade_property_class_get_adaptor (pclass), pclass, 
-	 value ? value : glade_property_inline_value (property));
+	 value ? value : _glade_property_peek_value (property));
     }
 
   return ret_string;
@@ -3314,7 +3523,7 @@ glade_widget_pack_property_string (GladeWidget  *widget,
       pclass     = glade_property_get_class (property);
       ret_string = glade_widget_adaptor_string_from_value
         (glade_property_class_get_adaptor (pclass), pclass, 
-	 value ? value : glade_property_inline_value (property));
+	 value ? value : _glade_property_peek_value (property));
     }
 
   return ret_string;
@@ -3828,36 +4037,11 @@ glade_widget_set_packing_properties (GladeWidget *widget,
   if (widget->priv->rebuilding)
     return;
 
-  g_list_foreach (widget->priv->packing_properties, (GFunc) g_object_unref, NULL);
-  g_list_free (widget->priv->packing_properties);
-  widget->priv->packing_properties = NULL;
-
-  if (widget->priv->pack_props_hash)
-    g_hash_table_destroy (widget->priv->pack_props_hash);
-  widget->priv->pack_props_hash = NULL;
+  glade_widget_reset_packing_properties (widget, container->priv->adaptor);
 
-  /* We have to detect whether this is an anarchist child of a composite
-   * widget or not, in otherwords; whether its really a direct child or
-   * a child of a popup window created on the composite widget's behalf.
-   */
   if (widget->priv->anarchist)
     return;
 
-  widget->priv->packing_properties =
-      glade_widget_create_packing_properties (container, widget);
-  widget->priv->pack_props_hash = g_hash_table_new (g_str_hash, g_str_equal);
-
-  /* update the quick reference hash table */
-  for (list = widget->priv->packing_properties; list && list->data; list = list->next)
-    {
-      GladeProperty      *property = list->data;
-      GladePropertyClass *pclass = glade_property_get_class (property);
-
-      g_hash_table_insert (widget->priv->pack_props_hash, 
-			   (gchar *)glade_property_class_id (pclass), 
-			   property);
-    }
-
   /* Dont introspect on properties that are not parented yet.
    */
   if (glade_widget_adaptor_has_child (container->priv->adaptor,
@@ -722,6 +722,45 @@ glade_xml_context_new_from_path (const gchar *full_path,
   return context;
 }
 
+/**
+ * glade_xml_context_new_from_buffer:
+ * @buffer: an xml document in memory
+ * @length: the length of @buffer, or -1 if nul terminated
+ * @root_name: (allow-none): the expected root node name
+ *
+ * Parses @buffer, this is used for project fragments exchanged through
+ * the clipboard.
+ *
+ * Returns: A new #GladeXmlContext or %NULL if @buffer is not a valid document
+ */
+GladeXmlContext *
+glade_xml_context_new_from_buffer (const gchar *buffer,
+                                   gssize       length,
+                                   const gchar *root_name)
+{
+  xmlDocPtr doc;
+  xmlNodePtr root;
+
+  g_return_val_if_fail (buffer != NULL, NULL);
+
+  if (length < 0)
+    length = strlen (buffer);
+
+  if ((doc = xmlReadMemory (buffer, length, NULL, NULL, XML_PARSE_NONET)) == NULL)
+    return NULL;
+
+  root = xmlDocGetRootElement (doc);
+  if (root == NULL ||
+      (root_name != NULL &&
+       (root->name == NULL || xmlStrcmp (root->name, BAD_CAST (root_name)) != 0)))
+    {
+      xmlFreeDoc (doc);
+      return NULL;
+    }
+
+  return glade_xml_context_new_real ((GladeXmlDoc *) doc, TRUE, NULL);
+}
+
 /**
  * glade_xml_context_free:
  * @context: 
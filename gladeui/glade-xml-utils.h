@@ -255,6 +255,9 @@ void              glade_xml_context_free    (GladeXmlContext *context);
 GladeXmlContext * glade_xml_context_new_from_path (const gchar *full_path,
 						   const gchar *nspace,
 						   const gchar *root_name);
+GladeXmlContext * glade_xml_context_new_from_buffer (const gchar *buffer,
+						     gssize       length,
+						     const gchar *root_name);
 GladeXmlDoc *     glade_xml_context_get_doc (GladeXmlContext *context);
 
 /* Dumps an xml string from a context */
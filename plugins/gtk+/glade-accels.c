@@ -164,6 +164,7 @@ glade_eprop_accel_load (GladeEditorProperty * eprop, GladeProperty * property)
   GladeEditorPropertyClass *parent_class =
       g_type_class_peek_parent (GLADE_EDITOR_PROPERTY_GET_CLASS (eprop));
   GladeEPropAccel *eprop_accel = GLADE_EPROP_ACCEL (eprop);
+  GList *list;
   gchar *accels;
 
   /* Chain up first */
@@ -172,8 +173,9 @@ glade_eprop_accel_load (GladeEditorProperty * eprop, GladeProperty * property)
   if (property == NULL)
     return;
 
-  if ((accels =
-       glade_accels_make_string (g_value_get_boxed (glade_property_inline_value (property)))) != NULL)
+  glade_property_get (property, &list);
+
+  if ((accels = glade_accels_make_string (list)) != NULL)
     {
       gtk_entry_set_text (GTK_ENTRY (eprop_accel->entry), accels);
       g_free (accels);
@@ -196,15 +198,28 @@ iter_tab_free (GladeEpropIterTab * iter_tab)
   g_free (iter_tab);
 }
 
+/* Property classes can be shared with a parent adaptor, the signals
+ * to list are the ones of the edited widget's adaptor.
+ */
+static GladeWidgetAdaptor *
+glade_eprop_accel_get_adaptor (GladeEditorProperty *eprop)
+{
+  GladeProperty *property = glade_editor_property_get_property (eprop);
+
+  if (property)
+    return glade_widget_get_adaptor (glade_property_get_widget (property));
+
+  return glade_property_class_get_adaptor (glade_editor_property_get_pclass (eprop));
+}
+
 static void
 glade_eprop_accel_populate_view (GladeEditorProperty * eprop,
                                  GtkTreeView * view)
 {
   GladeEPropAccel *eprop_accel = GLADE_EPROP_ACCEL (eprop);
   GladeSignalClass *sclass;
-  GladePropertyClass *pclass = glade_editor_property_get_pclass (eprop);
   GladeProperty      *property = glade_editor_property_get_property (eprop);
-  GladeWidgetAdaptor *adaptor = glade_property_class_get_adaptor (pclass);
+  GladeWidgetAdaptor *adaptor = glade_eprop_accel_get_adaptor (eprop);
   GtkTreeStore *model = (GtkTreeStore *) gtk_tree_view_get_model (view);
   GtkTreeIter iter;
   GladeEpropIterTab *parent_tab;
@@ -216,7 +231,7 @@ G_GNUC_BEGIN_IGNORE_DEPRECATIONS
   GType type_action = GTK_TYPE_ACTION;
 G_GNUC_END_IGNORE_DEPRECATIONS
 
-  accelerators = g_value_get_boxed (glade_property_inline_value (property));
+  glade_property_get (property, &accelerators);
 
   /* First make parent iters...
    */
@@ -343,15 +358,13 @@ accel_edited (GtkCellRendererAccel * accel,
   gboolean key_was_set;
   GtkTreeIter iter, parent_iter, new_iter;
   gchar *accel_text;
-  GladePropertyClass *pclass;
   GladeWidgetAdaptor *adaptor;
   gboolean is_action;
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
   GType type_action = GTK_TYPE_ACTION;
 G_GNUC_END_IGNORE_DEPRECATIONS
 
-  pclass = glade_editor_property_get_pclass (GLADE_EDITOR_PROPERTY (eprop_accel));
-  adaptor = glade_property_class_get_adaptor (pclass);
+  adaptor = glade_eprop_accel_get_adaptor (GLADE_EDITOR_PROPERTY (eprop_accel));
 
   if (!gtk_tree_model_get_iter_from_string (eprop_accel->model,
                                             &iter, path_string))
@@ -915,7 +928,9 @@ glade_gtk_write_accels (GladeWidget * widget,
   if (!(property = glade_widget_get_property (widget, "accelerator")))
     return;
 
-  for (list = g_value_get_boxed (glade_property_inline_value (property)); list; list = list->next)
+  glade_property_get (property, &list);
+
+  for (; list; list = list->next)
     {
       GladeAccelInfo *accel = list->data;
 
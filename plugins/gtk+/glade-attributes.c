@@ -986,7 +986,7 @@ glade_eprop_attrs_populate_view (GladeEditorProperty *eprop, GtkTreeView *view)
   gchar *text;
 
   property   = glade_editor_property_get_property (eprop);
-  attributes = g_value_get_boxed (glade_property_inline_value (property));
+  glade_property_get (property, &attributes);
 
   append_empty_row (model, PANGO_ATTR_FONT_DESC);
   append_empty_row (model, PANGO_ATTR_STYLE);
@@ -1052,7 +1052,8 @@ glade_eprop_attrs_show_dialog (GtkWidget *dialog_button,
 
 
   /* Keep a copy for commit time... */
-  old_attributes = g_value_dup_boxed (glade_property_inline_value (property));
+  glade_property_get (property, &old_attributes);
+  old_attributes = g_boxed_copy (GLADE_TYPE_ATTR_GLIST, old_attributes);
 
   dialog = gtk_dialog_new_with_buttons (_("Setup Text Attributes"),
                                         GTK_WINDOW (parent),
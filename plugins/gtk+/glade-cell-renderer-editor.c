@@ -499,7 +499,9 @@ glade_eprop_cell_attribute_load (GladeEditorProperty * eprop,
       GladeWidget *gmodel;
       GtkListStore *store = GTK_LIST_STORE (eprop_attribute->columns);
       GtkTreeIter iter;
+      gint column = -1;
 
+      glade_property_get (property, &column);
       gtk_list_store_clear (store);
 
       /* Generate model and set active iter */
@@ -526,8 +528,7 @@ glade_eprop_cell_attribute_load (GladeEditorProperty * eprop,
             }
 
           gtk_combo_box_set_active (GTK_COMBO_BOX (eprop_attribute->combo),
-                                    CLAMP (g_value_get_int (glade_property_inline_value (property)) +
-                                           1, 0, g_list_length (columns) + 1));
+                                    CLAMP (column + 1, 0, g_list_length (columns) + 1));
 
           gtk_widget_set_sensitive (eprop_attribute->combo, TRUE);
         }
@@ -540,7 +541,7 @@ glade_eprop_cell_attribute_load (GladeEditorProperty * eprop,
         }
 
       gtk_spin_button_set_value (GTK_SPIN_BUTTON (eprop_attribute->spin),
-                                 (gdouble) g_value_get_int (glade_property_inline_value (property)));
+                                 (gdouble) column);
     }
 }
 
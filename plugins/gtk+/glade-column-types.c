@@ -44,73 +44,31 @@ enum
 
 static GtkTreeModel *types_model = NULL;
 
-static gint
-find_by_type_name (const gchar * a, const gchar * b)
-{
-  return strcmp (a, b);
-}
-
 static void
 column_types_store_populate_enums_flags (GtkListStore * store, gboolean enums)
 {
   GtkTreeIter iter;
-  GList *types = NULL, *list;
-  GList *adaptors = glade_widget_adaptor_list_adaptors ();
   const GList *l;
 
-  for (list = adaptors; list; list = list->next)
-    {
-      GladeWidgetAdaptor *adaptor = list->data;
-      GladePropertyClass *pclass;
-      GParamSpec         *pspec;
-
-      for (l = glade_widget_adaptor_get_properties (adaptor); l; l = l->next)
-        {
-          pclass = l->data;
-	  pspec  = glade_property_class_get_pspec (pclass);
-
-          /* special case out a few of these... */
-          if (strcmp (g_type_name (pspec->value_type),
-                      "GladeStock") == 0 ||
-              strcmp (g_type_name (pspec->value_type),
-                      "GladeStockImage") == 0 ||
-              strcmp (g_type_name (pspec->value_type),
-                      "GladeGtkImageType") == 0 ||
-              strcmp (g_type_name (pspec->value_type),
-                      "GladeGtkButtonType") == 0 ||
-              strcmp (g_type_name (pspec->value_type),
-                      "GladeGnomeDruidPagePosition") == 0 ||
-              strcmp (g_type_name (pspec->value_type),
-                      "GladeGnomeIconListSelectionMode") == 0 ||
-              strcmp (g_type_name (pspec->value_type),
-                      "GladeGnomeMessageBoxType") == 0)
-            continue;
-
-          if ((enums ? G_TYPE_IS_ENUM (pspec->value_type) :
-               G_TYPE_IS_FLAGS (pspec->value_type)) &&
-              !g_list_find_custom (types,
-                                   g_type_name (pspec->value_type),
-                                   (GCompareFunc) find_by_type_name))
-            types =
-                g_list_prepend (types,
-                                g_strdup (g_type_name
-                                          (pspec->value_type)));
-
-        }
-    }
-  g_list_free (adaptors);
-
-  types = g_list_sort (types, (GCompareFunc) find_by_type_name);
-
-  for (l = types; l; l = l->next)
+  /* The catalog indexes these sorted and without duplicates */
+  for (l = enums ? glade_catalog_get_enum_types () : glade_catalog_get_flags_types ();
+       l; l = l->next)
     {
-      gchar *type_name = l->data;
+      const gchar *type_name = g_type_name (GPOINTER_TO_SIZE (l->data));
+
+      /* special case out a few of these... */
+      if (strcmp (type_name, "GladeStock") == 0 ||
+          strcmp (type_name, "GladeStockImage") == 0 ||
+          strcmp (type_name, "GladeGtkImageType") == 0 ||
+          strcmp (type_name, "GladeGtkButtonType") == 0 ||
+          strcmp (type_name, "GladeGnomeDruidPagePosition") == 0 ||
+          strcmp (type_name, "GladeGnomeIconListSelectionMode") == 0 ||
+          strcmp (type_name, "GladeGnomeMessageBoxType") == 0)
+        continue;
 
       gtk_list_store_append (store, &iter);
       gtk_list_store_set (store, &iter, COLUMN_NAME, type_name, -1);
-      g_free (type_name);
     }
-  g_list_free (types);
 }
 
 static void
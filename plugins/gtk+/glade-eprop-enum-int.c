@@ -89,7 +89,7 @@ glade_eprop_enum_int_load (GladeEditorProperty *eprop, GladeProperty *property)
       gboolean found = FALSE;
 
       enum_class = g_type_class_ref (priv->type);
-      value = g_value_get_int (glade_property_inline_value (property));
+      glade_property_get (property, &value);
 
       /*
        * If we find the value in our enum, then set the active item, otherwise
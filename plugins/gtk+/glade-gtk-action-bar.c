@@ -238,7 +238,7 @@ glade_gtk_action_bar_get_first_blank (GtkActionBar * box)
 
 	  /* property can be NULL here when project is closing */
 	  if (property)
-	    gwidget_position = g_value_get_int (glade_property_inline_value (property));
+	    glade_property_get (property, &gwidget_position);
 
           if (gwidget_position > position)
             break;
@@ -127,9 +127,7 @@ glade_gtk_action_widgets_write_responses (GladeWidget *widget,
       widget_node = glade_xml_node_new (context, GLADE_TAG_ACTION_WIDGET);
       glade_xml_node_append_child (node, widget_node);
 
-      str =
-          glade_property_class_make_string_from_gvalue (glade_property_get_class (property),
-                                                        glade_property_inline_value (property));
+      str = glade_property_make_string (property);
 
       glade_xml_node_set_property_string (widget_node, GLADE_TAG_RESPONSE, str);
       glade_xml_set_content (widget_node, glade_widget_get_name (action_widget));
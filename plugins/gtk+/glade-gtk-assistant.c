@@ -25,6 +25,8 @@
 #include <glib/gi18n-lib.h>
 #include <gladeui/glade.h>
 
+#include "glade-gtk-lazy-pages.h"
+
 static void
 glade_gtk_assistant_append_new_page (GladeWidget * parent,
                                      GladeProject * project,
@@ -170,12 +172,33 @@ on_assistant_project_selection_changed (GladeProject *project,
 
       if (!selected) return;
 
+      /* Find the page holding the selection */
+      while (glade_widget_get_parent (selected) &&
+             glade_widget_get_parent (selected) != gassist)
+        selected = glade_widget_get_parent (selected);
+
       if (glade_widget_get_parent (selected) == gassist &&
-          glade_widget_property_get (selected, "position", &pos, NULL))
+          glade_widget_pack_property_get (selected, "position", &pos, NULL))
 	gtk_assistant_set_current_page (assist, pos);
     }
 }
 
+/* Only the current page takes part in size negotiation */
+static void
+on_assistant_prepare (GtkAssistant *assistant,
+                      GtkWidget    *current,
+                      gpointer      data)
+{
+  GList *pages = NULL;
+  gint i;
+
+  for (i = gtk_assistant_get_n_pages (assistant) - 1; i >= 0; i--)
+    pages = g_list_prepend (pages, gtk_assistant_get_nth_page (assistant, i));
+
+  glade_gtk_lazy_pages_show (pages, current);
+  g_list_free (pages);
+}
+
 void
 glade_gtk_assistant_post_create (GladeWidgetAdaptor * adaptor,
                                  GObject * object, GladeCreateReason reason)
@@ -212,6 +235,9 @@ glade_gtk_assistant_post_create (GladeWidgetAdaptor * adaptor,
     g_signal_connect (project, "selection-changed",
 		      G_CALLBACK (on_assistant_project_selection_changed),
 		      parent);
+
+  g_signal_connect (object, "prepare",
+                    G_CALLBACK (on_assistant_prepare), NULL);
 }
 
 void
@@ -28,6 +28,7 @@
 
 #include "glade-fixed.h"
 #include "glade-gtk-notebook.h"
+#include "glade-gtk-child-order.h"
 #include "glade-box-editor.h"
 #include "glade-gtk.h"
 
@@ -140,99 +141,87 @@ glade_gtk_box_get_children (GladeWidgetAdaptor * adaptor,
   return g_list_sort_with_data (children, (GCompareDataFunc) sort_box_children, container);
 }
 
+static GList *
+glade_gtk_box_list_children (GObject *container)
+{
+  GList *children, *l, *sorted = NULL;
+  GObject **slots;
+  gint n_children, position, i;
+
+  children   = gtk_container_get_children (GTK_CONTAINER (container));
+  n_children = g_list_length (children);
+  slots      = g_new0 (GObject *, n_children);
+
+  /* gtk_container_forall() lists packed at end children last,
+   * use the real "position" child property instead.
+   */
+  for (l = children; l; l = l->next)
+    {
+      gtk_container_child_get (GTK_CONTAINER (container), GTK_WIDGET (l->data),
+                               "position", &position, NULL);
+
+      if (position >= 0 && position < n_children)
+        slots[position] = l->data;
+    }
+
+  for (i = n_children - 1; i >= 0; i--)
+    if (slots[i])
+      sorted = g_list_prepend (sorted, slots[i]);
+
+  g_free (slots);
+  g_list_free (children);
+
+  return sorted;
+}
+
+static void
+glade_gtk_box_reorder_child (GObject *container, GObject *child, gint position)
+{
+  gtk_box_reorder_child (GTK_BOX (container), GTK_WIDGET (child), position);
+}
+
+static const GladeChildOrderFuncs glade_gtk_box_child_order_funcs = {
+  glade_gtk_box_list_children,
+  glade_gtk_box_reorder_child,
+  NULL
+};
+
 void
 glade_gtk_box_set_child_property (GladeWidgetAdaptor * adaptor,
                                   GObject * container,
                                   GObject * child,
                                   const gchar * property_name, GValue * value)
 {
-  GladeWidget *gbox, *gchild, *gchild_iter;
-  GList *children, *list;
-  gboolean is_position;
-  gint old_position, iter_position, new_position;
-  static gboolean recursion = FALSE;
+  GladeWidget *gbox;
 
   g_return_if_fail (GTK_IS_BOX (container));
   g_return_if_fail (GTK_IS_WIDGET (child));
   g_return_if_fail (property_name != NULL || value != NULL);
 
   gbox = glade_widget_get_from_gobject (container);
-  gchild = glade_widget_get_from_gobject (child);
 
   g_return_if_fail (GLADE_IS_WIDGET (gbox));
 
   if (gtk_widget_get_parent (GTK_WIDGET (child)) != GTK_WIDGET (container))
     return;
 
-  /* Get old position */
-  if ((is_position = (strcmp (property_name, "position") == 0)) != FALSE)
+  if (strcmp (property_name, "position") == 0)
     {
-      gtk_container_child_get (GTK_CONTAINER (container),
-                               GTK_WIDGET (child),
-                               property_name, &old_position, NULL);
-
-
-      /* Get the real value */
-      new_position = g_value_get_int (value);
-    }
-
-  if (is_position && recursion == FALSE)
-    {
-      children = glade_widget_get_children (gbox);
-      children = g_list_sort (children, (GCompareFunc) sort_box_children);
-
-      for (list = children; list; list = list->next)
-        {
-          gchild_iter = glade_widget_get_from_gobject (list->data);
-
-          if (gchild_iter == gchild)
-            {
-              gtk_box_reorder_child (GTK_BOX (container),
-                                     GTK_WIDGET (child), new_position);
-              continue;
-            }
-
-          /* Get the old value from glade */
-          glade_widget_pack_property_get
-              (gchild_iter, "position", &iter_position);
-
-          /* Search for the child at the old position and update it */
-          if (iter_position == new_position &&
-              glade_property_superuser () == FALSE)
-            {
-              /* Update glade with the real value */
-              recursion = TRUE;
-              glade_widget_pack_property_set
-                  (gchild_iter, "position", old_position);
-              recursion = FALSE;
-              continue;
-            }
-          else
-            {
-              gtk_box_reorder_child (GTK_BOX (container),
-                                     GTK_WIDGET (list->data), iter_position);
-            }
-        }
-
-      for (list = children; list; list = list->next)
-        {
-          gchild_iter = glade_widget_get_from_gobject (list->data);
+      GladeChildOrder *order;
 
-          /* Refresh values yet again */
-          glade_widget_pack_property_get
-              (gchild_iter, "position", &iter_position);
+      /* The runtime box is already in place when siblings are renumbered */
+      if (glade_gtk_child_order_renumbering (container))
+        return;
 
-          gtk_box_reorder_child (GTK_BOX (container),
-                                 GTK_WIDGET (list->data), iter_position);
+      order = glade_gtk_child_order_get (container, &glade_gtk_box_child_order_funcs);
+      glade_gtk_child_order_move (order, child, g_value_get_int (value));
 
-        }
-
-      if (children)
-        g_list_free (children);
+      /* Positions are loaded in any order, sort the box once they are all set */
+      if (glade_widget_superuser ())
+        glade_gtk_child_order_queue_sort (order);
     }
-
-  /* Chain Up */
-  if (!is_position)
+  else
+    /* Chain Up */
     GWA_GET_CLASS
         (GTK_TYPE_CONTAINER)->child_set_property (adaptor,
                                                   container,
@@ -297,7 +286,7 @@ glade_gtk_box_get_first_blank (GtkBox * box)
 
 	  /* property can be NULL here when project is closing */
 	  if (property)
-	    gwidget_position = g_value_get_int (glade_property_inline_value (property));
+	    glade_property_get (property, &gwidget_position);
 
           if (gwidget_position > position)
             break;
@@ -633,13 +622,10 @@ glade_gtk_box_child_action_activate (GladeWidgetAdaptor *adaptor,
 /**********************************************************
  *             GladeFixed drag implementation             *
  **********************************************************/
-typedef struct
-{
-  GtkWidget *widget;
-  gint position;
-} GladeGtkBoxChild;
-
-static GList *glade_gtk_box_original_positions = NULL;
+/* Dragging a child only ever moves that child, we just need to
+ * remember where it was to record the whole drag as a single command.
+ */
+static gint glade_gtk_box_original_position = -1;
 
 static gboolean
 glade_gtk_box_configure_child (GladeFixed * fixed,
@@ -747,31 +733,10 @@ static gboolean
 glade_gtk_box_configure_begin (GladeFixed * fixed,
                                GladeWidget * child, GtkWidget * box)
 {
-  GList *list, *children;
-  GtkWidget *bchild;
-
-  g_assert (glade_gtk_box_original_positions == NULL);
-
-  children = gtk_container_get_children (GTK_CONTAINER (box));
-
-  for (list = children; list; list = list->next)
-    {
-      GladeGtkBoxChild *gbchild;
-      GladeWidget *gchild;
-
-      bchild = list->data;
-      if ((gchild = glade_widget_get_from_gobject (bchild)) == NULL)
-        continue;
+  g_assert (glade_gtk_box_original_position < 0);
 
-      gbchild = g_new0 (GladeGtkBoxChild, 1);
-      gbchild->widget = bchild;
-      glade_widget_pack_property_get (gchild, "position", &gbchild->position);
-
-      glade_gtk_box_original_positions =
-          g_list_prepend (glade_gtk_box_original_positions, gbchild);
-    }
-
-  g_list_free (children);
+  glade_widget_pack_property_get (child, "position",
+                                  &glade_gtk_box_original_position);
 
   return TRUE;
 }
@@ -780,59 +745,38 @@ static gboolean
 glade_gtk_box_configure_end (GladeFixed * fixed,
                              GladeWidget * child, GtkWidget * box)
 {
-  GList *list, *l, *children;
-  GList *prop_list = NULL;
+  GladeProperty *property;
+  gint position;
 
-  children = gtk_container_get_children (GTK_CONTAINER (box));
+  property = glade_widget_get_pack_property (child, "position");
+  glade_widget_pack_property_get (child, "position", &position);
 
-  for (list = children; list; list = list->next)
+  if (property && position != glade_gtk_box_original_position)
     {
-      GtkWidget *bchild = list->data;
+      GCSetPropData *prop_data = g_new0 (GCSetPropData, 1);
+      GList *prop_list;
 
-      for (l = glade_gtk_box_original_positions; l; l = l->next)
-        {
-          GladeGtkBoxChild *gbchild = l->data;
-          GladeWidget *gchild = glade_widget_get_from_gobject (gbchild->widget);
+      prop_data->property = property;
+      prop_data->old_value = g_new0 (GValue, 1);
+      prop_data->new_value = g_new0 (GValue, 1);
 
+      glade_property_get_value (prop_data->property, prop_data->new_value);
 
-          if (bchild == gbchild->widget)
-            {
-              GCSetPropData *prop_data = g_new0 (GCSetPropData, 1);
-              prop_data->property =
-                  glade_widget_get_pack_property (gchild, "position");
-
-              prop_data->old_value = g_new0 (GValue, 1);
-              prop_data->new_value = g_new0 (GValue, 1);
+      g_value_init (prop_data->old_value, G_TYPE_INT);
+      g_value_set_int (prop_data->old_value, glade_gtk_box_original_position);
 
-              glade_property_get_value (prop_data->property,
-                                        prop_data->new_value);
+      prop_list = g_list_prepend (NULL, prop_data);
 
-              g_value_init (prop_data->old_value, G_TYPE_INT);
-              g_value_set_int (prop_data->old_value, gbchild->position);
-
-              prop_list = g_list_prepend (prop_list, prop_data);
-              break;
-            }
-        }
+      glade_command_push_group (_("Ordering children of %s"),
+                                glade_widget_get_name (GLADE_WIDGET (fixed)));
+      glade_property_push_superuser ();
+      glade_command_set_properties_list (glade_widget_get_project (GLADE_WIDGET (fixed)),
+                                         prop_list);
+      glade_property_pop_superuser ();
+      glade_command_pop_group ();
     }
 
-  g_list_free (children);
-
-  glade_command_push_group (_("Ordering children of %s"),
-                            glade_widget_get_name (GLADE_WIDGET (fixed)));
-  glade_property_push_superuser ();
-  if (prop_list)
-    glade_command_set_properties_list (glade_widget_get_project (GLADE_WIDGET (fixed)),
-                                       prop_list);
-  glade_property_pop_superuser ();
-  glade_command_pop_group ();
-
-  for (l = glade_gtk_box_original_positions; l; l = l->next)
-    g_free (l->data);
-
-  glade_gtk_box_original_positions =
-      (g_list_free (glade_gtk_box_original_positions), NULL);
-
+  glade_gtk_box_original_position = -1;
 
   return TRUE;
 }
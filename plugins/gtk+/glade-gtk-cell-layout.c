@@ -280,14 +280,15 @@ glade_gtk_cell_renderer_write_attributes (GladeWidget * widget,
           GladeXmlNode *attr_node;
           gchar *column_str, *use_attr_str;
           gboolean use_attr = FALSE;
+          gint column = -1;
 
           use_attr_str = g_strdup_printf ("use-%s", glade_property_class_id (pclass));
           glade_widget_property_get (widget, use_attr_str, &use_attr);
+          glade_property_get (property, &column);
 
-          if (use_attr && g_value_get_int (glade_property_inline_value (property)) >= 0)
+          if (use_attr && column >= 0)
             {
-              column_str =
-                  g_strdup_printf ("%d", g_value_get_int (glade_property_inline_value (property)));
+              column_str = g_strdup_printf ("%d", column);
               attr_name = (gchar *)&glade_property_class_id (pclass)[attr_len];
 
               attr_node = glade_xml_node_new (context, GLADE_TAG_ATTRIBUTE);
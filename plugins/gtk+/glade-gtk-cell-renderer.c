@@ -389,7 +389,9 @@ glade_gtk_cell_renderer_sync_attributes (GObject * object)
 
       if (strncmp (glade_property_class_id (pclass), "attr-", attr_len) == 0)
         {
-          gint column = g_value_get_int (glade_property_inline_value (property));
+          gint column;
+
+          glade_property_get (property, &column);
 
           attr_prop_name = (gchar *)&glade_property_class_id (pclass)[attr_len];
 
@@ -0,0 +1,418 @@
+/*
+ * glade-gtk-child-order.c
+ *
+ * Copyright (C) 2017 The Glade developers
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include <config.h>
+
+#include "glade-gtk-child-order.h"
+
+/* An ordered index of the children of a position packed container
+ * (GtkBox, GtkToolbar, GtkNotebook...).
+ *
+ * Changing the "position" of one child used to walk (and rewrite the
+ * position of) every sibling, the index lets us apply a move as a single
+ * splice and renumber only the siblings between the old and new slots.
+ *
+ * The index is attached to the runtime container and is dropped whenever
+ * children are added or removed, it is then rebuilt lazily on next use.
+ */
+#define GLADE_CHILD_ORDER_KEY "glade-gtk-child-order"
+
+struct _GladeChildOrder
+{
+  GObject                    *container;
+  const GladeChildOrderFuncs *funcs;
+
+  GPtrArray  *children;   /* Runtime children in packing order, NULL if stale */
+  GHashTable *index;      /* child -> GINT_TO_POINTER (position + 1) */
+
+  GladeProject *project;    /* Set while a sort is pending */
+  gulong        changed_id;
+  gulong        parsed_id;
+
+  guint       moving : 1;      /* We are reordering the runtime container */
+  guint       renumbering : 1; /* We are updating the siblings positions */
+};
+
+static void
+child_order_clear (GladeChildOrder *order)
+{
+  if (order->children)
+    {
+      g_ptr_array_unref (order->children);
+      order->children = NULL;
+    }
+
+  g_hash_table_remove_all (order->index);
+}
+
+static void
+child_order_unqueue (GladeChildOrder *order)
+{
+  if (order->project == NULL)
+    return;
+
+  g_signal_handler_disconnect (order->project, order->changed_id);
+  g_signal_handler_disconnect (order->project, order->parsed_id);
+  g_object_remove_weak_pointer (G_OBJECT (order->project),
+                                (gpointer *) &order->project);
+
+  order->project    = NULL;
+  order->changed_id = 0;
+  order->parsed_id  = 0;
+}
+
+static void
+child_order_free (GladeChildOrder *order)
+{
+  child_order_unqueue (order);
+  child_order_clear (order);
+  g_hash_table_destroy (order->index);
+  g_slice_free (GladeChildOrder, order);
+}
+
+static void
+child_order_ensure (GladeChildOrder *order)
+{
+  GList *children, *l;
+
+  if (order->children)
+    return;
+
+  children = order->funcs->list_children (order->container);
+
+  order->children = g_ptr_array_sized_new (g_list_length (children));
+
+  for (l = children; l; l = l->next)
+    {
+      g_hash_table_insert (order->index, l->data,
+                           GINT_TO_POINTER (order->children->len + 1));
+      g_ptr_array_add (order->children, l->data);
+    }
+
+  g_list_free (children);
+}
+
+static gint
+child_order_lookup (GladeChildOrder *order, GObject *child)
+{
+  gint position;
+
+  child_order_ensure (order);
+
+  position = GPOINTER_TO_INT (g_hash_table_lookup (order->index, child)) - 1;
+
+  /* Someone changed the container behind our back, start over */
+  if (position < 0 || g_ptr_array_index (order->children, position) != child)
+    {
+      child_order_clear (order);
+      child_order_ensure (order);
+
+      position = GPOINTER_TO_INT (g_hash_table_lookup (order->index, child)) - 1;
+    }
+
+  return position;
+}
+
+static void
+child_order_changed (GtkContainer    *container,
+                     GtkWidget       *widget,
+                     GladeChildOrder *order)
+{
+  if (!order->moving)
+    child_order_clear (order);
+}
+
+static void
+child_order_renumber (GladeChildOrder *order, GObject *child, gint position)
+{
+  GladeWidget *gchild;
+
+  if (order->funcs->renumber)
+    {
+      order->funcs->renumber (order->container, child, position);
+      return;
+    }
+
+  if ((gchild = glade_widget_get_from_gobject (child)) != NULL &&
+      glade_widget_get_pack_property (gchild, "position") != NULL)
+    glade_widget_pack_property_set (gchild, "position", position);
+}
+
+/**
+ * glade_gtk_child_order_get:
+ * @container: A position packed runtime container
+ * @funcs: the hooks to access @container's children
+ *
+ * Returns: (transfer none): the ordered child index of @container,
+ * it is created on first use and lives as long as @container.
+ */
+GladeChildOrder *
+glade_gtk_child_order_get (GObject                    *container,
+                           const GladeChildOrderFuncs *funcs)
+{
+  GladeChildOrder *order;
+
+  g_return_val_if_fail (GTK_IS_CONTAINER (container), NULL);
+  g_return_val_if_fail (funcs != NULL && funcs->list_children && funcs->reorder, NULL);
+
+  if ((order = g_object_get_data (container, GLADE_CHILD_ORDER_KEY)) != NULL)
+    return order;
+
+  order = g_slice_new0 (GladeChildOrder);
+  order->container = container;
+  order->funcs = funcs;
+  order->index = g_hash_table_new (NULL, NULL);
+
+  g_object_set_data_full (container, GLADE_CHILD_ORDER_KEY, order,
+                          (GDestroyNotify) child_order_free);
+
+  g_signal_connect (container, "add", G_CALLBACK (child_order_changed), order);
+  g_signal_connect (container, "remove", G_CALLBACK (child_order_changed), order);
+
+  return order;
+}
+
+/**
+ * glade_gtk_child_order_get_position:
+ * @order: A #GladeChildOrder
+ * @child: A runtime child
+ *
+ * Returns: the real packing position of @child, or -1 if @child
+ * is not a child of the container.
+ */
+gint
+glade_gtk_child_order_get_position (GladeChildOrder *order, GObject *child)
+{
+  g_return_val_if_fail (order != NULL, -1);
+
+  return child_order_lookup (order, child);
+}
+
+gint
+glade_gtk_child_order_get_n_children (GladeChildOrder *order)
+{
+  g_return_val_if_fail (order != NULL, 0);
+
+  child_order_ensure (order);
+
+  return order->children->len;
+}
+
+/**
+ * glade_gtk_child_order_move:
+ * @order: A #GladeChildOrder
+ * @child: A runtime child
+ * @position: The new position for @child
+ *
+ * Moves @child to @position in the runtime container and in the index,
+ * unless in superuser mode the siblings between the old and new positions
+ * get their "position" packing property renumbered once.
+ *
+ * Returns: whether @child was found in the container.
+ */
+gboolean
+glade_gtk_child_order_move (GladeChildOrder *order,
+                            GObject         *child,
+                            gint             position)
+{
+  gint old_position, first, last, i;
+
+  g_return_val_if_fail (order != NULL, FALSE);
+
+  if ((old_position = child_order_lookup (order, child)) < 0)
+    return FALSE;
+
+  position = CLAMP (position, 0, (gint) order->children->len - 1);
+
+  if (position == old_position)
+    return TRUE;
+
+  order->moving = TRUE;
+  order->funcs->reorder (order->container, child, position);
+  order->moving = FALSE;
+
+  /* Splice */
+  g_ptr_array_remove_index (order->children, old_position);
+  g_ptr_array_insert (order->children, position, child);
+
+  first = MIN (old_position, position);
+  last  = MAX (old_position, position);
+
+  for (i = first; i <= last; i++)
+    g_hash_table_insert (order->index,
+                         g_ptr_array_index (order->children, i),
+                         GINT_TO_POINTER (i + 1));
+
+  /* When loading or undoing every child position is set explicitly */
+  if (glade_widget_superuser ())
+    return TRUE;
+
+  order->renumbering = TRUE;
+  for (i = first; i <= last; i++)
+    {
+      GObject *sibling = g_ptr_array_index (order->children, i);
+
+      if (sibling != child)
+        child_order_renumber (order, sibling, i);
+    }
+  order->renumbering = FALSE;
+
+  return TRUE;
+}
+
+static gint
+child_order_compare (gconstpointer a, gconstpointer b)
+{
+  GladeWidget *gwidget_a = glade_widget_get_from_gobject (*(GObject **) a);
+  GladeWidget *gwidget_b = glade_widget_get_from_gobject (*(GObject **) b);
+  gint position_a = 0, position_b = 0;
+
+  glade_widget_pack_property_get (gwidget_a, "position", &position_a);
+  glade_widget_pack_property_get (gwidget_b, "position", &position_b);
+
+  return position_a - position_b;
+}
+
+static void
+child_order_sort (GladeChildOrder *order)
+{
+  GPtrArray *sorted;
+  GList *children, *l;
+  guint i;
+
+  child_order_unqueue (order);
+
+  children = order->funcs->list_children (order->container);
+  sorted   = g_ptr_array_new ();
+
+  for (l = children; l; l = l->next)
+    {
+      GladeWidget *gchild = glade_widget_get_from_gobject (l->data);
+
+      if (gchild && glade_widget_get_pack_property (gchild, "position"))
+        g_ptr_array_add (sorted, l->data);
+    }
+  g_list_free (children);
+
+  g_ptr_array_sort (sorted, child_order_compare);
+
+  order->moving = TRUE;
+  for (i = 0; i < sorted->len; i++)
+    {
+      GObject *child = g_ptr_array_index (sorted, i);
+      gint position = 0;
+
+      glade_widget_pack_property_get (glade_widget_get_from_gobject (child),
+                                      "position", &position);
+      order->funcs->reorder (order->container, child, position);
+    }
+  order->moving = FALSE;
+
+  g_ptr_array_free (sorted, TRUE);
+
+  child_order_clear (order);
+}
+
+static void
+child_order_project_changed (GladeProject    *project,
+                             GladeCommand    *command,
+                             gboolean         forward,
+                             GladeChildOrder *order)
+{
+  child_order_sort (order);
+}
+
+/**
+ * glade_gtk_child_order_queue_sort:
+ * @order: A #GladeChildOrder
+ *
+ * Queues a single pass reordering the runtime children by their
+ * "position" packing property, this is used when positions are
+ * assigned one by one in superuser mode (loading, undo/redo) where
+ * the intermediate states can not be trusted.
+ *
+ * The sort is applied when the project finishes parsing or right
+ * after the command assigning the positions is executed or undone,
+ * so the container is in order before control returns to the caller.
+ * A container outside of any project is sorted right away.
+ */
+void
+glade_gtk_child_order_queue_sort (GladeChildOrder *order)
+{
+  GladeWidget *gwidget;
+  GladeProject *project;
+
+  g_return_if_fail (order != NULL);
+
+  if (order->project)
+    return;
+
+  gwidget = glade_widget_get_from_gobject (order->container);
+  project = gwidget ? glade_widget_get_project (gwidget) : NULL;
+
+  if (project == NULL)
+    {
+      child_order_sort (order);
+      return;
+    }
+
+  order->project = project;
+  g_object_add_weak_pointer (G_OBJECT (project), (gpointer *) &order->project);
+
+  order->parsed_id =
+    g_signal_connect_swapped (project, "parse-finished",
+                              G_CALLBACK (child_order_sort), order);
+  order->changed_id =
+    g_signal_connect (project, "changed",
+                      G_CALLBACK (child_order_project_changed), order);
+}
+
+/**
+ * glade_gtk_child_order_invalidate:
+ * @container: A position packed runtime container
+ *
+ * Drops the index of @container (if any), use this after adding
+ * or moving children without going through gtk_container_add() or
+ * gtk_container_remove().
+ */
+void
+glade_gtk_child_order_invalidate (GObject *container)
+{
+  GladeChildOrder *order = g_object_get_data (container, GLADE_CHILD_ORDER_KEY);
+
+  if (order && !order->moving)
+    child_order_clear (order);
+}
+
+/**
+ * glade_gtk_child_order_renumbering:
+ * @container: A position packed runtime container
+ *
+ * Returns: whether we are currently updating the "position" of
+ * @container's children as a result of a move, adaptors should
+ * not touch the runtime container when this is the case.
+ */
+gboolean
+glade_gtk_child_order_renumbering (GObject *container)
+{
+  GladeChildOrder *order = g_object_get_data (container, GLADE_CHILD_ORDER_KEY);
+
+  return order && order->renumbering;
+}
@@ -0,0 +1,67 @@
+/*
+ * glade-gtk-child-order.h
+ *
+ * Copyright (C) 2017 The Glade developers
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#ifndef _GLADE_GTK_CHILD_ORDER_H_
+#define _GLADE_GTK_CHILD_ORDER_H_
+
+#include <gtk/gtk.h>
+#include <gladeui/glade.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GladeChildOrder GladeChildOrder;
+
+/* Per adaptor hooks used by a GladeChildOrder:
+ *
+ *  list_children: returns a newly allocated list of the runtime children
+ *                 sorted by their real packing position.
+ *  reorder:       moves @child to @position in the runtime container.
+ *  renumber:      optional, updates the "position" packing property of a
+ *                 sibling that was shifted by a move (defaults to setting
+ *                 the GladeWidget's "position" packing property).
+ */
+typedef struct
+{
+  GList *(* list_children) (GObject *container);
+  void   (* reorder)       (GObject *container, GObject *child, gint position);
+  void   (* renumber)      (GObject *container, GObject *child, gint position);
+} GladeChildOrderFuncs;
+
+GladeChildOrder *glade_gtk_child_order_get            (GObject                    *container,
+                                                       const GladeChildOrderFuncs *funcs);
+
+gint             glade_gtk_child_order_get_position   (GladeChildOrder            *order,
+                                                       GObject                    *child);
+
+gint             glade_gtk_child_order_get_n_children (GladeChildOrder            *order);
+
+gboolean         glade_gtk_child_order_move           (GladeChildOrder            *order,
+                                                       GObject                    *child,
+                                                       gint                        position);
+
+void             glade_gtk_child_order_queue_sort     (GladeChildOrder            *order);
+
+void             glade_gtk_child_order_invalidate     (GObject                    *container);
+
+gboolean         glade_gtk_child_order_renumbering    (GObject                    *container);
+
+G_END_DECLS
+
+#endif  /* _GLADE_GTK_CHILD_ORDER_H_ */
@@ -388,6 +388,7 @@ glade_gtk_label_read_widget (GladeWidgetAdaptor * adaptor,
                              GladeWidget * widget, GladeXmlNode * node)
 {
   GladeProperty *prop;
+  GValue label = G_VALUE_INIT;
 
   if (!(glade_xml_node_verify_silent (node, GLADE_XML_TAG_WIDGET) ||
 	glade_xml_node_verify_silent (node, GLADE_XML_TAG_TEMPLATE)))
@@ -400,8 +401,9 @@ glade_gtk_label_read_widget (GladeWidgetAdaptor * adaptor,
 
   /* sync label property after a load... */
   prop = glade_widget_get_property (widget, "label");
-  glade_gtk_label_set_label (glade_widget_get_object (widget), 
-			     glade_property_inline_value (prop));
+  glade_property_get_value (prop, &label);
+  glade_gtk_label_set_label (glade_widget_get_object (widget), &label);
+  g_value_unset (&label);
 
   /* Resolve "label-content-mode" virtual control property  */
   if (!glade_widget_property_original_default (widget, "use-markup"))
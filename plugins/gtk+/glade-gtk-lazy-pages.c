@@ -0,0 +1,165 @@
+/*
+ * glade-gtk-lazy-pages.c
+ *
+ * Copyright (C) 2017 The Glade developers
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include <config.h>
+
+#include "glade-gtk-lazy-pages.h"
+
+/* Pages of notebooks, stacks and assistants which are not on display.
+ *
+ * GTK+ does not map the hidden pages but it still measures them, so a
+ * design with many pages is styled and sized as a whole. A parked page
+ * hides its children, which takes them out of size negotiation, and
+ * shows them again once it becomes the current page.
+ *
+ * Glade shows every widget it creates or rebuilds with
+ * gtk_widget_show_all(), the hidden children are flagged "no-show-all"
+ * so that they stay hidden, and children added to a parked page are
+ * hidden as well. A hidden child is shown again as soon as it leaves
+ * the page, for instance when the page itself is rebuilt.
+ *
+ * The "visible" and "no-show-all" properties are not applied to the
+ * runtime objects in the design, so this does not leak into the project.
+ */
+#define GLADE_LAZY_PAGE_PARKED "glade-gtk-lazy-page-parked"
+#define GLADE_LAZY_PAGE_HIDDEN "glade-gtk-lazy-page-hidden"
+
+static void lazy_page_child_parent_set (GtkWidget *child,
+                                        GtkWidget *old_parent,
+                                        gpointer   data);
+
+static void
+lazy_page_hide_child (GtkWidget *child)
+{
+  if (!gtk_widget_get_visible (child) ||
+      g_object_get_data (G_OBJECT (child), GLADE_LAZY_PAGE_HIDDEN))
+    return;
+
+  g_object_set_data (G_OBJECT (child), GLADE_LAZY_PAGE_HIDDEN, GINT_TO_POINTER (TRUE));
+  gtk_widget_set_no_show_all (child, TRUE);
+  gtk_widget_hide (child);
+
+  g_signal_connect (child, "parent-set",
+                    G_CALLBACK (lazy_page_child_parent_set), NULL);
+}
+
+static void
+lazy_page_show_child (GtkWidget *child)
+{
+  if (!g_object_get_data (G_OBJECT (child), GLADE_LAZY_PAGE_HIDDEN))
+    return;
+
+  g_signal_handlers_disconnect_by_func (child, lazy_page_child_parent_set, NULL);
+
+  g_object_set_data (G_OBJECT (child), GLADE_LAZY_PAGE_HIDDEN, NULL);
+  gtk_widget_set_no_show_all (child, FALSE);
+  gtk_widget_show (child);
+}
+
+/* The child was removed from the parked page */
+static void
+lazy_page_child_parent_set (GtkWidget *child,
+                            GtkWidget *old_parent,
+                            gpointer   data)
+{
+  lazy_page_show_child (child);
+}
+
+static void
+lazy_page_child_added (GtkContainer *page,
+                       GtkWidget    *child,
+                       gpointer      data)
+{
+  lazy_page_hide_child (child);
+}
+
+/**
+ * glade_gtk_lazy_page_park:
+ * @page: a page of a notebook, stack or assistant
+ *
+ * Hides the children of @page until it is unparked.
+ */
+void
+glade_gtk_lazy_page_park (GtkWidget *page)
+{
+  GList *children, *l;
+
+  if (!GTK_IS_CONTAINER (page) || glade_gtk_lazy_page_is_parked (page))
+    return;
+
+  g_object_set_data (G_OBJECT (page), GLADE_LAZY_PAGE_PARKED, GINT_TO_POINTER (TRUE));
+
+  g_signal_connect_after (page, "add",
+                          G_CALLBACK (lazy_page_child_added), NULL);
+
+  children = gtk_container_get_children (GTK_CONTAINER (page));
+  for (l = children; l; l = l->next)
+    lazy_page_hide_child (l->data);
+  g_list_free (children);
+}
+
+/**
+ * glade_gtk_lazy_page_unpark:
+ * @page: a page of a notebook, stack or assistant
+ *
+ * Shows the children hidden by glade_gtk_lazy_page_park() again.
+ */
+void
+glade_gtk_lazy_page_unpark (GtkWidget *page)
+{
+  GList *children, *l;
+
+  if (!glade_gtk_lazy_page_is_parked (page))
+    return;
+
+  g_object_set_data (G_OBJECT (page), GLADE_LAZY_PAGE_PARKED, NULL);
+  g_signal_handlers_disconnect_by_func (page, lazy_page_child_added, NULL);
+
+  children = gtk_container_get_children (GTK_CONTAINER (page));
+  for (l = children; l; l = l->next)
+    lazy_page_show_child (l->data);
+  g_list_free (children);
+}
+
+gboolean
+glade_gtk_lazy_page_is_parked (GtkWidget *page)
+{
+  return g_object_get_data (G_OBJECT (page), GLADE_LAZY_PAGE_PARKED) != NULL;
+}
+
+/**
+ * glade_gtk_lazy_pages_show:
+ * @pages: the pages of a container
+ * @current: the page on display
+ *
+ * Unparks @current and parks every other page in @pages.
+ */
+void
+glade_gtk_lazy_pages_show (GList *pages, GtkWidget *current)
+{
+  GList *l;
+
+  if (current)
+    glade_gtk_lazy_page_unpark (current);
+
+  for (l = pages; l; l = l->next)
+    if (l->data != current)
+      glade_gtk_lazy_page_park (l->data);
+}
@@ -0,0 +1,39 @@
+/*
+ * glade-gtk-lazy-pages.h
+ *
+ * Copyright (C) 2017 The Glade developers
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#ifndef _GLADE_GTK_LAZY_PAGES_H_
+#define _GLADE_GTK_LAZY_PAGES_H_
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+void     glade_gtk_lazy_page_park      (GtkWidget *page);
+
+void     glade_gtk_lazy_page_unpark    (GtkWidget *page);
+
+gboolean glade_gtk_lazy_page_is_parked (GtkWidget *page);
+
+void     glade_gtk_lazy_pages_show     (GList     *pages,
+                                        GtkWidget *current);
+
+G_END_DECLS
+
+#endif  /* _GLADE_GTK_LAZY_PAGES_H_ */
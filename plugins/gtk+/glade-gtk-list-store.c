@@ -65,60 +65,285 @@ glade_gtk_store_set_columns (GObject * object, const GValue * value)
   g_free (types);
 }
 
-static void
-glade_gtk_store_set_data (GObject * object, const GValue * value)
+/* Boxed cells are copies, so they are compared by content: with the
+ * equality function of the type when there is one, through their
+ * string form otherwise.
+ */
+static gboolean
+glade_gtk_store_boxed_equal (const GValue * a, const GValue * b)
 {
-  GladeWidget *gwidget = glade_widget_get_from_gobject (object);
-  GList *columns = NULL;
-  GNode *data_tree, *row, *iter;
-  gint colnum;
-  GtkTreeIter row_iter;
+  GType type = G_VALUE_TYPE (a);
+  gpointer boxed_a = g_value_get_boxed (a);
+  gpointer boxed_b = g_value_get_boxed (b);
+  gchar *string_a, *string_b;
+  gboolean equal;
+
+  if (boxed_a == boxed_b)
+    return TRUE;
+  if (boxed_a == NULL || boxed_b == NULL)
+    return FALSE;
+
+  if (type == GDK_TYPE_RGBA)
+    return gdk_rgba_equal (boxed_a, boxed_b);
+
+  if (type == G_TYPE_STRV)
+    {
+      gchar **strv_a = boxed_a, **strv_b = boxed_b;
+      gint i;
+
+      for (i = 0; strv_a[i] && strv_b[i]; i++)
+        if (strcmp (strv_a[i], strv_b[i]) != 0)
+          return FALSE;
+
+      return strv_a[i] == strv_b[i];
+    }
+
+  string_a = glade_utils_string_from_value (a);
+  string_b = glade_utils_string_from_value (b);
+
+  /* Values we can not tell apart are considered different */
+  equal = string_a && string_b && strcmp (string_a, string_b) == 0;
+
+  g_free (string_a);
+  g_free (string_b);
+
+  return equal;
+}
+
+/* Compares the value of a model data cell with the value found in the
+ * runtime store, objects are compared by address.
+ */
+static gboolean
+glade_gtk_store_value_equal (const GValue * a, const GValue * b)
+{
+  GType type = G_VALUE_TYPE (a);
+
+  if (type != G_VALUE_TYPE (b))
+    return FALSE;
+
+  switch (G_TYPE_FUNDAMENTAL (type))
+    {
+      case G_TYPE_CHAR:
+        return g_value_get_schar (a) == g_value_get_schar (b);
+      case G_TYPE_UCHAR:
+        return g_value_get_uchar (a) == g_value_get_uchar (b);
+      case G_TYPE_BOOLEAN:
+        return g_value_get_boolean (a) == g_value_get_boolean (b);
+      case G_TYPE_INT:
+        return g_value_get_int (a) == g_value_get_int (b);
+      case G_TYPE_UINT:
+        return g_value_get_uint (a) == g_value_get_uint (b);
+      case G_TYPE_LONG:
+        return g_value_get_long (a) == g_value_get_long (b);
+      case G_TYPE_ULONG:
+        return g_value_get_ulong (a) == g_value_get_ulong (b);
+      case G_TYPE_INT64:
+        return g_value_get_int64 (a) == g_value_get_int64 (b);
+      case G_TYPE_UINT64:
+        return g_value_get_uint64 (a) == g_value_get_uint64 (b);
+      case G_TYPE_FLOAT:
+        return g_value_get_float (a) == g_value_get_float (b);
+      case G_TYPE_DOUBLE:
+        return g_value_get_double (a) == g_value_get_double (b);
+      case G_TYPE_ENUM:
+        return g_value_get_enum (a) == g_value_get_enum (b);
+      case G_TYPE_FLAGS:
+        return g_value_get_flags (a) == g_value_get_flags (b);
+      case G_TYPE_STRING:
+        return g_strcmp0 (g_value_get_string (a), g_value_get_string (b)) == 0;
+      case G_TYPE_POINTER:
+        return g_value_get_pointer (a) == g_value_get_pointer (b);
+      case G_TYPE_BOXED:
+        return glade_gtk_store_boxed_equal (a, b);
+      case G_TYPE_OBJECT:
+        return g_value_get_object (a) == g_value_get_object (b);
+      default:
+        return FALSE;
+    }
+}
+
+/* Applies the cells of @row to the runtime row at @iter, only the cells
+ * which differ are set. If @apply is FALSE nothing is set and the return
+ * value tells whether the rows are identical.
+ */
+static gboolean
+glade_gtk_store_sync_row (GObject     * object,
+                          GtkTreeIter * iter,
+                          GNode       * row,
+                          GType       * column_types,
+                          gint          n_columns,
+                          gboolean      apply)
+{
+  GtkTreeModel *model = GTK_TREE_MODEL (object);
   GladeModelData *data;
-  GType column_type;
+  GNode *cell;
+  gboolean equal = TRUE;
+  gint colnum;
+
+  for (colnum = 0, cell = row->children; cell && colnum < n_columns;
+       colnum++, cell = cell->next)
+    {
+      GValue current = G_VALUE_INIT;
+
+      data = cell->data;
+
+      /* Skip cells on type mismatch, the widget's being rebuilt
+       * and a sync will come soon with the right values
+       */
+      if (G_VALUE_TYPE (&data->value) != column_types[colnum])
+        continue;
+
+      gtk_tree_model_get_value (model, iter, colnum, &current);
+
+      if (!glade_gtk_store_value_equal (&current, &data->value))
+        {
+          equal = FALSE;
+
+          if (!apply)
+            {
+              g_value_unset (&current);
+              break;
+            }
+
+          if (GTK_IS_LIST_STORE (object))
+            gtk_list_store_set_value (GTK_LIST_STORE (object),
+                                      iter, colnum, &data->value);
+          else
+            gtk_tree_store_set_value (GTK_TREE_STORE (object),
+                                      iter, colnum, &data->value);
+        }
+
+      g_value_unset (&current);
+    }
+
+  return equal;
+}
+
+static void
+glade_gtk_store_insert_row (GObject * object, GtkTreeIter * iter, gint position)
+{
+  if (GTK_IS_LIST_STORE (object))
+    gtk_list_store_insert (GTK_LIST_STORE (object), iter, position);
+  else
+    /* (for now no child data... ) */
+    gtk_tree_store_insert (GTK_TREE_STORE (object), iter, NULL, position);
+}
 
+static gboolean
+glade_gtk_store_remove_row (GObject * object, GtkTreeIter * iter)
+{
   if (GTK_IS_LIST_STORE (object))
-    gtk_list_store_clear (GTK_LIST_STORE (object));
+    return gtk_list_store_remove (GTK_LIST_STORE (object), iter);
   else
-    gtk_tree_store_clear (GTK_TREE_STORE (object));
+    return gtk_tree_store_remove (GTK_TREE_STORE (object), iter);
+}
+
+/* Updates the runtime store with a row diff against the new data:
+ * the common leading and trailing rows are left untouched, the rows in
+ * between are patched cell by cell and only the surplus rows are
+ * inserted or removed. Editing one cell of a big store thus results in
+ * a single "row-changed" instead of refilling the whole store.
+ */
+static void
+glade_gtk_store_set_data (GObject * object, const GValue * value)
+{
+  GladeWidget *gwidget = glade_widget_get_from_gobject (object);
+  GtkTreeModel *model = GTK_TREE_MODEL (object);
+  GList *columns = NULL;
+  GNode *data_tree, *row;
+  GPtrArray *rows;
+  GType *column_types;
+  GtkTreeIter iter;
+  gint n_columns, n_old, n_new, prefix, suffix, i;
 
   glade_widget_property_get (gwidget, "columns", &columns);
   data_tree = g_value_get_boxed (value);
 
   /* Nothing to enter without columns defined */
   if (!data_tree || !columns)
-    return;
-
-  for (row = data_tree->children; row; row = row->next)
     {
       if (GTK_IS_LIST_STORE (object))
-        gtk_list_store_append (GTK_LIST_STORE (object), &row_iter);
+        gtk_list_store_clear (GTK_LIST_STORE (object));
       else
-        /* (for now no child data... ) */
-        gtk_tree_store_append (GTK_TREE_STORE (object), &row_iter, NULL);
+        gtk_tree_store_clear (GTK_TREE_STORE (object));
+      return;
+    }
 
-      for (colnum = 0, iter = row->children; iter; colnum++, iter = iter->next)
+  n_columns = MIN (g_list_length (columns),
+                   gtk_tree_model_get_n_columns (model));
+  column_types = g_new (GType, MAX (n_columns, 1));
+  for (i = 0; i < n_columns; i++)
+    column_types[i] = gtk_tree_model_get_column_type (model, i);
+
+  rows = g_ptr_array_new ();
+  for (row = data_tree->children; row; row = row->next)
+    g_ptr_array_add (rows, row);
+
+  n_new = rows->len;
+  n_old = gtk_tree_model_iter_n_children (model, NULL);
+
+  /* Skip the identical leading rows */
+  prefix = 0;
+  if (gtk_tree_model_get_iter_first (model, &iter))
+    {
+      while (prefix < n_old && prefix < n_new &&
+             glade_gtk_store_sync_row (object, &iter,
+                                       g_ptr_array_index (rows, prefix),
+                                       column_types, n_columns, FALSE))
         {
-          data = iter->data;
+          prefix++;
+          if (!gtk_tree_model_iter_next (model, &iter))
+            break;
+        }
+    }
 
-          if (!g_list_nth (columns, colnum))
+  /* ... and the identical trailing ones */
+  suffix = 0;
+  if (n_old > prefix && n_new > prefix &&
+      gtk_tree_model_iter_nth_child (model, &iter, NULL, n_old - 1))
+    {
+      while (n_old - suffix > prefix && n_new - suffix > prefix &&
+             glade_gtk_store_sync_row (object, &iter,
+                                       g_ptr_array_index (rows, n_new - suffix - 1),
+                                       column_types, n_columns, FALSE))
+        {
+          suffix++;
+          if (!gtk_tree_model_iter_previous (model, &iter))
             break;
+        }
+    }
 
-          /* Abort if theres a type mismatch, the widget's being rebuilt
-           * and a sync will come soon with the right values
-           */
-          column_type =
-              gtk_tree_model_get_column_type (GTK_TREE_MODEL (object), colnum);
-          if (G_VALUE_TYPE (&data->value) != column_type)
-            continue;
+  /* Patch the rows present on both sides */
+  if (n_old - suffix > prefix &&
+      gtk_tree_model_iter_nth_child (model, &iter, NULL, prefix))
+    {
+      for (i = prefix; i < MIN (n_old, n_new) - suffix; i++)
+        {
+          glade_gtk_store_sync_row (object, &iter, g_ptr_array_index (rows, i),
+                                    column_types, n_columns, TRUE);
 
-          if (GTK_IS_LIST_STORE (object))
-            gtk_list_store_set_value (GTK_LIST_STORE (object),
-                                      &row_iter, colnum, &data->value);
-          else
-            gtk_tree_store_set_value (GTK_TREE_STORE (object),
-                                      &row_iter, colnum, &data->value);
+          if (!gtk_tree_model_iter_next (model, &iter))
+            break;
         }
+
+      /* Drop the surplus of old rows */
+      for (i = n_new; i < n_old; i++)
+        if (!glade_gtk_store_remove_row (object, &iter))
+          break;
     }
+
+  /* Insert the surplus of new rows */
+  for (i = n_old; i < n_new; i++)
+    {
+      gint position = i - n_old + MIN (n_old, n_new) - suffix;
+
+      glade_gtk_store_insert_row (object, &iter, position);
+      glade_gtk_store_sync_row (object, &iter, g_ptr_array_index (rows, position),
+                                column_types, n_columns, TRUE);
+    }
+
+  g_ptr_array_free (rows, TRUE);
+  g_free (column_types);
 }
 
 void
@@ -325,13 +550,14 @@ glade_gtk_store_write_columns (GladeWidget * widget,
 {
   GladeXmlNode *columns_node;
   GladeProperty *prop;
-  GList *l;
+  GList *columns = NULL, *l;
 
   prop = glade_widget_get_property (widget, "columns");
+  glade_property_get (prop, &columns);
 
   columns_node = glade_xml_node_new (context, GLADE_TAG_COLUMNS);
 
-  for (l = g_value_get_boxed (glade_property_inline_value (prop)); l; l = g_list_next (l))
+  for (l = columns; l; l = g_list_next (l))
     {
       GladeColumnType *data = l->data;
       GladeXmlNode *column_node, *comment_node;
@@ -363,7 +589,7 @@ glade_gtk_store_write_data (GladeWidget * widget,
   GList *columns = NULL;
   GladeModelData *data;
   GNode *data_tree = NULL, *row, *iter;
-  gint colnum;
+  gint colnum, n_columns;
 
   glade_widget_property_get (widget, "data", &data_tree);
   glade_widget_property_get (widget, "columns", &columns);
@@ -374,6 +600,8 @@ glade_gtk_store_write_data (GladeWidget * widget,
   if (!data_tree || !columns)
     return;
 
+  n_columns = g_list_length (columns);
+
   data_node = glade_xml_node_new (context, GLADE_TAG_DATA);
 
   for (row = data_tree->children; row; row = row->next)
@@ -392,12 +620,12 @@ glade_gtk_store_write_data (GladeWidget * widget,
               G_VALUE_TYPE (&data->value) == G_TYPE_POINTER)
             continue;
 
-          string = glade_utils_string_from_value (&data->value);
-
           /* XXX Log error: data col j exceeds columns on row i */
-          if (!g_list_nth (columns, colnum))
+          if (colnum >= n_columns)
             break;
 
+          string = glade_utils_string_from_value (&data->value);
+
           column_number = g_strdup_printf ("%d", colnum);
 
           col_node = glade_xml_node_new (context, GLADE_TAG_COL);
@@ -529,12 +757,13 @@ static void
 glade_gtk_store_read_data (GladeWidget * widget, GladeXmlNode * node)
 {
   GladeXmlNode *data_node, *row_node, *col_node;
-  GNode *data_tree, *row, *item;
+  GNode *data_tree, *row, *item, *last_row;
   GladeModelData *data;
   GValue *value;
-  GList *column_types = NULL;
-  GladeColumnType *column_type;
-  gint colnum;
+  GList *column_types = NULL, *l;
+  GladeColumnType **columns;
+  GType *types;
+  gint colnum, n_columns, i;
 
   if ((data_node = glade_xml_search_child (node, GLADE_TAG_DATA)) == NULL)
     return;
@@ -544,8 +773,19 @@ glade_gtk_store_read_data (GladeWidget * widget, GladeXmlNode * node)
       !column_types)
     return;
 
+  /* Resolve the columns once, not for every cell */
+  n_columns = g_list_length (column_types);
+  columns   = g_new (GladeColumnType *, n_columns);
+  types     = g_new (GType, n_columns);
+  for (i = 0, l = column_types; l; i++, l = l->next)
+    {
+      columns[i] = l->data;
+      types[i]   = g_type_from_name (columns[i]->type_name);
+    }
+
   /* Create root... */
   data_tree = g_node_new (NULL);
+  last_row  = NULL;
 
   for (row_node = glade_xml_node_get_children (data_node); row_node;
        row_node = glade_xml_node_next (row_node))
@@ -555,8 +795,10 @@ glade_gtk_store_read_data (GladeWidget * widget, GladeXmlNode * node)
       if (!glade_xml_node_verify (row_node, GLADE_TAG_ROW))
         continue;
 
-      row = g_node_new (NULL);
-      g_node_append (data_tree, row);
+      /* Keep track of the tails, g_node_append() walks all siblings */
+      row = g_node_insert_after (data_tree, last_row, g_node_new (NULL));
+      last_row = row;
+      item = NULL;
 
       /* XXX FIXME: we are assuming that the columns are listed in order */
       for (colnum = 0, col_node = glade_xml_node_get_children (row_node);
@@ -575,37 +817,34 @@ glade_gtk_store_read_data (GladeWidget * widget, GladeXmlNode * node)
             }
 
           /* Catch up for gaps in the list where unserializable types are involved */
-          while (colnum < read_column)
+          while (colnum < read_column && colnum < n_columns)
             {
-              column_type = g_list_nth_data (column_types, colnum);
-
               data =
                   glade_model_data_new (G_TYPE_INVALID,
-                                        column_type->column_name);
+                                        columns[colnum]->column_name);
 
-              item = g_node_new (data);
-              g_node_append (row, item);
+              item = g_node_insert_after (row, item, g_node_new (data));
 
               colnum++;
             }
 
-          if (!(column_type = g_list_nth_data (column_types, colnum)))
+          if (colnum >= n_columns)
             /* XXX Log this too... */
             continue;
 
           /* Ignore unloaded column types for the workspace */
-          if (g_type_from_name (column_type->type_name) != G_TYPE_INVALID)
+          if (types[colnum] != G_TYPE_INVALID)
             {
               /* XXX Do we need object properties to somehow work at load time here ??
                * should we be doing this part in "finished" ? ... todo thinkso...
                */
               value_str = glade_xml_get_content (col_node);
-              value = glade_utils_value_from_string (g_type_from_name (column_type->type_name), value_str,
+              value = glade_utils_value_from_string (types[colnum], value_str,
 						     glade_widget_get_project (widget));
               g_free (value_str);
 
-              data = glade_model_data_new (g_type_from_name (column_type->type_name),
-					   column_type->column_name);
+              data = glade_model_data_new (types[colnum],
+					   columns[colnum]->column_name);
 
               g_value_copy (value, &data->value);
               g_value_unset (value);
@@ -615,7 +854,7 @@ glade_gtk_store_read_data (GladeWidget * widget, GladeXmlNode * node)
             {
               data =
                   glade_model_data_new (G_TYPE_INVALID,
-                                        column_type->column_name);
+                                        columns[colnum]->column_name);
             }
 
           data->i18n_translatable =
@@ -626,8 +865,7 @@ glade_gtk_store_read_data (GladeWidget * widget, GladeXmlNode * node)
           data->i18n_comment =
               glade_xml_get_property_string (col_node, GLADE_TAG_COMMENT);
 
-          item = g_node_new (data);
-          g_node_append (row, item);
+          item = g_node_insert_after (row, item, g_node_new (data));
 
           /* dont increment colnum on invalid xml tags... */
           colnum++;
@@ -638,6 +876,8 @@ glade_gtk_store_read_data (GladeWidget * widget, GladeXmlNode * node)
     glade_widget_property_set (widget, "data", data_tree);
 
   glade_model_data_tree_free (data_tree);
+  g_free (columns);
+  g_free (types);
 }
 
 void
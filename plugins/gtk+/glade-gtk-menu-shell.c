@@ -25,6 +25,7 @@
 #include <glib/gi18n-lib.h>
 #include <gladeui/glade.h>
 
+#include "glade-gtk-child-order.h"
 #include "glade-gtk-menu-shell.h"
 #include "glade-gtk.h"
 
@@ -63,6 +64,7 @@ glade_gtk_menu_shell_add_child (GladeWidgetAdaptor * adaptor,
   g_return_if_fail (GTK_IS_MENU_ITEM (child));
 
   gtk_menu_shell_append (GTK_MENU_SHELL (object), GTK_WIDGET (child));
+  glade_gtk_child_order_invalidate (object);
 }
 
 
@@ -76,24 +78,34 @@ glade_gtk_menu_shell_remove_child (GladeWidgetAdaptor * adaptor,
   gtk_container_remove (GTK_CONTAINER (object), GTK_WIDGET (child));
 }
 
-static gint
-glade_gtk_menu_shell_get_item_position (GObject * container, GObject * child)
+static GList *
+glade_gtk_menu_shell_list_children (GObject *container)
 {
-  gint position = 0;
-  GList *list = gtk_container_get_children (GTK_CONTAINER (container));
+  return gtk_container_get_children (GTK_CONTAINER (container));
+}
 
-  while (list)
-    {
-      if (G_OBJECT (list->data) == child)
-        break;
+static void
+glade_gtk_menu_shell_reorder_child (GObject *container, GObject *child, gint position)
+{
+  g_object_ref (child);
+  gtk_container_remove (GTK_CONTAINER (container), GTK_WIDGET (child));
+  gtk_menu_shell_insert (GTK_MENU_SHELL (container), GTK_WIDGET (child), position);
+  g_object_unref (child);
+}
 
-      list = list->next;
-      position++;
-    }
+static const GladeChildOrderFuncs glade_gtk_menu_shell_child_order_funcs = {
+  glade_gtk_menu_shell_list_children,
+  glade_gtk_menu_shell_reorder_child,
+  NULL
+};
 
-  g_list_free (list);
+static gint
+glade_gtk_menu_shell_get_item_position (GObject * container, GObject * child)
+{
+  GladeChildOrder *order =
+    glade_gtk_child_order_get (container, &glade_gtk_menu_shell_child_order_funcs);
 
-  return position;
+  return MAX (glade_gtk_child_order_get_position (order, child), 0);
 }
 
 void
@@ -139,6 +151,9 @@ glade_gtk_menu_shell_set_child_property (GladeWidgetAdaptor * adaptor,
       gitem = glade_widget_get_from_gobject (child);
       g_return_if_fail (GLADE_IS_WIDGET (gitem));
 
+      if (glade_gtk_child_order_renumbering (container))
+        return;
+
       position = g_value_get_int (value);
 
       if (position < 0)
@@ -147,12 +162,9 @@ glade_gtk_menu_shell_set_child_property (GladeWidgetAdaptor * adaptor,
           g_value_set_int (value, position);
         }
 
-      g_object_ref (child);
-      gtk_container_remove (GTK_CONTAINER (container), GTK_WIDGET (child));
-      gtk_menu_shell_insert (GTK_MENU_SHELL (container), GTK_WIDGET (child),
-                             position);
-      g_object_unref (child);
-
+      glade_gtk_child_order_move (glade_gtk_child_order_get (container,
+                                                             &glade_gtk_menu_shell_child_order_funcs),
+                                  child, position);
     }
   else
     /* Chain Up */
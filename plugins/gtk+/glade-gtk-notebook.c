@@ -25,6 +25,8 @@
 #include <gladeui/glade.h>
 
 #include "glade-gtk-notebook.h"
+#include "glade-gtk-child-order.h"
+#include "glade-gtk-lazy-pages.h"
 #include "glade-notebook-editor.h"
 
 typedef struct
@@ -285,6 +287,8 @@ glade_gtk_notebook_insert_children (GtkWidget * notebook,
       g_object_unref (G_OBJECT (tab));
     }
 
+  glade_gtk_child_order_invalidate (G_OBJECT (notebook));
+
   /* Stay on the same page */
   gtk_notebook_set_current_page (GTK_NOTEBOOK (notebook), nchildren->page);
 
@@ -307,6 +311,20 @@ glade_gtk_notebook_insert_children (GtkWidget * notebook,
   g_free (nchildren);
 }
 
+/* Only the current page takes part in size negotiation */
+static void
+glade_gtk_notebook_show_page (GtkNotebook *notebook, GtkWidget *current)
+{
+  GList *pages = NULL;
+  gint i;
+
+  for (i = gtk_notebook_get_n_pages (notebook) - 1; i >= 0; i--)
+    pages = g_list_prepend (pages, gtk_notebook_get_nth_page (notebook, i));
+
+  glade_gtk_lazy_pages_show (pages, current);
+  g_list_free (pages);
+}
+
 static void
 glade_gtk_notebook_switch_page (GtkNotebook * notebook,
                                 GtkWidget * page,
@@ -314,6 +332,8 @@ glade_gtk_notebook_switch_page (GtkNotebook * notebook,
 {
   GladeWidget *gnotebook = glade_widget_get_from_gobject (notebook);
 
+  glade_gtk_notebook_show_page (notebook, page);
+
   glade_widget_property_set (gnotebook, "page", page_num);
 
 }
@@ -391,6 +411,10 @@ glade_gtk_notebook_parse_finished (GladeProject * project, GObject * object)
   action = gtk_notebook_get_action_widget (GTK_NOTEBOOK (object), GTK_PACK_END);
   glade_widget_property_set (glade_widget_get_from_gobject (object),
                              "has-action-end", action != NULL);
+
+  glade_gtk_notebook_show_page (GTK_NOTEBOOK (object),
+                                gtk_notebook_get_nth_page (GTK_NOTEBOOK (object),
+                                                           gtk_notebook_get_current_page (GTK_NOTEBOOK (object))));
 }
 
 void
@@ -430,7 +454,9 @@ glade_gtk_notebook_get_first_blank_page (GtkNotebook * notebook)
         {
           GladeProperty *property =
               glade_widget_get_property (gwidget, "position");
-          gint gwidget_position = g_value_get_int (glade_property_inline_value (property));
+          gint gwidget_position;
+
+          glade_property_get (property, &gwidget_position);
 
           if ((gwidget_position - position) > 0)
             return position;
@@ -518,6 +544,8 @@ glade_gtk_notebook_set_n_pages (GObject * object, const GValue * value)
                                           tab_placeholder);
             }
         }
+
+      glade_gtk_child_order_invalidate (object);
     }
 
   /*
@@ -865,6 +893,45 @@ glade_gtk_notebook_child_verify_property (GladeWidgetAdaptor * adaptor,
   return TRUE;
 }
 
+static GList *
+glade_gtk_notebook_list_pages (GObject *container)
+{
+  GtkNotebook *notebook = GTK_NOTEBOOK (container);
+  GList *pages = NULL;
+  gint i;
+
+  for (i = gtk_notebook_get_n_pages (notebook) - 1; i >= 0; i--)
+    pages = g_list_prepend (pages, gtk_notebook_get_nth_page (notebook, i));
+
+  return pages;
+}
+
+static void
+glade_gtk_notebook_reorder_page (GObject *container, GObject *page, gint position)
+{
+  gtk_notebook_reorder_child (GTK_NOTEBOOK (container), GTK_WIDGET (page), position);
+}
+
+/* Tabs travel along with their pages */
+static void
+glade_gtk_notebook_renumber_page (GObject *container, GObject *page, gint position)
+{
+  GtkWidget *tab = gtk_notebook_get_tab_label (GTK_NOTEBOOK (container), GTK_WIDGET (page));
+  GladeWidget *gchild;
+
+  if ((gchild = glade_widget_get_from_gobject (page)) != NULL)
+    glade_widget_pack_property_set (gchild, "position", position);
+
+  if (tab && (gchild = glade_widget_get_from_gobject (tab)) != NULL)
+    glade_widget_pack_property_set (gchild, "position", position);
+}
+
+static const GladeChildOrderFuncs glade_gtk_notebook_child_order_funcs = {
+  glade_gtk_notebook_list_pages,
+  glade_gtk_notebook_reorder_page,
+  glade_gtk_notebook_renumber_page
+};
+
 void
 glade_gtk_notebook_set_child_property (GladeWidgetAdaptor * adaptor,
                                        GObject * container,
@@ -877,9 +944,34 @@ glade_gtk_notebook_set_child_property (GladeWidgetAdaptor * adaptor,
   if (strcmp (property_name, "position") == 0)
     {
       /* If we are setting this internally, avoid feedback. */
-      if (glade_gtk_notebook_setting_position || glade_widget_superuser ())
+      if (glade_gtk_notebook_setting_position || glade_widget_superuser () ||
+          glade_gtk_child_order_renumbering (container))
         return;
 
+      if (g_object_get_data (child, "special-child-type") == NULL)
+        {
+          GladeChildOrder *order;
+          GtkWidget *tab;
+          GladeWidget *gtab;
+          gint position = g_value_get_int (value);
+
+          /* Move the page along with its tab and shift the pages in between */
+          order = glade_gtk_child_order_get (container, &glade_gtk_notebook_child_order_funcs);
+          if (glade_gtk_child_order_move (order, child, position))
+            {
+              tab = gtk_notebook_get_tab_label (GTK_NOTEBOOK (container), GTK_WIDGET (child));
+
+              if (tab && (gtab = glade_widget_get_from_gobject (tab)) != NULL)
+                {
+                  glade_gtk_notebook_setting_position = TRUE;
+                  glade_widget_pack_property_set (gtab, "position",
+                                                  glade_gtk_child_order_get_position (order, child));
+                  glade_gtk_notebook_setting_position = FALSE;
+                }
+              return;
+            }
+        }
+
       /* Just rebuild the notebook, property values are already set at this point */
       nchildren = glade_gtk_notebook_extract_children (GTK_WIDGET (container));
       glade_gtk_notebook_insert_children (GTK_WIDGET (container), nchildren);
@@ -954,6 +1046,21 @@ glade_gtk_notebook_child_action_activate (GladeWidgetAdaptor *adaptor,
                                                                action_path);
 }
 
+/* Orders children by position, descending for a positive @direction */
+static gint
+compare_positions (GladeWidget *gchild_a,
+                   GladeWidget *gchild_b,
+                   gpointer     direction)
+{
+  gint position_a = 0, position_b = 0;
+
+  glade_widget_pack_property_get (gchild_a, "position", &position_a);
+  glade_widget_pack_property_get (gchild_b, "position", &position_b);
+
+  return (GPOINTER_TO_INT (direction) > 0) ?
+    position_b - position_a : position_a - position_b;
+}
+
 /* Shared with glade-gtk-box.c */
 void
 glade_gtk_box_notebook_child_insert_remove_action (GladeWidgetAdaptor *adaptor,
@@ -965,7 +1072,7 @@ glade_gtk_box_notebook_child_insert_remove_action (GladeWidgetAdaptor *adaptor,
   gboolean is_notebook = GTK_IS_NOTEBOOK (container);
   const gchar *size_prop = (is_notebook) ? "pages" : "size";
   GladeWidget *parent;
-  GList *children, *l;
+  GList *children, *shifted = NULL, *l;
   gint child_pos, size, offset;
 
   if (is_notebook && g_object_get_data (object, "special-child-type"))
@@ -1031,7 +1138,7 @@ glade_gtk_box_notebook_child_insert_remove_action (GladeWidgetAdaptor *adaptor,
     }
 
   /* Reoder children (fix the position property tracking widget positions) */
-  for (l = g_list_last (children); l; l = g_list_previous (l))
+  for (l = children; l; l = g_list_next (l))
     {
       GladeWidget *gchild = glade_widget_get_from_gobject (l->data);
       gint pos;
@@ -1040,11 +1147,38 @@ glade_gtk_box_notebook_child_insert_remove_action (GladeWidgetAdaptor *adaptor,
       if (gchild == NULL)
         continue;
 
+      /* Tabs of project pages are renumbered along with their pages */
+      if (is_notebook &&
+          g_strcmp0 (g_object_get_data (l->data, "special-child-type"), "tab") == 0)
+        {
+          gint tab_pos = notebook_search_tab (GTK_NOTEBOOK (container),
+                                              GTK_WIDGET (l->data));
+          GtkWidget *page = gtk_notebook_get_nth_page (GTK_NOTEBOOK (container), tab_pos);
+
+          if (page && glade_widget_get_from_gobject (page))
+            continue;
+        }
+
       glade_widget_pack_property_get (gchild, "position", &pos);
       if ((after) ? pos > child_pos : pos >= child_pos)
-        glade_command_set_property (glade_widget_get_pack_property
-                                    (gchild, "position"), pos + offset);
+        shifted = g_list_prepend (shifted, gchild);
+    }
+
+  /* Shift them in the direction of the offset, so that every child moves
+   * to the position just freed and moving it does not renumber a sibling
+   * which is still to be shifted.
+   */
+  shifted = g_list_sort_with_data (shifted, (GCompareDataFunc) compare_positions,
+                                   GINT_TO_POINTER (offset));
+  for (l = shifted; l; l = g_list_next (l))
+    {
+      gint pos;
+
+      glade_widget_pack_property_get (l->data, "position", &pos);
+      glade_command_set_property (glade_widget_get_pack_property
+                                  (l->data, "position"), pos + offset);
     }
+  g_list_free (shifted);
 
   if (remove)
     {
@@ -25,6 +25,7 @@
 #include <gladeui/glade.h>
 
 #include "glade-stack-editor.h"
+#include "glade-gtk-lazy-pages.h"
 
 static void
 glade_gtk_stack_selection_changed (GladeProject * project,
@@ -63,6 +64,36 @@ glade_gtk_stack_selection_changed (GladeProject * project,
     }
 }
 
+/* Only the visible child takes part in size negotiation */
+static void
+glade_gtk_stack_show_page (GtkStack *stack)
+{
+  GList *children;
+
+  children = gtk_container_get_children (GTK_CONTAINER (stack));
+  glade_gtk_lazy_pages_show (children, gtk_stack_get_visible_child (stack));
+  g_list_free (children);
+}
+
+static void
+glade_gtk_stack_visible_child_changed (GtkStack   *stack,
+                                       GParamSpec *pspec,
+                                       gpointer    data)
+{
+  GladeProject *project = glade_widget_get_project (glade_widget_get_from_gobject (stack));
+
+  /* Pages are parked all at once when the project is loaded */
+  if (project == NULL || !glade_project_is_loading (project))
+    glade_gtk_stack_show_page (stack);
+}
+
+static void
+glade_gtk_stack_parse_finished (GladeProject *project,
+                                GObject      *stack)
+{
+  glade_gtk_stack_show_page (GTK_STACK (stack));
+}
+
 static void
 glade_gtk_stack_project_changed (GladeWidget * gwidget,
                                  GParamSpec * pspec,
@@ -100,6 +131,14 @@ glade_gtk_stack_post_create (GladeWidgetAdaptor *adaptor,
 
   glade_gtk_stack_project_changed (gwidget, NULL, NULL);
 
+  g_signal_connect (container, "notify::visible-child",
+                    G_CALLBACK (glade_gtk_stack_visible_child_changed), NULL);
+
+  if (reason == GLADE_CREATE_LOAD)
+    g_signal_connect_object (glade_widget_get_project (gwidget), "parse-finished",
+                             G_CALLBACK (glade_gtk_stack_parse_finished),
+                             container, 0);
+
 }
 
 static gchar *
@@ -26,6 +26,7 @@
 #include <gladeui/glade.h>
 
 #include "glade-tool-palette-editor.h"
+#include "glade-gtk-child-order.h"
 #include "glade-gtk-menu-shell.h"
 #include "glade-gtk.h"
 
@@ -67,6 +68,25 @@ glade_gtk_tool_palette_get_child_property (GladeWidgetAdaptor * adaptor,
     }
 }
 
+static GList *
+glade_gtk_tool_palette_list_children (GObject *container)
+{
+  return glade_util_container_get_all_children (GTK_CONTAINER (container));
+}
+
+static void
+glade_gtk_tool_palette_reorder_child (GObject *container, GObject *child, gint position)
+{
+  gtk_tool_palette_set_group_position (GTK_TOOL_PALETTE (container),
+                                       GTK_TOOL_ITEM_GROUP (child), position);
+}
+
+static const GladeChildOrderFuncs glade_gtk_tool_palette_child_order_funcs = {
+  glade_gtk_tool_palette_list_children,
+  glade_gtk_tool_palette_reorder_child,
+  NULL
+};
+
 void
 glade_gtk_tool_palette_set_child_property (GladeWidgetAdaptor * adaptor,
 					   GObject * container,
@@ -81,20 +101,13 @@ glade_gtk_tool_palette_set_child_property (GladeWidgetAdaptor * adaptor,
 
   if (strcmp (property_name, "position") == 0)
     {
-      GtkToolPalette *palette = GTK_TOOL_PALETTE (container);
-      GList *children;
-      gint position, size;
-
-      children = glade_util_container_get_all_children (GTK_CONTAINER (palette));
-      size = g_list_length (children);
-      g_list_free (children);
-
-      position = g_value_get_int (value);
+      GladeChildOrder *order;
 
-      if (position >= size)
-        position = size - 1;
+      if (glade_gtk_child_order_renumbering (container))
+        return;
 
-      gtk_tool_palette_set_group_position (palette, GTK_TOOL_ITEM_GROUP (child), position);
+      order = glade_gtk_child_order_get (container, &glade_gtk_tool_palette_child_order_funcs);
+      glade_gtk_child_order_move (order, child, g_value_get_int (value));
     }
   else
     /* Chain Up */
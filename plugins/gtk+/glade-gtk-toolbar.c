@@ -25,6 +25,7 @@
 #include <glib/gi18n-lib.h>
 #include <gladeui/glade.h>
 
+#include "glade-gtk-child-order.h"
 #include "glade-gtk-image.h"
 #include "glade-gtk-menu-shell.h"
 #include "glade-gtk.h"
@@ -124,6 +125,27 @@ glade_gtk_toolbar_get_child_property (GladeWidgetAdaptor * adaptor,
     }
 }
 
+static GList *
+glade_gtk_toolbar_list_children (GObject *container)
+{
+  return gtk_container_get_children (GTK_CONTAINER (container));
+}
+
+static void
+glade_gtk_toolbar_reorder_child (GObject *container, GObject *child, gint position)
+{
+  g_object_ref (child);
+  gtk_container_remove (GTK_CONTAINER (container), GTK_WIDGET (child));
+  gtk_toolbar_insert (GTK_TOOLBAR (container), GTK_TOOL_ITEM (child), position);
+  g_object_unref (child);
+}
+
+static const GladeChildOrderFuncs glade_gtk_toolbar_child_order_funcs = {
+  glade_gtk_toolbar_list_children,
+  glade_gtk_toolbar_reorder_child,
+  NULL
+};
+
 void
 glade_gtk_toolbar_set_child_property (GladeWidgetAdaptor * adaptor,
                                       GObject * container,
@@ -138,19 +160,13 @@ glade_gtk_toolbar_set_child_property (GladeWidgetAdaptor * adaptor,
 
   if (strcmp (property_name, "position") == 0)
     {
-      GtkToolbar *toolbar = GTK_TOOLBAR (container);
-      gint position, size;
-
-      position = g_value_get_int (value);
-      size = gtk_toolbar_get_n_items (toolbar);
+      GladeChildOrder *order;
 
-      if (position >= size)
-        position = size - 1;
+      if (glade_gtk_child_order_renumbering (container))
+        return;
 
-      g_object_ref (child);
-      gtk_container_remove (GTK_CONTAINER (container), GTK_WIDGET (child));
-      gtk_toolbar_insert (toolbar, GTK_TOOL_ITEM (child), position);
-      g_object_unref (child);
+      order = glade_gtk_child_order_get (container, &glade_gtk_toolbar_child_order_funcs);
+      glade_gtk_child_order_move (order, child, g_value_get_int (value));
     }
   else
     /* Chain Up */
@@ -200,6 +216,7 @@ glade_gtk_toolbar_add_child (GladeWidgetAdaptor * adaptor,
   item = GTK_TOOL_ITEM (child);
 
   gtk_toolbar_insert (toolbar, item, -1);
+  glade_gtk_child_order_invalidate (object);
 
   if (glade_util_object_is_loading (object))
     {
@@ -429,12 +429,17 @@ glade_gtk_widget_write_atk_relation (GladeProperty * property,
 {
   GladeXmlNode *prop_node;
   GladePropertyClass *pclass;
+  GValue objects = G_VALUE_INIT;
   gchar *value, **split;
   gint i;
 
-  if ((value = glade_widget_adaptor_string_from_value
-       (glade_property_class_get_adaptor (glade_property_get_class (property)),
-        glade_property_get_class (property), glade_property_inline_value (property))) != NULL)
+  glade_property_get_value (property, &objects);
+  value = glade_widget_adaptor_string_from_value
+    (glade_property_class_get_adaptor (glade_property_get_class (property)),
+     glade_property_get_class (property), &objects);
+  g_value_unset (&objects);
+
+  if (value != NULL)
     {
       if ((split = g_strsplit (value, GPC_OBJECT_DELIMITER, 0)) != NULL)
         {
@@ -985,16 +990,13 @@ static GList *
 list_sizegroups (GladeWidget * gwidget)
 {
   GladeProject *project = glade_widget_get_project (gwidget);
-  GList *groups = NULL;
-  const GList *list;
+  GList *groups, *list;
 
-  for (list = glade_project_get_objects (project); list; list = list->next)
-    {
-      GladeWidget *iter = glade_widget_get_from_gobject (list->data);
-      if (GTK_IS_SIZE_GROUP (glade_widget_get_object (iter)))
-        groups = g_list_prepend (groups, iter);
-    }
-  return g_list_reverse (groups);
+  groups = glade_project_list_objects_by_type (project, GTK_TYPE_SIZE_GROUP);
+  for (list = groups; list; list = list->next)
+    list->data = glade_widget_get_from_gobject (list->data);
+
+  return groups;
 }
 
 static void
@@ -0,0 +1,704 @@
+/*
+ * glade-model-data-store.c
+ *
+ * Copyright (C) 2017 The Glade developers
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include <config.h>
+
+#include <string.h>
+
+#include "glade-model-data-store.h"
+#include "glade-model-data.h"
+
+/* A GtkTreeModel viewing the model data tree of a GladeProperty in place.
+ *
+ * Nothing is copied out of the data tree, cells are converted to the
+ * displayed type only when the view asks for them. The property value is
+ * replaced by every command, the owner calls glade_model_data_store_refresh()
+ * to pick up the new tree and then signals only the rows it knows changed.
+ * The old tree is freed by then, so the store never looks at the property
+ * value by itself.
+ */
+struct _GladeModelDataStorePrivate
+{
+  GladeProperty *property;
+
+  GNode     *data_tree;  /* The tree we currently view (owned by the property) */
+  GPtrArray *rows;       /* Row index into data_tree, built on demand */
+  gint       n_rows;
+  gint       stamp;
+
+  /* The layout the store was created for */
+  gint       n_columns;
+  GType     *types;      /* Model column types */
+  GType     *cell_types; /* Value types of the data cells */
+  gchar    **names;
+};
+
+enum
+{
+  MOVE_ROW,
+  LAST_SIGNAL
+};
+
+static guint model_data_store_signals[LAST_SIGNAL] = { 0, };
+
+static void glade_model_data_store_tree_model_init (GtkTreeModelIface *iface);
+static void glade_model_data_store_drag_source_init (GtkTreeDragSourceIface *iface);
+static void glade_model_data_store_drag_dest_init (GtkTreeDragDestIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GladeModelDataStore, glade_model_data_store, G_TYPE_OBJECT,
+                         G_ADD_PRIVATE (GladeModelDataStore)
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_MODEL,
+                                                glade_model_data_store_tree_model_init)
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_DRAG_SOURCE,
+                                                glade_model_data_store_drag_source_init)
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_DRAG_DEST,
+                                                glade_model_data_store_drag_dest_init))
+
+static void
+glade_model_data_store_init (GladeModelDataStore *store)
+{
+  store->priv = glade_model_data_store_get_instance_private (store);
+  store->priv->stamp = g_random_int ();
+}
+
+static void
+glade_model_data_store_finalize (GObject *object)
+{
+  GladeModelDataStorePrivate *priv = GLADE_MODEL_DATA_STORE (object)->priv;
+
+  if (priv->rows)
+    g_ptr_array_free (priv->rows, TRUE);
+
+  g_clear_object (&priv->property);
+  g_free (priv->types);
+  g_free (priv->cell_types);
+  g_strfreev (priv->names);
+
+  G_OBJECT_CLASS (glade_model_data_store_parent_class)->finalize (object);
+}
+
+static void
+glade_model_data_store_class_init (GladeModelDataStoreClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = glade_model_data_store_finalize;
+
+  /**
+   * GladeModelDataStore::move-row:
+   * @store: the #GladeModelDataStore
+   * @row: the row which was dragged
+   * @position: the position it was dropped at
+   *
+   * Emitted when a row is reordered with drag and drop, the store does
+   * not modify the data itself.
+   */
+  model_data_store_signals[MOVE_ROW] =
+    g_signal_new ("move-row",
+                  G_TYPE_FROM_CLASS (object_class),
+                  G_SIGNAL_RUN_LAST,
+                  G_STRUCT_OFFSET (GladeModelDataStoreClass, move_row),
+                  NULL, NULL, NULL,
+                  G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_INT);
+}
+
+/*******************************************************************************
+                                  Row index
+ *******************************************************************************/
+/* Views the current value of the property. The tree we viewed may have
+ * been freed meanwhile, and a new one allocated at the same address, so
+ * the row index is always dropped.
+ */
+static void
+model_data_store_fetch_tree (GladeModelDataStore *store)
+{
+  GladeModelDataStorePrivate *priv = store->priv;
+  GNode *data_tree = NULL;
+
+  glade_property_get (priv->property, &data_tree);
+
+  priv->data_tree = data_tree;
+  priv->n_rows = data_tree ? g_node_n_children (data_tree) : 0;
+  priv->stamp++;
+
+  if (priv->rows)
+    {
+      g_ptr_array_free (priv->rows, TRUE);
+      priv->rows = NULL;
+    }
+}
+
+static GNode *
+model_data_store_nth_row (GladeModelDataStore *store, gint n)
+{
+  GladeModelDataStorePrivate *priv = store->priv;
+  GNode *data_tree, *row;
+
+  if ((data_tree = priv->data_tree) == NULL ||
+      n < 0 || n >= priv->n_rows)
+    return NULL;
+
+  if (n == 0)
+    return data_tree->children;
+
+  if (priv->rows == NULL)
+    {
+      priv->rows = g_ptr_array_sized_new (priv->n_rows);
+
+      for (row = data_tree->children; row; row = row->next)
+        g_ptr_array_add (priv->rows, row);
+    }
+
+  return g_ptr_array_index (priv->rows, n);
+}
+
+static gboolean
+model_data_store_set_iter (GladeModelDataStore *store,
+                           GtkTreeIter         *iter,
+                           GNode               *row,
+                           gint                 n)
+{
+  if (row == NULL)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  iter->stamp      = store->priv->stamp;
+  iter->user_data  = row;
+  iter->user_data2 = GINT_TO_POINTER (n);
+  return TRUE;
+}
+
+#define VALID_ITER(store, iter) \
+  ((iter) != NULL && (iter)->stamp == (store)->priv->stamp && (iter)->user_data != NULL)
+
+/*******************************************************************************
+                                GtkTreeModel
+ *******************************************************************************/
+static GtkTreeModelFlags
+glade_model_data_store_get_flags (GtkTreeModel *model)
+{
+  return GTK_TREE_MODEL_LIST_ONLY;
+}
+
+static gint
+glade_model_data_store_get_n_columns (GtkTreeModel *model)
+{
+  return GLADE_MODEL_DATA_STORE_N_COLUMNS + GLADE_MODEL_DATA_STORE (model)->priv->n_columns;
+}
+
+static GType
+glade_model_data_store_get_column_type (GtkTreeModel *model, gint column)
+{
+  GladeModelDataStorePrivate *priv = GLADE_MODEL_DATA_STORE (model)->priv;
+
+  if (column == GLADE_MODEL_DATA_STORE_COLUMN_ROW)
+    return G_TYPE_INT;
+
+  column -= GLADE_MODEL_DATA_STORE_N_COLUMNS;
+  g_return_val_if_fail (column >= 0 && column < priv->n_columns, G_TYPE_INVALID);
+
+  return priv->types[column];
+}
+
+static gboolean
+glade_model_data_store_get_iter (GtkTreeModel *model,
+                                 GtkTreeIter  *iter,
+                                 GtkTreePath  *path)
+{
+  GladeModelDataStore *store = GLADE_MODEL_DATA_STORE (model);
+  gint n;
+
+  if (gtk_tree_path_get_depth (path) != 1)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  n = gtk_tree_path_get_indices (path)[0];
+
+  return model_data_store_set_iter (store, iter, model_data_store_nth_row (store, n), n);
+}
+
+static GtkTreePath *
+glade_model_data_store_get_path (GtkTreeModel *model, GtkTreeIter *iter)
+{
+  g_return_val_if_fail (VALID_ITER (GLADE_MODEL_DATA_STORE (model), iter), NULL);
+
+  return gtk_tree_path_new_from_indices (GPOINTER_TO_INT (iter->user_data2), -1);
+}
+
+static void
+glade_model_data_store_get_value (GtkTreeModel *model,
+                                  GtkTreeIter  *iter,
+                                  gint          column,
+                                  GValue       *value)
+{
+  GladeModelDataStore *store = GLADE_MODEL_DATA_STORE (model);
+  GladeModelDataStorePrivate *priv = store->priv;
+  GladeModelData *data;
+  GNode *cell;
+
+  g_return_if_fail (VALID_ITER (store, iter));
+
+  if (column == GLADE_MODEL_DATA_STORE_COLUMN_ROW)
+    {
+      g_value_init (value, G_TYPE_INT);
+      g_value_set_int (value, GPOINTER_TO_INT (iter->user_data2));
+      return;
+    }
+
+  column -= GLADE_MODEL_DATA_STORE_N_COLUMNS;
+  g_return_if_fail (column >= 0 && column < priv->n_columns);
+
+  g_value_init (value, priv->types[column]);
+
+  if ((cell = g_node_nth_child ((GNode *) iter->user_data, column)) == NULL)
+    return;
+
+  data = cell->data;
+
+  /* Leave the default value if the tree changed under us */
+  if (G_VALUE_TYPE (&data->value) == 0 ||
+      G_VALUE_TYPE (&data->value) != priv->cell_types[column])
+    return;
+
+  /* Special case, show the filename in the cellrenderertext */
+  if (G_VALUE_TYPE (&data->value) == GDK_TYPE_PIXBUF)
+    {
+      GObject *object = g_value_get_object (&data->value);
+
+      if (object)
+        g_value_set_string (value, g_object_get_data (object, "GladeFileName"));
+    }
+  else
+    g_value_copy (&data->value, value);
+}
+
+static gboolean
+glade_model_data_store_iter_next (GtkTreeModel *model, GtkTreeIter *iter)
+{
+  GladeModelDataStore *store = GLADE_MODEL_DATA_STORE (model);
+
+  g_return_val_if_fail (VALID_ITER (store, iter), FALSE);
+
+  return model_data_store_set_iter (store, iter,
+                                    ((GNode *) iter->user_data)->next,
+                                    GPOINTER_TO_INT (iter->user_data2) + 1);
+}
+
+static gboolean
+glade_model_data_store_iter_previous (GtkTreeModel *model, GtkTreeIter *iter)
+{
+  GladeModelDataStore *store = GLADE_MODEL_DATA_STORE (model);
+
+  g_return_val_if_fail (VALID_ITER (store, iter), FALSE);
+
+  return model_data_store_set_iter (store, iter,
+                                    ((GNode *) iter->user_data)->prev,
+                                    GPOINTER_TO_INT (iter->user_data2) - 1);
+}
+
+static gboolean
+glade_model_data_store_iter_children (GtkTreeModel *model,
+                                      GtkTreeIter  *iter,
+                                      GtkTreeIter  *parent)
+{
+  GladeModelDataStore *store = GLADE_MODEL_DATA_STORE (model);
+
+  if (parent != NULL)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  return model_data_store_set_iter (store, iter, model_data_store_nth_row (store, 0), 0);
+}
+
+static gboolean
+glade_model_data_store_iter_has_child (GtkTreeModel *model, GtkTreeIter *iter)
+{
+  return FALSE;
+}
+
+static gint
+glade_model_data_store_iter_n_children (GtkTreeModel *model, GtkTreeIter *iter)
+{
+  GladeModelDataStore *store = GLADE_MODEL_DATA_STORE (model);
+
+  if (iter != NULL)
+    return 0;
+
+  return store->priv->n_rows;
+}
+
+static gboolean
+glade_model_data_store_iter_nth_child (GtkTreeModel *model,
+                                       GtkTreeIter  *iter,
+                                       GtkTreeIter  *parent,
+                                       gint          n)
+{
+  GladeModelDataStore *store = GLADE_MODEL_DATA_STORE (model);
+
+  if (parent != NULL)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  return model_data_store_set_iter (store, iter, model_data_store_nth_row (store, n), n);
+}
+
+static gboolean
+glade_model_data_store_iter_parent (GtkTreeModel *model,
+                                    GtkTreeIter  *iter,
+                                    GtkTreeIter  *child)
+{
+  iter->stamp = 0;
+  return FALSE;
+}
+
+static void
+glade_model_data_store_tree_model_init (GtkTreeModelIface *iface)
+{
+  iface->get_flags       = glade_model_data_store_get_flags;
+  iface->get_n_columns   = glade_model_data_store_get_n_columns;
+  iface->get_column_type = glade_model_data_store_get_column_type;
+  iface->get_iter        = glade_model_data_store_get_iter;
+  iface->get_path        = glade_model_data_store_get_path;
+  iface->get_value       = glade_model_data_store_get_value;
+  iface->iter_next       = glade_model_data_store_iter_next;
+  iface->iter_previous   = glade_model_data_store_iter_previous;
+  iface->iter_children   = glade_model_data_store_iter_children;
+  iface->iter_has_child  = glade_model_data_store_iter_has_child;
+  iface->iter_n_children = glade_model_data_store_iter_n_children;
+  iface->iter_nth_child  = glade_model_data_store_iter_nth_child;
+  iface->iter_parent     = glade_model_data_store_iter_parent;
+}
+
+/*******************************************************************************
+                          GtkTreeDragSource/Dest
+ *******************************************************************************/
+static gboolean
+glade_model_data_store_row_draggable (GtkTreeDragSource *source, GtkTreePath *path)
+{
+  return gtk_tree_path_get_depth (path) == 1;
+}
+
+static gboolean
+glade_model_data_store_drag_data_get (GtkTreeDragSource *source,
+                                      GtkTreePath       *path,
+                                      GtkSelectionData  *selection_data)
+{
+  return gtk_tree_set_row_drag_data (selection_data, GTK_TREE_MODEL (source), path);
+}
+
+static gboolean
+glade_model_data_store_drag_data_delete (GtkTreeDragSource *source, GtkTreePath *path)
+{
+  /* The move is requested as a whole when the row is received */
+  return TRUE;
+}
+
+static void
+glade_model_data_store_drag_source_init (GtkTreeDragSourceIface *iface)
+{
+  iface->row_draggable    = glade_model_data_store_row_draggable;
+  iface->drag_data_get    = glade_model_data_store_drag_data_get;
+  iface->drag_data_delete = glade_model_data_store_drag_data_delete;
+}
+
+static gboolean
+glade_model_data_store_row_drop_possible (GtkTreeDragDest  *dest,
+                                          GtkTreePath      *dest_path,
+                                          GtkSelectionData *selection_data)
+{
+  GtkTreeModel *src_model = NULL;
+  GtkTreePath *src_path = NULL;
+  gboolean possible = FALSE;
+
+  if (gtk_tree_get_row_drag_data (selection_data, &src_model, &src_path))
+    {
+      possible = (src_model == GTK_TREE_MODEL (dest) &&
+                  gtk_tree_path_get_depth (dest_path) == 1);
+      gtk_tree_path_free (src_path);
+    }
+
+  return possible;
+}
+
+static gboolean
+glade_model_data_store_drag_data_received (GtkTreeDragDest  *dest,
+                                           GtkTreePath      *dest_path,
+                                           GtkSelectionData *selection_data)
+{
+  GtkTreeModel *src_model = NULL;
+  GtkTreePath *src_path = NULL;
+  gint row, position;
+
+  if (!glade_model_data_store_row_drop_possible (dest, dest_path, selection_data) ||
+      !gtk_tree_get_row_drag_data (selection_data, &src_model, &src_path))
+    return FALSE;
+
+  row      = gtk_tree_path_get_indices (src_path)[0];
+  position = gtk_tree_path_get_indices (dest_path)[0];
+  gtk_tree_path_free (src_path);
+
+  /* The destination counts the dragged row itself */
+  if (position > row)
+    position--;
+
+  if (position != row)
+    g_signal_emit (dest, model_data_store_signals[MOVE_ROW], 0, row, position);
+
+  return TRUE;
+}
+
+static void
+glade_model_data_store_drag_dest_init (GtkTreeDragDestIface *iface)
+{
+  iface->drag_data_received = glade_model_data_store_drag_data_received;
+  iface->row_drop_possible  = glade_model_data_store_row_drop_possible;
+}
+
+/*******************************************************************************
+                                    API
+ *******************************************************************************/
+
+/* The displayed type of a data cell */
+static GType
+model_data_store_column_type (GType cell_type)
+{
+  if (cell_type == 0)
+    return G_TYPE_POINTER;
+  else if (cell_type == GDK_TYPE_PIXBUF)
+    return G_TYPE_STRING;
+
+  return cell_type;
+}
+
+/**
+ * glade_model_data_store_new:
+ * @property: A #GladeProperty holding a #GLADE_TYPE_MODEL_DATA_TREE
+ *
+ * Creates a model viewing the data of @property, the columns are
+ * taken from the current value's first row.
+ *
+ * Returns: A new #GladeModelDataStore
+ */
+GladeModelDataStore *
+glade_model_data_store_new (GladeProperty *property)
+{
+  GladeModelDataStore *store;
+  GladeModelDataStorePrivate *priv;
+  GladeModelData *data;
+  GNode *data_tree, *cell;
+  gint i;
+
+  g_return_val_if_fail (GLADE_IS_PROPERTY (property), NULL);
+
+  store = g_object_new (GLADE_TYPE_MODEL_DATA_STORE, NULL);
+  priv  = store->priv;
+
+  priv->property = g_object_ref (property);
+
+  model_data_store_fetch_tree (store);
+  data_tree = priv->data_tree;
+
+  if (data_tree && data_tree->children)
+    priv->n_columns = g_node_n_children (data_tree->children);
+
+  priv->types      = g_new0 (GType, priv->n_columns);
+  priv->cell_types = g_new0 (GType, priv->n_columns);
+  priv->names      = g_new0 (gchar *, priv->n_columns + 1);
+
+  for (i = 0, cell = priv->n_columns ? data_tree->children->children : NULL;
+       cell; i++, cell = cell->next)
+    {
+      data = cell->data;
+
+      priv->cell_types[i] = G_VALUE_TYPE (&data->value);
+      priv->types[i]      = model_data_store_column_type (priv->cell_types[i]);
+      priv->names[i]      = g_strdup (data->name);
+    }
+
+  return store;
+}
+
+GladeProperty *
+glade_model_data_store_get_property (GladeModelDataStore *store)
+{
+  g_return_val_if_fail (GLADE_IS_MODEL_DATA_STORE (store), NULL);
+
+  return store->priv->property;
+}
+
+/**
+ * glade_model_data_store_has_layout:
+ * @store: A #GladeModelDataStore
+ * @data_tree: A model data tree
+ *
+ * Returns: whether the columns of @data_tree are the ones @store was
+ * created for, if not a new store is needed to view @data_tree.
+ */
+gboolean
+glade_model_data_store_has_layout (GladeModelDataStore *store,
+                                   GNode               *data_tree)
+{
+  GladeModelDataStorePrivate *priv;
+  GladeModelData *data;
+  GNode *cell;
+  gint i;
+
+  g_return_val_if_fail (GLADE_IS_MODEL_DATA_STORE (store), FALSE);
+
+  priv = store->priv;
+
+  if (!data_tree || !data_tree->children)
+    return priv->n_columns == 0;
+
+  for (i = 0, cell = data_tree->children->children; cell; i++, cell = cell->next)
+    {
+      data = cell->data;
+
+      if (i >= priv->n_columns ||
+          G_VALUE_TYPE (&data->value) != priv->cell_types[i] ||
+          g_strcmp0 (data->name, priv->names[i]) != 0)
+        return FALSE;
+    }
+
+  return i == priv->n_columns;
+}
+
+gint
+glade_model_data_store_get_n_rows (GladeModelDataStore *store)
+{
+  g_return_val_if_fail (GLADE_IS_MODEL_DATA_STORE (store), 0);
+
+  return store->priv->n_rows;
+}
+
+/**
+ * glade_model_data_store_refresh:
+ * @store: A #GladeModelDataStore
+ *
+ * Picks up the current value of the property, all iters are
+ * invalidated. This must be called whenever the property was set,
+ * before the view looks at @store again.
+ */
+void
+glade_model_data_store_refresh (GladeModelDataStore *store)
+{
+  g_return_if_fail (GLADE_IS_MODEL_DATA_STORE (store));
+
+  model_data_store_fetch_tree (store);
+}
+
+void
+glade_model_data_store_row_changed (GladeModelDataStore *store, gint row)
+{
+  GtkTreePath *path;
+  GtkTreeIter iter;
+
+  g_return_if_fail (GLADE_IS_MODEL_DATA_STORE (store));
+
+  if (!model_data_store_set_iter (store, &iter, model_data_store_nth_row (store, row), row))
+    return;
+
+  path = gtk_tree_path_new_from_indices (row, -1);
+  gtk_tree_model_row_changed (GTK_TREE_MODEL (store), path, &iter);
+  gtk_tree_path_free (path);
+}
+
+void
+glade_model_data_store_row_inserted (GladeModelDataStore *store, gint row)
+{
+  GtkTreePath *path;
+  GtkTreeIter iter;
+
+  g_return_if_fail (GLADE_IS_MODEL_DATA_STORE (store));
+
+  if (!model_data_store_set_iter (store, &iter, model_data_store_nth_row (store, row), row))
+    return;
+
+  path = gtk_tree_path_new_from_indices (row, -1);
+  gtk_tree_model_row_inserted (GTK_TREE_MODEL (store), path, &iter);
+  gtk_tree_path_free (path);
+}
+
+void
+glade_model_data_store_row_deleted (GladeModelDataStore *store, gint row)
+{
+  GtkTreePath *path;
+
+  g_return_if_fail (GLADE_IS_MODEL_DATA_STORE (store));
+
+  path = gtk_tree_path_new_from_indices (row, -1);
+  gtk_tree_model_row_deleted (GTK_TREE_MODEL (store), path);
+  gtk_tree_path_free (path);
+}
+
+/**
+ * glade_model_data_store_row_moved:
+ * @store: A #GladeModelDataStore
+ * @row: the index the row had
+ * @position: the index the row has now, -1 or out of range if it was
+ *            moved to the end
+ *
+ * Signals that @row was taken out and inserted back at @position,
+ * the way g_node_insert() does it.
+ */
+void
+glade_model_data_store_row_moved (GladeModelDataStore *store,
+                                  gint                 row,
+                                  gint                 position)
+{
+  GtkTreePath *path;
+  gint *new_order, n_rows, i, j;
+
+  g_return_if_fail (GLADE_IS_MODEL_DATA_STORE (store));
+
+  n_rows = glade_model_data_store_get_n_rows (store);
+  if (row < 0 || row >= n_rows)
+    return;
+
+  if (position < 0 || position >= n_rows)
+    position = n_rows - 1;
+
+  /* new_order[new index] = old index */
+  new_order = g_new (gint, n_rows);
+  for (i = 0, j = 0; i < n_rows; i++)
+    {
+      if (i == position)
+        new_order[i] = row;
+      else
+        {
+          if (j == row)
+            j++;
+          new_order[i] = j++;
+        }
+    }
+
+  path = gtk_tree_path_new ();
+  gtk_tree_model_rows_reordered (GTK_TREE_MODEL (store), path, NULL, new_order);
+  gtk_tree_path_free (path);
+  g_free (new_order);
+}
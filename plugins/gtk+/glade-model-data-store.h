@@ -0,0 +1,91 @@
+/*
+ * glade-model-data-store.h
+ *
+ * Copyright (C) 2017 The Glade developers
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#ifndef __GLADE_MODEL_DATA_STORE_H__
+#define __GLADE_MODEL_DATA_STORE_H__
+
+#include <gtk/gtk.h>
+#include <gladeui/glade.h>
+
+G_BEGIN_DECLS
+
+#define GLADE_TYPE_MODEL_DATA_STORE            (glade_model_data_store_get_type ())
+#define GLADE_MODEL_DATA_STORE(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), GLADE_TYPE_MODEL_DATA_STORE, GladeModelDataStore))
+#define GLADE_MODEL_DATA_STORE_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), GLADE_TYPE_MODEL_DATA_STORE, GladeModelDataStoreClass))
+#define GLADE_IS_MODEL_DATA_STORE(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GLADE_TYPE_MODEL_DATA_STORE))
+#define GLADE_IS_MODEL_DATA_STORE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GLADE_TYPE_MODEL_DATA_STORE))
+#define GLADE_MODEL_DATA_STORE_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj), GLADE_TYPE_MODEL_DATA_STORE, GladeModelDataStoreClass))
+
+/* The first column holds the row number, the data columns follow */
+enum
+{
+  GLADE_MODEL_DATA_STORE_COLUMN_ROW = 0,
+  GLADE_MODEL_DATA_STORE_N_COLUMNS
+};
+
+typedef struct _GladeModelDataStore        GladeModelDataStore;
+typedef struct _GladeModelDataStoreClass   GladeModelDataStoreClass;
+typedef struct _GladeModelDataStorePrivate GladeModelDataStorePrivate;
+
+struct _GladeModelDataStore
+{
+  GObject parent_instance;
+
+  GladeModelDataStorePrivate *priv;
+};
+
+struct _GladeModelDataStoreClass
+{
+  GObjectClass parent_class;
+
+  void (* move_row) (GladeModelDataStore *store,
+                     gint                 row,
+                     gint                 position);
+};
+
+GType                glade_model_data_store_get_type     (void) G_GNUC_CONST;
+
+GladeModelDataStore *glade_model_data_store_new          (GladeProperty       *property);
+
+GladeProperty       *glade_model_data_store_get_property (GladeModelDataStore *store);
+
+gboolean             glade_model_data_store_has_layout   (GladeModelDataStore *store,
+                                                          GNode               *data_tree);
+
+gint                 glade_model_data_store_get_n_rows   (GladeModelDataStore *store);
+
+void                 glade_model_data_store_refresh      (GladeModelDataStore *store);
+
+void                 glade_model_data_store_row_changed  (GladeModelDataStore *store,
+                                                          gint                 row);
+
+void                 glade_model_data_store_row_inserted (GladeModelDataStore *store,
+                                                          gint                 row);
+
+void                 glade_model_data_store_row_deleted  (GladeModelDataStore *store,
+                                                          gint                 row);
+
+void                 glade_model_data_store_row_moved    (GladeModelDataStore *store,
+                                                          gint                 row,
+                                                          gint                 position);
+
+G_END_DECLS
+
+#endif /* __GLADE_MODEL_DATA_STORE_H__ */
@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "glade-model-data.h"
+#include "glade-model-data-store.h"
 #include "glade-column-types.h"
 
 GladeModelData *
@@ -35,6 +36,8 @@ glade_model_data_new (GType type, const gchar * column_name)
 {
   GladeModelData *data = g_slice_new0 (GladeModelData);
 
+  data->ref_count = 1;
+
   if (type != 0)
     g_value_init (&data->value, type);
 
@@ -55,6 +58,7 @@ glade_model_data_copy (GladeModelData * data)
     return NULL;
 
   dup = g_slice_new0 (GladeModelData);
+  dup->ref_count = 1;
 
   if (G_VALUE_TYPE (&data->value) != 0)
     {
@@ -71,10 +75,11 @@ glade_model_data_copy (GladeModelData * data)
   return dup;
 }
 
+/* Releases a reference to @data, it is shared by copies of a data tree */
 void
 glade_model_data_free (GladeModelData * data)
 {
-  if (data)
+  if (data && --data->ref_count == 0)
     {
       if (G_VALUE_TYPE (&data->value) != 0)
         g_value_unset (&data->value);
@@ -86,10 +91,38 @@ glade_model_data_free (GladeModelData * data)
     }
 }
 
+static GladeModelData *
+glade_model_data_ref (GladeModelData * data)
+{
+  if (data)
+    data->ref_count++;
+
+  return data;
+}
+
+/* The copy shares its data with @node, only the tree is duplicated.
+ * Shared data must not be modified, editors get a private copy of
+ * the data they modify with glade_model_data_tree_get_writable_data().
+ */
 GNode *
 glade_model_data_tree_copy (GNode * node)
 {
-  return g_node_copy_deep (node, (GCopyFunc) glade_model_data_copy, NULL);
+  return g_node_copy_deep (node, (GCopyFunc) glade_model_data_ref, NULL);
+}
+
+/* Unshares the data of @item so that it can be modified */
+static GladeModelData *
+model_data_node_writable (GNode * item)
+{
+  GladeModelData *data = item->data;
+
+  if (data && data->ref_count > 1)
+    {
+      item->data = glade_model_data_copy (data);
+      glade_model_data_free (data);
+    }
+
+  return item->data;
 }
 
 static gboolean
@@ -125,6 +158,20 @@ glade_model_data_tree_get_data (GNode * data_tree, gint row, gint colnum)
   return NULL;
 }
 
+GladeModelData *
+glade_model_data_tree_get_writable_data (GNode * data_tree, gint row, gint colnum)
+{
+  GNode *node;
+
+  g_return_val_if_fail (data_tree != NULL, NULL);
+
+  if ((node = g_node_nth_child (data_tree, row)) != NULL)
+    if ((node = g_node_nth_child (node, colnum)) != NULL)
+      return model_data_node_writable (node);
+
+  return NULL;
+}
+
 void
 glade_model_data_insert_column (GNode * node,
                                 GType type, const gchar * column_name, gint nth)
@@ -217,7 +264,7 @@ glade_model_data_column_rename (GNode * node,
   for (row = node->children; row; row = row->next)
     {
       iter = g_node_nth_child (row, idx);
-      data = iter->data;
+      data = model_data_node_writable (iter);
       g_free (data->name);
       data->name = g_strdup (new_name);
     }
@@ -239,19 +286,35 @@ glade_model_data_tree_get_type (void)
 /**************************** GladeEditorProperty *****************************/
 enum
 {
-  COLUMN_ROW = 0,               /* row number */
-  NUM_COLUMNS
+  COLUMN_ROW = GLADE_MODEL_DATA_STORE_COLUMN_ROW,   /* row number */
+  NUM_COLUMNS = GLADE_MODEL_DATA_STORE_N_COLUMNS
 };
 
+/* What the next commit changes, so that the view
+ * is only notified about the rows which changed
+ */
+typedef enum
+{
+  DATA_SYNC_RESET = 0,
+  DATA_SYNC_CHANGED,
+  DATA_SYNC_INSERTED,
+  DATA_SYNC_DELETED,
+  DATA_SYNC_MOVED
+} DataSync;
+
 typedef struct
 {
   GladeEditorProperty parent_instance;
 
   GtkTreeView *view;
-  GtkListStore *store;
+  GladeModelDataStore *store;
   GtkTreeSelection *selection;
   GNode *pending_data_tree;
 
+  DataSync sync;
+  gint sync_row;
+  gint sync_position;
+
   /* Used for setting focus on newly added rows */
   gboolean adding_row;
   gboolean want_focus;
@@ -301,9 +364,20 @@ clear_view (GladeEditorProperty * eprop)
   while ((column = gtk_tree_view_get_column (eprop_data->view, 0)) != NULL)
     gtk_tree_view_remove_column (eprop_data->view, column);
 
-  /* Clear store ... (this will unref the old store) */
+  /* Clear store ... */
   gtk_tree_view_set_model (eprop_data->view, NULL);
+  g_clear_object (&eprop_data->store);
+}
 
+static void
+eprop_data_set_sync (GladeEPropModelData *eprop_data,
+                     DataSync             sync,
+                     gint                 row,
+                     gint                 position)
+{
+  eprop_data->sync          = sync;
+  eprop_data->sync_row      = row;
+  eprop_data->sync_position = position;
 }
 
 static gboolean
@@ -323,6 +397,9 @@ update_data_tree_idle (GladeEditorProperty * eprop)
   if (!glade_property_equals_value (property, &value))
     glade_editor_property_commit (eprop, &value);
 
+  /* The hint is consumed by the load triggered by the commit */
+  eprop_data_set_sync (eprop_data, DATA_SYNC_RESET, -1, -1);
+
   g_value_unset (&value);
 
   eprop_data->pending_data_tree = NULL;
@@ -374,8 +451,6 @@ glade_eprop_model_data_add_row (GladeEditorProperty * eprop)
   if (!columns)
     return;
 
-  clear_view (eprop);
-
   if (!node)
     node = g_node_new (NULL);
   else
@@ -384,12 +459,15 @@ glade_eprop_model_data_add_row (GladeEditorProperty * eprop)
   append_row (node, columns);
 
   eprop_data->adding_row = TRUE;
+  eprop_data_set_sync (eprop_data, DATA_SYNC_INSERTED,
+                       g_node_n_children (node) - 1, -1);
 
   g_value_init (&value, GLADE_TYPE_MODEL_DATA_TREE);
   g_value_take_boxed (&value, node);
   glade_editor_property_commit (eprop, &value);
   g_value_unset (&value);
 
+  eprop_data_set_sync (eprop_data, DATA_SYNC_RESET, -1, -1);
   eprop_data->adding_row = FALSE;
 }
 
@@ -402,7 +480,6 @@ glade_eprop_model_data_delete_selected (GladeEditorProperty * eprop)
   GNode *data_tree = NULL, *row;
   gint rownum = -1;
 
-  /* NOTE: This will trigger row-deleted below... */
   if (!gtk_tree_selection_get_selected (eprop_data->selection, NULL, &iter))
     return;
 
@@ -423,6 +500,7 @@ glade_eprop_model_data_delete_selected (GladeEditorProperty * eprop)
   if (eprop_data->pending_data_tree)
     glade_model_data_tree_free (eprop_data->pending_data_tree);
 
+  eprop_data_set_sync (eprop_data, DATA_SYNC_DELETED, rownum, -1);
   eprop_data->pending_data_tree = data_tree;
   g_idle_add ((GSourceFunc) update_data_tree_idle, eprop);
 }
@@ -460,134 +538,49 @@ eprop_treeview_key_press (GtkWidget * treeview,
   return FALSE;
 }
 
-static gboolean
-data_changed_idle (GladeEditorProperty * eprop)
+static void
+eprop_model_data_move_row (GladeModelDataStore * store,
+                           gint                  rownum,
+                           gint                  position,
+                           GladeEditorProperty * eprop)
 {
   GladeEPropModelData *eprop_data = GLADE_EPROP_MODEL_DATA (eprop);
   GladeProperty *property = glade_editor_property_get_property (eprop);
-  GNode *data_tree = NULL, *new_tree, *row;
-  GtkTreeIter iter;
-  gint rownum;
+  GNode *data_tree = NULL, *row;
 
   glade_property_get (property, &data_tree);
   g_assert (data_tree);
 
-  new_tree = g_node_new (NULL);
+  data_tree = glade_model_data_tree_copy (data_tree);
 
-  if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (eprop_data->store), &iter))
+  if ((row = g_node_nth_child (data_tree, rownum)) == NULL)
     {
-      do
-        {
-          gtk_tree_model_get (GTK_TREE_MODEL (eprop_data->store), &iter,
-                              COLUMN_ROW, &rownum, -1);
-
-
-          if ((row = g_node_nth_child (data_tree, rownum)) != NULL)
-            {
-              /* Make a new tree by copying row by row... */
-              row = glade_model_data_tree_copy (row);
-              g_node_append (new_tree, row);
-            }
-        }
-      while (gtk_tree_model_iter_next
-             (GTK_TREE_MODEL (eprop_data->store), &iter));
+      glade_model_data_tree_free (data_tree);
+      return;
     }
 
-  /* Were already in an idle, no need to idle from here...  */
+  g_node_unlink (row);
+  g_node_insert (data_tree, position, row);
+
   if (eprop_data->pending_data_tree)
     glade_model_data_tree_free (eprop_data->pending_data_tree);
-  eprop_data->pending_data_tree = new_tree;
-  update_data_tree_idle (eprop);
-
-  return FALSE;
-}
-
-static void
-eprop_treeview_row_deleted (GtkTreeModel * tree_model,
-                            GtkTreePath * path, GladeEditorProperty * eprop)
-{
-  if (glade_editor_property_loading (eprop))
-    return;
 
-  g_idle_add ((GSourceFunc) data_changed_idle, eprop);
+  eprop_data_set_sync (eprop_data, DATA_SYNC_MOVED, rownum, position);
+  eprop_data->pending_data_tree = data_tree;
+  g_idle_add ((GSourceFunc) update_data_tree_idle, eprop);
 }
 
-
 static void
 glade_eprop_model_data_finalize (GObject * object)
 {
   /* Chain up */
   GObjectClass *parent_class =
       g_type_class_peek_parent (G_OBJECT_GET_CLASS (object));
-  //GladeEPropModelData *eprop_data = GLADE_EPROP_MODEL_DATA (object);
-
-  G_OBJECT_CLASS (parent_class)->finalize (object);
-}
-
-static GtkListStore *
-eprop_model_data_generate_store (GladeEditorProperty * eprop)
-{
-  GtkListStore *store = NULL;
-  GladeModelData *iter_data;
-  GNode *data_tree = NULL, *iter_node, *row_node;
-  GArray *gtypes = g_array_new (FALSE, TRUE, sizeof (GType));
-  GtkTreeIter iter;
-  gint column_num, row_num;
-  GType index_type = G_TYPE_INT, string_type = G_TYPE_STRING, pointer_type = G_TYPE_POINTER;
-  GladeProperty *property = glade_editor_property_get_property (eprop);
-
-  glade_property_get (property, &data_tree);
-
-  if (!data_tree || !data_tree->children || !data_tree->children->children)
-    return NULL;
-
-  /* Generate store with tailored column types */
-  g_array_append_val (gtypes, index_type);
-  for (iter_node = data_tree->children->children; iter_node;
-       iter_node = iter_node->next)
-    {
-      iter_data = iter_node->data;
-      if (G_VALUE_TYPE (&iter_data->value) == 0)
-        g_array_append_val (gtypes, pointer_type);
-      else if (G_VALUE_TYPE (&iter_data->value) == GDK_TYPE_PIXBUF)
-        g_array_append_val (gtypes, string_type);
-      else
-        g_array_append_val (gtypes, G_VALUE_TYPE (&iter_data->value));
-    }
-  store = gtk_list_store_newv (gtypes->len, (GType *) gtypes->data);
-  g_array_free (gtypes, TRUE);
+  GladeEPropModelData *eprop_data = GLADE_EPROP_MODEL_DATA (object);
 
-  /* Now populate the store with data */
-  for (row_num = 0, row_node = data_tree->children; row_node;
-       row_num++, row_node = row_node->next)
-    {
-      gtk_list_store_append (store, &iter);
-      gtk_list_store_set (store, &iter, COLUMN_ROW, row_num, -1);
+  g_clear_object (&eprop_data->store);
 
-      for (column_num = NUM_COLUMNS, iter_node = row_node->children; iter_node;
-           column_num++, iter_node = iter_node->next)
-        {
-          iter_data = iter_node->data;
-
-          if (G_VALUE_TYPE (&iter_data->value) == 0)
-            continue;
-
-          /* Special case, show the filename in the cellrenderertext */
-          if (G_VALUE_TYPE (&iter_data->value) == GDK_TYPE_PIXBUF)
-            {
-              GObject *object = g_value_get_object (&iter_data->value);
-              gchar *filename = NULL;
-              if (object)
-                filename = g_object_get_data (object, "GladeFileName");
-
-              gtk_list_store_set (store, &iter, column_num, filename, -1);
-            }
-          else
-            gtk_list_store_set_value (store, &iter, column_num,
-                                      &iter_data->value);
-        }
-    }
-  return store;
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 static void
@@ -617,7 +610,7 @@ value_toggled (GtkCellRendererToggle * cell,
 
   data_tree = glade_model_data_tree_copy (data_tree);
 
-  data = glade_model_data_tree_get_data (data_tree, row, colnum);
+  data = glade_model_data_tree_get_writable_data (data_tree, row, colnum);
 
   g_value_set_boolean (&data->value, !active);
 
@@ -626,6 +619,8 @@ value_toggled (GtkCellRendererToggle * cell,
   if (eprop_data->pending_data_tree)
     glade_model_data_tree_free (eprop_data->pending_data_tree);
 
+  eprop_data_set_sync (eprop_data, DATA_SYNC_CHANGED, row, -1);
+
   eprop_data->pending_data_tree = data_tree;
   g_idle_add ((GSourceFunc) update_and_focus_data_tree_idle, eprop);
 }
@@ -658,7 +653,7 @@ value_i18n_activate (GladeCellRendererIcon * cell,
 
   data_tree = glade_model_data_tree_copy (data_tree);
 
-  data = glade_model_data_tree_get_data (data_tree, row, colnum);
+  data = glade_model_data_tree_get_writable_data (data_tree, row, colnum);
   g_assert (G_VALUE_TYPE (&data->value) == G_TYPE_STRING);
 
   new_text = g_value_dup_string (&data->value);
@@ -676,6 +671,8 @@ value_i18n_activate (GladeCellRendererIcon * cell,
       if (eprop_data->pending_data_tree)
         glade_model_data_tree_free (eprop_data->pending_data_tree);
 
+      eprop_data_set_sync (eprop_data, DATA_SYNC_CHANGED, row, -1);
+
       eprop_data->pending_data_tree = data_tree;
       g_idle_add ((GSourceFunc) update_and_focus_data_tree_idle, eprop);
     }
@@ -713,7 +710,7 @@ value_text_edited (GtkCellRendererText * cell,
 
   data_tree = glade_model_data_tree_copy (data_tree);
 
-  data = glade_model_data_tree_get_data (data_tree, row, colnum);
+  data = glade_model_data_tree_get_writable_data (data_tree, row, colnum);
 
   /* Untranslate string and update value in tree. */
   if (G_VALUE_HOLDS_ENUM (&data->value) || G_VALUE_HOLDS_FLAGS (&data->value))
@@ -737,6 +734,8 @@ value_text_edited (GtkCellRendererText * cell,
   if (eprop_data->pending_data_tree)
     glade_model_data_tree_free (eprop_data->pending_data_tree);
 
+  eprop_data_set_sync (eprop_data, DATA_SYNC_CHANGED, row, -1);
+
   eprop_data->pending_data_tree = data_tree;
   g_idle_add ((GSourceFunc) update_and_focus_data_tree_idle, eprop);
 }
@@ -814,6 +813,10 @@ eprop_model_generate_column (GladeEditorProperty * eprop,
   gtk_tree_view_column_set_resizable (column, TRUE);
   gtk_tree_view_column_set_expand (column, TRUE);
 
+  /* Fixed sizing, so that the view only fetches the visible rows */
+  gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+  gtk_tree_view_column_set_fixed_width (column, 100);
+
   type = G_VALUE_TYPE (&data->value);
 
   /* Support enum and flag types, and a hardcoded list of fundamental types */
@@ -1060,6 +1063,59 @@ eprop_data_focus_editing_cell (GladeEPropModelData * eprop_data)
 }
 
 
+/* Tells the view about the rows which changed with the last commit,
+ * if we dont know what changed the view starts over.
+ */
+static void
+eprop_model_data_sync_store (GladeEPropModelData * eprop_data)
+{
+  GladeModelDataStore *store = eprop_data->store;
+  gint n_rows, old_n_rows = glade_model_data_store_get_n_rows (store);
+
+  glade_model_data_store_refresh (store);
+
+  n_rows = glade_model_data_store_get_n_rows (store);
+
+  switch (eprop_data->sync)
+    {
+      case DATA_SYNC_CHANGED:
+        if (n_rows == old_n_rows)
+          {
+            glade_model_data_store_row_changed (store, eprop_data->sync_row);
+            return;
+          }
+        break;
+      case DATA_SYNC_INSERTED:
+        if (n_rows == old_n_rows + 1)
+          {
+            glade_model_data_store_row_inserted (store, eprop_data->sync_row);
+            return;
+          }
+        break;
+      case DATA_SYNC_DELETED:
+        if (n_rows == old_n_rows - 1)
+          {
+            glade_model_data_store_row_deleted (store, eprop_data->sync_row);
+            return;
+          }
+        break;
+      case DATA_SYNC_MOVED:
+        if (n_rows == old_n_rows)
+          {
+            glade_model_data_store_row_moved (store, eprop_data->sync_row,
+                                              eprop_data->sync_position);
+            return;
+          }
+        break;
+      case DATA_SYNC_RESET:
+      default:
+        break;
+    }
+
+  gtk_tree_view_set_model (eprop_data->view, NULL);
+  gtk_tree_view_set_model (eprop_data->view, GTK_TREE_MODEL (store));
+}
+
 static void
 glade_eprop_model_data_load (GladeEditorProperty * eprop,
                              GladeProperty * property)
@@ -1067,31 +1123,44 @@ glade_eprop_model_data_load (GladeEditorProperty * eprop,
   GladeEditorPropertyClass *parent_class =
       g_type_class_peek_parent (GLADE_EDITOR_PROPERTY_GET_CLASS (eprop));
   GladeEPropModelData *eprop_data = GLADE_EPROP_MODEL_DATA (eprop);
+  GNode *data_tree = NULL;
 
-  clear_view (eprop);
-
-  /* Chain up in a clean state... */
   parent_class->load (eprop, property);
 
-  gtk_tree_view_set_model (eprop_data->view, NULL);
   if (!property)
-    return;
+    {
+      clear_view (eprop);
+      return;
+    }
 
-  if ((eprop_data->store = eprop_model_data_generate_store (eprop)) != NULL)
+  glade_property_get (property, &data_tree);
+
+  /* Keep the view and just notify the changed rows if the columns are unchanged */
+  if (eprop_data->store &&
+      glade_model_data_store_get_property (eprop_data->store) == property &&
+      glade_model_data_store_has_layout (eprop_data->store, data_tree))
+    eprop_model_data_sync_store (eprop_data);
+  else
     {
-      eprop_data->selection = gtk_tree_view_get_selection (eprop_data->view);
+      clear_view (eprop);
 
-      /* Pass ownership of the store to the view... */
-      gtk_tree_view_set_model (eprop_data->view,
-                               GTK_TREE_MODEL (eprop_data->store));
-      g_object_unref (G_OBJECT (eprop_data->store));
+      if (data_tree && data_tree->children && data_tree->children->children)
+        {
+          eprop_data->store     = glade_model_data_store_new (property);
+          eprop_data->selection = gtk_tree_view_get_selection (eprop_data->view);
+
+          gtk_tree_view_set_model (eprop_data->view,
+                                   GTK_TREE_MODEL (eprop_data->store));
+
+          g_signal_connect (G_OBJECT (eprop_data->store), "move-row",
+                            G_CALLBACK (eprop_model_data_move_row), eprop);
+        }
 
-      g_signal_connect (G_OBJECT (eprop_data->store), "row-deleted",
-                        G_CALLBACK (eprop_treeview_row_deleted), eprop);
+      /* Create new columns with renderers */
+      eprop_model_data_generate_columns (eprop);
     }
 
-  /* Create new columns with renderers */
-  eprop_model_data_generate_columns (eprop);
+  eprop_data_set_sync (eprop_data, DATA_SYNC_RESET, -1, -1);
 
   if (eprop_data->store)
     {
@@ -1161,6 +1230,7 @@ glade_eprop_model_data_create_input (GladeEditorProperty * eprop)
                                 GTK_TREE_VIEW_GRID_LINES_BOTH);
   gtk_tree_view_set_reorderable (GTK_TREE_VIEW (eprop_data->view), TRUE);
   gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (eprop_data->view), TRUE);
+  gtk_tree_view_set_fixed_height_mode (GTK_TREE_VIEW (eprop_data->view), TRUE);
   gtk_container_add (GTK_CONTAINER (swin), GTK_WIDGET (eprop_data->view));
 
   g_object_set (G_OBJECT (vbox), "height-request", 300, NULL);
@@ -33,6 +33,10 @@ struct _GladeModelData
 	gboolean  i18n_translatable;
 	gchar    *i18n_context;
 	gchar    *i18n_comment;
+
+	/* Copies of a data tree share their data, which is then
+	 * read only, see glade_model_data_tree_get_writable_data() */
+	gint      ref_count;
 };
 
 typedef struct _GladeModelData         GladeModelData;
@@ -56,6 +60,9 @@ void            glade_model_data_tree_free         (GNode          *node);
 GladeModelData *glade_model_data_tree_get_data     (GNode          *data_tree, 
 						    gint            row, 
 						    gint            colnum);
+GladeModelData *glade_model_data_tree_get_writable_data (GNode     *data_tree,
+							 gint       row,
+							 gint       colnum);
 void            glade_model_data_insert_column     (GNode          *node,
 						    GType           type,
 						    const gchar    *column_name,
@@ -44,6 +44,7 @@ glade_string_new (const gchar *string,
 {
   GladeString *gstring = g_slice_new0 (GladeString);
 
+  gstring->ref_count    = 1;
   gstring->string       = g_strdup (string);
   gstring->comment      = g_strdup (comment);
   gstring->context      = g_strdup (context);
@@ -63,9 +64,19 @@ glade_string_copy (GladeString *string)
 			   string->id);
 }
 
+static GladeString *
+glade_string_ref (GladeString *string)
+{
+  string->ref_count++;
+  return string;
+}
+
 static void
 glade_string_free (GladeString *string)
 {
+  if (--string->ref_count > 0)
+    return;
+
   g_free (string->string);
   g_free (string->comment);
   g_free (string->context);
@@ -88,22 +99,28 @@ glade_string_list_append (GList       *list,
   return g_list_append (list, gstring);
 }
 
+/* The copy shares its strings with @string_list, they are unshared
+ * with glade_string_list_nth_writable() before being modified.
+ */
 GList *
 glade_string_list_copy (GList *string_list)
 {
-  GList *ret = NULL, *list;
-  GladeString *string, *copy;
-
-  for (list = string_list; list; list = list->next)
-    {
-      string = list->data;
+  return g_list_copy_deep (string_list, (GCopyFunc) glade_string_ref, NULL);
+}
 
-      copy = glade_string_copy (string);
+static GladeString *
+glade_string_list_nth_writable (GList *string_list, guint index)
+{
+  GList *link = g_list_nth (string_list, index);
+  GladeString *string = link->data;
 
-      ret = g_list_prepend (ret, copy);
+  if (string->ref_count > 1)
+    {
+      link->data = glade_string_copy (string);
+      glade_string_free (string);
     }
 
-  return g_list_reverse (ret);
+  return link->data;
 }
 
 void
@@ -259,7 +276,7 @@ data_changed_idle (GladeEditorProperty *eprop)
 
           if ((string = g_list_nth_data (string_list, index)) != NULL)
             {
-	      copy = glade_string_copy (string);
+	      copy = glade_string_ref (string);
 	      new_list = g_list_prepend (new_list, copy);
             }
         }
@@ -386,7 +403,7 @@ string_edited (GtkCellRendererText *renderer,
   else if (new_text && new_text[0])
     {
       GladeString *string = 
-	g_list_nth_data (string_list, index);
+	glade_string_list_nth_writable (string_list, index);
 
       g_free (string->string);
       string->string = g_strdup (new_text);
@@ -436,7 +453,7 @@ id_edited (GtkCellRendererText *renderer,
   if (string_list)
     string_list = glade_string_list_copy (string_list);
 
-  string = g_list_nth_data (string_list, index);
+  string = glade_string_list_nth_writable (string_list, index);
 
   g_free (string->id);
 
@@ -479,7 +496,7 @@ i18n_icon_activate (GtkCellRenderer     *renderer,
   glade_property_get (property, &string_list);
   string_list = glade_string_list_copy (string_list);
 
-  string = g_list_nth_data (string_list, index);
+  string = glade_string_list_nth_writable (string_list, index);
 
   if (glade_editor_property_show_i18n_dialog (NULL,
                                               &string->string,
@@ -19,6 +19,9 @@ struct _GladeString {
   gchar    *context;
   gchar    *id;
   gboolean  translatable;
+
+  /* Copies of a list share their strings, which are then read only */
+  gint      ref_count;
 };
 
 GType        glade_eprop_string_list_get_type    (void) G_GNUC_CONST;
@@ -165,19 +165,24 @@ glade_python_setup ()
   return FALSE;
 }
 
+enum
+{
+  PYTHON_READY = 1,
+  PYTHON_FAILED
+};
+
 void
 glade_python_init (const gchar *name)
 {
   static gsize init = 0;
   gchar *import_sentence;
 
+  /* Remember a failed setup, later python catalogs just skip it */
   if (g_once_init_enter (&init))
-    {
-      if (glade_python_setup ())
-        return;
+    g_once_init_leave (&init, glade_python_setup () ? PYTHON_FAILED : PYTHON_READY);
 
-      g_once_init_leave (&init, TRUE);
-    }
+  if (init == PYTHON_FAILED)
+    return;
 
   /* Yeah, we use the catalog name as the library */
   import_sentence = g_strdup_printf ("import %s;", name);
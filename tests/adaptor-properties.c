@@ -0,0 +1,83 @@
+#include <glib.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+/* Time spent loading the catalogs, measured in main() */
+static gdouble load_seconds = 0.0;
+
+static void
+test_properties_shared (void)
+{
+  GladeWidgetAdaptor *toggle, *check, *radio;
+  GladePropertyClass *toggle_pclass, *check_pclass;
+
+  toggle = glade_widget_adaptor_get_by_type (GTK_TYPE_TOGGLE_BUTTON);
+  check  = glade_widget_adaptor_get_by_type (GTK_TYPE_CHECK_BUTTON);
+  radio  = glade_widget_adaptor_get_by_type (GTK_TYPE_RADIO_BUTTON);
+
+  /* Classes the catalog does not touch are inherited as is */
+  toggle_pclass = glade_widget_adaptor_get_property_class (toggle, "inconsistent");
+  g_assert (glade_widget_adaptor_get_property_class (check, "inconsistent") == toggle_pclass);
+  g_assert (glade_widget_adaptor_get_property_class (radio, "inconsistent") == toggle_pclass);
+
+  /* Overridden classes belong to the adaptor overriding them */
+  toggle_pclass = glade_widget_adaptor_get_property_class (toggle, "label");
+  check_pclass  = glade_widget_adaptor_get_property_class (check, "label");
+  g_assert (toggle_pclass != check_pclass);
+  g_assert (glade_property_class_get_adaptor (check_pclass) == check);
+  g_assert_cmpstr (g_value_get_string (glade_property_class_get_default (toggle_pclass)), ==, "togglebutton");
+  g_assert_cmpstr (g_value_get_string (glade_property_class_get_default (check_pclass)), ==, "checkbutton");
+}
+
+static void
+test_properties_count (void)
+{
+  GList *adaptors, *l;
+  const GList *p;
+  guint n_adaptors, total = 0, owned = 0;
+
+  adaptors   = glade_widget_adaptor_list_adaptors ();
+  n_adaptors = g_list_length (adaptors);
+
+  for (l = adaptors; l; l = l->next)
+    {
+      GladeWidgetAdaptor *adaptor = l->data;
+
+      for (p = glade_widget_adaptor_get_properties (adaptor); p; p = p->next, total++)
+        if (glade_property_class_get_adaptor (p->data) == adaptor)
+          owned++;
+
+      for (p = glade_widget_adaptor_get_packing_props (adaptor); p; p = p->next, total++)
+        if (glade_property_class_get_adaptor (p->data) == adaptor)
+          owned++;
+    }
+
+  g_list_free (adaptors);
+
+  g_assert_cmpuint (owned, <=, total);
+
+  /* Without sharing every property of every adaptor had its own class */
+  g_test_message ("Loaded %u adaptors in %.3f seconds, %u property classes for %u properties",
+                  n_adaptors, load_seconds, owned, total);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  GTimer *timer;
+
+  gtk_test_init (&argc, &argv, NULL);
+
+  timer = g_timer_new ();
+  glade_init ();
+  glade_app_get ();
+  load_seconds = g_timer_elapsed (timer, NULL);
+  g_timer_destroy (timer);
+
+  g_test_add_func ("/AdaptorProperties/Shared", test_properties_shared);
+  g_test_add_func ("/AdaptorProperties/Count", test_properties_count);
+
+  return g_test_run ();
+}
@@ -0,0 +1,278 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+#define N_CHILDREN 5
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+flush_idles (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+/* A box and a notebook with N_CHILDREN labels each */
+static GladeProject *
+load_ordered (void)
+{
+  GladeProject *project;
+  GString *xml;
+  gchar *path;
+  gint i;
+
+  xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		      "<interface>\n"
+		      "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+		      "  <object class=\"GtkWindow\" id=\"window\">\n"
+		      "    <child>\n"
+		      "      <object class=\"GtkBox\" id=\"box\">\n"
+		      "        <property name=\"orientation\">vertical</property>\n");
+
+  for (i = 0; i < N_CHILDREN; i++)
+    g_string_append_printf (xml,
+			    "        <child>\n"
+			    "          <object class=\"GtkLabel\" id=\"slot%d\"/>\n"
+			    "          <packing>\n"
+			    "            <property name=\"position\">%d</property>\n"
+			    "          </packing>\n"
+			    "        </child>\n",
+			    i, i);
+
+  g_string_append (xml,
+		   "        <child>\n"
+		   "          <object class=\"GtkNotebook\" id=\"notebook\">\n");
+
+  for (i = 0; i < N_CHILDREN; i++)
+    g_string_append_printf (xml,
+			    "            <child>\n"
+			    "              <object class=\"GtkLabel\" id=\"page%d\"/>\n"
+			    "              <packing>\n"
+			    "                <property name=\"position\">%d</property>\n"
+			    "              </packing>\n"
+			    "            </child>\n"
+			    "            <child type=\"tab\">\n"
+			    "              <object class=\"GtkLabel\" id=\"tab%d\"/>\n"
+			    "              <packing>\n"
+			    "                <property name=\"position\">%d</property>\n"
+			    "                <property name=\"tab_fill\">False</property>\n"
+			    "              </packing>\n"
+			    "            </child>\n",
+			    i, i, i, i);
+
+  g_string_append_printf (xml,
+			  "          </object>\n"
+			  "          <packing>\n"
+			  "            <property name=\"position\">%d</property>\n"
+			  "          </packing>\n"
+			  "        </child>\n"
+			  "      </object>\n"
+			  "    </child>\n"
+			  "  </object>\n"
+			  "</interface>\n",
+			  N_CHILDREN);
+
+  g_assert (g_close (g_file_open_tmp ("glade-child-order-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml->str, xml->len, NULL));
+  g_string_free (xml, TRUE);
+
+  g_assert ((project = glade_project_load (path)));
+  flush_idles ();
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+static void
+child_action (GladeProject *project,
+	      const gchar  *container,
+	      const gchar  *child,
+	      const gchar  *action)
+{
+  GladeWidget *gcontainer, *gchild;
+
+  g_assert ((gcontainer = glade_project_get_widget_by_name (project, container)));
+  g_assert ((gchild = glade_project_get_widget_by_name (project, child)));
+
+  glade_widget_adaptor_child_action_activate (glade_widget_get_adaptor (gcontainer),
+					      glade_widget_get_object (gcontainer),
+					      glade_widget_get_object (gchild),
+					      action);
+  flush_idles ();
+}
+
+/* Checks that the children named @prefix%d for each of @expected are at
+ * the successive positions, both in the runtime container and in their
+ * "position" packing property.
+ */
+static void
+assert_positions (GladeProject *project,
+		  const gchar  *container,
+		  const gchar  *prefix,
+		  const gint   *expected,
+		  gint          n_expected)
+{
+  GladeWidget *gcontainer, *gchild;
+  gint i, position, runtime_position;
+  gchar *name;
+
+  g_assert ((gcontainer = glade_project_get_widget_by_name (project, container)));
+
+  for (i = 0; i < n_expected; i++)
+    {
+      name = g_strdup_printf ("%s%d", prefix, expected[i]);
+      g_assert ((gchild = glade_project_get_widget_by_name (project, name)));
+      g_free (name);
+
+      glade_widget_pack_property_get (gchild, "position", &position);
+      gtk_container_child_get (GTK_CONTAINER (glade_widget_get_object (gcontainer)),
+			       GTK_WIDGET (glade_widget_get_object (gchild)),
+			       "position", &runtime_position, NULL);
+
+      g_assert_cmpint (position, ==, i);
+      g_assert_cmpint (runtime_position, ==, i);
+    }
+}
+
+static void
+test_box_remove_slot (void)
+{
+  GladeProject *project;
+  GladeWidget *box;
+  const gint removed[] = { 0, 2, 3, 4 };
+  const gint all[] = { 0, 1, 2, 3, 4 };
+  gint size = 0;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_ordered ();
+  box = glade_project_get_widget_by_name (project, "box");
+
+  child_action (project, "box", "slot1", "remove_slot");
+
+  glade_widget_property_get (box, "size", &size);
+  g_assert_cmpint (size, ==, N_CHILDREN);
+  g_assert (glade_project_get_widget_by_name (project, "slot1") == NULL);
+  assert_positions (project, "box", "slot", removed, G_N_ELEMENTS (removed));
+
+  /* The restored box is sorted before undo returns */
+  glade_project_undo (project);
+
+  glade_widget_property_get (box, "size", &size);
+  g_assert_cmpint (size, ==, N_CHILDREN + 1);
+  assert_positions (project, "box", "slot", all, G_N_ELEMENTS (all));
+
+  g_object_unref (project);
+}
+
+static void
+test_box_insert_slot (void)
+{
+  GladeProject *project;
+  GladeWidget *box, *slot;
+  gint size = 0, position = 0;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_ordered ();
+  box = glade_project_get_widget_by_name (project, "box");
+
+  child_action (project, "box", "slot1", "insert_before");
+
+  glade_widget_property_get (box, "size", &size);
+  g_assert_cmpint (size, ==, N_CHILDREN + 2);
+
+  /* Every child from slot1 on moved down once */
+  slot = glade_project_get_widget_by_name (project, "slot0");
+  glade_widget_pack_property_get (slot, "position", &position);
+  g_assert_cmpint (position, ==, 0);
+
+  slot = glade_project_get_widget_by_name (project, "slot1");
+  glade_widget_pack_property_get (slot, "position", &position);
+  g_assert_cmpint (position, ==, 2);
+
+  slot = glade_project_get_widget_by_name (project, "slot4");
+  glade_widget_pack_property_get (slot, "position", &position);
+  g_assert_cmpint (position, ==, 5);
+
+  g_object_unref (project);
+}
+
+static void
+test_notebook_remove_page (void)
+{
+  GladeProject *project;
+  GladeWidget *notebook, *page, *tab;
+  GtkNotebook *object;
+  const gint removed[] = { 0, 1, 3, 4 };
+  const gint all[] = { 0, 1, 2, 3, 4 };
+  gint pages = 0, i;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_ordered ();
+  notebook = glade_project_get_widget_by_name (project, "notebook");
+  object = GTK_NOTEBOOK (glade_widget_get_object (notebook));
+
+  child_action (project, "notebook", "page2", "remove_page");
+
+  glade_widget_property_get (notebook, "pages", &pages);
+  g_assert_cmpint (pages, ==, N_CHILDREN - 1);
+  g_assert (glade_project_get_widget_by_name (project, "page2") == NULL);
+  assert_positions (project, "notebook", "page", removed, G_N_ELEMENTS (removed));
+
+  /* The tabs followed their pages */
+  for (i = 0; i < (gint) G_N_ELEMENTS (removed); i++)
+    {
+      gchar *name = g_strdup_printf ("page%d", removed[i]);
+      gchar *tab_name = g_strdup_printf ("tab%d", removed[i]);
+
+      page = glade_project_get_widget_by_name (project, name);
+      tab  = glade_project_get_widget_by_name (project, tab_name);
+      g_assert (gtk_notebook_get_tab_label (object, GTK_WIDGET (glade_widget_get_object (page))) ==
+		GTK_WIDGET (glade_widget_get_object (tab)));
+
+      g_free (name);
+      g_free (tab_name);
+    }
+
+  glade_project_undo (project);
+  flush_idles ();
+
+  glade_widget_property_get (notebook, "pages", &pages);
+  g_assert_cmpint (pages, ==, N_CHILDREN);
+  assert_positions (project, "notebook", "page", all, G_N_ELEMENTS (all));
+
+  g_object_unref (project);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/ChildOrder/Box/RemoveSlot", test_box_remove_slot);
+  g_test_add_func ("/ChildOrder/Box/InsertSlot", test_box_insert_slot);
+  g_test_add_func ("/ChildOrder/Notebook/RemovePage", test_notebook_remove_page);
+
+  return g_test_run ();
+}
@@ -0,0 +1,271 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+flush_idles (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+/* A box holding a sparse grid and a notebook with an action widget */
+static GladeProject *
+load_containers (void)
+{
+  GladeProject *project;
+  gchar *path;
+  const gchar *xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<interface>\n"
+    "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+    "  <object class=\"GtkWindow\" id=\"window\">\n"
+    "    <child>\n"
+    "      <object class=\"GtkBox\" id=\"box\">\n"
+    "        <property name=\"orientation\">vertical</property>\n"
+    "        <child>\n"
+    "          <object class=\"GtkGrid\" id=\"grid\">\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"first\">\n"
+    "                <property name=\"label\">First</property>\n"
+    "              </object>\n"
+    "              <packing>\n"
+    "                <property name=\"left_attach\">0</property>\n"
+    "                <property name=\"top_attach\">0</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"last\">\n"
+    "                <property name=\"label\">Last</property>\n"
+    "              </object>\n"
+    "              <packing>\n"
+    "                <property name=\"left_attach\">2</property>\n"
+    "                <property name=\"top_attach\">1</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "          </object>\n"
+    "          <packing>\n"
+    "            <property name=\"expand\">True</property>\n"
+    "            <property name=\"fill\">True</property>\n"
+    "            <property name=\"padding\">4</property>\n"
+    "            <property name=\"position\">0</property>\n"
+    "          </packing>\n"
+    "        </child>\n"
+    "        <child>\n"
+    "          <object class=\"GtkNotebook\" id=\"notebook\">\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"page0\">\n"
+    "                <property name=\"label\">Page 0</property>\n"
+    "              </object>\n"
+    "            </child>\n"
+    "            <child type=\"tab\">\n"
+    "              <object class=\"GtkLabel\" id=\"tab0\">\n"
+    "                <property name=\"label\">Tab 0</property>\n"
+    "              </object>\n"
+    "              <packing>\n"
+    "                <property name=\"tab_fill\">False</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"page1\">\n"
+    "                <property name=\"label\">Page 1</property>\n"
+    "              </object>\n"
+    "              <packing>\n"
+    "                <property name=\"position\">1</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child type=\"tab\">\n"
+    "              <object class=\"GtkLabel\" id=\"tab1\">\n"
+    "                <property name=\"label\">Tab 1</property>\n"
+    "              </object>\n"
+    "              <packing>\n"
+    "                <property name=\"position\">1</property>\n"
+    "                <property name=\"tab_fill\">False</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child type=\"action-start\">\n"
+    "              <object class=\"GtkButton\" id=\"action\">\n"
+    "                <property name=\"label\">Action</property>\n"
+    "              </object>\n"
+    "              <packing>\n"
+    "                <property name=\"tab_fill\">False</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "          </object>\n"
+    "          <packing>\n"
+    "            <property name=\"expand\">False</property>\n"
+    "            <property name=\"fill\">True</property>\n"
+    "            <property name=\"position\">1</property>\n"
+    "          </packing>\n"
+    "        </child>\n"
+    "      </object>\n"
+    "    </child>\n"
+    "  </object>\n"
+    "</interface>\n";
+
+  g_assert (g_close (g_file_open_tmp ("glade-clipboard-paste-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml, -1, NULL));
+
+  g_assert ((project = glade_project_load (path)));
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+/* Copies @name and pastes it in the box, returns the pasted widget */
+static GladeWidget *
+copy_paste (GladeProject *project, const gchar *name)
+{
+  GladeWidget *widget, *box, *pasted;
+  GList *selection;
+
+  g_assert ((widget = glade_project_get_widget_by_name (project, name)));
+  g_assert ((box = glade_project_get_widget_by_name (project, "box")));
+
+  glade_project_selection_set (project, glade_widget_get_object (widget), FALSE);
+  glade_project_copy_selection (project);
+
+  glade_project_selection_set (project, glade_widget_get_object (box), FALSE);
+  glade_project_command_paste (project, NULL);
+  flush_idles ();
+
+  /* The pasted widget is selected */
+  selection = glade_project_selection_get (project);
+  g_assert (selection && selection->next == NULL);
+  g_assert ((pasted = glade_widget_get_from_gobject (selection->data)));
+  g_assert (pasted != widget);
+  g_assert (glade_widget_get_parent (pasted) == box);
+
+  /* The parse-finished fix-ups ran and were disconnected */
+  g_assert_cmpuint (g_signal_handler_find (project, G_SIGNAL_MATCH_DATA, 0, 0,
+					   NULL, NULL, glade_widget_get_object (pasted)), ==, 0);
+
+  return pasted;
+}
+
+static void
+test_paste_grid (void)
+{
+  GladeProject *project;
+  GladeWidget *grid;
+  GList *children;
+  gboolean expand = FALSE;
+  guint padding = 0, n_columns = 0, n_rows = 0;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_containers ();
+  grid = copy_paste (project, "grid");
+
+  /* The size is computed from the attachments */
+  glade_widget_property_get (grid, "n-columns", &n_columns);
+  glade_widget_property_get (grid, "n-rows", &n_rows);
+  g_assert_cmpuint (n_columns, ==, 3);
+  g_assert_cmpuint (n_rows, ==, 2);
+
+  /* And the empty cells hold placeholders */
+  children = gtk_container_get_children (GTK_CONTAINER (glade_widget_get_object (grid)));
+  g_assert_cmpint (g_list_length (children), ==, 6);
+  g_list_free (children);
+
+  /* Packing properties transfered on paste are kept */
+  glade_widget_pack_property_get (grid, "expand", &expand);
+  glade_widget_pack_property_get (grid, "padding", &padding);
+  g_assert (expand);
+  g_assert_cmpuint (padding, ==, 4);
+
+  g_object_unref (project);
+}
+
+static void
+test_paste_notebook (void)
+{
+  GladeProject *project;
+  GladeWidget *notebook;
+  GtkNotebook *object;
+  gboolean has_action_start = FALSE, expand = TRUE;
+  gint pages = 0;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_containers ();
+  notebook = copy_paste (project, "notebook");
+  object = GTK_NOTEBOOK (glade_widget_get_object (notebook));
+
+  glade_widget_property_get (notebook, "pages", &pages);
+  g_assert_cmpint (pages, ==, 2);
+  g_assert_cmpint (gtk_notebook_get_n_pages (object), ==, 2);
+
+  /* The action widget is reflected on the notebook properties */
+  glade_widget_property_get (notebook, "has-action-start", &has_action_start);
+  g_assert (has_action_start);
+  g_assert (gtk_notebook_get_action_widget (object, GTK_PACK_START) != NULL);
+
+  glade_widget_pack_property_get (notebook, "expand", &expand);
+  g_assert (!expand);
+
+  g_object_unref (project);
+}
+
+static void
+test_paste_discarded (void)
+{
+  GladeProject *project;
+  GladeWidget *grid;
+  GList *widgets, *l;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_containers ();
+
+  g_assert ((grid = glade_project_get_widget_by_name (project, "grid")));
+  glade_project_selection_set (project, glade_widget_get_object (grid), FALSE);
+  glade_project_copy_selection (project);
+
+  /* Instantiate the clipboard contents and drop them */
+  g_assert ((widgets = glade_clipboard_instantiate (glade_app_get_clipboard (), project)));
+
+  for (l = widgets; l; l = l->next)
+    {
+      g_object_ref_sink (l->data);
+      g_object_unref (l->data);
+    }
+  g_list_free (widgets);
+
+  /* No handler of the dropped widgets is left connected */
+  g_signal_emit_by_name (project, "parse-finished");
+
+  g_object_unref (project);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/ClipboardPaste/Grid", test_paste_grid);
+  g_test_add_func ("/ClipboardPaste/Notebook", test_paste_notebook);
+  g_test_add_func ("/ClipboardPaste/Discarded", test_paste_discarded);
+
+  return g_test_run ();
+}
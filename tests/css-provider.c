@@ -0,0 +1,160 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+#include <string.h>
+
+#include <gladeui/glade.h>
+
+/* Rows of styled widgets, more when measuring performance */
+#define N_ROWS      200
+#define N_ROWS_PERF 2000
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static gchar *
+write_tmp_file (const gchar *template, const gchar *contents)
+{
+  gchar *path;
+
+  g_assert (g_close (g_file_open_tmp (template, &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, contents, -1, NULL));
+
+  return path;
+}
+
+/* A window with rows of nested boxes holding a label and a spin button */
+static GladeProject *
+load_styled (gint n_rows)
+{
+  GladeProject *project;
+  GString *xml;
+  gchar *path;
+  gint i;
+
+  xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		      "<interface>\n"
+		      "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+		      "  <object class=\"GtkWindow\" id=\"window\">\n"
+		      "    <child>\n"
+		      "      <object class=\"GtkBox\" id=\"rows\">\n"
+		      "        <property name=\"orientation\">vertical</property>\n");
+
+  for (i = 0; i < n_rows; i++)
+    g_string_append_printf (xml,
+			    "        <child>\n"
+			    "          <object class=\"GtkBox\" id=\"row%d\">\n"
+			    "            <child>\n"
+			    "              <object class=\"GtkLabel\" id=\"label%d\">\n"
+			    "                <property name=\"label\">Row %d</property>\n"
+			    "              </object>\n"
+			    "            </child>\n"
+			    "            <child>\n"
+			    "              <object class=\"GtkSpinButton\" id=\"spin%d\"/>\n"
+			    "            </child>\n"
+			    "          </object>\n"
+			    "        </child>\n",
+			    i, i, i, i);
+
+  g_string_append (xml,
+		   "      </object>\n"
+		   "    </child>\n"
+		   "  </object>\n"
+		   "</interface>\n");
+
+  path = write_tmp_file ("glade-css-provider-XXXXXX.glade", xml->str);
+  g_string_free (xml, TRUE);
+
+  g_assert ((project = glade_project_load (path)));
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+static gint
+get_margin_left (GladeProject *project, const gchar *name)
+{
+  GladeWidget *gwidget;
+  GtkStyleContext *context;
+  GtkBorder margin;
+
+  g_assert ((gwidget = glade_project_get_widget_by_name (project, name)));
+
+  context = gtk_widget_get_style_context (GTK_WIDGET (glade_widget_get_object (gwidget)));
+  gtk_style_context_get_margin (context, gtk_style_context_get_state (context), &margin);
+
+  return margin.left;
+}
+
+static void
+test_css_provider_load (void)
+{
+  GladeProject *project;
+  gchar *first, *second;
+  GTimer *timer;
+  gint n_rows = g_test_perf () ? N_ROWS_PERF : N_ROWS;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  first = write_tmp_file ("glade-css-provider-XXXXXX.css",
+			  "label { margin-left: 3px; }\n"
+			  "box { margin-left: 5px; }\n");
+  second = write_tmp_file ("glade-css-provider-XXXXXX.css",
+			   "label { margin-left: 7px; }\n");
+
+  timer = g_timer_new ();
+  project = load_styled (n_rows);
+  g_test_message ("Loaded %d styled rows in %f seconds", n_rows, g_timer_elapsed (timer, NULL));
+
+  g_timer_start (timer);
+  glade_project_set_css_provider_path (project, first);
+  g_test_message ("Applied the project CSS in %f seconds", g_timer_elapsed (timer, NULL));
+
+  g_assert_cmpint (get_margin_left (project, "label7"), ==, 3);
+  g_assert_cmpint (get_margin_left (project, "row7"), ==, 5);
+  g_assert_cmpint (get_margin_left (project, "rows"), ==, 5);
+
+  g_timer_start (timer);
+  glade_project_set_css_provider_path (project, second);
+  g_test_message ("Replaced the project CSS in %f seconds", g_timer_elapsed (timer, NULL));
+
+  g_assert_cmpint (get_margin_left (project, "label7"), ==, 7);
+  g_assert_cmpint (get_margin_left (project, "row7"), ==, 0);
+
+  glade_project_set_css_provider_path (project, NULL);
+  g_assert_cmpint (get_margin_left (project, "label7"), ==, 0);
+
+  g_timer_destroy (timer);
+  g_object_unref (project);
+
+  g_unlink (first);
+  g_unlink (second);
+  g_free (first);
+  g_free (second);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/CssProvider/Load", test_css_provider_load);
+
+  return g_test_run ();
+}
@@ -0,0 +1,122 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+flush_idles (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+/* A window with a label much wider than the dormant placeholder */
+static GladeProject *
+load_wide (void)
+{
+  GladeProject *project;
+  GString *xml;
+  gchar *path;
+  gint i;
+
+  xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		      "<interface>\n"
+		      "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+		      "  <object class=\"GtkWindow\" id=\"window\">\n"
+		      "    <child>\n"
+		      "      <object class=\"GtkLabel\" id=\"label\">\n"
+		      "        <property name=\"label\">");
+
+  for (i = 0; i < 200; i++)
+    g_string_append (xml, "Wide ");
+
+  g_string_append (xml,
+		   "</property>\n"
+		   "      </object>\n"
+		   "    </child>\n"
+		   "  </object>\n"
+		   "</interface>\n");
+
+  g_assert (g_close (g_file_open_tmp ("glade-design-layout-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml->str, xml->len, NULL));
+  g_string_free (xml, TRUE);
+
+  g_assert ((project = glade_project_load (path)));
+  flush_idles ();
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+static void
+test_design_layout_dormant (void)
+{
+  GladeProject *project;
+  GladeWidget *window;
+  GtkWidget *view, *object, *label, *layout;
+  gint label_width, placeholder_width, saved_width, saved_height, height;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_wide ();
+  window = glade_project_get_widget_by_name (project, "window");
+  object = GTK_WIDGET (glade_widget_get_object (window));
+  label = GTK_WIDGET (glade_widget_get_object (glade_project_get_widget_by_name (project, "label")));
+
+  view = g_object_ref_sink (glade_design_view_new (project));
+  flush_idles ();
+
+  /* The view was never allocated, the layout stays dormant */
+  g_assert ((layout = gtk_widget_get_parent (object)));
+
+  gtk_widget_get_preferred_width (label, NULL, &label_width);
+
+  /* A dormant layout does not measure its child */
+  gtk_widget_get_preferred_width (layout, &placeholder_width, NULL);
+  g_assert_cmpint (placeholder_width, <, label_width);
+
+  /* It reserves the saved toplevel size instead, as soon as it changes */
+  g_object_set (window, "toplevel-width", 400, "toplevel-height", 300, NULL);
+
+  gtk_widget_get_preferred_width (layout, &saved_width, NULL);
+  g_assert_cmpint (saved_width, <, label_width);
+  g_assert_cmpint (saved_width, ==, placeholder_width + 200);
+
+  gtk_widget_get_preferred_height (layout, &saved_height, NULL);
+
+  g_object_set (window, "toplevel-height", 350, NULL);
+  gtk_widget_get_preferred_height (layout, &height, NULL);
+  g_assert_cmpint (height, ==, saved_height + 50);
+
+  g_object_unref (view);
+  g_object_unref (project);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/DesignLayout/Dormant", test_design_layout_dormant);
+
+  return g_test_run ();
+}
@@ -0,0 +1,209 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+#define N_PAGES 3
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+flush_idles (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+/* A notebook with N_PAGES pages, each a box with a label and a free slot */
+static GladeProject *
+load_pages (void)
+{
+  GladeProject *project;
+  GString *xml;
+  gchar *path;
+  gint i;
+
+  xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		      "<interface>\n"
+		      "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+		      "  <object class=\"GtkWindow\" id=\"window\">\n"
+		      "    <child>\n"
+		      "      <object class=\"GtkNotebook\" id=\"notebook\">\n");
+
+  for (i = 0; i < N_PAGES; i++)
+    g_string_append_printf (xml,
+			    "        <child>\n"
+			    "          <object class=\"GtkBox\" id=\"page%d\">\n"
+			    "            <child>\n"
+			    "              <object class=\"GtkLabel\" id=\"label%d\">\n"
+			    "                <property name=\"label\">Page %d</property>\n"
+			    "              </object>\n"
+			    "            </child>\n"
+			    "            <child>\n"
+			    "              <placeholder/>\n"
+			    "            </child>\n"
+			    "          </object>\n"
+			    "          <packing>\n"
+			    "            <property name=\"position\">%d</property>\n"
+			    "          </packing>\n"
+			    "        </child>\n"
+			    "        <child type=\"tab\">\n"
+			    "          <object class=\"GtkLabel\" id=\"tab%d\"/>\n"
+			    "          <packing>\n"
+			    "            <property name=\"position\">%d</property>\n"
+			    "            <property name=\"tab_fill\">False</property>\n"
+			    "          </packing>\n"
+			    "        </child>\n",
+			    i, i, i, i, i, i);
+
+  g_string_append (xml,
+		   "      </object>\n"
+		   "    </child>\n"
+		   "  </object>\n"
+		   "</interface>\n");
+
+  g_assert (g_close (g_file_open_tmp ("glade-lazy-pages-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml->str, xml->len, NULL));
+  g_string_free (xml, TRUE);
+
+  g_assert ((project = glade_project_load (path)));
+  flush_idles ();
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+static GtkWidget *
+get_widget (GladeProject *project, const gchar *name)
+{
+  GladeWidget *gwidget;
+
+  g_assert ((gwidget = glade_project_get_widget_by_name (project, name)));
+
+  return GTK_WIDGET (glade_widget_get_object (gwidget));
+}
+
+static void
+show_page (GladeProject *project, gint page)
+{
+  gtk_notebook_set_current_page (GTK_NOTEBOOK (get_widget (project, "notebook")), page);
+  flush_idles ();
+}
+
+static void
+test_lazy_pages_load (void)
+{
+  GladeProject *project;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_pages ();
+
+  /* Only the current page has its children on display */
+  g_assert (gtk_widget_get_visible (get_widget (project, "label0")));
+  g_assert (!gtk_widget_get_visible (get_widget (project, "label1")));
+  g_assert (!gtk_widget_get_visible (get_widget (project, "label2")));
+
+  /* Showing the whole design does not show the parked children */
+  gtk_widget_show_all (get_widget (project, "window"));
+  g_assert (!gtk_widget_get_visible (get_widget (project, "label1")));
+
+  show_page (project, 1);
+  g_assert (!gtk_widget_get_visible (get_widget (project, "label0")));
+  g_assert (gtk_widget_get_visible (get_widget (project, "label1")));
+
+  g_object_unref (project);
+}
+
+static void
+test_lazy_pages_rebuild (void)
+{
+  GladeProject *project;
+  GladeWidget *label;
+  GtkWidget *old_object;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_pages ();
+
+  /* A child rebuilt in a parked page stays hidden */
+  label = glade_project_get_widget_by_name (project, "label2");
+  old_object = get_widget (project, "label2");
+  glade_widget_rebuild (label);
+  g_assert (get_widget (project, "label2") != old_object);
+  g_assert (!gtk_widget_get_visible (get_widget (project, "label2")));
+
+  show_page (project, 2);
+  g_assert (gtk_widget_get_visible (get_widget (project, "label2")));
+
+  /* The children of a rebuilt page are not left hidden */
+  show_page (project, 0);
+  glade_widget_rebuild (glade_project_get_widget_by_name (project, "page2"));
+  show_page (project, 2);
+  g_assert (gtk_widget_get_visible (get_widget (project, "label2")));
+
+  g_object_unref (project);
+}
+
+static void
+test_lazy_pages_add (void)
+{
+  GladeProject *project;
+  GladeWidget *page, *button;
+  GList *children, *l;
+  GladePlaceholder *placeholder = NULL;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_pages ();
+
+  page = glade_project_get_widget_by_name (project, "page1");
+
+  children = gtk_container_get_children (GTK_CONTAINER (glade_widget_get_object (page)));
+  for (l = children; l; l = l->next)
+    if (GLADE_IS_PLACEHOLDER (l->data))
+      placeholder = l->data;
+  g_list_free (children);
+  g_assert (placeholder);
+
+  /* A child added to a parked page is hidden along with the others */
+  button = glade_command_create (glade_widget_adaptor_get_by_type (GTK_TYPE_BUTTON),
+				 page, placeholder, project);
+  g_assert (button);
+  g_assert (!gtk_widget_get_visible (GTK_WIDGET (glade_widget_get_object (button))));
+
+  show_page (project, 1);
+  g_assert (gtk_widget_get_visible (GTK_WIDGET (glade_widget_get_object (button))));
+  g_assert (gtk_widget_get_visible (get_widget (project, "label1")));
+
+  g_object_unref (project);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/LazyPages/Load", test_lazy_pages_load);
+  g_test_add_func ("/LazyPages/Rebuild", test_lazy_pages_rebuild);
+  g_test_add_func ("/LazyPages/Add", test_lazy_pages_add);
+
+  return g_test_run ();
+}
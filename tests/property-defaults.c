@@ -0,0 +1,140 @@
+#include <glib.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+#include "test-utils.h"
+
+#define N_WIDGETS 2000
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+test_defaults_shared (void)
+{
+  GladeWidgetAdaptor *adaptor;
+  GladeProject *project;
+  GladeWidget *first, *second;
+  GladeProperty *property;
+  GladePropertyClass *pclass;
+  gchar *label = NULL;
+  gint width_chars = 0;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = glade_project_new ();
+  adaptor = glade_widget_adaptor_get_by_type (GTK_TYPE_LABEL);
+
+  first  = glade_widget_adaptor_create_widget (adaptor, FALSE, "project", project, NULL);
+  second = glade_widget_adaptor_create_widget (adaptor, FALSE, "project", project, NULL);
+  glade_project_add_object (project, glade_widget_get_object (first));
+  glade_project_add_object (project, glade_widget_get_object (second));
+
+  /* Writing to a property does not leak into other widgets or the class */
+  glade_widget_property_set (first, "label", "changed");
+  glade_widget_property_get (second, "label", &label);
+  g_assert_cmpstr (label, !=, "changed");
+
+  property = glade_widget_get_property (second, "label");
+  pclass   = glade_property_get_class (property);
+  g_assert (glade_property_default (property));
+  g_assert_cmpstr (g_value_get_string (glade_property_class_get_original_default (pclass)), !=, "changed");
+
+  /* Values modified in place are private too */
+  property = glade_widget_get_property (second, "width-chars");
+  pclass   = glade_property_get_class (property);
+  g_value_set_int (glade_property_inline_value (property), 42);
+
+  glade_widget_property_get (first, "width-chars", &width_chars);
+  g_assert_cmpint (width_chars, !=, 42);
+  g_assert_cmpint (g_value_get_int (glade_property_class_get_original_default (pclass)), !=, 42);
+
+  g_object_unref (project);
+}
+
+/* Resident memory in kB taken by N_WIDGETS buttons, either sharing the
+ * defaults of their classes or each owning a value for every property
+ * as they did before defaults were shared.
+ */
+static gulong
+buttons_rss (GladeProject *project, GladeWidgetAdaptor *adaptor, gboolean owned)
+{
+  gulong rss_before;
+  gint i;
+
+  rss_before = test_current_rss ();
+
+  for (i = 0; i < N_WIDGETS; i++)
+    {
+      GladeWidget *widget =
+        glade_widget_adaptor_create_widget (adaptor, FALSE, "project", project, NULL);
+      GList *l;
+
+      glade_project_add_object (project, glade_widget_get_object (widget));
+
+      for (l = owned ? glade_widget_get_properties (widget) : NULL; l; l = l->next)
+        glade_property_inline_value (l->data);
+    }
+
+  return test_current_rss () - rss_before;
+}
+
+static void
+test_defaults_memory (void)
+{
+  GladeWidgetAdaptor *adaptor;
+  GladeProject *shared, *owned;
+  gulong shared_rss, owned_rss;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  if (test_current_rss () == 0)
+    {
+      g_test_message ("Resident memory is not available, skipping");
+      return;
+    }
+
+  adaptor = glade_widget_adaptor_get_by_type (GTK_TYPE_BUTTON);
+
+  /* Warm up, so that the adaptor and its classes are in place */
+  g_object_unref (glade_widget_adaptor_create_widget (adaptor, FALSE, NULL));
+
+  shared = glade_project_new ();
+  owned  = glade_project_new ();
+
+  shared_rss = buttons_rss (shared, adaptor, FALSE);
+  owned_rss  = buttons_rss (owned, adaptor, TRUE);
+
+  g_test_message ("Resident memory for %d buttons: %lu kB sharing defaults, "
+                  "%lu kB owning every value",
+                  N_WIDGETS, shared_rss, owned_rss);
+
+  g_object_unref (shared);
+  g_object_unref (owned);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/PropertyDefaults/Shared", test_defaults_shared);
+  g_test_add_func ("/PropertyDefaults/Memory", test_defaults_memory);
+
+  return g_test_run ();
+}
@@ -0,0 +1,707 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+#include "test-utils.h"
+
+#define N_ROWS   40
+#define N_CYCLES 25
+
+/* Peak memory may grow across all the cycles by at most as much as
+ * keeping this many forms alive, the undo stack used to keep one per
+ * cycle. Forms are assumed to take at least MIN_FORM_RSS kB.
+ */
+#define MAX_KEPT_FORMS 4
+#define MIN_FORM_RSS   256
+
+/* Referrers of a shared adjustment, more when measuring performance */
+#define N_REFERRERS      1000
+#define N_REFERRERS_PERF 10000
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+check_finalized (gpointer data,
+		 GObject *where_the_object_was)
+{
+  gboolean *did_finalize = (gboolean *)data;
+
+  *did_finalize = TRUE;
+}
+
+static void
+flush_idles (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+/* A window holding a form with N_ROWS rows of a label and an entry */
+static GladeProject *
+load_form (void)
+{
+  GladeProject *project;
+  GString *xml;
+  gchar *path;
+  gint i;
+
+  xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		      "<interface>\n"
+		      "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+		      "  <object class=\"GtkWindow\" id=\"window\">\n"
+		      "    <child>\n"
+		      "      <object class=\"GtkBox\" id=\"form\">\n"
+		      "        <property name=\"orientation\">vertical</property>\n");
+
+  for (i = 0; i < N_ROWS; i++)
+    g_string_append_printf (xml,
+			    "        <child>\n"
+			    "          <object class=\"GtkBox\" id=\"row%d\">\n"
+			    "            <child>\n"
+			    "              <object class=\"GtkLabel\" id=\"label%d\">\n"
+			    "                <property name=\"label\">Field %d</property>\n"
+			    "                <property name=\"mnemonic_widget\">entry%d</property>\n"
+			    "              </object>\n"
+			    "            </child>\n"
+			    "            <child>\n"
+			    "              <object class=\"GtkEntry\" id=\"entry%d\"/>\n"
+			    "              <packing>\n"
+			    "                <property name=\"expand\">True</property>\n"
+			    "                <property name=\"position\">1</property>\n"
+			    "              </packing>\n"
+			    "            </child>\n"
+			    "          </object>\n"
+			    "          <packing>\n"
+			    "            <property name=\"position\">%d</property>\n"
+			    "          </packing>\n"
+			    "        </child>\n",
+			    i, i, i, i, i, i);
+
+  g_string_append (xml,
+		   "      </object>\n"
+		   "    </child>\n"
+		   "  </object>\n"
+		   "</interface>\n");
+
+  g_assert (g_close (g_file_open_tmp ("glade-remove-undo-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml->str, xml->len, NULL));
+  g_string_free (xml, TRUE);
+
+  g_assert ((project = glade_project_load (path)));
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+static void
+assert_form (GladeProject *project)
+{
+  GladeWidget *window, *form, *label, *entry;
+  GObject *mnemonic = NULL;
+  GList *children;
+  gboolean expand = FALSE;
+
+  g_assert ((window = glade_project_get_widget_by_name (project, "window")));
+  g_assert ((form = glade_project_get_widget_by_name (project, "form")));
+  g_assert (glade_widget_get_parent (form) == window);
+
+  children = glade_widget_get_children (form);
+  g_assert_cmpint (g_list_length (children), ==, N_ROWS);
+  g_list_free (children);
+
+  /* References within the removed hierarchy are restored */
+  g_assert ((label = glade_project_get_widget_by_name (project, "label7")));
+  g_assert ((entry = glade_project_get_widget_by_name (project, "entry7")));
+  glade_widget_property_get (label, "mnemonic-widget", &mnemonic);
+  g_assert (mnemonic == glade_widget_get_object (entry));
+
+  /* And so are packing properties */
+  glade_widget_pack_property_get (entry, "expand", &expand);
+  g_assert (expand);
+}
+
+static void
+test_remove_compact (void)
+{
+  GladeProject *project, *extra;
+  GladeWidget *form;
+  GObject *object;
+  gboolean form_finalized, object_finalized;
+  gulong rss_before, rss_after, form_rss;
+  GList list = { 0, };
+  gint i;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_form ();
+  assert_form (project);
+
+  /* What keeping one more form alive costs */
+  rss_before = test_current_rss ();
+  extra = load_form ();
+  form_rss = test_current_rss () - rss_before;
+  g_object_unref (extra);
+
+  /* Warm up once, so that only the steady state is measured below */
+  list.data = glade_project_get_widget_by_name (project, "form");
+  glade_command_delete (&list);
+  flush_idles ();
+  glade_project_undo (project);
+  flush_idles ();
+
+  rss_before = test_peak_rss ();
+
+  for (i = 0; i < N_CYCLES; i++)
+    {
+      form = glade_project_get_widget_by_name (project, "form");
+      object = glade_widget_get_object (form);
+
+      form_finalized = object_finalized = FALSE;
+      g_object_weak_ref (G_OBJECT (form), check_finalized, &form_finalized);
+      g_object_weak_ref (object, check_finalized, &object_finalized);
+
+      list.data = form;
+      glade_command_delete (&list);
+      flush_idles ();
+
+      /* Nothing else refers to the form, the undo record is compacted */
+      g_assert (form_finalized);
+      g_assert (object_finalized);
+      g_assert (glade_project_get_widget_by_name (project, "form") == NULL);
+
+      glade_project_undo (project);
+      flush_idles ();
+      assert_form (project);
+
+      /* Redo and undo the compacted record */
+      glade_project_redo (project);
+      flush_idles ();
+      g_assert (glade_project_get_widget_by_name (project, "form") == NULL);
+
+      glade_project_undo (project);
+      flush_idles ();
+      assert_form (project);
+    }
+
+  rss_after = test_peak_rss ();
+
+  if (rss_before > 0)
+    {
+      g_test_message ("Peak RSS across %d delete/undo cycles of %d rows: %lu kB -> %lu kB, "
+		      "one form takes %lu kB",
+		      N_CYCLES, N_ROWS, rss_before, rss_after, form_rss);
+
+      /* Removed trees are not kept alive by the undo stack */
+      g_assert_cmpuint (rss_after - rss_before, <=, MAX_KEPT_FORMS * MAX (form_rss, MIN_FORM_RSS));
+    }
+
+  g_object_unref (project);
+}
+
+static void
+test_remove_referenced (void)
+{
+  GladeProject *project;
+  GladeWidget *form, *label;
+  GladeProperty *property;
+  gboolean form_finalized = FALSE;
+  GList list = { 0, };
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_form ();
+
+  /* An earlier command operates on a widget in the hierarchy */
+  label    = glade_project_get_widget_by_name (project, "label3");
+  property = glade_widget_get_property (label, "label");
+  glade_command_set_property (property, "Renamed");
+
+  form = glade_project_get_widget_by_name (project, "form");
+  g_object_weak_ref (G_OBJECT (form), check_finalized, &form_finalized);
+
+  list.data = form;
+  glade_command_delete (&list);
+  flush_idles ();
+
+  /* The widgets are kept alive for the property command */
+  g_assert (!form_finalized);
+
+  glade_project_undo (project);
+  flush_idles ();
+  g_assert (glade_project_get_widget_by_name (project, "form") == form);
+  g_assert (glade_project_get_widget_by_name (project, "label3") == label);
+
+  /* Undoing the property command still applies to the same widget */
+  glade_project_undo (project);
+  g_assert_cmpstr (gtk_label_get_label (GTK_LABEL (glade_widget_get_object (label))), ==, "Field 3");
+
+  g_object_weak_unref (G_OBJECT (form), check_finalized, &form_finalized);
+  g_object_unref (project);
+}
+
+/* A box of spin buttons all sharing the same adjustment */
+static GladeProject *
+load_shared_adjustment (gint n_referrers)
+{
+  GladeProject *project;
+  GString *xml;
+  gchar *path;
+  gint i;
+
+  xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		      "<interface>\n"
+		      "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+		      "  <object class=\"GtkAdjustment\" id=\"adjustment\">\n"
+		      "    <property name=\"upper\">100</property>\n"
+		      "  </object>\n"
+		      "  <object class=\"GtkWindow\" id=\"window\">\n"
+		      "    <child>\n"
+		      "      <object class=\"GtkBox\" id=\"box\">\n"
+		      "        <property name=\"orientation\">vertical</property>\n");
+
+  for (i = 0; i < n_referrers; i++)
+    g_string_append_printf (xml,
+			    "        <child>\n"
+			    "          <object class=\"GtkSpinButton\" id=\"spin%d\">\n"
+			    "            <property name=\"adjustment\">adjustment</property>\n"
+			    "          </object>\n"
+			    "          <packing>\n"
+			    "            <property name=\"position\">%d</property>\n"
+			    "          </packing>\n"
+			    "        </child>\n",
+			    i, i);
+
+  g_string_append (xml,
+		   "      </object>\n"
+		   "    </child>\n"
+		   "  </object>\n"
+		   "</interface>\n");
+
+  g_assert (g_close (g_file_open_tmp ("glade-remove-undo-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml->str, xml->len, NULL));
+  g_string_free (xml, TRUE);
+
+  g_assert ((project = glade_project_load (path)));
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+static void
+assert_spin_adjustment (GladeProject *project, const gchar *name, GObject *expected)
+{
+  GladeWidget *spin;
+  GObject *adjustment = NULL;
+
+  g_assert ((spin = glade_project_get_widget_by_name (project, name)));
+  glade_widget_property_get (spin, "adjustment", &adjustment);
+  g_assert (adjustment == expected);
+}
+
+/* Deletes and restores an adjustment shared by @n_referrers spin buttons,
+ * returns the time taken to load, delete and undo in seconds.
+ */
+static void
+shared_reference_cycle (gint     n_referrers,
+			gdouble *load_seconds,
+			gdouble *delete_seconds,
+			gdouble *undo_seconds)
+{
+  GladeProject *project;
+  GladeWidget *adjustment;
+  GList list = { 0, }, *refs;
+  GTimer *timer;
+
+  timer = g_timer_new ();
+  project = load_shared_adjustment (n_referrers);
+  *load_seconds = g_timer_elapsed (timer, NULL);
+
+  g_assert ((adjustment = glade_project_get_widget_by_name (project, "adjustment")));
+  g_assert (glade_widget_has_prop_refs (adjustment));
+
+  /* Hold the widget across the deletion, it is not compacted then */
+  g_object_ref (adjustment);
+
+  refs = glade_widget_list_prop_refs (adjustment);
+  g_assert_cmpint (g_list_length (refs), ==, n_referrers);
+  g_list_free (refs);
+
+  /* Deleting the adjustment unsets every property referring to it */
+  g_timer_start (timer);
+  list.data = adjustment;
+  glade_command_delete (&list);
+  flush_idles ();
+  *delete_seconds = g_timer_elapsed (timer, NULL);
+
+  g_assert (glade_project_get_widget_by_name (project, "adjustment") == NULL);
+  g_assert (!glade_widget_has_prop_refs (adjustment));
+  assert_spin_adjustment (project, "spin0", NULL);
+  assert_spin_adjustment (project, "spin7", NULL);
+
+  /* And undo sets them all back */
+  g_timer_start (timer);
+  glade_project_undo (project);
+  flush_idles ();
+  *undo_seconds = g_timer_elapsed (timer, NULL);
+
+  g_assert (glade_project_get_widget_by_name (project, "adjustment") == adjustment);
+
+  refs = glade_widget_list_prop_refs (adjustment);
+  g_assert_cmpint (g_list_length (refs), ==, n_referrers);
+  g_list_free (refs);
+
+  assert_spin_adjustment (project, "spin0", glade_widget_get_object (adjustment));
+  assert_spin_adjustment (project, "spin7", glade_widget_get_object (adjustment));
+
+  g_timer_destroy (timer);
+  g_object_unref (adjustment);
+  g_object_unref (project);
+}
+
+static void
+test_remove_shared_reference (void)
+{
+  gdouble load, delete, undo, perf_load, perf_delete, perf_undo;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  shared_reference_cycle (N_REFERRERS, &load, &delete, &undo);
+  g_test_message ("%d referrers of one adjustment: loaded in %f, deleted in %f, "
+		  "undone in %f seconds", N_REFERRERS, load, delete, undo);
+
+  if (!g_test_perf ())
+    return;
+
+  /* With indexed references the cost per referrer stays flat */
+  shared_reference_cycle (N_REFERRERS_PERF, &perf_load, &perf_delete, &perf_undo);
+  g_test_message ("%d referrers of one adjustment: loaded in %f, deleted in %f, "
+		  "undone in %f seconds", N_REFERRERS_PERF, perf_load, perf_delete, perf_undo);
+  g_test_message ("Per referrer cost against %d referrers: load x%.2f, delete x%.2f, undo x%.2f",
+		  N_REFERRERS,
+		  (perf_load / N_REFERRERS_PERF) / MAX (load / N_REFERRERS, G_MINDOUBLE),
+		  (perf_delete / N_REFERRERS_PERF) / MAX (delete / N_REFERRERS, G_MINDOUBLE),
+		  (perf_undo / N_REFERRERS_PERF) / MAX (undo / N_REFERRERS, G_MINDOUBLE));
+}
+
+/* Containers whose children depend on their packing and on the
+ * parse-finished fix-ups
+ */
+static GladeProject *
+load_containers (void)
+{
+  GladeProject *project;
+  gchar *path;
+  const gchar *xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<interface>\n"
+    "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+    "  <object class=\"GtkListStore\" id=\"store\">\n"
+    "    <columns>\n"
+    "      <column type=\"gchararray\"/>\n"
+    "    </columns>\n"
+    "  </object>\n"
+    "  <object class=\"GtkWindow\" id=\"window\">\n"
+    "    <child>\n"
+    "      <object class=\"GtkBox\" id=\"box\">\n"
+    "        <property name=\"orientation\">vertical</property>\n"
+    "        <child>\n"
+    "          <object class=\"GtkGrid\" id=\"grid\">\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"first\"/>\n"
+    "              <packing>\n"
+    "                <property name=\"left_attach\">0</property>\n"
+    "                <property name=\"top_attach\">0</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"last\"/>\n"
+    "              <packing>\n"
+    "                <property name=\"left_attach\">2</property>\n"
+    "                <property name=\"top_attach\">1</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "          </object>\n"
+    "          <packing>\n"
+    "            <property name=\"position\">0</property>\n"
+    "          </packing>\n"
+    "        </child>\n"
+    "        <child>\n"
+    "          <object class=\"GtkNotebook\" id=\"notebook\">\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"page0\"/>\n"
+    "            </child>\n"
+    "            <child type=\"tab\">\n"
+    "              <object class=\"GtkLabel\" id=\"tab0\"/>\n"
+    "              <packing>\n"
+    "                <property name=\"tab_fill\">False</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"page1\"/>\n"
+    "              <packing>\n"
+    "                <property name=\"position\">1</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child type=\"tab\">\n"
+    "              <object class=\"GtkLabel\" id=\"tab1\"/>\n"
+    "              <packing>\n"
+    "                <property name=\"position\">1</property>\n"
+    "                <property name=\"tab_fill\">False</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child type=\"action-start\">\n"
+    "              <object class=\"GtkButton\" id=\"action\"/>\n"
+    "              <packing>\n"
+    "                <property name=\"tab_fill\">False</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "          </object>\n"
+    "          <packing>\n"
+    "            <property name=\"position\">1</property>\n"
+    "          </packing>\n"
+    "        </child>\n"
+    "        <child>\n"
+    "          <object class=\"GtkStack\" id=\"stack\">\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"stack_a\"/>\n"
+    "              <packing>\n"
+    "                <property name=\"name\">a</property>\n"
+    "                <property name=\"title\">A</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "            <child>\n"
+    "              <object class=\"GtkLabel\" id=\"stack_b\"/>\n"
+    "              <packing>\n"
+    "                <property name=\"name\">b</property>\n"
+    "                <property name=\"title\">B</property>\n"
+    "                <property name=\"position\">1</property>\n"
+    "              </packing>\n"
+    "            </child>\n"
+    "          </object>\n"
+    "          <packing>\n"
+    "            <property name=\"position\">2</property>\n"
+    "          </packing>\n"
+    "        </child>\n"
+    "        <child>\n"
+    "          <object class=\"GtkTreeView\" id=\"treeview\">\n"
+    "            <property name=\"model\">store</property>\n"
+    "            <child>\n"
+    "              <object class=\"GtkTreeViewColumn\" id=\"column\">\n"
+    "                <child>\n"
+    "                  <object class=\"GtkCellRendererText\" id=\"renderer\"/>\n"
+    "                  <attributes>\n"
+    "                    <attribute name=\"text\">0</attribute>\n"
+    "                  </attributes>\n"
+    "                </child>\n"
+    "              </object>\n"
+    "            </child>\n"
+    "          </object>\n"
+    "          <packing>\n"
+    "            <property name=\"position\">3</property>\n"
+    "          </packing>\n"
+    "        </child>\n"
+    "      </object>\n"
+    "    </child>\n"
+    "  </object>\n"
+    "</interface>\n";
+
+  g_assert (g_close (g_file_open_tmp ("glade-remove-undo-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml, -1, NULL));
+
+  g_assert ((project = glade_project_load (path)));
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+/* Deletes @name, checks that the undo record is compacted and undoes it */
+static GladeWidget *
+delete_compact_undo (GladeProject *project, const gchar *name)
+{
+  GladeWidget *widget;
+  gboolean finalized = FALSE;
+  GList list = { 0, };
+
+  g_assert ((widget = glade_project_get_widget_by_name (project, name)));
+  g_object_weak_ref (G_OBJECT (widget), check_finalized, &finalized);
+
+  list.data = widget;
+  glade_command_delete (&list);
+  flush_idles ();
+  g_assert (finalized);
+
+  glade_project_undo (project);
+  flush_idles ();
+
+  g_assert ((widget = glade_project_get_widget_by_name (project, name)));
+  g_assert (glade_widget_get_parent (widget) ==
+	    glade_project_get_widget_by_name (project, "box"));
+
+  /* Nothing the restored widgets connected to is left for a later load */
+  g_assert_cmpuint (g_signal_handler_find (project, G_SIGNAL_MATCH_DATA, 0, 0,
+					   NULL, NULL, glade_widget_get_object (widget)), ==, 0);
+
+  return widget;
+}
+
+static void
+test_remove_grid (void)
+{
+  GladeProject *project;
+  GladeWidget *grid, *last;
+  GList *children;
+  guint n_columns = 0, n_rows = 0;
+  gint left_attach = 0, top_attach = 0, position = -1;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_containers ();
+  grid = delete_compact_undo (project, "grid");
+
+  glade_widget_property_get (grid, "n-columns", &n_columns);
+  glade_widget_property_get (grid, "n-rows", &n_rows);
+  g_assert_cmpuint (n_columns, ==, 3);
+  g_assert_cmpuint (n_rows, ==, 2);
+
+  /* Empty cells are filled with placeholders once */
+  children = gtk_container_get_children (GTK_CONTAINER (glade_widget_get_object (grid)));
+  g_assert_cmpint (g_list_length (children), ==, 6);
+  g_list_free (children);
+
+  g_assert ((last = glade_project_get_widget_by_name (project, "last")));
+  glade_widget_pack_property_get (last, "left-attach", &left_attach);
+  glade_widget_pack_property_get (last, "top-attach", &top_attach);
+  g_assert_cmpint (left_attach, ==, 2);
+  g_assert_cmpint (top_attach, ==, 1);
+
+  glade_widget_pack_property_get (grid, "position", &position);
+  g_assert_cmpint (position, ==, 0);
+
+  g_object_unref (project);
+}
+
+static void
+test_remove_notebook (void)
+{
+  GladeProject *project;
+  GladeWidget *notebook, *page1, *tab1;
+  GtkNotebook *object;
+  gboolean has_action_start = FALSE;
+  gint pages = 0;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_containers ();
+  notebook = delete_compact_undo (project, "notebook");
+  object = GTK_NOTEBOOK (glade_widget_get_object (notebook));
+
+  glade_widget_property_get (notebook, "pages", &pages);
+  g_assert_cmpint (pages, ==, 2);
+  g_assert_cmpint (gtk_notebook_get_n_pages (object), ==, 2);
+
+  /* Pages keep their order and tabs */
+  g_assert ((page1 = glade_project_get_widget_by_name (project, "page1")));
+  g_assert ((tab1 = glade_project_get_widget_by_name (project, "tab1")));
+  g_assert_cmpint (gtk_notebook_page_num (object, GTK_WIDGET (glade_widget_get_object (page1))), ==, 1);
+  g_assert (gtk_notebook_get_tab_label (object, GTK_WIDGET (glade_widget_get_object (page1))) ==
+	    GTK_WIDGET (glade_widget_get_object (tab1)));
+
+  glade_widget_property_get (notebook, "has-action-start", &has_action_start);
+  g_assert (has_action_start);
+
+  g_object_unref (project);
+}
+
+static void
+test_remove_stack (void)
+{
+  GladeProject *project;
+  GladeWidget *stack, *child;
+  gchar *name = NULL, *title = NULL;
+  gint position = -1;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_containers ();
+  stack = delete_compact_undo (project, "stack");
+
+  g_assert ((child = glade_project_get_widget_by_name (project, "stack_b")));
+  gtk_container_child_get (GTK_CONTAINER (glade_widget_get_object (stack)),
+			   GTK_WIDGET (glade_widget_get_object (child)),
+			   "name", &name, "title", &title, "position", &position,
+			   NULL);
+  g_assert_cmpstr (name, ==, "b");
+  g_assert_cmpstr (title, ==, "B");
+  g_assert_cmpint (position, ==, 1);
+
+  g_free (name);
+  g_free (title);
+  g_object_unref (project);
+}
+
+static void
+test_remove_tree_view (void)
+{
+  GladeProject *project;
+  GladeWidget *treeview, *renderer, *store;
+  GObject *model = NULL;
+  gboolean use_attr = FALSE;
+  gint attr = -1;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_containers ();
+  treeview = delete_compact_undo (project, "treeview");
+
+  /* The model outside of the removed hierarchy is looked up again */
+  g_assert ((store = glade_project_get_widget_by_name (project, "store")));
+  glade_widget_property_get (treeview, "model", &model);
+  g_assert (model == glade_widget_get_object (store));
+
+  /* And the renderer attributes are switched on */
+  g_assert ((renderer = glade_project_get_widget_by_name (project, "renderer")));
+  glade_widget_property_get (renderer, "attr-text", &attr);
+  glade_widget_property_get (renderer, "use-attr-text", &use_attr);
+  g_assert_cmpint (attr, ==, 0);
+  g_assert (use_attr);
+
+  g_object_unref (project);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/RemoveUndo/Compact", test_remove_compact);
+  g_test_add_func ("/RemoveUndo/Referenced", test_remove_referenced);
+  g_test_add_func ("/RemoveUndo/SharedReference", test_remove_shared_reference);
+  g_test_add_func ("/RemoveUndo/Grid", test_remove_grid);
+  g_test_add_func ("/RemoveUndo/Notebook", test_remove_notebook);
+  g_test_add_func ("/RemoveUndo/Stack", test_remove_stack);
+  g_test_add_func ("/RemoveUndo/TreeView", test_remove_tree_view);
+
+  return g_test_run ();
+}
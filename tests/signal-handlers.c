@@ -0,0 +1,299 @@
+#include <glib.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+#include "test-utils.h"
+
+#define N_WIDGETS 500
+#define N_LOOKUPS 200000
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+test_handlers_lookup (void)
+{
+  GladeWidgetAdaptor *adaptor;
+  GladeSignalClass *sclass;
+  GladeWidget *widget;
+  GladeSignal *signal, *copy, *changed;
+  GPtrArray *handlers;
+  gchar *name, *handler;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  adaptor = glade_widget_adaptor_get_by_type (GTK_TYPE_BUTTON);
+  sclass  = glade_widget_adaptor_get_signal_class (adaptor, "clicked");
+  widget  = glade_widget_adaptor_create_widget (adaptor, FALSE, NULL);
+
+  /* Strings built at runtime name the same signals and properties */
+  name    = g_strconcat ("click", "ed", NULL);
+  handler = g_strconcat ("on_button", "_clicked", NULL);
+
+  signal = glade_signal_new (sclass, "on_button_clicked", NULL, FALSE, FALSE);
+  copy   = glade_signal_new (sclass, handler, NULL, FALSE, FALSE);
+  g_assert (glade_signal_equal (signal, copy));
+
+  glade_widget_add_signal_handler (widget, signal);
+  g_assert ((handlers = glade_widget_list_signal_handlers (widget, name)));
+  g_assert_cmpuint (handlers->len, ==, 1);
+  g_assert (glade_signal_equal (g_ptr_array_index (handlers, 0), copy));
+
+  changed = glade_signal_new (sclass, "on_button_activated", "button", FALSE, TRUE);
+  glade_widget_change_signal_handler (widget, copy, changed);
+  g_assert (glade_signal_equal (g_ptr_array_index (handlers, 0), changed));
+  g_assert_cmpstr (glade_signal_get_handler (g_ptr_array_index (handlers, 0)), ==, "on_button_activated");
+
+  glade_widget_remove_signal_handler (widget, changed);
+  g_assert_cmpuint (handlers->len, ==, 0);
+
+  g_assert (glade_widget_list_signal_handlers (widget, "no-such-signal") == NULL);
+  g_assert (glade_widget_get_property (widget, "no-such-property") == NULL);
+
+  g_free (name);
+  g_free (handler);
+  g_object_unref (signal);
+  g_object_unref (copy);
+  g_object_unref (changed);
+  g_object_unref (widget);
+}
+
+static void
+on_row_inserted (GtkTreeModel *model,
+                 GtkTreePath  *path,
+                 GtkTreeIter  *iter,
+                 gint         *inserted)
+{
+  (*inserted)++;
+}
+
+static void
+test_handlers_model (void)
+{
+  GladeWidgetAdaptor *adaptor;
+  GladeWidget *widget;
+  GladeSignal *signal, *row_signal = NULL;
+  GtkTreeModel *model;
+  GtkTreeIter parent, iter;
+  GtkTreePath *path;
+  gint n_rows, inserted = 0;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  adaptor = glade_widget_adaptor_get_by_type (GTK_TYPE_BUTTON);
+  widget  = glade_widget_adaptor_create_widget (adaptor, FALSE, NULL);
+  model   = glade_widget_get_signal_model (widget);
+
+  g_assert (gtk_tree_model_iter_children (model, &parent, NULL));
+  do
+    {
+      gchar *type;
+
+      gtk_tree_model_get (model, &parent, GLADE_SIGNAL_COLUMN_NAME, &type, -1);
+      if (g_strcmp0 (type, "GtkButton") == 0)
+        {
+          g_free (type);
+          break;
+        }
+      g_free (type);
+    }
+  while (gtk_tree_model_iter_next (model, &parent));
+
+  n_rows = gtk_tree_model_iter_n_children (model, &parent);
+  g_assert_cmpint (n_rows, >, 0);
+
+  /* Adding a handler inserts a single row, with a valid path */
+  g_signal_connect (model, "row-inserted", G_CALLBACK (on_row_inserted), &inserted);
+
+  signal = glade_signal_new (glade_widget_adaptor_get_signal_class (adaptor, "clicked"),
+                             "on_button_clicked", NULL, FALSE, FALSE);
+  glade_widget_add_signal_handler (widget, signal);
+
+  g_assert_cmpint (inserted, ==, 1);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (model, &parent), ==, n_rows + 1);
+
+  /* Every row maps back to its own path */
+  g_assert (gtk_tree_model_iter_nth_child (model, &iter, &parent, n_rows));
+  path = gtk_tree_model_get_path (model, &iter);
+  g_assert_cmpint (gtk_tree_path_get_indices (path)[1], ==, n_rows);
+  gtk_tree_path_free (path);
+
+  g_assert (gtk_tree_model_iter_children (model, &iter, &parent));
+  do
+    {
+      gtk_tree_model_get (model, &iter, GLADE_SIGNAL_COLUMN_SIGNAL, &row_signal, -1);
+      if (glade_signal_equal (row_signal, signal))
+        break;
+      g_clear_object (&row_signal);
+    }
+  while (gtk_tree_model_iter_next (model, &iter));
+
+  g_assert (row_signal != NULL);
+  g_object_unref (row_signal);
+
+  glade_widget_remove_signal_handler (widget, signal);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (model, &parent), ==, n_rows);
+
+  g_signal_handlers_disconnect_by_func (model, on_row_inserted, &inserted);
+  g_object_unref (signal);
+  g_object_unref (widget);
+}
+
+static GladeSignal *
+add_quit_handler (GladeProject *project, GladeWidgetAdaptor *adaptor)
+{
+  GladeWidget *widget;
+  GladeSignal *signal;
+  GPtrArray *handlers;
+  gchar *handler = g_strconcat ("gtk_main", "_quit", NULL);
+
+  widget = glade_widget_adaptor_create_widget (adaptor, FALSE, "project", project, NULL);
+  glade_project_add_object (project, glade_widget_get_object (widget));
+
+  signal = glade_signal_new (glade_widget_adaptor_get_signal_class (adaptor, "clicked"),
+                             handler, NULL, FALSE, FALSE);
+  glade_widget_add_signal_handler (widget, signal);
+  g_object_unref (signal);
+  g_free (handler);
+
+  handlers = glade_widget_list_signal_handlers (widget, "clicked");
+  g_assert (handlers && handlers->len == 1);
+
+  return g_ptr_array_index (handlers, 0);
+}
+
+static void
+test_handlers_shared (void)
+{
+  GladeWidgetAdaptor *adaptor;
+  GladeProject *project, *other;
+  GladeSignal *first, *second, *third;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  adaptor = glade_widget_adaptor_get_by_type (GTK_TYPE_BUTTON);
+  project = glade_project_new ();
+  other   = glade_project_new ();
+
+  /* Handlers are shared within a project only */
+  first  = add_quit_handler (project, adaptor);
+  second = add_quit_handler (project, adaptor);
+  third  = add_quit_handler (other, adaptor);
+
+  g_assert (glade_signal_get_handler (first) == glade_signal_get_handler (second));
+  g_assert (glade_signal_get_handler (first) != glade_signal_get_handler (third));
+  g_assert_cmpstr (glade_signal_get_handler (third), ==, "gtk_main_quit");
+
+  /* A signal outliving its project keeps its strings */
+  g_object_ref (first);
+  g_object_unref (project);
+  g_assert_cmpstr (glade_signal_get_handler (first), ==, "gtk_main_quit");
+
+  g_object_unref (first);
+  g_object_unref (other);
+}
+
+static void
+test_handlers_dense (void)
+{
+  static const gchar *signal_names[] = { "clicked", "enter", "leave", "pressed", "released" };
+  GladeWidgetAdaptor *adaptor;
+  GladeProject *project;
+  GladeWidget *widget = NULL;
+  GPtrArray *handlers;
+  gulong rss_before, rss_after;
+  GTimer *timer;
+  gchar *expected;
+  gint i, j;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = glade_project_new ();
+  adaptor = glade_widget_adaptor_get_by_type (GTK_TYPE_BUTTON);
+
+  rss_before = test_current_rss ();
+
+  for (i = 0; i < N_WIDGETS; i++)
+    {
+      widget = glade_widget_adaptor_create_widget (adaptor, FALSE, "project", project, NULL);
+      glade_project_add_object (project, glade_widget_get_object (widget));
+
+      for (j = 0; j < G_N_ELEMENTS (signal_names); j++)
+        {
+          GladeSignalClass *sclass = glade_widget_adaptor_get_signal_class (adaptor, signal_names[j]);
+          gchar *handler = g_strdup_printf ("on_%s_%s", glade_widget_get_name (widget), signal_names[j]);
+          GladeSignal *signal = glade_signal_new (sclass, handler, NULL, FALSE, FALSE);
+
+          glade_widget_add_signal_handler (widget, signal);
+
+          g_object_unref (signal);
+          g_free (handler);
+        }
+    }
+
+  rss_after = test_current_rss ();
+
+  /* The last widget lists its own handlers only */
+  for (j = 0; j < G_N_ELEMENTS (signal_names); j++)
+    {
+      handlers = glade_widget_list_signal_handlers (widget, signal_names[j]);
+      g_assert (handlers);
+      g_assert_cmpuint (handlers->len, ==, 1);
+
+      expected = g_strdup_printf ("on_%s_%s", glade_widget_get_name (widget), signal_names[j]);
+      g_assert_cmpstr (glade_signal_get_handler (g_ptr_array_index (handlers, 0)), ==, expected);
+      g_free (expected);
+    }
+
+  if (!g_test_perf ())
+    {
+      g_object_unref (project);
+      return;
+    }
+
+  timer = g_timer_new ();
+  for (i = 0; i < N_LOOKUPS; i++)
+    {
+      g_assert (glade_widget_list_signal_handlers (widget, signal_names[i % G_N_ELEMENTS (signal_names)]));
+      g_assert (glade_widget_get_property (widget, "label"));
+    }
+  g_timer_stop (timer);
+
+  if (rss_before > 0)
+    g_test_message ("Resident memory for %d widgets with %d handlers each: %lu kB",
+                    N_WIDGETS, (gint) G_N_ELEMENTS (signal_names), rss_after - rss_before);
+
+  g_test_message ("%d signal and property lookups in %.3f seconds",
+                  N_LOOKUPS, g_timer_elapsed (timer, NULL));
+
+  g_timer_destroy (timer);
+  g_object_unref (project);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/SignalHandlers/Lookup", test_handlers_lookup);
+  g_test_add_func ("/SignalHandlers/Model", test_handlers_model);
+  g_test_add_func ("/SignalHandlers/Shared", test_handlers_shared);
+  g_test_add_func ("/SignalHandlers/Dense", test_handlers_dense);
+
+  return g_test_run ();
+}
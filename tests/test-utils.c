@@ -0,0 +1,35 @@
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test-utils.h"
+
+/* Reads the value in kB of @field from /proc/self/status, or 0 */
+static gulong
+read_status_field (const gchar *field)
+{
+  gchar *status = NULL, *line;
+  gulong value = 0;
+
+  if (g_file_get_contents ("/proc/self/status", &status, NULL, NULL) &&
+      (line = strstr (status, field)) != NULL)
+    value = strtoul (line + strlen (field), NULL, 10);
+
+  g_free (status);
+
+  return value;
+}
+
+/* Current resident set size in kB, or 0 if unavailable */
+gulong
+test_current_rss (void)
+{
+  return read_status_field ("VmRSS:");
+}
+
+/* Peak resident set size in kB, or 0 if unavailable */
+gulong
+test_peak_rss (void)
+{
+  return read_status_field ("VmHWM:");
+}
@@ -0,0 +1,13 @@
+#ifndef __TEST_UTILS_H__
+#define __TEST_UTILS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+gulong test_current_rss (void);
+gulong test_peak_rss    (void);
+
+G_END_DECLS
+
+#endif /* __TEST_UTILS_H__ */
@@ -0,0 +1,203 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+#define N_ROWS 10
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+flush_idles (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+/* Two windows, the first one holding N_ROWS rows of a label and an
+ * entry, followed by two size groups.
+ */
+static GladeProject *
+load_rows (void)
+{
+  GladeProject *project;
+  GString *xml;
+  gchar *path;
+  gint i;
+
+  xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		      "<interface>\n"
+		      "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+		      "  <object class=\"GtkWindow\" id=\"window\">\n"
+		      "    <child>\n"
+		      "      <object class=\"GtkBox\" id=\"form\">\n"
+		      "        <property name=\"orientation\">vertical</property>\n");
+
+  for (i = 0; i < N_ROWS; i++)
+    g_string_append_printf (xml,
+			    "        <child>\n"
+			    "          <object class=\"GtkBox\" id=\"row%d\">\n"
+			    "            <child>\n"
+			    "              <object class=\"GtkLabel\" id=\"label%d\"/>\n"
+			    "            </child>\n"
+			    "            <child>\n"
+			    "              <object class=\"GtkEntry\" id=\"entry%d\"/>\n"
+			    "              <packing>\n"
+			    "                <property name=\"position\">1</property>\n"
+			    "              </packing>\n"
+			    "            </child>\n"
+			    "          </object>\n"
+			    "          <packing>\n"
+			    "            <property name=\"position\">%d</property>\n"
+			    "          </packing>\n"
+			    "        </child>\n",
+			    i, i, i, i);
+
+  g_string_append_printf (xml,
+			  "      </object>\n"
+			  "    </child>\n"
+			  "  </object>\n"
+			  "  <object class=\"GtkWindow\" id=\"window2\">\n"
+			  "    <child>\n"
+			  "      <object class=\"GtkLabel\" id=\"label%d\"/>\n"
+			  "    </child>\n"
+			  "  </object>\n"
+			  "  <object class=\"GtkSizeGroup\" id=\"group0\"/>\n"
+			  "  <object class=\"GtkSizeGroup\" id=\"group1\"/>\n"
+			  "</interface>\n",
+			  N_ROWS);
+
+  g_assert (g_close (g_file_open_tmp ("glade-type-index-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml->str, xml->len, NULL));
+  g_string_free (xml, TRUE);
+
+  g_assert ((project = glade_project_load (path)));
+  flush_idles ();
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+static guint
+count_objects (GladeProject *project, GType type)
+{
+  GList *objects = glade_project_list_objects_by_type (project, type);
+  guint n_objects = g_list_length (objects);
+
+  g_list_free (objects);
+
+  return n_objects;
+}
+
+/* Checks that the objects of @type are listed as @prefix%d in order */
+static void
+assert_order (GladeProject *project, GType type, const gchar *prefix, gint n_objects)
+{
+  GList *objects, *l;
+  gchar *name;
+  gint i = 0;
+
+  objects = glade_project_list_objects_by_type (project, type);
+
+  for (l = objects; l; l = l->next, i++)
+    {
+      name = g_strdup_printf ("%s%d", prefix, i);
+      g_assert_cmpstr (glade_widget_get_name (glade_widget_get_from_gobject (l->data)), ==, name);
+      g_free (name);
+    }
+
+  g_assert_cmpint (i, ==, n_objects);
+  g_list_free (objects);
+}
+
+static void
+test_type_index_count (void)
+{
+  GladeProject *project;
+  GList list = { 0, };
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_rows ();
+
+  /* Exact types and their ancestors are both found */
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_ENTRY), ==, N_ROWS);
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_LABEL), ==, N_ROWS + 1);
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_BOX), ==, N_ROWS + 1);
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_WIDGET), ==, 3 * N_ROWS + 4);
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_EDITABLE), ==, N_ROWS);
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_SIZE_GROUP), ==, 2);
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_TREE_VIEW), ==, 0);
+
+  list.data = glade_project_get_widget_by_name (project, "form");
+  glade_command_delete (&list);
+  flush_idles ();
+
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_ENTRY), ==, 0);
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_WIDGET), ==, 3);
+
+  glade_project_undo (project);
+  flush_idles ();
+
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_ENTRY), ==, N_ROWS);
+  g_assert_cmpuint (count_objects (project, GTK_TYPE_WIDGET), ==, 3 * N_ROWS + 4);
+
+  g_object_unref (project);
+}
+
+static void
+test_type_index_order (void)
+{
+  GladeProject *project;
+  GList list = { 0, };
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  project = load_rows ();
+
+  /* Objects are listed in tree order, across toplevels */
+  assert_order (project, GTK_TYPE_LABEL, "label", N_ROWS + 1);
+  assert_order (project, GTK_TYPE_ENTRY, "entry", N_ROWS);
+  assert_order (project, GTK_TYPE_SIZE_GROUP, "group", 2);
+
+  /* A restored row goes back to its place */
+  list.data = glade_project_get_widget_by_name (project, "row3");
+  glade_command_delete (&list);
+  flush_idles ();
+
+  glade_project_undo (project);
+  flush_idles ();
+
+  assert_order (project, GTK_TYPE_LABEL, "label", N_ROWS + 1);
+  assert_order (project, GTK_TYPE_ENTRY, "entry", N_ROWS);
+
+  g_object_unref (project);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/TypeIndex/Count", test_type_index_count);
+  g_test_add_func ("/TypeIndex/Order", test_type_index_order);
+
+  return g_test_run ();
+}
@@ -0,0 +1,330 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+
+#include <gladeui/glade.h>
+
+/* Rows of enum and flags heavy widgets, more when measuring performance */
+#define N_ROWS      500
+#define N_ROWS_PERF 5000
+
+/* String to value conversions timed when measuring performance */
+#define N_CONVERSIONS 100000
+
+/* Avoid warnings from GVFS-RemoteVolumeMonitor */
+static gboolean
+ignore_gvfs_warning (const gchar *log_domain,
+		     GLogLevelFlags log_level,
+		     const gchar *message,
+		     gpointer user_data)
+{
+  if (g_strcmp0 (log_domain, "GVFS-RemoteVolumeMonitor") == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+static GType
+test_enum_get_type (void)
+{
+  static GType type = 0;
+
+  if (type == 0)
+    {
+      static const GEnumValue values[] = {
+	{ 0, "TEST_ENUM_FIRST", "first" },
+	{ 1, "TEST_ENUM_SECOND", "second" },
+	{ 0, NULL, NULL }
+      };
+
+      type = g_enum_register_static ("GladeTestConversionEnum", values);
+      glade_register_translated_value (type, "TEST_ENUM_SECOND", "The second one");
+    }
+
+  return type;
+}
+
+static void
+test_conversion_enum (void)
+{
+  gchar *string;
+
+  g_assert_cmpint (glade_utils_enum_value_from_string (GTK_TYPE_ORIENTATION, "vertical"),
+		   ==, GTK_ORIENTATION_VERTICAL);
+  g_assert_cmpint (glade_utils_enum_value_from_string (GTK_TYPE_ORIENTATION, "GTK_ORIENTATION_VERTICAL"),
+		   ==, GTK_ORIENTATION_VERTICAL);
+  g_assert_cmpint (glade_utils_enum_value_from_string (GTK_TYPE_ORIENTATION, "1"),
+		   ==, GTK_ORIENTATION_VERTICAL);
+
+  string = glade_utils_enum_string_from_value (GTK_TYPE_ORIENTATION, GTK_ORIENTATION_VERTICAL);
+  g_assert_cmpstr (string, ==, "vertical");
+  g_free (string);
+}
+
+static void
+test_conversion_flags (void)
+{
+  gchar *string;
+
+  g_assert_cmpint (glade_utils_flags_value_from_string (GTK_TYPE_STATE_FLAGS, "GTK_STATE_FLAG_PRELIGHT"),
+		   ==, GTK_STATE_FLAG_PRELIGHT);
+  g_assert_cmpint (glade_utils_flags_value_from_string (GTK_TYPE_STATE_FLAGS, "active | prelight"),
+		   ==, GTK_STATE_FLAG_ACTIVE | GTK_STATE_FLAG_PRELIGHT);
+  g_assert_cmpint (glade_utils_flags_value_from_string (GTK_TYPE_STATE_FLAGS,
+							"  GTK_STATE_FLAG_ACTIVE|GTK_STATE_FLAG_PRELIGHT "),
+		   ==, GTK_STATE_FLAG_ACTIVE | GTK_STATE_FLAG_PRELIGHT);
+
+  string = glade_utils_flags_string_from_value (GTK_TYPE_STATE_FLAGS,
+						GTK_STATE_FLAG_ACTIVE | GTK_STATE_FLAG_PRELIGHT);
+  g_assert_cmpstr (string, ==, "GTK_STATE_FLAG_ACTIVE | GTK_STATE_FLAG_PRELIGHT");
+  g_free (string);
+}
+
+static void
+test_conversion_displayable (void)
+{
+  GType type = test_enum_get_type ();
+  gchar *string;
+
+  g_assert (glade_type_has_displayable_values (type));
+  g_assert_cmpstr (glade_get_displayable_value (type, "TEST_ENUM_SECOND"), ==, "The second one");
+  g_assert_cmpstr (glade_get_value_from_displayable (type, "The second one"), ==, "TEST_ENUM_SECOND");
+  g_assert (glade_get_displayable_value (type, "TEST_ENUM_FIRST") == NULL);
+
+  g_assert_cmpint (glade_utils_enum_value_from_string (type, "The second one"), ==, 1);
+  g_assert_cmpint (glade_utils_enum_value_from_string (type, "second"), ==, 1);
+  g_assert_cmpint (glade_utils_enum_value_from_string (type, "first"), ==, 0);
+
+  string = glade_utils_enum_string_from_value_displayable (type, 1);
+  g_assert_cmpstr (string, ==, "The second one");
+  g_free (string);
+
+  string = glade_utils_enum_string_from_value_displayable (type, 0);
+  g_assert_cmpstr (string, ==, "first");
+  g_free (string);
+}
+
+/* A window with rows of boxes and labels setting many enum and flags properties */
+static GladeProject *
+load_enum_heavy (gint n_rows)
+{
+  GladeProject *project;
+  GString *xml;
+  gchar *path;
+  gint i;
+
+  xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		      "<interface>\n"
+		      "  <requires lib=\"gtk+\" version=\"3.20\"/>\n"
+		      "  <object class=\"GtkWindow\" id=\"window\">\n"
+		      "    <child>\n"
+		      "      <object class=\"GtkBox\" id=\"rows\">\n"
+		      "        <property name=\"orientation\">vertical</property>\n");
+
+  for (i = 0; i < n_rows; i++)
+    g_string_append_printf (xml,
+			    "        <child>\n"
+			    "          <object class=\"GtkBox\" id=\"row%d\">\n"
+			    "            <property name=\"orientation\">horizontal</property>\n"
+			    "            <property name=\"halign\">start</property>\n"
+			    "            <property name=\"valign\">GTK_ALIGN_CENTER</property>\n"
+			    "            <property name=\"baseline_position\">bottom</property>\n"
+			    "            <property name=\"events\">GDK_BUTTON_PRESS_MASK | GDK_KEY_PRESS_MASK</property>\n"
+			    "            <child>\n"
+			    "              <object class=\"GtkLabel\" id=\"label%d\">\n"
+			    "                <property name=\"label\">Row %d</property>\n"
+			    "                <property name=\"justify\">center</property>\n"
+			    "                <property name=\"ellipsize\">end</property>\n"
+			    "                <property name=\"wrap_mode\">word-char</property>\n"
+			    "                <property name=\"halign\">end</property>\n"
+			    "              </object>\n"
+			    "            </child>\n"
+			    "          </object>\n"
+			    "          <packing>\n"
+			    "            <property name=\"pack_type\">end</property>\n"
+			    "            <property name=\"position\">%d</property>\n"
+			    "          </packing>\n"
+			    "        </child>\n",
+			    i, i, i, i);
+
+  g_string_append (xml,
+		   "      </object>\n"
+		   "    </child>\n"
+		   "  </object>\n"
+		   "</interface>\n");
+
+  g_assert (g_close (g_file_open_tmp ("glade-value-conversion-XXXXXX.glade", &path, NULL), NULL));
+  g_assert (g_file_set_contents (path, xml->str, xml->len, NULL));
+  g_string_free (xml, TRUE);
+
+  g_assert ((project = glade_project_load (path)));
+
+  g_unlink (path);
+  g_free (path);
+
+  return project;
+}
+
+static void
+test_conversion_load (void)
+{
+  GladeProject *project;
+  GladeWidget *row, *label;
+  GtkOrientation orientation = GTK_ORIENTATION_VERTICAL;
+  GtkAlign valign = GTK_ALIGN_FILL;
+  PangoEllipsizeMode ellipsize = PANGO_ELLIPSIZE_NONE;
+  gint events = 0;
+  GTimer *timer;
+  gint n_rows = g_test_perf () ? N_ROWS_PERF : N_ROWS;
+
+  g_test_log_set_fatal_handler (ignore_gvfs_warning, NULL);
+
+  timer = g_timer_new ();
+  project = load_enum_heavy (n_rows);
+  g_test_message ("Loaded %d rows with 10 enum and flags properties each in %f seconds",
+		  n_rows, g_timer_elapsed (timer, NULL));
+
+  g_assert ((row = glade_project_get_widget_by_name (project, "row7")));
+  glade_widget_property_get (row, "orientation", &orientation);
+  glade_widget_property_get (row, "valign", &valign);
+  glade_widget_property_get (row, "events", &events);
+  g_assert_cmpint (orientation, ==, GTK_ORIENTATION_HORIZONTAL);
+  g_assert_cmpint (valign, ==, GTK_ALIGN_CENTER);
+  g_assert_cmpint (events, ==, GDK_BUTTON_PRESS_MASK | GDK_KEY_PRESS_MASK);
+
+  g_assert ((label = glade_project_get_widget_by_name (project, "label7")));
+  glade_widget_property_get (label, "ellipsize", &ellipsize);
+  g_assert_cmpint (ellipsize, ==, PANGO_ELLIPSIZE_END);
+
+  g_timer_destroy (timer);
+  g_object_unref (project);
+}
+
+/* How values were found before the conversion tables: by referencing
+ * the type class and searching its values, names first and then nicks.
+ */
+static gint
+linear_enum_from_string (GType type, const gchar *string)
+{
+  GEnumClass *eclass = g_type_class_ref (type);
+  GEnumValue *ev;
+  gint value = 0;
+
+  if ((ev = g_enum_get_value_by_name (eclass, string)) == NULL)
+    ev = g_enum_get_value_by_nick (eclass, string);
+
+  if (ev)
+    value = ev->value;
+
+  g_type_class_unref (eclass);
+
+  return value;
+}
+
+static guint
+linear_flags_from_string (GType type, const gchar *string)
+{
+  GFlagsClass *fclass = g_type_class_ref (type);
+  GFlagsValue *fv;
+  guint value = 0;
+
+  if ((fv = g_flags_get_value_by_name (fclass, string)) == NULL)
+    fv = g_flags_get_value_by_nick (fclass, string);
+
+  if (fv)
+    value = fv->value;
+
+  g_type_class_unref (fclass);
+
+  return value;
+}
+
+static gdouble
+time_conversions (GladePropertyClass *pclass, const gchar *string)
+{
+  GTimer *timer = g_timer_new ();
+  GValue *value;
+  gdouble elapsed;
+  gint i;
+
+  for (i = 0; i < N_CONVERSIONS; i++)
+    {
+      value = glade_property_class_make_gvalue_from_string (pclass, string, NULL);
+      g_value_unset (value);
+      g_free (value);
+    }
+
+  elapsed = g_timer_elapsed (timer, NULL);
+  g_timer_destroy (timer);
+
+  return elapsed;
+}
+
+static void
+test_conversion_throughput (void)
+{
+  GladeWidgetAdaptor *label, *widget;
+  GladePropertyClass *ellipsize, *events;
+  GValue *value;
+  GTimer *timer;
+  gdouble enum_time, flags_time, linear_enum_time, linear_flags_time;
+  gint i;
+
+  if (!g_test_perf ())
+    return;
+
+  label = glade_widget_adaptor_get_by_type (GTK_TYPE_LABEL);
+  widget = glade_widget_adaptor_get_by_type (GTK_TYPE_WIDGET);
+  g_assert ((ellipsize = glade_widget_adaptor_get_property_class (label, "ellipsize")));
+  g_assert ((events = glade_widget_adaptor_get_property_class (widget, "events")));
+
+  /* Both paths agree before being timed */
+  value = glade_property_class_make_gvalue_from_string (ellipsize, "end", NULL);
+  g_assert_cmpint (g_value_get_enum (value), ==,
+		   linear_enum_from_string (PANGO_TYPE_ELLIPSIZE_MODE, "end"));
+  g_value_unset (value);
+  g_free (value);
+
+  value = glade_property_class_make_gvalue_from_string (events, "GDK_KEY_PRESS_MASK", NULL);
+  g_assert_cmpuint (g_value_get_flags (value), ==,
+		    linear_flags_from_string (GDK_TYPE_EVENT_MASK, "GDK_KEY_PRESS_MASK"));
+  g_value_unset (value);
+  g_free (value);
+
+  enum_time = time_conversions (ellipsize, "end");
+  flags_time = time_conversions (events, "GDK_KEY_PRESS_MASK");
+
+  timer = g_timer_new ();
+  for (i = 0; i < N_CONVERSIONS; i++)
+    linear_enum_from_string (PANGO_TYPE_ELLIPSIZE_MODE, "end");
+  linear_enum_time = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 0; i < N_CONVERSIONS; i++)
+    linear_flags_from_string (GDK_TYPE_EVENT_MASK, "GDK_KEY_PRESS_MASK");
+  linear_flags_time = g_timer_elapsed (timer, NULL);
+  g_timer_destroy (timer);
+
+  g_test_message ("%d enum conversions in %f seconds, %f seconds searching the class",
+		  N_CONVERSIONS, enum_time, linear_enum_time);
+  g_test_message ("%d flags conversions in %f seconds, %f seconds searching the class",
+		  N_CONVERSIONS, flags_time, linear_flags_time);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  glade_init ();
+  glade_app_get ();
+
+  g_test_add_func ("/ValueConversion/Enum", test_conversion_enum);
+  g_test_add_func ("/ValueConversion/Flags", test_conversion_flags);
+  g_test_add_func ("/ValueConversion/Displayable", test_conversion_displayable);
+  g_test_add_func ("/ValueConversion/Load", test_conversion_load);
+  g_test_add_func ("/ValueConversion/Throughput", test_conversion_throughput);
+
+  return g_test_run ();
+}